@@ -81,6 +81,9 @@ public:
 
     virtual void getGpuStats(SkCanvas*, SkTArray<SkString>* keys, SkTArray<double>* values) {}
 
+    // Metrics of the benchmark's own, from the draws since the last call, to log with its timings.
+    virtual void getExtraStats(SkTArray<SkString>* keys, SkTArray<double>* values) {}
+
     // Replaces the GrRecordingContext's dmsaaStats() with a single frame of this benchmark.
     virtual bool getDMSAAStats(GrRecordingContext*) { return false; }
 
@@ -7,6 +7,7 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkPaint.h"
 
 class CanvasSaveRestoreBench : public Benchmark {
 public:
@@ -42,8 +43,60 @@ private:
 };
 
 // Performance remains roughly constant up to 32 (the number of preallocated save records).
-// After that, the cost of additional malloc/free calls starts to be measurable.
+// After that, save records are allocated 32 at a time, so malloc/free calls stay rare.
 DEF_BENCH( return new CanvasSaveRestoreBench(8);)
 DEF_BENCH( return new CanvasSaveRestoreBench(32);)
 DEF_BENCH( return new CanvasSaveRestoreBench(128);)
 DEF_BENCH( return new CanvasSaveRestoreBench(512);)
+
+// Layer-heavy traffic like web content produces: each loop makes fCount layers of fSize x fSize,
+// either nested inside one another or as siblings (e.g. a list of translucent items).  Each layer
+// is composited with some alpha, so none of them can be optimized away.
+class CanvasSaveLayerBench : public Benchmark {
+public:
+    CanvasSaveLayerBench(int count, int size, bool nested)
+            : fCount(count), fSize(size), fNested(nested) {
+        fName.printf("canvas_savelayer_%s_%d_%d", nested ? "nested" : "siblings", fCount, fSize);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+    SkIPoint onGetSize() override { return { fSize, fSize }; }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        const SkRect bounds = SkRect::MakeIWH(fSize, fSize);
+        SkPaint layerPaint;
+        layerPaint.setAlphaf(0.9f);
+
+        for (int i = 0; i < loops; ++i) {
+            for (int j = 0; j < fCount; ++j) {
+                canvas->saveLayer(&bounds, &layerPaint);
+                canvas->drawRect(SkRect::MakeXYWH(j % fSize, 0, 1, 1), SkPaint());
+                if (!fNested) {
+                    canvas->restore();
+                }
+            }
+            if (fNested) {
+                for (int j = 0; j < fCount; ++j) {
+                    canvas->restore();
+                }
+            }
+        }
+    }
+
+private:
+    const int  fCount,
+               fSize;
+    const bool fNested;
+    SkString   fName;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new CanvasSaveLayerBench(  8,  16, true);)
+DEF_BENCH( return new CanvasSaveLayerBench(128,  16, true);)
+DEF_BENCH( return new CanvasSaveLayerBench(  8, 256, true);)
+DEF_BENCH( return new CanvasSaveLayerBench( 64,  16, false);)
+DEF_BENCH( return new CanvasSaveLayerBench( 64, 256, false);)
+DEF_BENCH( return new CanvasSaveLayerBench( 16, 512, false);)
@@ -17,14 +17,15 @@ static DEFINE_bool(zero_init, false,
                    "Pretend our destination is zero-intialized, simulating Android?");
 
 CodecBench::CodecBench(SkString baseName, SkData* encoded, SkColorType colorType,
-        SkAlphaType alphaType)
+        SkAlphaType alphaType, sk_sp<SkColorSpace> dstColorSpace)
     : fColorType(colorType)
     , fAlphaType(alphaType)
+    , fDstColorSpace(std::move(dstColorSpace))
     , fData(SkRef(encoded))
 {
     // Parse filename and the color type to give the benchmark a useful name
-    fName.printf("Codec_%s_%s%s", baseName.c_str(), color_type_to_str(colorType),
-            alpha_type_to_str(alphaType));
+    fName.printf("Codec_%s_%s%s%s", baseName.c_str(), color_type_to_str(colorType),
+            alpha_type_to_str(alphaType), fDstColorSpace ? "_xform" : "");
     // Ensure that we can create an SkCodec from this data.
     SkASSERT(SkCodec::MakeFromData(fData));
 }
@@ -42,7 +43,7 @@ void CodecBench::onDelayedSetup() {
 
     fInfo = codec->getInfo().makeColorType(fColorType)
                             .makeAlphaType(fAlphaType)
-                            .makeColorSpace(nullptr);
+                            .makeColorSpace(fDstColorSpace);
 
     fPixelStorage.reset(fInfo.computeMinByteSize());
 }
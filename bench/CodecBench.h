@@ -9,6 +9,7 @@
 #define CodecBench_DEFINED
 
 #include "bench/Benchmark.h"
+#include "include/core/SkColorSpace.h"
 #include "include/core/SkData.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkRefCnt.h"
@@ -21,7 +22,9 @@
 class CodecBench : public Benchmark {
 public:
     // Calls encoded->ref()
-    CodecBench(SkString basename, SkData* encoded, SkColorType colorType, SkAlphaType alphaType);
+    // If dstColorSpace is not null, the decode converts to it.
+    CodecBench(SkString basename, SkData* encoded, SkColorType colorType, SkAlphaType alphaType,
+               sk_sp<SkColorSpace> dstColorSpace = nullptr);
 
 protected:
     const char* onGetName() override;
@@ -33,6 +36,7 @@ private:
     SkString                fName;
     const SkColorType       fColorType;
     const SkAlphaType       fAlphaType;
+    sk_sp<SkColorSpace>     fDstColorSpace;
     sk_sp<SkData>           fData;
     SkImageInfo             fInfo;          // Set in onDelayedSetup.
     SkAutoMalloc            fPixelStorage;
@@ -0,0 +1,171 @@
+/*
+ * Copyright 2022 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/codec/SkCodec.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkString.h"
+#include "include/private/SkTArray.h"
+#include "include/private/SkTo.h"
+#include "include/utils/SkRandom.h"
+#include "src/utils/SkCodecFrameCache.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// Writes a size x size GIF with frameCount frames. The first frame covers the whole image; every
+// later frame paints a small square over the one before, which it keeps, so frame N requires
+// frame N - 1 and decoding frame N from scratch decodes N + 1 frames.
+static sk_sp<SkData> make_gif(int size, int frameCount) {
+    SkDynamicMemoryWStream stream;
+    auto write16 = [&stream](int v) {
+        stream.write8(SkToU8(v & 0xFF));
+        stream.write8(SkToU8(v >> 8));
+    };
+
+    stream.write("GIF89a", 6);
+    write16(size);
+    write16(size);
+    stream.write8(0xF7);  // 256 entry global color table
+    stream.write8(0);     // background color index
+    stream.write8(0);     // pixel aspect ratio
+    for (int i = 0; i < 256; ++i) {
+        stream.write8(SkToU8(i));
+        stream.write8(SkToU8(255 - i));
+        stream.write8(SkToU8((i * 7) & 0xFF));
+    }
+
+    for (int f = 0; f < frameCount; ++f) {
+        const int w = f == 0 ? size : size / 8,
+                  h = w,
+                  x = f == 0 ? 0 : (f * 37) % (size - w),
+                  y = f == 0 ? 0 : (f * 53) % (size - h);
+
+        // Graphic control extension: keep this frame when drawing the next, 40ms, opaque.
+        static constexpr uint8_t kGraphicControl[] = { 0x21, 0xF9, 0x04, 0x04, 4, 0, 0, 0 };
+        stream.write(kGraphicControl, sizeof(kGraphicControl));
+
+        stream.write8(0x2C);  // image descriptor
+        write16(x);
+        write16(y);
+        write16(w);
+        write16(h);
+        stream.write8(0);
+
+        // Uncompressed LZW: every pixel is a 9 bit literal code, and the code table is cleared
+        // before it can grow past 9 bits.
+        static constexpr uint32_t kClearCode = 256,
+                                  kEndCode   = 257;
+        static constexpr int      kMaxRun    = 250;
+        std::vector<uint8_t> bytes;
+        uint32_t bits = 0;
+        int bitCount = 0;
+        auto writeCode = [&](uint32_t code) {
+            bits |= code << bitCount;
+            for (bitCount += 9; bitCount >= 8; bitCount -= 8) {
+                bytes.push_back(SkToU8(bits & 0xFF));
+                bits >>= 8;
+            }
+        };
+        writeCode(kClearCode);
+        for (int i = 0; i < w * h; ++i) {
+            if (i > 0 && i % kMaxRun == 0) {
+                writeCode(kClearCode);
+            }
+            writeCode(f == 0 ? (i % w + i / w) & 0xFF : 1 + f % 254);
+        }
+        writeCode(kEndCode);
+        if (bitCount > 0) {
+            bytes.push_back(SkToU8(bits));
+        }
+
+        stream.write8(8);  // minimum code size
+        for (size_t i = 0; i < bytes.size(); i += 255) {
+            size_t n = std::min<size_t>(255, bytes.size() - i);
+            stream.write8(SkToU8(n));
+            stream.write(bytes.data() + i, n);
+        }
+        stream.write8(0);
+    }
+    stream.write8(0x3B);  // trailer
+    return stream.detachAsData();
+}
+
+// Seeks to random frames of a 500 frame GIF in which every frame requires the one before, either
+// with SkCodec directly (which decodes the whole chain of required frames each time) or through
+// SkCodecFrameCache (which decodes forward from the nearest keyframe).
+class CodecFrameCacheBench final : public Benchmark {
+public:
+    explicit CodecFrameCacheBench(bool useCache) : fUseCache(useCache) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override {
+        return fUseCache ? "codec_seek_gif500_framecache" : "codec_seek_gif500_codec";
+    }
+
+    void onDelayedSetup() override {
+        sk_sp<SkData> data = make_gif(256, kFrameCount);
+        if (fUseCache) {
+            fCache = std::make_unique<SkCodecFrameCache>(SkCodec::MakeFromData(data),
+                                                         SkCodecFrameCache::Options());
+            SkASSERT(fCache->frameCount() == kFrameCount);
+        } else {
+            fCodec = SkCodec::MakeFromData(data);
+            SkASSERT(fCodec->getFrameCount() == kFrameCount);
+            fBitmap.allocPixels(fCodec->getInfo());
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkRandom rand;
+        while (loops-- > 0) {
+            const int index = rand.nextULessThan(kFrameCount);
+            if (fUseCache) {
+                SkAssertResult(fCache->getFrame(index));
+            } else {
+                SkCodec::Options options;
+                options.fFrameIndex = index;
+                SkAssertResult(SkCodec::kSuccess == fCodec->getPixels(fBitmap.pixmap(), &options));
+            }
+        }
+    }
+
+    void getExtraStats(SkTArray<SkString>* keys, SkTArray<double>* values) override {
+        if (!fUseCache) {
+            return;
+        }
+        // Totals over every seek the cache has served, including warmup loops.
+        const SkCodecFrameCache::Stats stats = fCache->stats();
+        keys->push_back(SkString("cache_hits"));
+        values->push_back(stats.fHits);
+        keys->push_back(SkString("cache_misses"));
+        values->push_back(stats.fMisses);
+        keys->push_back(SkString("frames_decoded_per_miss"));
+        values->push_back(stats.fMisses ? stats.fFramesDecoded / (double)stats.fMisses : 0.0);
+        keys->push_back(SkString("keyframe_bytes"));
+        values->push_back(stats.fBytesUsed);
+    }
+
+private:
+    static constexpr int kFrameCount = 500;
+
+    const bool                         fUseCache;
+    std::unique_ptr<SkCodecFrameCache> fCache;
+    std::unique_ptr<SkCodec>           fCodec;
+    SkBitmap                           fBitmap;
+};
+
+// Without Wuffs there is no GIF decoder to seek with.
+#ifdef SK_HAS_WUFFS_LIBRARY
+DEF_BENCH(return new CodecFrameCacheBench(false));
+DEF_BENCH(return new CodecFrameCacheBench(true));
+#endif
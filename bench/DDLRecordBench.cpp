@@ -0,0 +1,176 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/DDLRecordBench.h"
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkDeferredDisplayList.h"
+#include "include/core/SkDeferredDisplayListRecorder.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkTime.h"
+#include "include/gpu/GrContextThreadSafeProxy.h"
+#include "include/gpu/GrDirectContext.h"
+#include "include/gpu/mock/GrMockTypes.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
+
+DDLRecordBench::DDLRecordBench(const char* name, sk_sp<SkPicture> picture, int tilesPerSide,
+                               int threads)
+        : fPicture(std::move(picture))
+        , fTilesPerSide(tilesPerSide)
+        , fThreads(threads) {
+    fName.printf("ddl_record_%s_%dx%d_%dthreads", name, tilesPerSide, tilesPerSide, threads);
+}
+
+DDLRecordBench::~DDLRecordBench() = default;
+
+const char* DDLRecordBench::onGetName() { return fName.c_str(); }
+
+bool DDLRecordBench::isSuitableFor(Backend backend) {
+    // We bring our own mock context, so there's no need to run on real GPU configs.
+    return backend == kNonRendering_Backend;
+}
+
+void DDLRecordBench::onDelayedSetup() {
+    GrMockOptions mockOptions;
+    fContext = GrDirectContext::MakeMock(&mockOptions);
+    if (!fContext) {
+        return;
+    }
+
+    const SkIRect bounds = fPicture->cullRect().roundOut();
+    const int tileW = (bounds.width()  + fTilesPerSide - 1) / fTilesPerSide,
+              tileH = (bounds.height() + fTilesPerSide - 1) / fTilesPerSide;
+    if (tileW <= 0 || tileH <= 0) {
+        fContext.reset();
+        return;
+    }
+
+    const SkImageInfo ii = SkImageInfo::Make(tileW, tileH, kRGBA_8888_SkColorType,
+                                             kPremul_SkAlphaType);
+    const GrBackendFormat format = fContext->defaultBackendFormat(kRGBA_8888_SkColorType,
+                                                                  GrRenderable::kYes);
+    const SkSurfaceCharacterization full = fContext->threadSafeProxy()->createCharacterization(
+            fContext->getResourceCacheLimit(), ii, format, 1, kTopLeft_GrSurfaceOrigin,
+            SkSurfaceProps(0, kUnknown_SkPixelGeometry), false);
+    if (!full.isValid()) {
+        fContext.reset();
+        return;
+    }
+
+    for (int y = 0; y < fTilesPerSide; y++)
+    for (int x = 0; x < fTilesPerSide; x++) {
+        SkIRect tile = SkIRect::MakeXYWH(bounds.fLeft + x * tileW, bounds.fTop + y * tileH,
+                                         tileW, tileH);
+        if (tile.intersect(bounds)) {
+            fTiles.push_back(tile);
+            fCharacterizations.push_back(full.createResized(tile.width(), tile.height()));
+        }
+    }
+    fDDLs.resize(fTiles.size());
+    fTallies.assign(fTiles.size() * fThreads, {SkThreadID(), 0, 0});
+
+    // Record every tile once to warm up the caches, then again on this thread alone to see how
+    // long each tile takes without any contention.
+    const int tiles = (int)fTiles.size();
+    for (int i = 0; i < tiles; i++) {
+        this->recordTile(i);
+    }
+    double serialMs = 0;
+    for (int i = 0; i < tiles; i++) {
+        serialMs += this->recordTile(i);
+    }
+    fSerialMsPerTile = serialMs / tiles;
+
+    // The waiting thread doesn't borrow tasks, so exactly fThreads threads record.
+    fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads, /*allowBorrowing=*/false);
+}
+
+double DDLRecordBench::recordTile(int i) {
+    const double start = SkTime::GetNSecs();
+
+    SkDeferredDisplayListRecorder recorder(fCharacterizations[i]);
+    SkCanvas* canvas = recorder.getCanvas();
+    canvas->clipRect(SkRect::MakeWH(fTiles[i].width(), fTiles[i].height()));
+    canvas->translate(-fTiles[i].fLeft, -fTiles[i].fTop);
+    canvas->drawPicture(fPicture);
+    fDDLs[i] = recorder.detach();
+
+    return (SkTime::GetNSecs() - start) * 1e-6;
+}
+
+void DDLRecordBench::onDraw(int loops, SkCanvas*) {
+    if (!fContext) {
+        return;
+    }
+
+    // Each tile's time is only added to its own tallies here; they're merged in getExtraStats().
+    const int tiles = (int)fTiles.size();
+    SkTaskGroup tg(*fExecutor);
+    for (int loop = 0; loop < loops; loop++) {
+        tg.batch(tiles, [this](int i) {
+            // Like a compositor, drop the last frame's DDL before recording the next, but keep
+            // deleting it out of the tile's own time.
+            fDDLs[i].reset();
+            const double ms = this->recordTile(i);
+
+            // Only fThreads threads ever record, so one of the tile's tallies is this thread's
+            // or still unused.
+            const SkThreadID thread = SkGetThreadID();
+            Tally* tally = &fTallies[(size_t)i * fThreads];
+            while (tally->fTiles > 0 && tally->fThread != thread) {
+                tally++;
+            }
+            SkASSERT(tally < fTallies.data() + (size_t)(i + 1) * fThreads);
+            tally->fThread = thread;
+            tally->fTiles += 1;
+            tally->fMs    += ms;
+        });
+        tg.wait();
+    }
+}
+
+void DDLRecordBench::getExtraStats(SkTArray<SkString>* keys, SkTArray<double>* values) {
+    if (!fContext) {
+        return;
+    }
+
+    std::vector<Tally> threads;
+    for (Tally& tally : fTallies) {
+        if (tally.fTiles == 0) {
+            continue;
+        }
+        auto stats = std::find_if(threads.begin(), threads.end(), [&](const Tally& t) {
+            return t.fThread == tally.fThread;
+        });
+        if (stats == threads.end()) {
+            stats = threads.insert(stats, {tally.fThread, 0, 0});
+        }
+        stats->fTiles += tally.fTiles;
+        stats->fMs    += tally.fMs;
+        tally = {SkThreadID(), 0, 0};
+    }
+    if (threads.empty()) {
+        return;
+    }
+
+    // Slowdowns above 1x are time lost to sharing: locks, atomics, caches, and memory bandwidth.
+    keys->push_back(SkString("serial_ms_per_tile"));
+    values->push_back(fSerialMsPerTile);
+    double worst = 0;
+    for (size_t t = 0; t < threads.size(); t++) {
+        const double slowdown = threads[t].fMs / threads[t].fTiles / fSerialMsPerTile;
+        keys->push_back(SkStringPrintf("thread%zu_tiles", t));
+        values->push_back(threads[t].fTiles);
+        keys->push_back(SkStringPrintf("thread%zu_slowdown", t));
+        values->push_back(slowdown);
+        worst = std::max(worst, slowdown);
+    }
+    keys->push_back(SkString("max_thread_slowdown"));
+    values->push_back(worst);
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef DDLRecordBench_DEFINED
+#define DDLRecordBench_DEFINED
+
+#include "bench/Benchmark.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkString.h"
+#include "include/core/SkSurfaceCharacterization.h"
+#include "include/private/SkThreadID.h"
+
+#include <memory>
+#include <vector>
+
+class GrDirectContext;
+class SkDeferredDisplayList;
+class SkExecutor;
+
+/**
+ * Records a picture into a grid of DDL tiles concurrently on a pool of threads, the way a
+ * compositor would. It runs against a mock GrDirectContext, so it needs no GPU and times only
+ * recording, on threads that share the GrThreadSafeCache and text blob cache behind
+ * GrContextThreadSafeProxy, the global GrProcessor pool, and SkStrikeCache.
+ *
+ * Alongside the timings, it reports how long each thread spent recording a tile compared to
+ * recording the same tiles on a single thread. That shows how much sharing costs, but not where:
+ * a tile's time covers all of its recording, not just op creation, and nothing here counts
+ * contention on the GrRecordingContext or any other lock. For per-lock contention, build with
+ * SK_MUTEX_STATS and run with --trace.
+ */
+class DDLRecordBench : public Benchmark {
+public:
+    DDLRecordBench(const char* name, sk_sp<SkPicture>, int tilesPerSide, int threads);
+    ~DDLRecordBench() override;
+
+    void getExtraStats(SkTArray<SkString>* keys, SkTArray<double>* values) override;
+
+protected:
+    const char* onGetName() override;
+    bool isSuitableFor(Backend) override;
+    void onDelayedSetup() override;
+    void onDraw(int loops, SkCanvas*) override;
+
+private:
+    // How many times one thread recorded a tile, and how long that took in total.
+    struct Tally {
+        SkThreadID fThread;
+        int        fTiles;
+        double     fMs;
+    };
+
+    // Records tile i into fDDLs[i], returning how long it took in ms.
+    double recordTile(int i);
+
+    SkString                                  fName;
+    sk_sp<SkPicture>                          fPicture;
+    const int                                 fTilesPerSide;
+    const int                                 fThreads;
+
+    sk_sp<GrDirectContext>                    fContext;
+    std::unique_ptr<SkExecutor>               fExecutor;
+    std::vector<SkIRect>                      fTiles;
+    std::vector<SkSurfaceCharacterization>    fCharacterizations;
+    std::vector<sk_sp<SkDeferredDisplayList>> fDDLs;
+
+    double                                    fSerialMsPerTile = 0;
+    // fThreads tallies per tile, each written only by the task recording that tile. Allocated
+    // up front so onDraw() only adds to them.
+    std::vector<Tally>                        fTallies;
+};
+
+#endif
@@ -6,8 +6,17 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkPictureRecorder.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkSurface.h"
+#include "include/encode/SkJpegEncoder.h"
+#include "include/private/SkTArray.h"
 #include "modules/skottie/include/Skottie.h"
 #include "tools/Resources.h"
 
@@ -233,3 +242,132 @@ DEF_BENCH(return new BitmapDecodeBench("png_small"    /*  32x  32*/, "images/man
 DEF_BENCH(return new BitmapDecodeBench("png_phonehub_connecting"   , "images/Connecting.png"));
 DEF_BENCH(return new BitmapDecodeBench("png_phonehub_generic_error", "images/Generic_Error.png"));
 DEF_BENCH(return new BitmapDecodeBench("png_phonehub_onboard"      , "images/Onboard.png"));
+
+// Decodes a 12 megapixel photo-sized JPEG with a restart marker after each MCU row, serially or
+// with SkCodec::Options::fExecutor set to a pool of the given number of threads, to show how
+// decoding strips of restart intervals in parallel scales.
+class JpegParallelDecodeBench final : public Benchmark {
+public:
+    explicit JpegParallelDecodeBench(int threads) : fThreads(threads) {
+        if (threads > 0) {
+            fName.printf("decode_jpeg_12mp_%dthreads", threads);
+        } else {
+            fName.printf("decode_jpeg_12mp_serial");
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkBitmap mandrill;
+        SkAssertResult(GetResourceAsBitmap("images/mandrill_1600.png", &mandrill));
+        SkBitmap photo;
+        photo.allocN32Pixels(4032, 3024, /*isOpaque=*/true);
+        SkCanvas(photo).drawImageRect(mandrill.asImage(), SkRect::MakeWH(4032, 3024),
+                                      SkSamplingOptions(SkFilterMode::kLinear));
+
+        SkJpegEncoder::Options options;
+        options.fQuality = 90;
+        options.fRestartRows = 1;
+        SkDynamicMemoryWStream stream;
+        SkAssertResult(SkJpegEncoder::Encode(&stream, photo.pixmap(), options));
+        fData = stream.detachAsData();
+
+        fBitmap.allocN32Pixels(4032, 3024, /*isOpaque=*/true);
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCodec::Options options;
+        options.fExecutor = fExecutor.get();
+        while (loops-- > 0) {
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(fData);
+            SkAssertResult(SkCodec::kSuccess == codec->getPixels(fBitmap.pixmap(), &options));
+        }
+    }
+
+private:
+    const int                   fThreads;
+    SkString                    fName;
+    sk_sp<SkData>               fData;
+    SkBitmap                    fBitmap;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH(return new JpegParallelDecodeBench(0));
+DEF_BENCH(return new JpegParallelDecodeBench(1));
+DEF_BENCH(return new JpegParallelDecodeBench(2));
+DEF_BENCH(return new JpegParallelDecodeBench(4));
+DEF_BENCH(return new JpegParallelDecodeBench(8));
+
+// Draws a 4x4 gallery of lazily decoded 1600x1200 JPEGs as 200x150 thumbnails into a raster surface,
+// purging the resource cache each loop so every thumbnail is decoded again. With kFast the images
+// are decoded at 1/8 scale and cached at 200x150 (16 x 117KB); kStrict forces the full resolution
+// decode every minified draw used to make (16 x 7.3MB).
+class DownscaledGalleryBench final : public Benchmark {
+public:
+    explicit DownscaledGalleryBench(SkCanvas::SrcRectConstraint constraint)
+        : fConstraint(constraint) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override {
+        return fConstraint == SkCanvas::kFast_SrcRectConstraint ? "decode_gallery_scaled"
+                                                                : "decode_gallery_full";
+    }
+
+    void onDelayedSetup() override {
+        SkBitmap mandrill;
+        SkAssertResult(GetResourceAsBitmap("images/mandrill_1600.png", &mandrill));
+        SkBitmap photo;
+        photo.allocN32Pixels(1600, 1200, /*isOpaque=*/true);
+        SkCanvas(photo).drawImageRect(mandrill.asImage(), SkRect::MakeWH(1600, 1200),
+                                      SkSamplingOptions(SkFilterMode::kLinear));
+
+        SkJpegEncoder::Options options;
+        options.fQuality = 90;
+        SkDynamicMemoryWStream stream;
+        SkAssertResult(SkJpegEncoder::Encode(&stream, photo.pixmap(), options));
+        sk_sp<SkData> data = stream.detachAsData();
+
+        for (auto& image : fImages) {
+            image = SkImage::MakeFromEncoded(data);
+            SkASSERT(image);
+        }
+        fSurface = SkSurface::MakeRasterN32Premul(800, 600);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas* canvas = fSurface->getCanvas();
+        while (loops-- > 0) {
+            SkGraphics::PurgeResourceCache();
+            for (int i = 0; i < kImageCount; ++i) {
+                const sk_sp<SkImage>& image = fImages[i];
+                canvas->drawImageRect(image, SkRect::Make(image->bounds()),
+                                      SkRect::MakeXYWH((i % 4) * 200, (i / 4) * 150, 200, 150),
+                                      SkSamplingOptions(SkFilterMode::kLinear), nullptr,
+                                      fConstraint);
+            }
+        }
+    }
+
+    void getExtraStats(SkTArray<SkString>* keys, SkTArray<double>* values) override {
+        // What the last pass over the gallery left in the resource cache.
+        keys->push_back(SkString("resource_cache_bytes"));
+        values->push_back(SkGraphics::GetResourceCacheTotalBytesUsed());
+    }
+
+private:
+    static constexpr int kImageCount = 16;
+
+    const SkCanvas::SrcRectConstraint fConstraint;
+    sk_sp<SkImage>                    fImages[kImageCount];
+    sk_sp<SkSurface>                  fSurface;
+};
+
+DEF_BENCH(return new DownscaledGalleryBench(SkCanvas::kFast_SrcRectConstraint));
+DEF_BENCH(return new DownscaledGalleryBench(SkCanvas::kStrict_SrcRectConstraint));
@@ -7,6 +7,9 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkStream.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
@@ -123,3 +126,56 @@ DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 3), "PNG_3n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 1), "PNG_1n"));
 
 #undef PNG
+
+// Encodes a 4K screenshot-sized image as PNG serially, or with SkPngEncoder::Options::fExecutor
+// set to a pool of the given number of threads, to show how strip-parallel deflate scales.
+class PngParallelEncodeBench : public Benchmark {
+public:
+    PngParallelEncodeBench(int zlibLevel, int threads) : fZLibLevel(zlibLevel), fThreads(threads) {
+        if (threads > 0) {
+            fName.printf("Encode_png_4k_%d_%dthreads", zlibLevel, threads);
+        } else {
+            fName.printf("Encode_png_4k_%d_serial", zlibLevel);
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkBitmap mandrill;
+        SkAssertResult(GetResourceAsBitmap("images/mandrill_1600.png", &mandrill));
+        fBitmap.allocN32Pixels(3840, 2160, /*isOpaque=*/true);
+        SkCanvas(fBitmap).drawImageRect(mandrill.asImage(), SkRect::MakeWH(3840, 2160),
+                                        SkSamplingOptions(SkFilterMode::kLinear));
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPngEncoder::Options opts;
+        opts.fZLibLevel = fZLibLevel;
+        opts.fExecutor = fExecutor.get();
+        while (loops-- > 0) {
+            SkNullWStream dst;
+            SkAssertResult(SkPngEncoder::Encode(&dst, fBitmap.pixmap(), opts));
+        }
+    }
+
+private:
+    const int                   fZLibLevel;
+    const int                   fThreads;
+    SkString                    fName;
+    SkBitmap                    fBitmap;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH(return new PngParallelEncodeBench(6, 0));
+DEF_BENCH(return new PngParallelEncodeBench(6, 1));
+DEF_BENCH(return new PngParallelEncodeBench(6, 2));
+DEF_BENCH(return new PngParallelEncodeBench(6, 4));
+DEF_BENCH(return new PngParallelEncodeBench(6, 8));
+DEF_BENCH(return new PngParallelEncodeBench(1, 0));
+DEF_BENCH(return new PngParallelEncodeBench(1, 4));
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkString.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <atomic>
+
+// Measures executor overhead and queue contention by pushing lots of tiny tasks through a pool.
+// "batch" adds them all at once from the bench thread via SkTaskGroup::batch(); "spawn" has
+// every task add its children from inside the pool, the pattern that hammers a shared queue.
+class ExecutorBench : public Benchmark {
+public:
+    enum class Pool { kFIFO, kLIFO, kWorkStealing };
+    enum class Mode { kBatch, kSpawn };
+
+    ExecutorBench(Pool pool, Mode mode, int threads) : fPool(pool), fMode(mode), fThreads(threads) {
+        static const char* kPoolNames[] = { "fifo", "lifo", "workstealing" };
+        fName.printf("executor_%s_%s_%dthreads", kPoolNames[(int)pool],
+                     mode == Mode::kBatch ? "batch" : "spawn", threads);
+    }
+
+private:
+    static constexpr int kTasks = 10000;
+
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        switch (fPool) {
+            case Pool::kFIFO:         fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);   break;
+            case Pool::kLIFO:         fExecutor = SkExecutor::MakeLIFOThreadPool(fThreads);   break;
+            case Pool::kWorkStealing: fExecutor = SkExecutor::MakeWorkStealingPool(fThreads); break;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int loop = 0; loop < loops; loop++) {
+            std::atomic<int> sink{0};
+            SkTaskGroup tg(*fExecutor);
+            if (fMode == Mode::kBatch) {
+                tg.batch(kTasks, [&](int i) { sink.fetch_add(i, std::memory_order_relaxed); });
+            } else {
+                // 100 tasks, each adding 99 more from inside the pool.
+                for (int i = 0; i < kTasks / 100; i++) {
+                    tg.add([&] {
+                        for (int j = 1; j < 100; j++) {
+                            tg.add([&sink, j] { sink.fetch_add(j, std::memory_order_relaxed); });
+                        }
+                    });
+                }
+            }
+            tg.wait();
+        }
+    }
+
+    Pool                        fPool;
+    Mode                        fMode;
+    int                         fThreads;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+#define DEF_EXECUTOR_BENCHES(pool)                                                              \
+    DEF_BENCH( return new ExecutorBench(ExecutorBench::Pool::pool,                              \
+                                        ExecutorBench::Mode::kBatch, 4); )                      \
+    DEF_BENCH( return new ExecutorBench(ExecutorBench::Pool::pool,                              \
+                                        ExecutorBench::Mode::kSpawn, 4); )                      \
+    DEF_BENCH( return new ExecutorBench(ExecutorBench::Pool::pool,                              \
+                                        ExecutorBench::Mode::kSpawn, 8); )
+
+DEF_EXECUTOR_BENCHES(kFIFO)
+DEF_EXECUTOR_BENCHES(kLIFO)
+DEF_EXECUTOR_BENCHES(kWorkStealing)
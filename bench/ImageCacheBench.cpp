@@ -6,7 +6,10 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkString.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkTaskGroup.h"
 
 namespace {
 static void* gGlobalAddress;
@@ -75,3 +78,61 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ImageCacheBench(); )
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Looks up keys in the global cache from several threads at once, the way raster threads hit it
+// for bitmaps, mipmaps and blurred masks.
+class ImageCacheMTBench : public Benchmark {
+    enum {
+        CACHE_COUNT = 500,
+        FINDS_PER_LOOP = 100,
+    };
+
+    // Keep clear of the keys any other bench or test might have left in the global cache.
+    static constexpr intptr_t kKeyBase = 1 << 20;
+
+public:
+    explicit ImageCacheMTBench(int threads) : fThreads(threads) {
+        fName.printf("imagecache_mt_%dthreads", threads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        for (int i = 0; i < CACHE_COUNT; ++i) {
+            SkResourceCache::Add(new TestRec(TestKey(kKeyBase + i), i));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkTaskGroup tg(*fExecutor);
+        tg.batch(fThreads, [loops](int thread) {
+            for (int i = 0; i < loops; ++i) {
+                for (int j = 0; j < FINDS_PER_LOOP; ++j) {
+                    intptr_t value = (thread * 7919 + i * FINDS_PER_LOOP + j) % CACHE_COUNT;
+                    SkResourceCache::Find(TestKey(kKeyBase + value), TestRec::Visitor, nullptr);
+                }
+            }
+        });
+        tg.wait();
+    }
+
+private:
+    int                         fThreads;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new ImageCacheMTBench(1); )
+DEF_BENCH( return new ImageCacheMTBench(2); )
+DEF_BENCH( return new ImageCacheMTBench(4); )
+DEF_BENCH( return new ImageCacheMTBench(8); )
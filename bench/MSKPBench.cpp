@@ -7,8 +7,11 @@
 
 #include "bench/MSKPBench.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkStream.h"
 #include "include/gpu/GrDirectContext.h"
 #include "include/gpu/GrRecordingContext.h"
+#include "src/utils/SkMultiPictureDocument.h"
 #include "tools/MSKPPlayer.h"
 
 MSKPBench::MSKPBench(SkString name, std::unique_ptr<MSKPPlayer> player)
@@ -48,3 +51,40 @@ void MSKPBench::onPostDraw(SkCanvas*) {
     // nanobench can tear down the 3D API context/device before destroying the benchmarks.
     fPlayer->resetLayers();
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+MSKPSeekBench::MSKPSeekBench(SkString name, SkString path, Mode mode)
+        : fPath(std::move(path)), fMode(mode) {
+    fName.printf("%s_%s", name.c_str(), mode == Mode::kOpen ? "open" : "seek");
+}
+
+MSKPSeekBench::~MSKPSeekBench() = default;
+
+const char* MSKPSeekBench::onGetName() { return fName.c_str(); }
+
+void MSKPSeekBench::onDelayedSetup() {
+    if (fMode == Mode::kSeek) {
+        fReader = SkMultiPictureDocumentReader::Make(SkStream::MakeFromFile(fPath.c_str()));
+    }
+}
+
+void MSKPSeekBench::onDraw(int loops, SkCanvas*) {
+    for (int i = 0; i < loops; ++i) {
+        if (fMode == Mode::kOpen) {
+            auto reader = SkMultiPictureDocumentReader::Make(SkStream::MakeFromFile(fPath.c_str()));
+            if (!reader) {
+                SkDebugf("Could not open %s.\n", fPath.c_str());
+                return;
+            }
+        } else if (fReader && fReader->pageCount() > 0) {
+            // A cheap LCG picks frames all over the file without depending on their order.
+            fSeed = fSeed * 1664525 + 1013904223;
+            sk_sp<SkPicture> frame = fReader->readPage((fSeed >> 8) % fReader->pageCount());
+            if (!frame) {
+                SkDebugf("Could not read a frame of %s.\n", fPath.c_str());
+                return;
+            }
+        }
+    }
+}
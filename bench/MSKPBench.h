@@ -11,6 +11,7 @@
 #include "bench/Benchmark.h"
 
 class MSKPPlayer;
+class SkMultiPictureDocumentReader;
 
 class MSKPBench : public Benchmark {
 public:
@@ -29,4 +30,29 @@ private:
     std::unique_ptr<MSKPPlayer> fPlayer;
 };
 
+/**
+ * Measures random access into a MSKP through SkMultiPictureDocumentReader: either how long it takes
+ * to open the file, or how long it takes to seek to and decode a random frame once it's open.
+ */
+class MSKPSeekBench : public Benchmark {
+public:
+    enum class Mode { kOpen, kSeek };
+
+    MSKPSeekBench(SkString name, SkString path, Mode);
+    ~MSKPSeekBench() override;
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    void onDelayedSetup() override;
+    void onDraw(int loops, SkCanvas*) override;
+    const char* onGetName() override;
+
+private:
+    SkString fName;
+    SkString fPath;
+    Mode     fMode;
+    uint32_t fSeed = 0;
+    std::unique_ptr<SkMultiPictureDocumentReader> fReader;
+};
+
 #endif
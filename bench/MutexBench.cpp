@@ -59,9 +59,16 @@ private:
     SkSharedMutex fMu;
 };
 
+// A named SkMutex, which becomes a record/replay ordered lock when that runtime is present.
+class OrderedSkMutex : public SkMutex {
+public:
+    OrderedSkMutex() : SkMutex("MutexBench") {}
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new MutexBench<SkSharedMutex>(SkString("SkSharedMutex")); )
 DEF_BENCH( return new MutexBench<SkMutex>(SkString("SkMutex")); )
+DEF_BENCH( return new MutexBench<OrderedSkMutex>(SkString("SkMutexOrdered")); )
 DEF_BENCH( return new MutexBench<SkSpinlock>(SkString("SkSpinlock")); )
 DEF_BENCH( return new SharedBench; )
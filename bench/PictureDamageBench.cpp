@@ -0,0 +1,162 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkM44.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkRegion.h"
+#include "include/core/SkString.h"
+#include "include/core/SkSurface.h"
+#include "include/private/SkTArray.h"
+#include "src/core/SkRecordDiff.h"
+
+#include <vector>
+
+// Plays back a synthetic animation: a static grid of tiles with a ball bouncing across it and a
+// spinning clock hand in one corner.  Each frame is a freshly recorded picture, like a UI toolkit
+// would produce.  The _full variant rasterizes every frame from scratch; the _damage variant
+// diffs each frame against the last and re-rasterizes only the damaged region.
+//
+// The _damage variant also reports how many pixels it rasterizes compared to how many actually
+// change, which is how much work damage tracking leaves on the table.
+class PictureDamageBench : public Benchmark {
+public:
+    explicit PictureDamageBench(bool damage) : fDamage(damage) {
+        fName.printf("picture_damage_%s", damage ? "damage" : "full");
+    }
+
+private:
+    static constexpr int kW = 1024, kH = 768, kFrames = 60, kTile = 32;
+
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void getExtraStats(SkTArray<SkString>* keys, SkTArray<double>* values) override {
+        if (!fDamage) {
+            return;
+        }
+        keys->push_back(SkString("rasterized_pixels_per_frame"));
+        values->push_back(fRasterized / (double)kFrames);
+        keys->push_back(SkString("changed_pixels_per_frame"));
+        values->push_back(fChanged / (double)kFrames);
+        keys->push_back(SkString("rasterized_per_changed_pixel"));
+        values->push_back(fChanged ? fRasterized / (double)fChanged : 0.0);
+        keys->push_back(SkString("rasterized_percent_of_full"));
+        values->push_back(100.0 * fRasterized / ((double)kW * kH * kFrames));
+    }
+
+    static sk_sp<SkPicture> RecordFrame(int frame) {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(kW, kH));
+
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int y = 0; y < kH / kTile; y++)
+        for (int x = 0; x < kW / kTile; x++) {
+            paint.setColor(0xff000000 | (x * 8) << 16 | (y * 10) << 8 | 0x80);
+            canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(x * kTile + 2, y * kTile + 2,
+                                                                   kTile - 4, kTile - 4), 4, 4),
+                              paint);
+        }
+
+        // The ball bounces along a parabola.
+        const float t = frame / (float)kFrames;
+        paint.setColor(SK_ColorRED);
+        canvas->drawCircle(64 + t * (kW - 128), kH - 64 - 4 * t * (1 - t) * (kH - 128), 24, paint);
+
+        // The clock hand sweeps once per animation, inside a clipped dial.
+        canvas->save();
+            canvas->clipRect(SkRect::MakeXYWH(kW - 96, 0, 96, 96));
+            canvas->translate(kW - 48, 48);
+            canvas->rotate(360 * t);
+            SkPath hand;
+            hand.moveTo(-3, 0);
+            hand.lineTo(0, -40);
+            hand.lineTo(3, 0);
+            hand.close();
+            paint.setColor(SK_ColorBLACK);
+            canvas->drawPath(hand, paint);
+        canvas->restore();
+
+        return recorder.finishRecordingAsPicture();
+    }
+
+    static int64_t Area(const SkRegion& region) {
+        int64_t area = 0;
+        for (SkRegion::Iterator iter(region); !iter.done(); iter.next()) {
+            area += (int64_t)iter.rect().width() * iter.rect().height();
+        }
+        return area;
+    }
+
+    void onDelayedSetup() override {
+        for (int i = 0; i < kFrames; i++) {
+            fFrames.push_back(RecordFrame(i));
+        }
+        fSurface = SkSurface::MakeRasterN32Premul(kW, kH);
+        fSurface->getCanvas()->drawPicture(fFrames.back());
+
+        if (fDamage) {
+            // Compare each frame's pixels with the last frame's to count what really changed.
+            auto render = [](const SkPicture& picture) {
+                SkBitmap bm;
+                bm.allocN32Pixels(kW, kH);
+                bm.eraseColor(SK_ColorTRANSPARENT);
+                SkCanvas(bm).drawPicture(&picture);
+                return bm;
+            };
+            fRasterized = fChanged = 0;
+            SkBitmap prev = render(*fFrames.back());
+            for (int i = 0; i < kFrames; i++) {
+                SkRegion damage;
+                SkPictureComputeDamage(SkM44(), *fFrames[(i + kFrames - 1) % kFrames], *fFrames[i],
+                                       &damage);
+                fRasterized += Area(damage);
+
+                SkBitmap next = render(*fFrames[i]);
+                for (int y = 0; y < kH; y++)
+                for (int x = 0; x < kW; x++) {
+                    fChanged += *prev.getAddr32(x, y) != *next.getAddr32(x, y);
+                }
+                prev = next;
+            }
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas* canvas = fSurface->getCanvas();
+        for (int i = 0; i < loops; i++) {
+            const SkPicture& prev = *fFrames[fFrame];
+            fFrame = (fFrame + 1) % kFrames;
+            const SkPicture& next = *fFrames[fFrame];
+
+            if (fDamage) {
+                SkRegion damage;
+                SkPictureComputeDamage(SkM44(), prev, next, &damage);
+                SkPictureDrawDamage(next, SkM44(), damage, canvas);
+            } else {
+                canvas->clear(SK_ColorTRANSPARENT);
+                canvas->drawPicture(&next);
+            }
+        }
+    }
+
+    bool                          fDamage;
+    SkString                      fName;
+    std::vector<sk_sp<SkPicture>> fFrames;
+    sk_sp<SkSurface>              fSurface;  // Always holds fFrames[fFrame].
+    int                           fFrame = kFrames - 1;
+    int64_t                       fRasterized = 0;  // Pixels rasterized over the animation,
+    int64_t                       fChanged    = 0;  // and how many of those really changed.
+};
+
+DEF_BENCH( return new PictureDamageBench(false); )
+DEF_BENCH( return new PictureDamageBench(true); )
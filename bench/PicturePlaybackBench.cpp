@@ -9,7 +9,9 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkData.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPoint.h"
@@ -97,3 +99,62 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+
+// Measures deserializing a picture full of paths, eagerly with SkPicture::MakeFromData(), or
+// deferred with SkPicture::MakeFromDataDeferred(), optionally followed by the first playback,
+// which is when a deferred picture does its decoding.  nanobench reports RSS alongside timing.
+class PictureLoadBench : public Benchmark {
+public:
+    PictureLoadBench(bool deferred, bool draw) : fDeferred(deferred), fDraw(draw) {
+        fName.printf("picture_load_%s%s", deferred ? "deferred" : "eager", draw ? "_draw" : "");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return fDraw ? backend != kNonRendering_Backend : backend == kNonRendering_Backend;
+    }
+
+private:
+    const char* onGetName() override { return fName.c_str(); }
+    SkIPoint onGetSize() override { return SkIPoint::Make(1024,1024); }
+
+    void onDelayedSetup() override {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(1024, 1024);
+            SkRandom rand;
+            for (int i = 0; i < 20000; i++) {
+                SkPath path;
+                path.moveTo(rand.nextRangeScalar(0, 1024), rand.nextRangeScalar(0, 1024));
+                for (int j = 0; j < 4; j++) {
+                    path.cubicTo(rand.nextRangeScalar(0, 1024), rand.nextRangeScalar(0, 1024),
+                                 rand.nextRangeScalar(0, 1024), rand.nextRangeScalar(0, 1024),
+                                 rand.nextRangeScalar(0, 1024), rand.nextRangeScalar(0, 1024));
+                }
+                SkPaint paint;
+                paint.setColor(rand.nextU());
+                paint.setStrokeWidth(rand.nextRangeScalar(0, 4));
+                paint.setStroke(rand.nextBool());
+                canvas->drawPath(path, paint);
+            }
+        fData = recorder.finishRecordingAsPicture()->serialize();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            sk_sp<SkPicture> pic = fDeferred ? SkPicture::MakeFromDataDeferred(fData)
+                                             : SkPicture::MakeFromData(fData.get());
+            if (fDraw) {
+                canvas->drawPicture(pic);
+            }
+        }
+    }
+
+    bool          fDeferred;
+    bool          fDraw;
+    SkString      fName;
+    sk_sp<SkData> fData;
+};
+
+DEF_BENCH( return new PictureLoadBench(false, false); )
+DEF_BENCH( return new PictureLoadBench(true,  false); )
+DEF_BENCH( return new PictureLoadBench(false, true ); )
+DEF_BENCH( return new PictureLoadBench(true,  true ); )
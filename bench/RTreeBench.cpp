@@ -7,6 +7,7 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkString.h"
 #include "include/private/SkTemplates.h"
 #include "include/utils/SkRandom.h"
@@ -17,14 +18,23 @@ static const SkScalar GENERATE_EXTENTS = 1000.0f;
 static const int NUM_BUILD_RECTS = 500;
 static const int NUM_QUERY_RECTS = 5000;
 static const int GRID_WIDTH = 100;
+// Big enough that SkRTree takes its parallel STR path when given an executor.
+static const int NUM_LARGE_RECTS = 1000000;
 
 typedef SkRect (*MakeRectProc)(SkRandom&, int, int);
 
 // Time how long it takes to build an R-Tree.
 class RTreeBuildBench : public Benchmark {
 public:
-    RTreeBuildBench(const char* name, MakeRectProc proc) : fProc(proc) {
+    RTreeBuildBench(const char* name, MakeRectProc proc, int count = NUM_BUILD_RECTS,
+                    bool parallel = false)
+            : fProc(proc)
+            , fCount(count)
+            , fParallel(parallel) {
         fName.printf("rtree_%s_build", name);
+        if (count != NUM_BUILD_RECTS) {
+            fName.appendf("_%d%s", count, parallel ? "_parallel" : "");
+        }
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -35,21 +45,29 @@ protected:
     const char* onGetName() override {
         return fName.c_str();
     }
+    void onDelayedSetup() override {
+        if (fParallel) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
     void onDraw(int loops, SkCanvas* canvas) override {
         SkRandom rand;
-        SkAutoTMalloc<SkRect> rects(NUM_BUILD_RECTS);
-        for (int i = 0; i < NUM_BUILD_RECTS; ++i) {
-            rects[i] = fProc(rand, i, NUM_BUILD_RECTS);
+        SkAutoTMalloc<SkRect> rects(fCount);
+        for (int i = 0; i < fCount; ++i) {
+            rects[i] = fProc(rand, i, fCount);
         }
 
         for (int i = 0; i < loops; ++i) {
-            SkRTree tree;
-            tree.insert(rects.get(), NUM_BUILD_RECTS);
+            SkRTree tree(fExecutor.get());
+            tree.insert(rects.get(), fCount);
             SkASSERT(rects != nullptr);  // It'd break this bench if the tree took ownership of rects.
         }
     }
 private:
     MakeRectProc fProc;
+    int fCount;
+    bool fParallel;
+    std::unique_ptr<SkExecutor> fExecutor;
     SkString fName;
     using INHERITED = Benchmark;
 };
@@ -57,8 +75,15 @@ private:
 // Time how long it takes to perform queries on an R-Tree.
 class RTreeQueryBench : public Benchmark {
 public:
-    RTreeQueryBench(const char* name, MakeRectProc proc) : fProc(proc) {
+    RTreeQueryBench(const char* name, MakeRectProc proc, int count = NUM_QUERY_RECTS,
+                    bool parallel = false)
+            : fProc(proc)
+            , fCount(count)
+            , fParallel(parallel) {
         fName.printf("rtree_%s_query", name);
+        if (count != NUM_QUERY_RECTS) {
+            fName.appendf("_%d%s", count, parallel ? "_parallel" : "");
+        }
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -69,12 +94,18 @@ protected:
         return fName.c_str();
     }
     void onDelayedSetup() override {
+        std::unique_ptr<SkExecutor> executor;
+        if (fParallel) {
+            executor = SkExecutor::MakeFIFOThreadPool();
+        }
+        fTree = sk_make_sp<SkRTree>(executor.get());
+
         SkRandom rand;
-        SkAutoTMalloc<SkRect> rects(NUM_QUERY_RECTS);
-        for (int i = 0; i < NUM_QUERY_RECTS; ++i) {
-            rects[i] = fProc(rand, i, NUM_QUERY_RECTS);
+        SkAutoTMalloc<SkRect> rects(fCount);
+        for (int i = 0; i < fCount; ++i) {
+            rects[i] = fProc(rand, i, fCount);
         }
-        fTree.insert(rects.get(), NUM_QUERY_RECTS);
+        fTree->insert(rects.get(), fCount);
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
@@ -86,12 +117,14 @@ protected:
             query.fTop    = rand.nextRangeF(0, GENERATE_EXTENTS);
             query.fRight  = query.fLeft + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
             query.fBottom = query.fTop  + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
-            fTree.search(query, &hits);
+            fTree->search(query, &hits);
         }
     }
 private:
-    SkRTree fTree;
+    sk_sp<SkRTree> fTree;
     MakeRectProc fProc;
+    int fCount;
+    bool fParallel;
     SkString fName;
     using INHERITED = Benchmark;
 };
@@ -122,6 +155,16 @@ static inline SkRect make_random_rects(SkRandom& rand, int index, int numRects)
     return out;
 }
 
+// Like make_random_rects(), but small enough that a million of them don't all overlap each other.
+static inline SkRect make_small_random_rects(SkRandom& rand, int index, int numRects) {
+    SkRect out;
+    out.fLeft   = rand.nextRangeF(0, GENERATE_EXTENTS);
+    out.fTop    = rand.nextRangeF(0, GENERATE_EXTENTS);
+    out.fRight  = out.fLeft + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/500);
+    out.fBottom = out.fTop  + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/500);
+    return out;
+}
+
 static inline SkRect make_concentric_rects(SkRandom&, int index, int numRects) {
     return SkRect::MakeWH(SkIntToScalar(index+1), SkIntToScalar(index+1));
 }
@@ -137,3 +180,8 @@ DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects));
 DEF_BENCH(return new RTreeQueryBench("YX", &make_YXordered_rects));
 DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects));
 DEF_BENCH(return new RTreeQueryBench("concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeBuildBench("small", &make_small_random_rects, NUM_LARGE_RECTS));
+DEF_BENCH(return new RTreeBuildBench("small", &make_small_random_rects, NUM_LARGE_RECTS, true));
+DEF_BENCH(return new RTreeQueryBench("small", &make_small_random_rects, NUM_LARGE_RECTS));
+DEF_BENCH(return new RTreeQueryBench("small", &make_small_random_rects, NUM_LARGE_RECTS, true));
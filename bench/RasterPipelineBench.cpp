@@ -0,0 +1,131 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkString.h"
+#include "include/core/SkSurface.h"
+#include "include/effects/SkGradientShader.h"
+#include "src/core/SkRasterPipeline.h"
+
+// These measure SkRasterPipeline stages through whichever SkOpts tier the CPU selects, so the
+// same bench compares e.g. the HSW and SKX stages when run on different machines.
+// kWidth is deliberately not a multiple of any stride, so every row also runs a tail.
+static constexpr int kWidth  = 1000,
+                     kHeight = 64;
+
+// Blits a row of pixels with srcover. 8888 runs in lowp; F16 has no lowp stages, so runs in highp.
+class RasterPipelineBlitBench : public Benchmark {
+public:
+    explicit RasterPipelineBlitBench(bool f16) : fF16(f16) {
+        fName.printf("SkRasterPipeline_blit_%s", f16 ? "f16_highp" : "8888_lowp");
+    }
+
+private:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDraw(int loops, SkCanvas*) override {
+        uint64_t src[kWidth], dst[kWidth];
+        for (int i = 0; i < kWidth; i++) {
+            src[i] = fF16 ? 0x3800380038003800ull : 0x80808080;
+            dst[i] = fF16 ? 0x3c00000000003c00ull : 0xff0000ff;
+        }
+
+        SkRasterPipeline_MemoryCtx src_ctx = { src, 0 },
+                                   dst_ctx = { dst, 0 };
+
+        const SkColorType ct = fF16 ? kRGBA_F16_SkColorType : kRGBA_8888_SkColorType;
+        SkRasterPipeline_<256> p;
+        p.append_load    (ct, &src_ctx);
+        p.append_load_dst(ct, &dst_ctx);
+        p.append(SkRasterPipeline::srcover);
+        p.append_store   (ct, &dst_ctx);
+
+        auto fn = p.compile();
+        for (int i = 0; i < loops; i++) {
+            fn(0,0, kWidth,1);
+        }
+    }
+
+    bool     fF16;
+    SkString fName;
+};
+
+// Fills a raster surface through a gradient or image shader, which goes through
+// SkRasterPipelineBlitter just like a real draw would.
+class RasterPipelineShaderBench : public Benchmark {
+public:
+    enum class Kind { kLinear2, kLinear6, kImageNearest, kImageLinear };
+
+    explicit RasterPipelineShaderBench(Kind kind) : fKind(kind) {
+        switch (kind) {
+            case Kind::kLinear2:      fName = "SkRasterPipeline_gradient_2stop"; break;
+            case Kind::kLinear6:      fName = "SkRasterPipeline_gradient_6stop"; break;
+            case Kind::kImageNearest: fName = "SkRasterPipeline_image_nearest";  break;
+            case Kind::kImageLinear:  fName = "SkRasterPipeline_image_linear";   break;
+        }
+    }
+
+private:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        fSurface = SkSurface::MakeRasterN32Premul(kWidth, kHeight);
+
+        const SkPoint pts[] = {{0, 0}, {kWidth, kHeight}};
+        const SkColor colors[] = { SK_ColorRED,  SK_ColorGREEN,   SK_ColorBLUE,
+                                   SK_ColorCYAN, SK_ColorMAGENTA, SK_ColorYELLOW };
+        switch (fKind) {
+            case Kind::kLinear2:
+            case Kind::kLinear6: {
+                int count = fKind == Kind::kLinear2 ? 2 : 6;
+                fPaint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, count,
+                                                              SkTileMode::kClamp));
+                break;
+            }
+            case Kind::kImageNearest:
+            case Kind::kImageLinear: {
+                sk_sp<SkSurface> src = SkSurface::MakeRasterN32Premul(256, 256);
+                SkPaint gradient;
+                gradient.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 6,
+                                                                SkTileMode::kMirror));
+                src->getCanvas()->drawPaint(gradient);
+                SkSamplingOptions sampling(fKind == Kind::kImageNearest ? SkFilterMode::kNearest
+                                                                        : SkFilterMode::kLinear);
+                // A rotation and non-integer scale keeps the blitter off its sprite fast paths.
+                SkMatrix m = SkMatrix::RotateDeg(15);
+                m.preScale(1.3f, 1.3f);
+                fPaint.setShader(src->makeImageSnapshot()->makeShader(
+                        SkTileMode::kRepeat, SkTileMode::kRepeat, sampling, &m));
+                break;
+            }
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas* canvas = fSurface->getCanvas();
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPaint(fPaint);
+        }
+    }
+
+    Kind             fKind;
+    SkString         fName;
+    SkPaint          fPaint;
+    sk_sp<SkSurface> fSurface;
+};
+
+DEF_BENCH( return new RasterPipelineBlitBench(false); )
+DEF_BENCH( return new RasterPipelineBlitBench(true); )
+DEF_BENCH( return new RasterPipelineShaderBench(RasterPipelineShaderBench::Kind::kLinear2); )
+DEF_BENCH( return new RasterPipelineShaderBench(RasterPipelineShaderBench::Kind::kLinear6); )
+DEF_BENCH( return new RasterPipelineShaderBench(RasterPipelineShaderBench::Kind::kImageNearest); )
+DEF_BENCH( return new RasterPipelineShaderBench(RasterPipelineShaderBench::Kind::kImageLinear); )
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkString.h"
+#include "src/core/SkRecordReplay.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+// Per-call cost of a hot path assertion, with the record/replay runtime stubbed out.
+//   string: SkRecordReplayAssert, varargs into a runtime that formats the message.
+//   binary: SkRecordReplayAssertValues, values into a per-thread stream of batches.
+//   off:    SkRecordReplayAssertValues when not recording or replaying.
+namespace {
+
+enum class Mode { kString, kBinary, kOff };
+
+// Stand in for the runtime: formatting the message is the least it has to do with it.
+void stub_runtime_assert(const char* format, va_list args) {
+    char buffer[256];
+    vsnprintf(buffer, sizeof(buffer), format, args);
+}
+
+size_t gStubBytes;
+void stub_runtime_assert_bytes(const char*, const void*, size_t bytes) { gStubBytes += bytes; }
+
+class RecordReplayAssertBench : public Benchmark {
+public:
+    explicit RecordReplayAssertBench(Mode mode) : fMode(mode) {
+        const char* names[] = {"string", "binary", "off"};
+        fName.printf("recordreplay_assert_%s", names[static_cast<int>(mode)]);
+    }
+
+private:
+    static constexpr int kCallsPerLoop = 1000;
+
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (fMode != Mode::kOff) {
+            SkRecordReplaySetAssertsForTesting(stub_runtime_assert, stub_runtime_assert_bytes);
+        }
+        for (int i = 0; i < loops; i++) {
+            for (uint32_t j = 0; j < kCallsPerLoop; j++) {
+                bool found = j & 1;
+                switch (fMode) {
+                    case Mode::kString:
+                        SkRecordReplayAssert("SkScalerCache::digest %d %d", j, found);
+                        break;
+                    case Mode::kBinary:
+                    case Mode::kOff:
+                        SkRecordReplayAssertValues(SK_RECORD_REPLAY_SITE("SkScalerCache::digest"),
+                                                   j, found);
+                        break;
+                }
+            }
+        }
+        if (fMode != Mode::kOff) {
+            SkRecordReplaySetAssertsForTesting(nullptr, nullptr);
+        }
+    }
+
+    const Mode fMode;
+    SkString   fName;
+};
+
+}  // namespace
+
+DEF_BENCH( return new RecordReplayAssertBench(Mode::kString); )
+DEF_BENCH( return new RecordReplayAssertBench(Mode::kBinary); )
+DEF_BENCH( return new RecordReplayAssertBench(Mode::kOff); )
@@ -10,6 +10,13 @@
 #include "include/core/SkBBHFactory.h"
 #include "include/core/SkData.h"
 #include "include/core/SkPictureRecorder.h"
+#include "include/core/SkSurface.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecordOpts.h"
+#include "src/core/SkRecorder.h"
+
+#include <algorithm>
 
 PictureCentricBench::PictureCentricBench(const char* name, const SkPicture* pic) : fName(name) {
     // Flatten the source picture in case it's trivially nested (useless for timing).
@@ -34,18 +41,83 @@ SkIPoint PictureCentricBench::onGetSize() {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-RecordingBench::RecordingBench(const char* name, const SkPicture* pic, bool useBBH)
+RecordingBench::RecordingBench(const char* name, const SkPicture* pic, bool useBBH,
+                               bool internContent)
     : INHERITED(name, pic)
     , fUseBBH(useBBH)
-{}
+    , fInternContent(internContent)
+{
+    if (internContent) {
+        fName.append("_interned");
+    }
+}
 
-void RecordingBench::onDraw(int loops, SkCanvas*) {
+sk_sp<SkPicture> RecordingBench::record(SkPictureRecorder* recorder) const {
     SkRTreeFactory factory;
+    fSrc->playback(recorder->beginRecording(fSrc->cullRect(),
+                                            fUseBBH ? factory() : nullptr,
+                                            fInternContent
+                                                    ? SkPictureRecorder::kInternContent_RecordFlag
+                                                    : 0));
+    return recorder->finishRecordingAsPicture();
+}
+
+size_t RecordingBench::approximateBytesUsed() const {
     SkPictureRecorder recorder;
+    return this->record(&recorder)->approximateBytesUsed();
+}
+
+void RecordingBench::onDraw(int loops, SkCanvas*) {
+    SkPictureRecorder recorder;
+    while (loops --> 0) {
+        (void)this->record(&recorder);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+RecordPlaybackBench::RecordPlaybackBench(const char* name, const SkPicture* pic, bool cullOccluded)
+    : INHERITED(name, pic)
+    , fCullOccluded(cullOccluded)
+{
+    fName.append(cullOccluded ? "_occlusion_culled" : "_unculled");
+}
+
+RecordPlaybackBench::~RecordPlaybackBench() = default;
+
+void RecordPlaybackBench::onDelayedSetup() {
+    // fSrc's record is immutable, so re-record it into one we can cull.
+    const SkRect cull = fSrc->cullRect();
+    fRecord = std::make_unique<SkRecord>();
+    SkRecorder recorder(fRecord.get(), cull);
+    fSrc->playback(&recorder);
+    fOpsBeforeCulling = fRecord->count();
+    if (fCullOccluded) {
+        SkRecordNoopOccludedDraws(fRecord.get(), &fOcclusion);
+        fRecord->defrag();
+    }
+
+    const SkIPoint size = this->getSize();
+    fSurface = SkSurface::MakeRasterN32Premul(std::max(1, size.fX), std::max(1, size.fY));
+    fSurface->getCanvas()->translate(-cull.fLeft, -cull.fTop);
+}
+
+void RecordPlaybackBench::onDraw(int loops, SkCanvas*) {
     while (loops --> 0) {
-        fSrc->playback(recorder.beginRecording(fSrc->cullRect(), fUseBBH ? &factory : nullptr));
-        (void)recorder.finishRecordingAsPicture();
+        SkRecordDraw(*fRecord, fSurface->getCanvas(), nullptr, nullptr, 0, nullptr, nullptr);
+    }
+}
+
+void RecordPlaybackBench::getExtraStats(SkTArray<SkString>* keys, SkTArray<double>* values) {
+    if (!fCullOccluded) {
+        return;
     }
+    keys->push_back(SkString("occluded_ops_culled"));
+    values->push_back(fOcclusion.fOps);
+    keys->push_back(SkString("occluded_ops_culled_percent"));
+    values->push_back(fOpsBeforeCulling ? 100.0 * fOcclusion.fOps / fOpsBeforeCulling : 0.0);
+    keys->push_back(SkString("occluded_pixels_culled"));
+    values->push_back(fOcclusion.fPixels);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
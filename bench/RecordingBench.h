@@ -10,6 +10,13 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkPicture.h"
+#include "src/core/SkRecordOpts.h"
+
+#include <memory>
+
+class SkPictureRecorder;
+class SkRecord;
+class SkSurface;
 
 class PictureCentricBench : public Benchmark {
 public:
@@ -29,13 +36,42 @@ protected:
 
 class RecordingBench : public PictureCentricBench {
 public:
-    RecordingBench(const char* name, const SkPicture*, bool useBBH);
+    RecordingBench(const char* name, const SkPicture*, bool useBBH, bool internContent = false);
+
+    // The size of the picture this bench records, for comparing recording flags.
+    size_t approximateBytesUsed() const;
 
 protected:
     void onDraw(int loops, SkCanvas*) override;
 
 private:
+    sk_sp<SkPicture> record(SkPictureRecorder*) const;
+
     bool fUseBBH;
+    bool fInternContent;
+
+    using INHERITED = PictureCentricBench;
+};
+
+// Plays back a picture's unoptimized SkRecord into a raster surface, optionally after culling
+// draws occluded by later opaque draws, to measure what SkRecordNoopOccludedDraws() saves.
+class RecordPlaybackBench : public PictureCentricBench {
+public:
+    RecordPlaybackBench(const char* name, const SkPicture*, bool cullOccluded);
+    ~RecordPlaybackBench() override;
+
+    void getExtraStats(SkTArray<SkString>* keys, SkTArray<double>* values) override;
+
+protected:
+    void onDelayedSetup() override;
+    void onDraw(int loops, SkCanvas*) override;
+
+private:
+    bool                      fCullOccluded;
+    std::unique_ptr<SkRecord> fRecord;
+    sk_sp<SkSurface>          fSurface;
+    int                       fOpsBeforeCulling = 0;
+    SkRecordOcclusionStats    fOcclusion;
 
     using INHERITED = PictureCentricBench;
 };
@@ -13,6 +13,7 @@
 #include "include/core/SkGraphics.h"
 #include "include/core/SkTypeface.h"
 #include "include/private/chromium/SkChromeRemoteGlyphCache.h"
+#include "src/core/SkGlyphBuffer.h"
 #include "src/core/SkStrikeSpec.h"
 #include "src/core/SkTLazy.h"
 #include "src/core/SkTaskGroup.h"
@@ -118,6 +119,79 @@ DEF_BENCH( return new SkGlyphCacheBasic(32 * 1024 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(32 * 1024 * 1024); )
 
+// Several threads drawing text with the same, already warm strike, as raster threads do when
+// they draw the tiles of a text heavy page. Every lookup hits, so this measures the cost of the
+// warm path itself and how much the threads get in each other's way.
+class SkGlyphCacheWarmStrikeMT : public Benchmark {
+public:
+    explicit SkGlyphCacheWarmStrikeMT(int threads) : fThreads(threads) {
+        fName.printf("SkGlyphCacheWarmStrikeMT_%dthreads", threads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        SkFont font;
+        font.setEdging(SkFont::Edging::kAntiAlias);
+        font.setSubpixel(true);
+        font.setTypeface(ToolUtils::create_portable_typeface("serif", SkFontStyle::Italic()));
+
+        for (int c = ' '; c < 'z'; c++) {
+            fGlyphs[c - ' '] = font.unicharToGlyph(c);
+            fPositions[c - ' '] = {10.0f * (c - ' '), 20.0f};
+        }
+
+        SkPaint defaultPaint;
+        SkStrikeSpec strikeSpec = SkStrikeSpec::MakeMask(
+                font, defaultPaint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                SkScalerContextFlags::kNone, SkMatrix::I());
+        fScalerCache = std::make_unique<SkScalerCache>(strikeSpec.createScalerContext());
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+
+        // Warm up the strike so that every lookup in onDraw is a hit.
+        this->drawLine();
+    }
+
+    void drawLine() {
+        SkDrawableGlyphBuffer accepted;
+        SkSourceGlyphBuffer rejected;
+        accepted.ensureSize(kGlyphCount);
+        rejected.setSource(SkMakeZip(fGlyphs, fPositions));
+        accepted.startDevicePositioning(
+                rejected.source(), SkMatrix::I(), fScalerCache->roundingSpec());
+        fScalerCache->prepareForDrawingMasksCPU(&accepted);
+        accepted.reset();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkTaskGroup(*fExecutor).batch(fThreads, [&](int) {
+            for (int i = 0; i < loops; i++) {
+                this->drawLine();
+            }
+        });
+    }
+
+private:
+    static constexpr int kGlyphCount = 'z' - ' ';
+
+    const int                      fThreads;
+    SkString                       fName;
+    SkGlyphID                      fGlyphs[kGlyphCount];
+    SkPoint                        fPositions[kGlyphCount];
+    std::unique_ptr<SkScalerCache> fScalerCache;
+    std::unique_ptr<SkExecutor>    fExecutor;
+};
+
+DEF_BENCH( return new SkGlyphCacheWarmStrikeMT(1); )
+DEF_BENCH( return new SkGlyphCacheWarmStrikeMT(2); )
+DEF_BENCH( return new SkGlyphCacheWarmStrikeMT(4); )
+DEF_BENCH( return new SkGlyphCacheWarmStrikeMT(8); )
+
 namespace {
 class DiscardableManager : public SkStrikeServer::DiscardableHandleManager,
                            public SkStrikeClient::DiscardableHandleManager {
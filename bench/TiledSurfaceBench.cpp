@@ -0,0 +1,85 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkString.h"
+#include "include/core/SkSurface.h"
+#include "include/effects/SkGradientShader.h"
+#include "include/utils/SkRandom.h"
+
+// Draws a full-page-like workload into a large raster surface and snapshots it.
+// threads == 0 measures a plain SkSurface::MakeRaster() surface as the serial baseline;
+// otherwise an SkSurface::MakeRasterTiled() surface on a pool of that many threads.
+class TiledSurfaceBench : public Benchmark {
+public:
+    explicit TiledSurfaceBench(int threads) : fThreads(threads) {
+        if (threads == 0) {
+            fName = "tiled_surface_serial";
+        } else {
+            fName.printf("tiled_surface_%dthreads", threads);
+        }
+    }
+
+private:
+    static constexpr int kSize = 4096;
+
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    static void DrawPage(SkCanvas* canvas) {
+        SkRandom rand;
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        const SkPoint pts[] = {{0, 0}, {kSize, kSize}};
+        const SkColor colors[] = {SK_ColorWHITE, 0xFFDDEEFF};
+        paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2, SkTileMode::kClamp));
+        canvas->drawPaint(paint);
+        paint.setShader(nullptr);
+
+        for (int i = 0; i < 4000; i++) {
+            paint.setColor(rand.nextU() | 0x80000000);
+            SkRect r = SkRect::MakeXYWH(rand.nextRangeF(0, kSize), rand.nextRangeF(0, kSize),
+                                        rand.nextRangeF(10, 300), rand.nextRangeF(10, 300));
+            switch (i % 3) {
+                case 0: canvas->drawRRect(SkRRect::MakeRectXY(r, 9, 9), paint); break;
+                case 1: canvas->drawOval(r, paint); break;
+                case 2: canvas->drawPath(SkPath::Circle(r.centerX(), r.centerY(), r.width()/2),
+                                         paint); break;
+            }
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkImageInfo info = SkImageInfo::MakeN32Premul(kSize, kSize);
+        for (int i = 0; i < loops; i++) {
+            sk_sp<SkSurface> surface = fExecutor ? SkSurface::MakeRasterTiled(info, fExecutor.get())
+                                                 : SkSurface::MakeRaster(info);
+            DrawPage(surface->getCanvas());
+            (void)surface->makeImageSnapshot();
+        }
+    }
+
+    int                         fThreads;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH( return new TiledSurfaceBench(0); )
+DEF_BENCH( return new TiledSurfaceBench(1); )
+DEF_BENCH( return new TiledSurfaceBench(2); )
+DEF_BENCH( return new TiledSurfaceBench(4); )
+DEF_BENCH( return new TiledSurfaceBench(8); )
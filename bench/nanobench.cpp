@@ -13,6 +13,7 @@
 #include "bench/Benchmark.h"
 #include "bench/CodecBench.h"
 #include "bench/CodecBenchPriv.h"
+#include "bench/DDLRecordBench.h"
 #include "bench/GMBench.h"
 #include "bench/MSKPBench.h"
 #include "bench/RecordingBench.h"
@@ -139,7 +140,13 @@ static DEFINE_string(zoom, "1.0,0",
                      "Comma-separated zoomMax,zoomPeriodMs factors for a periodic SKP zoom "
                      "function that ping-pongs between 1.0 and zoomMax.");
 static DEFINE_bool(bbh, true, "Build a BBH for SKPs?");
+static DEFINE_bool(internContent, false,
+                   "Record SKPs with SkPictureRecorder::kInternContent_RecordFlag?");
 static DEFINE_bool(loopSKP, true, "Loop SKPs like we do for micro benches?");
+static DEFINE_string(ddlRecordThreads, "",
+                     "Space-separated thread counts. If given, also time recording each SKP into "
+                     "DDL tiles on a mock GPU context with that many threads.");
+static DEFINE_int(ddlRecordTiles, 4, "Tiles along each edge of SKPs timed with --ddlRecordThreads.");
 static DEFINE_int(flushEvery, 10, "Flush --outResultsFile every Nth run.");
 static DEFINE_bool(gpuStats, false, "Print GPU stats after each gpu benchmark?");
 static DEFINE_bool(gpuStatsDump, false, "Dump GPU stats after each benchmark to json");
@@ -943,9 +950,27 @@ public:
             SkString name = SkOSPath::Basename(path.c_str());
             fSourceType = "skp";
             fBenchType  = "recording";
+            auto bench = new RecordingBench(name.c_str(), pic.get(), FLAGS_bbh,
+                                            FLAGS_internContent);
+            fSKPBytes = static_cast<double>(bench->approximateBytesUsed());
+            fSKPOps   = pic->approximateOpCount();
+            return bench;
+        }
+
+        // Then play back each .skp's record with and without occluded draws culled.
+        while (fCurrentRecordPlayback < 2 * fSKPs.count()) {
+            const bool cullOccluded = fCurrentRecordPlayback % 2;
+            const SkString& path = fSKPs[fCurrentRecordPlayback++ / 2];
+            sk_sp<SkPicture> pic = ReadPicture(path.c_str());
+            if (!pic) {
+                continue;
+            }
+            SkString name = SkOSPath::Basename(path.c_str());
+            fSourceType = "skp";
+            fBenchType  = "playback";
             fSKPBytes = static_cast<double>(pic->approximateBytesUsed());
             fSKPOps   = pic->approximateOpCount();
-            return new RecordingBench(name.c_str(), pic.get(), FLAGS_bbh);
+            return new RecordPlaybackBench(name.c_str(), pic.get(), cullOccluded);
         }
 
         // Add all .skps as DeserializePictureBenchs.
@@ -1022,6 +1047,22 @@ public:
             }
         }
 
+        // Then record each .skp into DDL tiles on a mock context at each thread count.
+        while (fCurrentDDLRecord < fSKPs.count() * FLAGS_ddlRecordThreads.size()) {
+            const int threads = atoi(
+                    FLAGS_ddlRecordThreads[fCurrentDDLRecord % FLAGS_ddlRecordThreads.size()]);
+            const SkString& path = fSKPs[fCurrentDDLRecord++ / FLAGS_ddlRecordThreads.size()];
+            sk_sp<SkPicture> pic = ReadPicture(path.c_str());
+            if (!pic || threads <= 0) {
+                continue;
+            }
+            SkString name = SkOSPath::Basename(path.c_str());
+            fSourceType = "skp";
+            fBenchType  = "ddl_record";
+            return new DDLRecordBench(name.c_str(), std::move(pic), FLAGS_ddlRecordTiles,
+                                      threads);
+        }
+
         // Read all MSKPs as benches
         while (fCurrentMSKP < fMSKPs.count()) {
             const SkString& path = fMSKPs[fCurrentMSKP++];
@@ -1035,6 +1076,16 @@ public:
             return new MSKPBench(std::move(name), std::move(player));
         }
 
+        // Then time opening each MSKP and seeking to random frames in it.
+        while (fCurrentMSKPSeek < 2 * fMSKPs.count()) {
+            const auto mode = fCurrentMSKPSeek % 2 ? MSKPSeekBench::Mode::kSeek
+                                                   : MSKPSeekBench::Mode::kOpen;
+            const SkString& path = fMSKPs[fCurrentMSKPSeek++ / 2];
+            fSourceType = "mskp";
+            fBenchType  = "mskp_seek";
+            return new MSKPSeekBench(SkOSPath::Basename(path.c_str()), path, mode);
+        }
+
         for (; fCurrentCodec < fImages.count(); fCurrentCodec++) {
             fSourceType = "image";
             fBenchType = "skcodec";
@@ -1111,6 +1162,39 @@ public:
             fCurrentColorType = 0;
         }
 
+        // Run CodecBenches that convert to a wide gamut, to time decoding with a color xform.
+        for (; fCurrentCodecXform < fImages.count(); fCurrentCodecXform++) {
+            fSourceType = "image";
+            fBenchType = "skcodec_xform";
+            const SkString& path = fImages[fCurrentCodecXform];
+            if (CommandLineFlags::ShouldSkip(FLAGS_match, path.c_str())) {
+                continue;
+            }
+            sk_sp<SkData> encoded(SkData::MakeFromFileName(path.c_str()));
+            std::unique_ptr<SkCodec> codec(SkCodec::MakeFromData(encoded));
+            if (!codec) {
+                continue;
+            }
+
+            SkAlphaType alphaType = codec->getInfo().alphaType();
+            if (kUnpremul_SkAlphaType == alphaType) {
+                alphaType = kPremul_SkAlphaType;
+            }
+            sk_sp<SkColorSpace> p3 = SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB,
+                                                           SkNamedGamut::kDisplayP3);
+            SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType)
+                                               .makeAlphaType(alphaType)
+                                               .makeColorSpace(p3);
+            SkAutoMalloc storage(info.computeMinByteSize());
+            const SkCodec::Result result = codec->getPixels(info, storage.get(),
+                                                            info.minRowBytes());
+            if (SkCodec::kSuccess == result || SkCodec::kIncompleteInput == result) {
+                fCurrentCodecXform++;
+                return new CodecBench(SkOSPath::Basename(path.c_str()), encoded.get(),
+                                      kN32_SkColorType, alphaType, std::move(p3));
+            }
+        }
+
         // Run AndroidCodecBenches
         const int sampleSizes[] = { 2, 4, 8 };
         for (; fCurrentAndroidCodec < fImages.count(); fCurrentAndroidCodec++) {
@@ -1284,13 +1368,17 @@ private:
     const char* fSourceType;  // What we're benching: bench, GM, SKP, ...
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
     int fCurrentRecording = 0;
+    int fCurrentRecordPlayback = 0;
     int fCurrentDeserialPicture = 0;
+    int fCurrentDDLRecord = 0;
     int fCurrentMSKP = 0;
+    int fCurrentMSKPSeek = 0;
     int fCurrentScale = 0;
     int fCurrentSKP = 0;
     int fCurrentSVG = 0;
     int fCurrentTextBlobTrace = 0;
     int fCurrentCodec = 0;
+    int fCurrentCodecXform = 0;
     int fCurrentAndroidCodec = 0;
 #ifdef SK_ENABLE_ANDROID_UTILS
     int fCurrentBRDImage = 0;
@@ -1535,6 +1623,7 @@ int main(int argc, char** argv) {
                     combinedDMSAAStats.merge(dmsaaStats);
                 }
             }
+            bench->getExtraStats(&keys, &values);
 
             bench->perCanvasPostDraw(canvas);
 
@@ -1568,7 +1657,7 @@ int main(int argc, char** argv) {
             log.endArray(); // samples
             benchStream.fillCurrentMetrics(log);
             if (!keys.empty()) {
-                // dump to json, only SKPBench currently returns valid keys / values
+                // dump to json, from getGpuStats() and getExtraStats()
                 SkASSERT(keys.count() == values.count());
                 for (int j = 0; j < keys.count(); j++) {
                     log.appendMetric(keys[j].c_str(), values[j]);
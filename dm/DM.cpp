@@ -1461,6 +1461,7 @@ struct Task {
 // Unit tests don't fit so well into the Src/Sink model, so we give them special treatment.
 
 static SkTDArray<skiatest::Test>* gCPUTests = new SkTDArray<skiatest::Test>;
+static SkTDArray<skiatest::Test>* gSerialCPUTests = new SkTDArray<skiatest::Test>;
 static SkTDArray<skiatest::Test>* gGaneshTests = new SkTDArray<skiatest::Test>;
 static SkTDArray<skiatest::Test>* gGraphiteTests = new SkTDArray<skiatest::Test>;
 
@@ -1480,7 +1481,7 @@ static void gather_tests() {
         } else if (test.fTestType == TestType::kGraphite && FLAGS_graphite) {
             gGraphiteTests->push_back(test);
         } else if (test.fTestType == TestType::kCPU && FLAGS_cpu) {
-            gCPUTests->push_back(test);
+            (test.fSerial ? gSerialCPUTests : gCPUTests)->push_back(test);
         }
     }
 }
@@ -1609,7 +1610,8 @@ int main(int argc, char** argv) {
         return 1;
     }
     gather_tests();
-    int testCount = gCPUTests->size() + gGaneshTests->size() + gGraphiteTests->size();
+    int testCount = gCPUTests->size() + gSerialCPUTests->size() + gGaneshTests->size() +
+                    gGraphiteTests->size();
     gPending = gSrcs->count() * gSinks->count() + testCount;
     info("%d srcs * %d sinks + %d tests == %d tasks\n",
          gSrcs->count(), gSinks->count(), testCount,
@@ -1652,6 +1654,9 @@ int main(int argc, char** argv) {
 
     // At this point we're back in single-threaded land.
 
+    // Serial CPU tests change process-wide state, so they run alone.
+    for (skiatest::Test& test : *gSerialCPUTests) { run_cpu_test(test); }
+
     // We'd better have run everything.
     SkASSERT(gPending == 0);
     // Make sure we've flushed all our results to disk.
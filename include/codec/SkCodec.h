@@ -30,11 +30,13 @@
 
 class SkAndroidCodec;
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkImage;
 class SkPngChunkReader;
 class SkSampler;
 class SkStream;
+class SkSwizzler;
 
 namespace DM {
 class CodecSrc;
@@ -292,6 +294,7 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -335,6 +338,18 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, getPixels() may split the decode across this executor.
+         *
+         *  Currently only honored by JPEG, for baseline images with restart markers that are
+         *  backed by memory (e.g. MakeFromData()).  Each strip of restart intervals is decoded
+         *  by its own decompressor straight into the dst.  The result is identical to a serial
+         *  decode.  Everything else, including scanline and incremental decodes, ignores this.
+         *
+         *  Experimental.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
@@ -868,6 +883,14 @@ protected:
     virtual bool usesColorXform() const { return true; }
     void applyColorXform(void* dst, const void* src, int count) const;
 
+    /**
+     *  Swizzles a row of src and color transforms it into dst, a chunk at a time, so each chunk
+     *  is still in cache when it is transformed.  Each chunk is swizzled into xformSrc, or if
+     *  xformSrc is null, into dst to be transformed in place.
+     */
+    void applySwizzleAndColorXform(SkSwizzler*, void* dst, void* xformSrc,
+                                   const uint8_t* src) const;
+
     bool colorXform() const { return fXformTime != kNo_XformTime; }
     bool xformOnDecode() const { return fXformTime == kDecodeRow_XformTime; }
 
@@ -13,6 +13,8 @@
 #include "include/core/SkTypes.h"
 #include <vector>
 
+class SkExecutor;
+
 class SkBBoxHierarchy : public SkRefCnt {
 public:
     struct Metadata {
@@ -57,7 +59,18 @@ protected:
 
 class SK_API SkRTreeFactory : public SkBBHFactory {
 public:
+    SkRTreeFactory() = default;
+
+    /**
+     *  R-Trees made by this factory build large hierarchies in parallel on the executor, which
+     *  must outlive the recording.  Search results are the same as without an executor.
+     */
+    explicit SkRTreeFactory(SkExecutor* executor) : fExecutor(executor) {}
+
     sk_sp<SkBBoxHierarchy> operator()() const override;
+
+private:
+    SkExecutor* fExecutor = nullptr;
 };
 
 #endif
@@ -54,6 +54,7 @@ struct SkDrawShadowRec;
 class SkFont;
 class SkImage;
 class SkImageFilter;
+class SkLayerPixelPool;
 class SkPaintFilterCanvas;
 class SkPath;
 class SkPicture;
@@ -2382,7 +2383,8 @@ private:
         void reset(SkBaseDevice* device);
     };
 
-    // the first N recs that can fit here mean we won't call malloc
+    // the first N recs that can fit here mean we won't call malloc, and deeper recs are allocated
+    // N at a time
     static constexpr int kMCRecSize      = 96; // most recent measurement
     static constexpr int kMCRecCount     = 32; // common depth for save/restores
 
@@ -2400,6 +2402,9 @@ private:
 
     std::unique_ptr<SkRasterHandleAllocator> fAllocator;
 
+    // Recycles the pixels of raster layers across saveLayer()s, created by the first one.
+    sk_sp<SkLayerPixelPool> fLayerPool;
+
     SkSurface_Base*  fSurfaceBase;
     SkSurface_Base* getSurfaceBase() const { return fSurfaceBase; }
     void setSurfaceBase(SkSurface_Base* sb) {
@@ -22,6 +22,21 @@ public:
     static std::unique_ptr<SkExecutor> MakeLIFOThreadPool(int threads = 0,
                                                           bool allowBorrowing = true);
 
+    // Create a thread pool SkExecutor where each thread keeps its own queue of work, adding
+    // work it spawns to that queue and stealing from the others when it runs dry.
+    // This scales better than the FIFO/LIFO pools when lots of small tasks are added from
+    // inside other tasks.  Work added from outside the pool is shared by all threads.
+    static std::unique_ptr<SkExecutor> MakeWorkStealingPool(int threads = 0,
+                                                            bool allowBorrowing = true);
+
+    // Create a thread pool SkExecutor that runs work on the same threads, in the same order on
+    // each thread, whenever work is added in the same order, regardless of timing.  This lets
+    // a record/replay runtime replay multithreaded work.  Work added from inside a task always
+    // runs on that task's thread, and borrow() only runs such work, so nested SkTaskGroups run
+    // serially on their parent's thread.  A task must not wait for work added by any other
+    // thread.  Threads outside the pool block in borrow() rather than spin.
+    static std::unique_ptr<SkExecutor> MakeDeterministicPool(int threads = 0);
+
     // There is always a default SkExecutor available by calling SkExecutor::GetDefault().
     static SkExecutor& GetDefault();
     static void SetDefault(SkExecutor*);  // Does not take ownership.  Not thread safe.
@@ -32,6 +47,11 @@ public:
     // If it makes sense for this executor, use this thread to execute work for a little while.
     virtual void borrow() {}
 
+    // True if this executor runs each piece of work on a thread, and in an order, that depends
+    // only on the order work was added.  Callers dividing work among several adds should then
+    // divide it up front rather than having tasks race to claim it.
+    virtual bool isDeterministic() const { return false; }
+
 protected:
     SkExecutor() = default;
     SkExecutor(const SkExecutor&) = delete;
@@ -163,6 +163,57 @@ public:
      *  Call early in main() to allow Skia to use a JIT to accelerate CPU-bound operations.
      */
     static void AllowJIT();
+
+    /**
+     *  The CPU backend caches the SkVM programs it builds for each kind of draw in one cache
+     *  shared by all threads. This returns the memory used by the programs in that cache,
+     *  including any JIT code.
+     */
+    static size_t GetVMProgramCacheTotalBytesUsed();
+
+    /**
+     *  These functions get/set the memory usage limit for the SkVM program cache. The least
+     *  recently used programs are purged when the memory usage exceeds this limit.
+     *  SetVMProgramCacheTotalByteLimit() returns the previous limit.
+     */
+    static size_t GetVMProgramCacheTotalByteLimit();
+    static size_t SetVMProgramCacheTotalByteLimit(size_t newLimit);
+
+    /**
+     *  Lookups in the SkVM program cache since the process started. A miss that was satisfied
+     *  by the persistent cache (see SetVMProgramPersistentCache()) also counts as a persistentHit.
+     */
+    struct VMProgramCacheStats {
+        int64_t hits           = 0;
+        int64_t misses         = 0;
+        int64_t persistentHits = 0;
+    };
+    static VMProgramCacheStats GetVMProgramCacheStats();
+
+    /**
+     *  Like GrContextOptions::PersistentCache, but for the SkVM program cache: a second level
+     *  cache, e.g. on disk, so that optimized programs can survive restarts. Keys and data are
+     *  opaque. They are only meaningful to the same build of Skia on the same kind of CPU, and
+     *  loaded data is trusted, so only load() data that was store()d by this application.
+     */
+    class SK_API VMProgramPersistentCache {
+    public:
+        virtual ~VMProgramPersistentCache() = default;
+
+        /**
+         *  Returns the data for the key if it exists in the cache, otherwise returns null.
+         */
+        virtual sk_sp<SkData> load(const SkData& key) = 0;
+
+        virtual void store(const SkData& key, const SkData& data) = 0;
+    };
+
+    /**
+     *  Sets the persistent cache the SkVM program cache falls back on. It is not owned. load() and
+     *  store() may be called from several threads at once, but never after a call that replaces
+     *  it returns, so it may be destroyed once replaced. Pass nullptr to stop using it.
+     */
+    static void SetVMProgramPersistentCache(VMProgramPersistentCache*);
 };
 
 class SkAutoGraphics {
@@ -18,6 +18,7 @@
 class SkCanvas;
 class SkData;
 struct SkDeserialProcs;
+class SkExecutor;
 class SkImage;
 class SkMatrix;
 struct SkSerialProcs;
@@ -82,6 +83,26 @@ public:
     static sk_sp<SkPicture> MakeFromData(const void* data, size_t size,
                                          const SkDeserialProcs* procs = nullptr);
 
+    /** Recreates SkPicture that was serialized into data, like MakeFromData(), but defers most
+        of the work until the picture is first drawn. The returned SkPicture keeps a reference
+        to data and reads its drawing commands straight out of it where alignment allows,
+        instead of copying them. Paints, paths, text blobs, vertices and images are decoded
+        the first time the picture is played back.
+
+        Opening a large picture this way, e.g. from SkData::MakeFromFD(), costs little more
+        than reading its header. Malformed contents may not be detected until playback, which
+        then draws nothing.
+
+        data must not change while the SkPicture is alive. procs, and any context they use,
+        must remain valid until the picture is first played back.
+
+        @param data   container for serial data
+        @param procs  custom serial data decoders; may be nullptr
+        @return       SkPicture constructed from data
+    */
+    static sk_sp<SkPicture> MakeFromDataDeferred(sk_sp<SkData> data,
+                                                 const SkDeserialProcs* procs = nullptr);
+
     /** \class SkPicture::AbortCallback
         AbortCallback is an abstract class. An implementation of AbortCallback may
         passed as a parameter to SkPicture::playback, to stop it before all drawing
@@ -178,6 +199,20 @@ public:
     */
     void serialize(SkWStream* stream, const SkSerialProcs* procs = nullptr) const;
 
+    /** Returns storage containing SkData describing SkPicture, like serialize(procs), but encodes
+        images and serializes typefaces in parallel on executor. The result is byte-for-byte
+        identical to serialize(procs).
+
+        procs->fImageProc and procs->fTypefaceProc may be called on executor's threads, so must
+        be thread-safe. Each is called at most once per distinct image or typeface.
+        If executor is nullptr, this is the same as serialize(procs).
+
+        @param procs     custom serial data encoders; may be nullptr
+        @param executor  runs the encoding work; may be nullptr
+        @return          storage containing serialized SkPicture
+    */
+    sk_sp<SkData> serialize(const SkSerialProcs* procs, SkExecutor* executor) const;
+
     /** Returns a placeholder SkPicture. Result does not draw, and contains only
         cull SkRect, a hint of its bounds. Result is immutable; it cannot be changed
         later. Result identifier is unique.
@@ -238,13 +273,16 @@ private:
     // Allowed subclasses.
     SkPicture();
     friend class SkBigPicture;
+    friend class SkDeferredPicture;
     friend class SkEmptyPicture;
     friend class SkPicturePriv;
 
     void serialize(SkWStream*, const SkSerialProcs*, class SkRefCntSet* typefaces,
         bool textBlobsOnly=false) const;
+    // If deferredBacking is set, stream reads from it, and the picture is an SkDeferredPicture.
     static sk_sp<SkPicture> MakeFromStream(SkStream*, const SkDeserialProcs*,
-                                           class SkTypefacePlayback*);
+                                           class SkTypefacePlayback*,
+                                           sk_sp<SkData> deferredBacking);
     friend class SkPictureData;
 
     /** Return true if the SkStream/Buffer represents a serialized picture, and
@@ -262,6 +300,9 @@ private:
     // Returns NULL if this is not an SkBigPicture.
     virtual const class SkBigPicture* asSkBigPicture() const { return nullptr; }
 
+    // Returns NULL if this is not an SkDeferredPicture.
+    virtual const class SkDeferredPicture* asSkDeferredPicture() const { return nullptr; }
+
     static bool IsValidPictInfo(const struct SkPictInfo& info);
     static sk_sp<SkPicture> Forwardport(const struct SkPictInfo&,
                                         const class SkPictureData*,
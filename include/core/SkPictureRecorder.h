@@ -32,6 +32,21 @@ public:
     enum FinishFlags {
     };
 
+    enum RecordFlags {
+        /** Record paths and vertices with identical contents as references to one shared copy.
+            This costs some recording time, but shrinks pictures of repetitive content in memory
+            and when serialized.
+        */
+        kInternContent_RecordFlag = 1 << 0,
+
+        /** Turn draws entirely hidden behind later opaque draws into no-ops when recording
+            finishes. Only set this if the picture will be played back under a translate or an
+            axis-aligned scale up: scaled down, rotated, or in perspective, an occluder's
+            antialiased edges can let a culled draw show through.
+        */
+        kCullOccludedDraws_RecordFlag = 1 << 1,
+    };
+
     /** Returns the canvas that records the drawing commands.
         @param bounds the cull rect used when recording this picture. Any drawing the falls outside
                       of this rect is undefined, and may be drawn or it may not.
@@ -39,7 +54,8 @@ public:
         @param recordFlags optional flags that control recording.
         @return the canvas.
     */
-    SkCanvas* beginRecording(const SkRect& bounds, sk_sp<SkBBoxHierarchy> bbh);
+    SkCanvas* beginRecording(const SkRect& bounds, sk_sp<SkBBoxHierarchy> bbh,
+                             uint32_t recordFlags = 0);
 
     SkCanvas* beginRecording(const SkRect& bounds, SkBBHFactory* bbhFactory = nullptr);
 
@@ -91,6 +107,9 @@ public:
 private:
     void reset();
 
+    // Runs the optimizations recordFlags ask for on fRecord.
+    void optimize();
+
     /** Replay the current (partially recorded) operation stream into
         canvas. This call doesn't close the current recording.
     */
@@ -101,6 +120,7 @@ private:
     void partialReplay(SkCanvas* canvas) const;
 
     bool                        fActivelyRecording;
+    uint32_t                    fRecordFlags = 0;
     SkRect                      fCullRect;
     sk_sp<SkBBoxHierarchy>      fBBH;
     std::unique_ptr<SkRecorder> fRecorder;
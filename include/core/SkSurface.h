@@ -28,6 +28,7 @@
 class SkCanvas;
 class SkCapabilities;
 class SkDeferredDisplayList;
+class SkExecutor;
 class SkPaint;
 class SkSurfaceCharacterization;
 class GrBackendRenderTarget;
@@ -182,6 +183,25 @@ public:
     static sk_sp<SkSurface> MakeRasterN32Premul(int width, int height,
                                                 const SkSurfaceProps* surfaceProps = nullptr);
 
+    /** Allocates raster SkSurface whose SkCanvas records draws instead of rasterizing them
+        immediately. Recorded draws are rasterized when the surface contents are observed
+        (makeImageSnapshot(), draw(), readPixels(), peekPixels() or writePixels()), split into
+        tiles that are replayed in parallel on executor. Each tile replays only the draws whose
+        bounds touch it, rasterizing them against the whole surface but writing only its own
+        pixels, so the result exactly matches that of a surface from MakeRaster().
+        Allocates and zeroes pixel memory, which is deleted when SkSurface is deleted.
+
+        @param imageInfo     width, height, SkColorType, SkAlphaType, SkColorSpace,
+                             of raster surface; width and height must be greater than zero
+        @param executor      runs the tile rasterization; if nullptr, SkExecutor::GetDefault()
+                             is used. Must outlive the returned SkSurface.
+        @param surfaceProps  LCD striping orientation and setting for device independent fonts;
+                             may be nullptr
+        @return              SkSurface if all parameters are valid; otherwise, nullptr
+    */
+    static sk_sp<SkSurface> MakeRasterTiled(const SkImageInfo& imageInfo, SkExecutor* executor,
+                                            const SkSurfaceProps* surfaceProps = nullptr);
+
     /** Caller data passed to RenderTarget/TextureReleaseProc; may be nullptr. */
     typedef void* ReleaseContext;
 
@@ -61,6 +61,13 @@ public:
          *  In the second case, the encoder supports linear or legacy blending.
          */
         AlphaOption fAlphaOption = AlphaOption::kIgnore;
+
+        /**
+         *  If positive, a restart marker is written after every |fRestartRows| rows of MCUs
+         *  (16 rows of pixels for k420, 8 otherwise).  This makes the file slightly larger,
+         *  but lets decoders resynchronize after corrupt data, or decode strips in parallel.
+         */
+        int fRestartRows = 0;
     };
 
     /**
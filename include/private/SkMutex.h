@@ -14,27 +14,69 @@
 #include "include/private/SkThreadAnnotations.h"
 #include "include/private/SkThreadID.h"
 
+#include <atomic>
+#include <cstdint>
+
 extern int SkRecordReplayCreateOrderedLock(const char* ordered_name);
 extern void SkRecordReplayOrderedLock(int lock);
 extern void SkRecordReplayOrderedUnlock(int lock);
 
+// Whether the record/replay runtime provides ordered locks: -1 until probed, then 0 or 1.
+// Probing resolves the runtime's lock functions once for the whole process.
+SK_SPI extern std::atomic<int> gSkRecordReplayOrderedLocks;
+SK_SPI bool SkRecordReplayProbeOrderedLocks();
+
+static inline bool SkRecordReplayHasOrderedLocks() {
+    int state = gSkRecordReplayOrderedLocks.load(std::memory_order_acquire);
+    return state >= 0 ? state != 0 : SkRecordReplayProbeOrderedLocks();
+}
+
+// Tests only: use these in place of the runtime's ordered lock functions, as if the probe had
+// found them.  An SkMutex named while they're installed keeps using them, so only go back to the
+// runtime's (by passing nullptrs) once every such SkMutex is gone.
+SK_SPI void SkRecordReplaySetOrderedLocksForTesting(int (*createLock)(const char*),
+                                                    void (*lock)(int),
+                                                    void (*unlock)(int));
+
+// Define SK_MUTEX_STATS to have every SkMutex count its acquisitions and how many of them had to
+// wait.  The counts are reported through SkEventTracer as "skia.mutex" counters named after the
+// mutex every kStatsReportInterval acquisitions, and again when the mutex is destroyed.  Named
+// SkSpinlocks count theirs too.
+#if defined(SK_MUTEX_STATS)
+SK_SPI void SkMutexReportStats(const char* name, uint32_t acquisitions, uint32_t contentions);
+#endif
+
 class SK_CAPABILITY("mutex") SkMutex {
 public:
     constexpr SkMutex() = default;
     SkMutex(const char* ordered_name) {
-      fOrderedLockId = SkRecordReplayCreateOrderedLock(ordered_name);
+#if defined(SK_MUTEX_STATS)
+        fName = ordered_name;
+#endif
+        if (SkRecordReplayHasOrderedLocks()) {
+            fOrderedLockId = SkRecordReplayCreateOrderedLock(ordered_name);
+        }
     }
 
     ~SkMutex() {
         this->assertNotHeld();
+#if defined(SK_MUTEX_STATS)
+        if (uint32_t acquisitions = fAcquisitions.load(std::memory_order_relaxed)) {
+            SkMutexReportStats(fName, acquisitions, fContentions.load(std::memory_order_relaxed));
+        }
+#endif
     }
 
     void acquire() SK_ACQUIRE() {
+#if defined(SK_MUTEX_STATS)
+        this->acquireCounted();
+#else
         if (fOrderedLockId) {
           SkRecordReplayOrderedLock(fOrderedLockId);
         } else {
           fSemaphore.wait();
         }
+#endif
         SkDEBUGCODE(fOwner = SkGetThreadID();)
     }
 
@@ -57,6 +99,34 @@ public:
     }
 
 private:
+#if defined(SK_MUTEX_STATS)
+    static constexpr uint32_t kStatsReportInterval = 4096;
+
+    void acquireCounted() {
+        bool contended = false;
+        if (fOrderedLockId) {
+            // The runtime owns ordered locks, so we can't tell whether they were contended.
+            SkRecordReplayOrderedLock(fOrderedLockId);
+        } else if (!fSemaphore.try_wait()) {
+            contended = true;
+            fSemaphore.wait();
+        }
+        // We hold the lock, so these can't race with each other; only the reports read them
+        // without it.
+        uint32_t contentions = fContentions.load(std::memory_order_relaxed) + contended;
+        uint32_t acquisitions = fAcquisitions.load(std::memory_order_relaxed) + 1;
+        fContentions.store(contentions, std::memory_order_relaxed);
+        fAcquisitions.store(acquisitions, std::memory_order_relaxed);
+        if (acquisitions % kStatsReportInterval == 0) {
+            SkMutexReportStats(fName, acquisitions, contentions);
+        }
+    }
+
+    const char* fName = "SkMutex";
+    std::atomic<uint32_t> fAcquisitions{0};
+    std::atomic<uint32_t> fContentions{0};
+#endif
+
     SkSemaphore fSemaphore{1};
     int fOrderedLockId = 0;
     SkDEBUGCODE(SkThreadID fOwner{kIllegalThreadID};)
@@ -11,17 +11,34 @@
 #include "include/core/SkTypes.h"
 #include "include/private/SkThreadAnnotations.h"
 #include <atomic>
+#include <cstdint>
+
+// With SK_MUTEX_STATS, named spinlocks count their acquisitions and contentions just like SkMutex
+// (see SkMutex.h), and report them every kStatsReportInterval acquisitions.  They don't report
+// again when destroyed, so that SkSpinlock stays trivially destructible.
+#if defined(SK_MUTEX_STATS)
+SK_SPI void SkMutexReportStats(const char* name, uint32_t acquisitions, uint32_t contentions);
+#endif
 
 class SK_CAPABILITY("mutex") SkSpinlock {
 public:
     constexpr SkSpinlock() = default;
+    constexpr explicit SkSpinlock(const char* name)
+#if defined(SK_MUTEX_STATS)
+        : fName(name)
+#endif
+    {}
 
     void acquire() SK_ACQUIRE() {
         // To act as a mutex, we need an acquire barrier when we acquire the lock.
-        if (fLocked.exchange(true, std::memory_order_acquire)) {
+        const bool contended = fLocked.exchange(true, std::memory_order_acquire);
+        if (contended) {
             // Lock was contended.  Fall back to an out-of-line spin loop.
             this->contendedAcquire();
         }
+#if defined(SK_MUTEX_STATS)
+        this->countAcquisition(contended);
+#endif
     }
 
     // Acquire the lock or fail (quickly). Lets the caller decide to do something other than wait.
@@ -31,6 +48,9 @@ public:
             // Lock was contended. Let the caller decide what to do.
             return false;
         }
+#if defined(SK_MUTEX_STATS)
+        this->countAcquisition(false);
+#endif
         return true;
     }
 
@@ -42,6 +62,28 @@ public:
 private:
     SK_API void contendedAcquire();
 
+#if defined(SK_MUTEX_STATS)
+    static constexpr uint32_t kStatsReportInterval = 4096;
+
+    void countAcquisition(bool contended) {
+        if (!fName) {
+            return;
+        }
+        // As in SkMutex, we hold the lock, so these can't race with each other.
+        uint32_t contentions = fContentions.load(std::memory_order_relaxed) + contended;
+        uint32_t acquisitions = fAcquisitions.load(std::memory_order_relaxed) + 1;
+        fContentions.store(contentions, std::memory_order_relaxed);
+        fAcquisitions.store(acquisitions, std::memory_order_relaxed);
+        if (acquisitions % kStatsReportInterval == 0) {
+            SkMutexReportStats(fName, acquisitions, contentions);
+        }
+    }
+
+    const char* fName = nullptr;
+    std::atomic<uint32_t> fAcquisitions{0};
+    std::atomic<uint32_t> fContentions{0};
+#endif
+
     std::atomic<bool> fLocked{false};
 };
 
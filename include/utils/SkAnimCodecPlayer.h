@@ -17,6 +17,7 @@
 #include <memory>
 #include <vector>
 
+class SkCodecFrameCache;
 class SkImage;
 
 class SkAnimCodecPlayer {
@@ -53,12 +54,15 @@ public:
 
 
 private:
-    std::unique_ptr<SkCodec>        fCodec;
-    SkImageInfo                     fImageInfo;
-    std::vector<SkCodec::FrameInfo> fFrameInfos;
-    std::vector<sk_sp<SkImage> >    fImages;
-    int                             fCurrIndex = 0;
-    uint32_t                        fTotalDuration;
+    // Null for a single-frame image.
+    std::unique_ptr<SkCodecFrameCache> fFrameCache;
+    SkImageInfo                        fImageInfo;
+    std::vector<SkCodec::FrameInfo>    fFrameInfos;
+    // The single-frame image, or the most recent frame returned by getFrameAt().
+    sk_sp<SkImage>                     fImage;
+    int                                fImageIndex = SkCodec::kNoFrame;
+    int                                fCurrIndex = 0;
+    uint32_t                           fTotalDuration;
 
     sk_sp<SkImage> getFrameAt(int index);
 };
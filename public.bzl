@@ -392,6 +392,8 @@ BASE_SRCS_ALL = [
     "src/core/SkDeferredDisplayList.cpp",
     "src/core/SkDeferredDisplayListPriv.h",
     "src/core/SkDeferredDisplayListRecorder.cpp",
+    "src/core/SkDeferredPicture.cpp",
+    "src/core/SkDeferredPicture.h",
     "src/core/SkDeque.cpp",
     "src/core/SkDescriptor.cpp",
     "src/core/SkDescriptor.h",
@@ -469,6 +471,8 @@ BASE_SRCS_ALL = [
     "src/core/SkLRUCache.h",
     "src/core/SkLatticeIter.cpp",
     "src/core/SkLatticeIter.h",
+    "src/core/SkLayerPixelPool.cpp",
+    "src/core/SkLayerPixelPool.h",
     "src/core/SkLeanWindows.h",
     "src/core/SkLineClipper.cpp",
     "src/core/SkLineClipper.h",
@@ -570,6 +574,8 @@ BASE_SRCS_ALL = [
     "src/core/SkReadBuffer.h",
     "src/core/SkRecord.cpp",
     "src/core/SkRecord.h",
+    "src/core/SkRecordDiff.cpp",
+    "src/core/SkRecordDiff.h",
     "src/core/SkRecordDraw.cpp",
     "src/core/SkRecordDraw.h",
     "src/core/SkRecordOpts.cpp",
@@ -1224,6 +1230,7 @@ BASE_SRCS_ALL = [
     "src/image/SkSurface_Gpu.cpp",
     "src/image/SkSurface_Gpu.h",
     "src/image/SkSurface_Raster.cpp",
+    "src/image/SkSurface_RasterTiled.cpp",
     "src/images/SkImageEncoder.cpp",
     "src/images/SkImageEncoderFns.h",
     "src/images/SkImageEncoderPriv.h",
@@ -1640,6 +1647,8 @@ BASE_SRCS_ALL = [
     "src/utils/SkCharToGlyphCache.h",
     "src/utils/SkClipStackUtils.cpp",
     "src/utils/SkClipStackUtils.h",
+    "src/utils/SkCodecFrameCache.cpp",
+    "src/utils/SkCodecFrameCache.h",
     "src/utils/SkCustomTypeface.cpp",
     "src/utils/SkCycles.h",
     "src/utils/SkDashPath.cpp",
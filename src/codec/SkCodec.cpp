@@ -20,11 +20,13 @@
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkFrameHolder.h"
 #include "src/codec/SkSampler.h"
+#include "src/codec/SkSwizzler.h"
 
 // We always include and compile in these BMP codecs
 #include "src/codec/SkBmpCodec.h"
 #include "src/codec/SkWbmpCodec.h"
 
+#include <algorithm>
 #include <utility>
 
 #ifdef SK_HAS_ANDROID_CODEC
@@ -782,6 +784,24 @@ void SkCodec::applyColorXform(void* dst, const void* src, int count) const {
                                    count));
 }
 
+void SkCodec::applySwizzleAndColorXform(SkSwizzler* swizzler, void* dst, void* xformSrc,
+                                        const uint8_t* src) const {
+    SkASSERT(0 == swizzler->swizzleOffsetBytes());
+
+    // Enough pixels to amortize the setup in skcms_Transform(), and few enough that a chunk of
+    // 16-bit RGBA is still in L1 when skcms reads it back.
+    constexpr int kChunkPixels = 512;
+    const int width = swizzler->swizzleWidth();
+    const size_t dstBPP = fDstInfo.bytesPerPixel();
+    for (int x = 0; x < width; x += kChunkPixels) {
+        const int count = std::min(kChunkPixels, width - x);
+        void* dstChunk = SkTAddOffset<void>(dst, x * dstBPP);
+        void* srcChunk = xformSrc ? xformSrc : dstChunk;
+        swizzler->swizzleRange(srcChunk, src, x, count);
+        this->applyColorXform(dstChunk, srcChunk, count);
+    }
+}
+
 std::vector<SkCodec::FrameInfo> SkCodec::getFrameInfo() {
     const int frameCount = this->getFrameCount();
     SkASSERT(frameCount >= 0);
@@ -27,11 +27,16 @@
 #include "src/codec/SkJpegPriv.h"
 #include "src/codec/SkParseEncodedOrigin.h"
 #include "src/codec/SkSwizzler.h"
+#include "src/core/SkTaskGroup.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <csetjmp>
 #include <cstring>
+#include <numeric>
 #include <utility>
+#include <vector>
 
 class SkSampler;
 
@@ -500,11 +505,12 @@ int SkJpegCodec::readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes
             return y;
         }
 
-        if (fSwizzler) {
+        if (fSwizzler && this->colorXform()) {
+            this->applySwizzleAndColorXform(fSwizzler.get(), dst, fColorXformSrcRow, decodeDst);
+            dst = SkTAddOffset<void>(dst, rowBytes);
+        } else if (fSwizzler) {
             fSwizzler->swizzle(swizzleDst, decodeDst);
-        }
-
-        if (this->colorXform()) {
+        } else if (this->colorXform()) {
             this->applyColorXform(dst, swizzleDst, dstWidth);
             dst = SkTAddOffset<void>(dst, rowBytes);
         }
@@ -533,6 +539,262 @@ static inline bool needs_swizzler_to_convert_from_cmyk(J_COLOR_SPACE jpegColorTy
     return !hasCMYKColorSpace || !hasColorSpaceXform;
 }
 
+// Marker codes that jpeglib.h does not define.
+static constexpr uint8_t kSOIMarker  = 0xD8;
+static constexpr uint8_t kSOF0Marker = 0xC0;
+static constexpr uint8_t kSOF1Marker = 0xC1;
+static constexpr uint8_t kSOSMarker  = 0xDA;
+
+/*
+ * Where the pieces of a baseline jpeg's only scan live in its encoded data, for splitting the
+ * scan at its restart markers.
+ */
+struct RestartLayout {
+    size_t              fSOFHeightOffset;  // The 16-bit image height in the SOF segment.
+    size_t              fScanOffset;       // The first byte of entropy-coded data.
+    size_t              fScanEnd;          // The marker (normally EOI) that ends the scan.
+    std::vector<size_t> fRestartMarkers;   // Each RSTn marker, in order.
+};
+
+static bool find_restart_markers(const uint8_t* data, size_t length, RestartLayout* layout) {
+    if (length < 4 || 0xFF != data[0] || kSOIMarker != data[1]) {
+        return false;
+    }
+
+    // Walk the marker segments up to the start of scan.
+    bool foundSOF = false;
+    size_t offset = 2;
+    while (true) {
+        if (offset + 4 > length || 0xFF != data[offset]) {
+            return false;
+        }
+        const uint8_t marker = data[offset + 1];
+        if (0xFF == marker) {
+            // Fill byte.
+            offset++;
+            continue;
+        }
+        const size_t segmentLength = (data[offset + 2] << 8) | data[offset + 3];
+        if (segmentLength < 2 || offset + 2 + segmentLength > length) {
+            return false;
+        }
+        if (kSOF0Marker == marker || kSOF1Marker == marker) {
+            if (segmentLength < 8) {
+                return false;
+            }
+            layout->fSOFHeightOffset = offset + 5;
+            foundSOF = true;
+        } else if (kSOSMarker == marker) {
+            layout->fScanOffset = offset + 2 + segmentLength;
+            break;
+        }
+        offset += 2 + segmentLength;
+    }
+    if (!foundSOF) {
+        return false;
+    }
+
+    // In entropy-coded data, 0xFF is followed by a stuffed zero, by more 0xFF fill bytes before
+    // a marker, or by a marker.  Restart markers count up modulo 8.  Anything else ends the scan.
+    int nextRestart = 0;
+    for (offset = layout->fScanOffset; offset + 1 < length; offset++) {
+        if (0xFF != data[offset]) {
+            continue;
+        }
+        const uint8_t marker = data[offset + 1];
+        if (0x00 == marker || 0xFF == marker) {
+            continue;
+        }
+        if (marker >= JPEG_RST0 && marker < JPEG_RST0 + 8) {
+            if (JPEG_RST0 + nextRestart != marker) {
+                return false;
+            }
+            nextRestart = (nextRestart + 1) & 7;
+            layout->fRestartMarkers.push_back(offset);
+            offset++;
+            continue;
+        }
+        layout->fScanEnd = offset;
+        return true;
+    }
+    layout->fScanEnd = length;
+    return true;
+}
+
+bool SkJpegCodec::decodeRestartIntervalsInParallel(const SkImageInfo& dstInfo, void* dst,
+                                                   size_t rowBytes, const Options& options) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    const void* memory = this->stream()->getMemoryBase();
+    if (!memory || !dinfo->restart_interval || dinfo->progressive_mode || dinfo->arith_code ||
+        jpeg_has_multiple_scans(dinfo)) {
+        return false;
+    }
+
+    // The swizzler that converts from CMYK is not shared across threads.
+    if (needs_swizzler_to_convert_from_cmyk(dinfo->out_color_space,
+                                            this->getEncodedInfo().profile(), this->colorXform())) {
+        return false;
+    }
+
+    // A scan with one component has one block per MCU, whatever its sampling factors.
+    int mcuWidth = DCTSIZE,
+        mcuHeight = DCTSIZE;
+    bool needsContext = false;
+    if (dinfo->num_components > 1) {
+        mcuWidth *= dinfo->max_h_samp_factor;
+        mcuHeight *= dinfo->max_v_samp_factor;
+
+        // Fancy upsampling blends each subsampled row with the rows above and below it, so the
+        // first and last output rows of an MCU row depend on the neighboring MCU rows.
+        for (int i = 0; i < dinfo->num_components; i++) {
+            needsContext |= dinfo->comp_info[i].v_samp_factor != dinfo->max_v_samp_factor;
+        }
+        needsContext &= SkToBool(dinfo->do_fancy_upsampling);
+    }
+
+    const int width = dinfo->image_width,
+              height = dinfo->image_height;
+    const int mcusPerRow = (width + mcuWidth - 1) / mcuWidth,
+              mcuRows = (height + mcuHeight - 1) / mcuHeight;
+    const int outRowsPerMcuRow = mcuHeight * dinfo->scale_num / dinfo->scale_denom;
+    if (0 != mcuHeight * dinfo->scale_num % dinfo->scale_denom ||
+        (needsContext && 0 != outRowsPerMcuRow % 2)) {
+        return false;
+    }
+
+    // Strips must start at MCU rows that also start restart intervals.
+    const int64_t restartInterval = dinfo->restart_interval;
+    const int mcuRowStep =
+            SkToInt(restartInterval / std::gcd(restartInterval, (int64_t)mcusPerRow));
+    const int64_t intervals = ((int64_t)mcusPerRow * mcuRows + restartInterval - 1)
+                            / restartInterval;
+
+    RestartLayout layout;
+    const size_t length = this->stream()->getLength();
+    if (!find_restart_markers(static_cast<const uint8_t*>(memory), length, &layout) ||
+        (int64_t)layout.fRestartMarkers.size() != intervals - 1) {
+        return false;
+    }
+
+    // Keep each strip several MCU rows tall so that the MCU rows decoded twice for context stay
+    // a small share of the work, and cap the number of strips.
+    constexpr int kMinStripMcuRows = 4;
+    constexpr int kMaxStrips = 16;
+    int stripMcuRows = std::max(kMinStripMcuRows, (mcuRows + kMaxStrips - 1) / kMaxStrips);
+    stripMcuRows = (stripMcuRows + mcuRowStep - 1) / mcuRowStep * mcuRowStep;
+    const int stripCount = (mcuRows + stripMcuRows - 1) / stripMcuRows;
+    if (stripCount < 2) {
+        return false;
+    }
+
+    const uint8_t* data = static_cast<const uint8_t*>(memory);
+    const int contextMcuRows = needsContext ? mcuRowStep : 0;
+    const int contextRows = needsContext ? outRowsPerMcuRow / 2 : 0;
+    std::atomic<bool> failed{false};
+
+    SkTaskGroup tg(*options.fExecutor);
+    tg.batch(stripCount, [&](int i) {
+        // Decode an extra restart boundary's worth of MCU rows on each side for context.
+        // Neighboring strips split the MCU row at the seam in half, so each writes the half it
+        // decoded with context.
+        const int stripStart = i * stripMcuRows,
+                  stripEnd = std::min(mcuRows, stripStart + stripMcuRows);
+        const int decodeStart = std::max(0, stripStart - contextMcuRows),
+                  decodeEnd = std::min(mcuRows, stripEnd + contextMcuRows);
+        const int writeRow = 0 == stripStart ? 0 : stripStart * outRowsPerMcuRow - contextRows,
+                  endRow = mcuRows == stripEnd ? dstInfo.height()
+                                               : stripEnd * outRowsPerMcuRow - contextRows;
+
+        // Build a standalone jpeg from the original headers, with the height patched, and the
+        // strip's restart intervals renumbered from RST0.
+        const int64_t firstInterval = (int64_t)decodeStart * mcusPerRow / restartInterval,
+                      endInterval = mcuRows == decodeEnd
+                                  ? intervals : (int64_t)decodeEnd * mcusPerRow / restartInterval;
+        auto intervalStart = [&](int64_t n) {
+            return 0 == n ? layout.fScanOffset : layout.fRestartMarkers[n - 1] + 2;
+        };
+        auto intervalEnd = [&](int64_t n) {
+            return intervals - 1 == n ? layout.fScanEnd : layout.fRestartMarkers[n];
+        };
+
+        std::vector<uint8_t> strip(data, data + layout.fScanOffset);
+        strip.reserve(layout.fScanOffset + intervalEnd(endInterval - 1)
+                                         - intervalStart(firstInterval) + 2);
+        const int stripHeight = mcuRows == decodeEnd ? height - decodeStart * mcuHeight
+                                                     : (decodeEnd - decodeStart) * mcuHeight;
+        strip[layout.fSOFHeightOffset + 0] = SkToU8(stripHeight >> 8);
+        strip[layout.fSOFHeightOffset + 1] = SkToU8(stripHeight & 0xFF);
+        for (int64_t n = firstInterval; n < endInterval; n++) {
+            if (n > firstInterval) {
+                strip.push_back(0xFF);
+                strip.push_back(SkToU8(JPEG_RST0 + ((n - firstInterval - 1) & 7)));
+            }
+            strip.insert(strip.end(), data + intervalStart(n), data + intervalEnd(n));
+        }
+        strip.push_back(0xFF);
+        strip.push_back(JPEG_EOI);
+
+        // Owned out here, since a libjpeg error longjmps out of decodeRestartStrip().
+        SkAutoTMalloc<uint32_t> row(dstInfo.width());
+        if (!this->decodeRestartStrip(strip.data(), strip.size(), decodeStart * outRowsPerMcuRow,
+                                      writeRow, endRow, dstInfo, dst, rowBytes, row.get())) {
+            failed = true;
+        }
+    });
+    tg.wait();
+
+    return !failed;
+}
+
+bool SkJpegCodec::decodeRestartStrip(const void* strip, size_t length, int firstRow,
+                                     int writeRow, int endRow, const SkImageInfo& dstInfo,
+                                     void* dst, size_t rowBytes, uint32_t* row) const {
+    SkMemoryStream stream(strip, length, /*copyData=*/false);
+    JpegDecoderMgr decoderMgr(&stream);
+
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(decoderMgr.errorMgr());
+    if (setjmp(jmp)) {
+        return decoderMgr.returnFalse("decodeRestartStrip");
+    }
+
+    decoderMgr.init();
+    jpeg_decompress_struct* dinfo = decoderMgr.dinfo();
+    if (JPEG_HEADER_OK != jpeg_read_header(dinfo, true)) {
+        return false;
+    }
+
+    // Decode to the same format and scale as the serial decode would.
+    const jpeg_decompress_struct* imageInfo = fDecoderMgr->dinfo();
+    dinfo->out_color_space = imageInfo->out_color_space;
+    dinfo->dither_mode = imageInfo->dither_mode;
+    dinfo->scale_num = imageInfo->scale_num;
+    dinfo->scale_denom = imageInfo->scale_denom;
+    if (!jpeg_start_decompress(dinfo)) {
+        return false;
+    }
+    if ((int)dinfo->output_width != dstInfo.width() ||
+        (int)dinfo->output_height < endRow - firstRow ||
+        get_row_bytes(dinfo) > sizeof(uint32_t) * dstInfo.width()) {
+        return false;
+    }
+
+    // Rows above writeRow are only decoded for context.  As in readRows(), the color xform reads
+    // from a separate row when dst is not 32-bit.
+    const bool xformFromRow = this->colorXform() && sizeof(uint32_t) != dstInfo.bytesPerPixel();
+    for (int y = firstRow; y < endRow; y++) {
+        void* dstRow = SkTAddOffset<void>(dst, rowBytes * y);
+        JSAMPLE* decodeDst = (y < writeRow || xformFromRow) ? reinterpret_cast<JSAMPLE*>(row)
+                                                            : static_cast<JSAMPLE*>(dstRow);
+        if (1 != jpeg_read_scanlines(dinfo, &decodeDst, 1)) {
+            return false;
+        }
+        if (y >= writeRow && this->colorXform()) {
+            this->applyColorXform(dstRow, decodeDst, dstInfo.width());
+        }
+    }
+    return true;
+}
+
 /*
  * Performs the jpeg decode
  */
@@ -554,6 +816,11 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
     }
 
+    if (options.fExecutor &&
+        this->decodeRestartIntervalsInParallel(dstInfo, dst, dstRowBytes, options)) {
+        return kSuccess;
+    }
+
     if (!jpeg_start_decompress(dinfo)) {
         return fDecoderMgr->returnFailure("startDecompress", kInvalidInput);
     }
@@ -123,6 +123,23 @@ private:
     bool SK_WARN_UNUSED_RESULT allocateStorage(const SkImageInfo& dstInfo);
     int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&);
 
+    /*
+     * Decodes strips of restart intervals on options.fExecutor, each with its own decompressor.
+     * Returns false if the image cannot be split this way or if any strip fails, in which case
+     * the caller should decode serially.
+     */
+    bool decodeRestartIntervalsInParallel(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                          const Options&);
+
+    /*
+     * Decodes output rows [firstRow, endRow) of the standalone jpeg strip, which starts at row
+     * firstRow of the image, and writes rows [writeRow, endRow) to dst. row is scratch space for
+     * dstInfo.width() 32-bit pixels.
+     */
+    bool decodeRestartStrip(const void* strip, size_t length, int firstRow, int writeRow,
+                            int endRow, const SkImageInfo& dstInfo, void* dst,
+                            size_t rowBytes, uint32_t* row) const;
+
     /*
      * Scanline decoding.
      */
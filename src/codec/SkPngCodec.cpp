@@ -487,8 +487,8 @@ void SkPngCodec::applyXformRow(void* dst, const void* src) {
             this->applyColorXform(dst, src, fXformWidth);
             break;
         case kSwizzleColor_XformMode:
-            fSwizzler->swizzle(fColorXformSrcRow, (const uint8_t*) src);
-            this->applyColorXform(dst, fColorXformSrcRow, fXformWidth);
+            this->applySwizzleAndColorXform(fSwizzler.get(), dst, fColorXformSrcRow,
+                                            (const uint8_t*) src);
             break;
     }
 }
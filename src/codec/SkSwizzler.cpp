@@ -1246,3 +1246,10 @@ void SkSwizzler::swizzle(void* dst, const uint8_t* SK_RESTRICT src) {
     fActualProc(SkTAddOffset<void>(dst, fDstOffsetBytes), src, fSwizzleWidth, fSrcBPP,
             fSampleX * fSrcBPP, fSrcOffsetUnits, fColorTable);
 }
+
+void SkSwizzler::swizzleRange(void* dst, const uint8_t* SK_RESTRICT src, int x, int count) {
+    SkASSERT(nullptr != dst && nullptr != src);
+    SkASSERT(0 <= x && 0 <= count && x + count <= fSwizzleWidth);
+    const int deltaSrc = fSampleX * fSrcBPP;
+    fActualProc(dst, src, count, fSrcBPP, deltaSrc, fSrcOffsetUnits + x * deltaSrc, fColorTable);
+}
@@ -69,6 +69,13 @@ public:
      */
     void swizzle(void* dst, const uint8_t* SK_RESTRICT src);
 
+    /**
+     *  Swizzle |count| pixels of a line, starting with the |x|'th pixel that swizzle() would
+     *  write.  Unlike swizzle(), this writes to the start of |dst|, ignoring any frame offset.
+     *  This lets a caller convert a line in chunks that stay in cache.
+     */
+    void swizzleRange(void* dst, const uint8_t* SK_RESTRICT src, int x, int count);
+
     int fillWidth() const override {
         return fAllocatedWidth;
     }
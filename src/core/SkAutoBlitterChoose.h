@@ -39,6 +39,7 @@ public:
         fBlitter = SkBlitter::Choose(draw.fDst, *matrixProvider, paint, &fAlloc, drawCoverage,
                                      draw.fRC->clipShader(),
                                      SkSurfacePropsCopyOrDefault(draw.fProps));
+        fBlitter = draw.clipBlitter(fBlitter, &fAlloc);
         return fBlitter;
     }
 
@@ -9,7 +9,7 @@
 #include "src/core/SkRTree.h"
 
 sk_sp<SkBBoxHierarchy> SkRTreeFactory::operator()() const {
-    return sk_make_sp<SkRTree>();
+    return sk_make_sp<SkRTree>(fExecutor);
 }
 
 void SkBBoxHierarchy::insert(const SkRect rects[], const Metadata[], int N) {
@@ -15,12 +15,14 @@ SkBigPicture::SkBigPicture(const SkRect& cull,
                            sk_sp<SkRecord> record,
                            std::unique_ptr<SnapshotArray> drawablePicts,
                            sk_sp<SkBBoxHierarchy> bbh,
-                           size_t approxBytesUsedBySubPictures)
+                           size_t approxBytesUsedBySubPictures,
+                           bool contentInterned)
     : fCullRect(cull)
     , fApproxBytesUsedBySubPictures(approxBytesUsedBySubPictures)
     , fRecord(std::move(record))
     , fDrawablePicts(std::move(drawablePicts))
     , fBBH(std::move(bbh))
+    , fContentInterned(contentInterned)
 {}
 
 void SkBigPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
@@ -38,6 +40,19 @@ void SkBigPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
                  callback);
 }
 
+void SkBigPicture::indexedPlayback(SkCanvas* canvas,
+                                   const std::function<void(int)>& beforeOp) const {
+    SkASSERT(canvas);
+    SkAutoCanvasRestore saveRestore(canvas, true /*save now, restore at exit*/);
+
+    SkRecords::Draw draw(canvas, this->drawablePicts(), nullptr, this->drawableCount());
+    for (int i = 0; i < fRecord->count(); i++) {
+        beforeOp(i);
+        fRecord->visit(i, draw);
+    }
+    beforeOp(fRecord->count());
+}
+
 void SkBigPicture::partialPlayback(SkCanvas* canvas,
                                    int start,
                                    int stop,
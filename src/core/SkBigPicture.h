@@ -15,6 +15,8 @@
 #include "include/private/SkOnce.h"
 #include "include/private/SkTemplates.h"
 
+#include <functional>
+
 class SkBBoxHierarchy;
 class SkMatrix;
 class SkRecord;
@@ -41,7 +43,8 @@ public:
                  sk_sp<SkRecord>,
                  std::unique_ptr<SnapshotArray>,
                  sk_sp<SkBBoxHierarchy>,
-                 size_t approxBytesUsedBySubPictures);
+                 size_t approxBytesUsedBySubPictures,
+                 bool contentInterned = false);
 
 
 // SkPicture overrides
@@ -56,10 +59,17 @@ public:
                          int start,
                          int stop,
                          const SkM44& initialCTM) const;
+// Used by SkPicture::backport() to build an op index.  Draws every op like playback() does
+// without a BBH, calling beforeOp(i) before drawing op i, and beforeOp(count) after the last.
+    void indexedPlayback(SkCanvas*, const std::function<void(int)>& beforeOp) const;
+
 // Used by GrRecordReplaceDraw
     const SkBBoxHierarchy* bbh() const { return fBBH.get(); }
     const SkRecord*     record() const { return fRecord.get(); }
 
+// Used by SkPicture::backport() to dedupe paints only for pictures that opted into interning.
+    bool contentInterned() const { return fContentInterned; }
+
 private:
     int drawableCount() const;
     SkPicture const* const* drawablePicts() const;
@@ -69,6 +79,7 @@ private:
     sk_sp<const SkRecord>                fRecord;
     std::unique_ptr<const SnapshotArray> fDrawablePicts;
     sk_sp<const SkBBoxHierarchy>         fBBH;
+    const bool                           fContentInterned;
 };
 
 #endif//SkBigPicture_DEFINED
@@ -20,6 +20,7 @@
 #include "src/core/SkDraw.h"
 #include "src/core/SkImageFilterCache.h"
 #include "src/core/SkImageFilter_Base.h"
+#include "src/core/SkLayerPixelPool.h"
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkStrikeCache.h"
@@ -58,6 +59,8 @@ class SkDrawTiler {
     // fCurr... are only used if fNeedTiling
     SkTLazy<SkPostTranslateMatrixProvider> fTileMatrixProvider;
     SkRasterClip                           fTileRC;
+    SkIRect                                fDeviceBlitClip;
+    SkIRect                                fTileBlitClip;
     SkIPoint                               fOrigin;
 
     bool            fDone, fNeedsTiling;
@@ -109,6 +112,7 @@ public:
         if (fNeedsTiling) {
             // fDraw.fDst and fMatrixProvider are reset each time in setupTileDraw()
             fDraw.fRC = &fTileRC;
+            fDraw.fBlitClip = dev->deviceBlitClip(&fDeviceBlitClip) ? &fTileBlitClip : nullptr;
             // we'll step/increase it before using it
             fOrigin.set(fSrcBounds.fLeft - kMaxDim, fSrcBounds.fTop);
         } else {
@@ -116,6 +120,7 @@ public:
             fDraw.fDst = fRootPixmap;
             fDraw.fMatrixProvider = dev;
             fDraw.fRC = &dev->fRCStack.rc();
+            fDraw.fBlitClip = dev->deviceBlitClip(&fDeviceBlitClip);
             fOrigin.set(0, 0);
         }
 
@@ -172,6 +177,14 @@ private:
         fDevice->fRCStack.rc().translate(-fOrigin.x(), -fOrigin.y(), &fTileRC);
         fTileRC.op(SkIRect::MakeWH(fDraw.fDst.width(), fDraw.fDst.height()),
                    SkClipOp::kIntersect);
+
+        if (fDraw.fBlitClip) {
+            fTileBlitClip = fDeviceBlitClip.makeOffset(-fOrigin.x(), -fOrigin.y());
+            if (!fTileBlitClip.intersect(SkIRect::MakeWH(fDraw.fDst.width(),
+                                                         fDraw.fDst.height()))) {
+                fTileRC.setEmpty();  // Nothing to write in this tile.
+            }
+        }
     }
 };
 
@@ -196,7 +209,11 @@ public:
         }
         fMatrixProvider = dev;
         fRC = &dev->fRCStack.rc();
+        fBlitClip = dev->deviceBlitClip(&fDeviceBlitClip);
     }
+
+private:
+    SkIRect fDeviceBlitClip;
 };
 
 static bool valid_for_bitmap_device(const SkImageInfo& info,
@@ -237,7 +254,8 @@ SkBitmapDevice::SkBitmapDevice(const SkBitmap& bitmap, const SkSurfaceProps& sur
 
 SkBitmapDevice* SkBitmapDevice::Create(const SkImageInfo& origInfo,
                                        const SkSurfaceProps& surfaceProps,
-                                       SkRasterHandleAllocator* allocator) {
+                                       SkRasterHandleAllocator* allocator,
+                                       SkLayerPixelPool* pool) {
     SkAlphaType newAT = origInfo.alphaType();
     if (!valid_for_bitmap_device(origInfo, &newAT)) {
         return nullptr;
@@ -262,6 +280,10 @@ SkBitmapDevice* SkBitmapDevice::Create(const SkImageInfo& origInfo,
         if (!bitmap.tryAllocPixels(info)) {
             return nullptr;
         }
+    } else if (pool) {
+        if (!pool->allocPixels(info, &bitmap)) {
+            return nullptr;
+        }
     } else {
         // This bitmap has transparency, so we'll zero the pixels (to transparent).
         // We use the flag as a faster alloc-then-eraseColor(SK_ColorTRANSPARENT).
@@ -292,7 +314,35 @@ SkBaseDevice* SkBitmapDevice::onCreateDevice(const CreateInfo& cinfo, const SkPa
         info = info.makeColorType(kN32_SkColorType);
     }
 
-    return SkBitmapDevice::Create(info, surfaceProps, cinfo.fAllocator);
+    if (fLayerAllocator && !(layerPaint && layerPaint->getImageFilter())) {
+        SkAlphaType newAT;
+        if (!valid_for_bitmap_device(info, &newAT)) {
+            return nullptr;
+        }
+        SkBitmap bitmap;
+        if (!fLayerAllocator->allocLayer(info.makeAlphaType(newAT), &bitmap)) {
+            return nullptr;
+        }
+        auto device = new SkBitmapDevice(bitmap, surfaceProps);
+        device->setBlitClip(*fBlitClip, fLayerAllocator);
+        return device;
+    }
+
+    return SkBitmapDevice::Create(info, surfaceProps, cinfo.fAllocator, cinfo.fLayerPool);
+}
+
+const SkIRect* SkBitmapDevice::deviceBlitClip(SkIRect* storage) const {
+    if (!fBlitClip.isValid()) {
+        return nullptr;
+    }
+    // Layers without image filters are only ever translated from their parent device.
+    SkASSERT(this->isPixelAlignedToGlobal());
+    const SkIPoint origin = this->getOrigin();
+    *storage = fBlitClip->makeOffset(-origin.x(), -origin.y());
+    if (!storage->intersect(this->bounds())) {
+        storage->setEmpty();
+    }
+    return storage;
 }
 
 bool SkBitmapDevice::onAccessPixels(SkPixmap* pmap) {
@@ -401,6 +451,31 @@ static inline bool CanApplyDstMatrixAsCTM(const SkMatrix& m, const SkPaint& pain
     return m.getType() <= SkMatrix::kTranslate_Mask;
 }
 
+// If the draw minifies a lazy image that can be decoded natively at a reduced size (e.g. a JPEG),
+// fetch it at the smallest such size that still covers the draw and map src (in image coordinates)
+// into the scaled bitmap.
+static bool get_scaled_pixels(GrDirectContext* dContext, const SkImage* image, const SkRect* src,
+                              const SkRect& dst, const SkMatrix& ctm, SkBitmap* bitmap,
+                              SkRect* scaledSrc) {
+    if (!image->isLazyGenerated()) {
+        return false;
+    }
+    SkRect srcRect = src ? *src : SkRect::Make(image->bounds());
+    SkMatrix total = SkMatrix::Concat(ctm, SkMatrix::RectToRect(srcRect, dst));
+    SkSize scale;
+    if (!total.decomposeScale(&scale, nullptr) || scale.width() >= 1 || scale.height() >= 1) {
+        return false;
+    }
+    SkISize minSize = {sk_float_ceil2int(image->width()  * scale.width()),
+                       sk_float_ceil2int(image->height() * scale.height())};
+    if (minSize.isEmpty() || !as_IB(image)->getScaledROPixels(dContext, minSize, bitmap)) {
+        return false;
+    }
+    *scaledSrc = SkMatrix::Scale(SkIntToScalar(bitmap->width())  / image->width(),
+                                 SkIntToScalar(bitmap->height()) / image->height()).mapRect(srcRect);
+    return true;
+}
+
 void SkBitmapDevice::drawImageRect(const SkImage* image, const SkRect* src, const SkRect& dst,
                                    const SkSamplingOptions& sampling, const SkPaint& paint,
                                    SkCanvas::SrcRectConstraint constraint) {
@@ -408,9 +483,17 @@ void SkBitmapDevice::drawImageRect(const SkImage* image, const SkRect* src, cons
     SkASSERT(dst.isSorted());
 
     SkBitmap bitmap;
+    SkRect scaledSrc;
     // TODO: Elevate direct context requirement to public API and remove cheat.
     auto dContext = as_IB(image)->directContext();
-    if (!as_IB(image)->getROPixels(dContext, &bitmap)) {
+    // A reduced size decode blends texels across the edges of src, so only use it when the draw
+    // isn't constrained to src.
+    if ((!src || SkCanvas::kFast_SrcRectConstraint == constraint) &&
+        get_scaled_pixels(dContext, image, src, dst, this->localToDevice(), &bitmap, &scaledSrc)) {
+        if (src) {
+            src = &scaledSrc;
+        }
+    } else if (!as_IB(image)->getROPixels(dContext, &bitmap)) {
         return;
     }
 
@@ -584,6 +667,8 @@ void SkBitmapDevice::drawSpecial(SkSpecialImage* src,
         }
         draw.fMatrixProvider = &matrixProvider;
         draw.fRC = &fRCStack.rc();
+        SkIRect deviceBlitClip;
+        draw.fBlitClip = this->deviceBlitClip(&deviceBlitClip);
         draw.drawBitmap(resultBM, SkMatrix::I(), nullptr, sampling, paint);
     }
 }
@@ -19,8 +19,10 @@
 #include "src/core/SkGlyphRunPainter.h"
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkRasterClipStack.h"
+#include "src/core/SkTLazy.h"
 
 class SkImageFilterCache;
+class SkLayerPixelPool;
 class SkMatrix;
 class SkPaint;
 class SkPath;
@@ -59,7 +61,38 @@ public:
                    void* externalHandle = nullptr);
 
     static SkBitmapDevice* Create(const SkImageInfo&, const SkSurfaceProps&,
-                                  SkRasterHandleAllocator* = nullptr);
+                                  SkRasterHandleAllocator* = nullptr,
+                                  SkLayerPixelPool* = nullptr);
+
+    /**
+     *  Supplies the pixels of layers made by a device with a blit clip, so that devices drawing
+     *  disjoint parts of one bitmap can share each of their layers as well.
+     */
+    class LayerAllocator {
+    public:
+        virtual ~LayerAllocator() = default;
+
+        /**
+         *  Sets bitmap to the pixels for the layer being made, cleared to transparent. Every
+         *  device making the same layer must be given the same pixels. Returns false on failure.
+         */
+        virtual bool allocLayer(const SkImageInfo&, SkBitmap* bitmap) = 0;
+    };
+
+    /**
+     *  Limits the pixels this device's draws write to blitClip (in global space). Unlike a clip,
+     *  this doesn't change how anything is rasterized, so several devices sharing one bitmap can
+     *  each draw into a disjoint part of it and together produce exactly the same pixels as one
+     *  device drawing everywhere.
+     *
+     *  If layers is set, layers without an image filter take their pixels from it and are limited
+     *  to blitClip too. Other layers are private to this device and not limited, since filters
+     *  read pixels outside blitClip.
+     */
+    void setBlitClip(const SkIRect& blitClip, LayerAllocator* layers = nullptr) {
+        fBlitClip.init(blitClip);
+        fLayerAllocator = layers;
+    }
 
 protected:
     void* getRasterHandle() const override { return fRasterHandle; }
@@ -150,6 +183,9 @@ private:
 
     SkBaseDevice* onCreateDevice(const CreateInfo&, const SkPaint*) override;
 
+    // Returns fBlitClip mapped to device space (in storage), or null if there is no blit clip.
+    const SkIRect* deviceBlitClip(SkIRect* storage) const;
+
     sk_sp<SkSurface> makeSurface(const SkImageInfo&, const SkSurfaceProps&) override;
 
     SkImageFilterCache* getImageFilterCache() override;
@@ -158,6 +194,8 @@ private:
     void*       fRasterHandle = nullptr;
     SkRasterClipStack  fRCStack;
     SkGlyphRunListPainterCPU fGlyphPainter;
+    SkTLazy<SkIRect>   fBlitClip;
+    LayerAllocator*    fLayerAllocator = nullptr;
 
 
     using INHERITED = SkBaseDevice;
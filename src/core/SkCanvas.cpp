@@ -33,6 +33,7 @@
 #include "src/core/SkImageFilterCache.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkLatticeIter.h"
+#include "src/core/SkLayerPixelPool.h"
 #include "src/core/SkMSAN.h"
 #include "src/core/SkMatrixPriv.h"
 #include "src/core/SkMatrixUtils.h"
@@ -428,13 +429,14 @@ void SkCanvas::init(sk_sp<SkBaseDevice> device) {
     fQuickRejectBounds = this->computeDeviceClipBounds();
 }
 
-SkCanvas::SkCanvas() : fMCStack(sizeof(MCRec), fMCRecStorage, sizeof(fMCRecStorage)) {
+SkCanvas::SkCanvas()
+        : fMCStack(sizeof(MCRec), fMCRecStorage, sizeof(fMCRecStorage), kMCRecCount) {
     inc_canvas();
     this->init(nullptr);
 }
 
 SkCanvas::SkCanvas(int width, int height, const SkSurfaceProps* props)
-        : fMCStack(sizeof(MCRec), fMCRecStorage, sizeof(fMCRecStorage))
+        : fMCStack(sizeof(MCRec), fMCRecStorage, sizeof(fMCRecStorage), kMCRecCount)
         , fProps(SkSurfacePropsCopyOrDefault(props)) {
     inc_canvas();
     this->init(sk_make_sp<SkNoPixelsDevice>(
@@ -442,7 +444,7 @@ SkCanvas::SkCanvas(int width, int height, const SkSurfaceProps* props)
 }
 
 SkCanvas::SkCanvas(const SkIRect& bounds)
-        : fMCStack(sizeof(MCRec), fMCRecStorage, sizeof(fMCRecStorage)) {
+        : fMCStack(sizeof(MCRec), fMCRecStorage, sizeof(fMCRecStorage), kMCRecCount) {
     inc_canvas();
 
     SkIRect r = bounds.isEmpty() ? SkIRect::MakeEmpty() : bounds;
@@ -450,7 +452,7 @@ SkCanvas::SkCanvas(const SkIRect& bounds)
 }
 
 SkCanvas::SkCanvas(sk_sp<SkBaseDevice> device)
-        : fMCStack(sizeof(MCRec), fMCRecStorage, sizeof(fMCRecStorage))
+        : fMCStack(sizeof(MCRec), fMCRecStorage, sizeof(fMCRecStorage), kMCRecCount)
         , fProps(device->surfaceProps()) {
     inc_canvas();
 
@@ -458,7 +460,8 @@ SkCanvas::SkCanvas(sk_sp<SkBaseDevice> device)
 }
 
 SkCanvas::SkCanvas(const SkBitmap& bitmap, const SkSurfaceProps& props)
-        : fMCStack(sizeof(MCRec), fMCRecStorage, sizeof(fMCRecStorage)), fProps(props) {
+        : fMCStack(sizeof(MCRec), fMCRecStorage, sizeof(fMCRecStorage), kMCRecCount)
+        , fProps(props) {
     inc_canvas();
 
     sk_sp<SkBaseDevice> device(new SkBitmapDevice(bitmap, fProps));
@@ -469,7 +472,7 @@ SkCanvas::SkCanvas(const SkBitmap& bitmap,
                    std::unique_ptr<SkRasterHandleAllocator> alloc,
                    SkRasterHandleAllocator::Handle hndl,
                    const SkSurfaceProps* props)
-        : fMCStack(sizeof(MCRec), fMCRecStorage, sizeof(fMCRecStorage))
+        : fMCStack(sizeof(MCRec), fMCRecStorage, sizeof(fMCRecStorage), kMCRecCount)
         , fProps(SkSurfacePropsCopyOrDefault(props))
         , fAllocator(std::move(alloc)) {
     inc_canvas();
@@ -482,7 +485,7 @@ SkCanvas::SkCanvas(const SkBitmap& bitmap) : SkCanvas(bitmap, nullptr, nullptr,
 
 #ifdef SK_BUILD_FOR_ANDROID_FRAMEWORK
 SkCanvas::SkCanvas(const SkBitmap& bitmap, ColorBehavior)
-        : fMCStack(sizeof(MCRec), fMCRecStorage, sizeof(fMCRecStorage)) {
+        : fMCStack(sizeof(MCRec), fMCRecStorage, sizeof(fMCRecStorage), kMCRecCount) {
     inc_canvas();
 
     SkBitmap tmp(bitmap);
@@ -1130,8 +1133,15 @@ void SkCanvas::internalSaveLayer(const SaveLayerRec& rec, SaveLayerStrategy stra
         SkPixelGeometry geo = rec.fSaveLayerFlags & kPreserveLCDText_SaveLayerFlag
                                       ? fProps.pixelGeometry()
                                       : kUnknown_SkPixelGeometry;
-        const auto createInfo = SkBaseDevice::CreateInfo(info, geo, SkBaseDevice::kNever_TileUsage,
-                                                         fAllocator.get());
+        auto createInfo = SkBaseDevice::CreateInfo(info, geo, SkBaseDevice::kNever_TileUsage,
+                                                   fAllocator.get());
+        if (!fAllocator) {
+            // Raster layers recycle their pixels through fLayerPool; other devices ignore it.
+            if (!fLayerPool) {
+                fLayerPool = sk_make_sp<SkLayerPixelPool>();
+            }
+            createInfo.fLayerPool = fLayerPool.get();
+        }
         // Use the original paint as a hint so that it includes the image filter
         newDevice.reset(priorDevice->onCreateDevice(createInfo, rec.fPaint));
     }
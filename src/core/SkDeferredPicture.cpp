@@ -0,0 +1,130 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkDeferredPicture.h"
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkTextBlob.h"
+#include "include/core/SkVertices.h"
+#include "src/core/SkPictureData.h"
+#include "src/core/SkPicturePlayback.h"
+#include "src/core/SkRTree.h"
+#include "src/core/SkTraceEvent.h"
+
+#include <vector>
+
+#if SK_SUPPORT_GPU
+#include "include/private/chromium/Slug.h"
+#endif
+
+SkDeferredPicture::SkDeferredPicture(const SkRect& cull, std::unique_ptr<SkPictureData> data)
+    : fCullRect(cull)
+    , fData(std::move(data)) {
+    SkASSERT(fData && fData->opData());
+}
+
+SkDeferredPicture::~SkDeferredPicture() = default;
+
+bool SkDeferredPicture::decode() const {
+    fDecodeOnce([this] {
+        TRACE_EVENT0("skia", TRACE_FUNC);
+        fDecodedOK = fData->parseDeferredArrays();
+
+        const SkRect* bounds;
+        if (fDecodedOK && fData->readOpIndex(&fOffsets, &bounds, &fCount)) {
+            fBBH = sk_make_sp<SkRTree>();
+            fBBH->insert(bounds, fCount);
+        }
+    });
+    return fDecodedOK;
+}
+
+void SkDeferredPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
+    SkASSERT(canvas);
+    if (!this->decode()) {
+        return;
+    }
+    SkPicturePlayback playback(fData.get());
+
+    // Like SkBigPicture, if the query contains the whole picture, don't bother with the BBH.
+    const SkRect query = canvas->getLocalClipBounds();
+    if (!fBBH || query.contains(fCullRect)) {
+        playback.draw(canvas, callback, nullptr);
+        return;
+    }
+
+    std::vector<int> ops;
+    fBBH->search(query, &ops);
+
+    // Merge runs of consecutive ops into single ranges of the op stream.
+    std::vector<SkPicturePlayback::OpRange> ranges;
+    for (int op : ops) {
+        if (!ranges.empty() && ranges.back().fEnd == fOffsets[op]) {
+            ranges.back().fEnd = fOffsets[op + 1];
+        } else {
+            ranges.push_back({fOffsets[op], fOffsets[op + 1]});
+        }
+    }
+    playback.draw(canvas, SkSpan(ranges), callback);
+}
+
+int SkDeferredPicture::indexedOpCount() const {
+    return this->decode() ? fCount : 0;
+}
+
+bool SkDeferredPicture::partialPlayback(SkCanvas* canvas, int start, int stop,
+                                        AbortCallback* callback) const {
+    SkASSERT(canvas);
+    if (!this->decode() || !fOffsets || start < 0 || start > stop || stop > fCount) {
+        return false;
+    }
+    const SkPicturePlayback::OpRange range = {fOffsets[start], fOffsets[stop]};
+    SkPicturePlayback playback(fData.get());
+    playback.draw(canvas, SkSpan(&range, 1), callback);
+    return true;
+}
+
+int SkDeferredPicture::approximateOpCount(bool nested) const {
+    // Walk the op headers without decoding anything.  Each is 8 bits of op and 24 bits of size,
+    // the size of the op including that header.  Larger sizes spill into the following word,
+    // and then (see SkPictureRecord::addDraw()) are one more than the size without that word.
+    const sk_sp<SkData>& ops = fData->opData();
+    const size_t n = ops->size() / sizeof(uint32_t);
+    const uint32_t* words = static_cast<const uint32_t*>(ops->data());
+
+    int count = 0;
+    for (size_t i = 0; i < n; ++count) {
+        size_t size = words[i] & 0xffffff;
+        if (size == 0xffffff) {
+            if (i + 1 >= n) {
+                break;
+            }
+            size = (size_t)words[i + 1] - 1 + sizeof(uint32_t);
+        }
+        if (size == 0 || size % sizeof(uint32_t) != 0) {
+            break;
+        }
+        i += size / sizeof(uint32_t);
+    }
+
+    if (nested) {
+        // Approximate: counts each sub-picture once, however many times it's drawn.
+        for (const auto& pic : fData->pictures()) {
+            count += pic->approximateOpCount(true);
+        }
+    }
+    return count;
+}
+
+size_t SkDeferredPicture::approximateBytesUsed() const {
+    size_t bytes = sizeof(*this) + fData->opData()->size();
+    for (const auto& pic : fData->pictures()) {
+        bytes += pic->approximateBytesUsed();
+    }
+    return bytes;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkDeferredPicture_DEFINED
+#define SkDeferredPicture_DEFINED
+
+#include "include/core/SkPicture.h"
+#include "include/core/SkRect.h"
+#include "include/private/SkOnce.h"
+
+#include <memory>
+
+class SkBBoxHierarchy;
+class SkPictureData;
+
+// An SkPicture made by SkPicture::MakeFromDataDeferred().  Rather than being forwardported into
+// an SkRecord like other deserialized pictures, it plays its SkPictureData back directly, and
+// decodes that data's paints, paths, etc. on first playback.
+//
+// Pictures serialized with an op index (i.e. recorded with a BBH) can also seek: playback()
+// reads only the ops that intersect the canvas' clip, and partialPlayback() draws a range of ops.
+class SkDeferredPicture final : public SkPicture {
+public:
+    SkDeferredPicture(const SkRect& cull, std::unique_ptr<SkPictureData>);
+    ~SkDeferredPicture() override;
+
+// SkPicture overrides
+    void playback(SkCanvas*, AbortCallback*) const override;
+    SkRect cullRect() const override { return fCullRect; }
+    int approximateOpCount(bool nested) const override;
+    size_t approximateBytesUsed() const override;
+    const SkDeferredPicture* asSkDeferredPicture() const override { return this; }
+
+    // The number of ops in the op index, the ops of the SkRecord this picture was recorded
+    // from, or 0 if the picture has no op index.
+    int indexedOpCount() const;
+
+    // Draws indexed ops [start, stop) on top of the canvas' current state, like
+    // SkBigPicture::partialPlayback().  Any matrix, clip or save set by earlier ops is not
+    // replayed, so ranges should be chosen to start and end at balanced points.
+    // Returns false, drawing nothing, if the picture has no op index or the range is invalid.
+    bool partialPlayback(SkCanvas*, int start, int stop, AbortCallback* = nullptr) const;
+
+private:
+    // Returns false if the picture data turned out to be invalid.
+    bool decode() const;
+
+    const SkRect                         fCullRect;
+    const std::unique_ptr<SkPictureData> fData;
+    mutable SkOnce                       fDecodeOnce;
+    mutable bool                         fDecodedOK = false;
+
+    // Set by decode() if we have a valid op index.  fOffsets and fCount point into fData.
+    mutable sk_sp<SkBBoxHierarchy>       fBBH;
+    mutable const uint32_t*              fOffsets = nullptr;
+    mutable int                          fCount = 0;
+};
+
+#endif//SkDeferredPicture_DEFINED
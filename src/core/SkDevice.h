@@ -33,6 +33,7 @@ struct SkDrawShadowRec;
 class SkImageFilter;
 class SkImageFilterCache;
 struct SkIRect;
+class SkLayerPixelPool;
 class SkRasterHandleAllocator;
 class SkSpecialImage;
 
@@ -427,6 +428,8 @@ protected:
         const TileUsage          fTileUsage;
         const SkPixelGeometry    fPixelGeometry;
         SkRasterHandleAllocator* fAllocator = nullptr;
+        // If set, raster devices may take their pixels from here rather than allocating them.
+        SkLayerPixelPool*        fLayerPool = nullptr;
     };
 
     /**
@@ -39,6 +39,7 @@
 #include "src/core/SkTLazy.h"
 #include "src/core/SkUtils.h"
 
+#include <cstring>
 #include <utility>
 
 static SkPaint make_paint_with_image(const SkPaint& origPaint, const SkBitmap& bitmap,
@@ -51,10 +52,135 @@ static SkPaint make_paint_with_image(const SkPaint& origPaint, const SkBitmap& b
     return paint;
 }
 
+namespace {
+
+// Drops the parts of each blit outside a rect, like SkRectClipBlitter, but also keeps the pixels
+// it does write identical to those the wrapped blitter would write without it. Two pixel blits
+// that straddle the rect are the only case that needs care: SkBlitter splits them into
+// single pixel blitAntiH() calls, which some blitters blend with different rounding. Instead we
+// repeat the pair blit one pixel further inside the rect with zero coverage on the extra pixel,
+// and then put that pixel back. That pair lies entirely inside the rect, and pair blits write only
+// their own two pixels, so nothing outside the rect is touched; debug builds check the neighbours.
+class BlitClipBlitter final : public SkRectClipBlitter {
+public:
+    BlitClipBlitter(SkBlitter* blitter, const SkIRect& clip, const SkPixmap& dst)
+            : fBlitter(blitter)
+            , fClip(clip)
+            , fDst(dst) {
+        this->init(blitter, clip);
+    }
+
+    void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override {
+        const bool in0 = fClip.contains(x, y),
+                   in1 = fClip.contains(x + 1, y);
+        if (in0 && in1) {
+            fBlitter->blitAntiH2(x, y, a0, a1);
+        } else if (in0 && fClip.contains(x - 1, y)) {
+            this->replayInside(x - 1, y, 1, 0, x - 1, y,
+                               [&] { fBlitter->blitAntiH2(x - 1, y, 0, a0); });
+        } else if (in1 && fClip.contains(x + 2, y)) {
+            this->replayInside(x + 1, y, 1, 0, x + 2, y,
+                               [&] { fBlitter->blitAntiH2(x + 1, y, a1, 0); });
+        } else if (in0 || in1) {
+            this->INHERITED::blitAntiH2(x, y, a0, a1);  // The rect is a single pixel wide.
+        }
+    }
+
+    void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override {
+        const bool in0 = fClip.contains(x, y),
+                   in1 = fClip.contains(x, y + 1);
+        if (in0 && in1) {
+            fBlitter->blitAntiV2(x, y, a0, a1);
+        } else if (in0 && fClip.contains(x, y - 1)) {
+            this->replayInside(x, y - 1, 0, 1, x, y - 1,
+                               [&] { fBlitter->blitAntiV2(x, y - 1, 0, a0); });
+        } else if (in1 && fClip.contains(x, y + 2)) {
+            this->replayInside(x, y + 1, 0, 1, x, y + 2,
+                               [&] { fBlitter->blitAntiV2(x, y + 1, a1, 0); });
+        } else if (in0 || in1) {
+            this->INHERITED::blitAntiV2(x, y, a0, a1);  // The rect is a single pixel tall.
+        }
+    }
+
+    // SkRectClipBlitter turns a clipped edge column into an opaque blitV(), but no device blitter
+    // overrides blitAntiRect(), so without the clip that column would have gone through
+    // blitRect(), which can round differently. Split the rect like SkBlitter::blitAntiRect() does
+    // and clip each part instead.
+    void blitAntiRect(int x, int y, int width, int height,
+                      SkAlpha leftAlpha, SkAlpha rightAlpha) override {
+        if (leftAlpha > 0) {
+            this->blitV(x, y, height, leftAlpha);
+        }
+        if (width > 0) {
+            this->blitRect(x + 1, y, width, height);
+        }
+        if (rightAlpha > 0) {
+            this->blitV(x + width + 1, y, height, rightAlpha);
+        }
+    }
+
+    // Callers that write the returned pixels directly would bypass the clip.
+    const SkPixmap* justAnOpaqueColor(uint32_t*) override { return nullptr; }
+
+private:
+    // Runs blit, a pair blit of the pixels at (x, y) and (x + dx, y + dy), then restores the one
+    // at (keepX, keepY), to which it gave zero coverage.
+    template <typename Fn>
+    void replayInside(int x, int y, int dx, int dy, int keepX, int keepY, Fn&& blit) {
+        SkASSERT(fClip.contains(x, y) && fClip.contains(x + dx, y + dy));
+        const size_t bpp = fDst.info().bytesPerPixel();
+        uint8_t kept[16];
+        SkASSERT(bpp <= sizeof(kept));
+        void* keepAddr = fDst.writable_addr(keepX, keepY);
+        memcpy(kept, keepAddr, bpp);
+
+#ifdef SK_DEBUG
+        // The pixels just before and after the pair, where they are ours to read.
+        const SkIPoint neighbours[] = {{x - dx, y - dy}, {x + 2*dx, y + 2*dy}};
+        uint8_t before[2][16];
+        for (int i = 0; i < 2; i++) {
+            if (fClip.contains(neighbours[i].x(), neighbours[i].y())) {
+                memcpy(before[i], fDst.addr(neighbours[i].x(), neighbours[i].y()), bpp);
+            }
+        }
+#endif
+
+        blit();
+        memcpy(keepAddr, kept, bpp);
+
+#ifdef SK_DEBUG
+        for (int i = 0; i < 2; i++) {
+            if (fClip.contains(neighbours[i].x(), neighbours[i].y())) {
+                SkASSERT(!memcmp(before[i],
+                                 fDst.addr(neighbours[i].x(), neighbours[i].y()), bpp));
+            }
+        }
+#endif
+    }
+
+    SkBlitter*      fBlitter;
+    const SkIRect   fClip;
+    const SkPixmap& fDst;
+
+    using INHERITED = SkRectClipBlitter;
+};
+
+}  // namespace
+
 ///////////////////////////////////////////////////////////////////////////////
 
 SkDraw::SkDraw() {}
 
+SkBlitter* SkDraw::clipBlitter(SkBlitter* blitter, SkArenaAlloc* alloc) const {
+    if (!blitter || !fBlitClip) {
+        return blitter;
+    }
+    if (fBlitClip->isEmpty()) {
+        return alloc->make<SkNullBlitter>();
+    }
+    return alloc->make<BlitClipBlitter>(blitter, *fBlitClip, fDst);
+}
+
 bool SkDraw::computeConservativeLocalClipBounds(SkRect* localBounds) const {
     if (fRC->isEmpty()) {
         return false;
@@ -1105,6 +1231,7 @@ void SkDraw::drawBitmap(const SkBitmap& bitmap, const SkMatrix& prematrix,
             // blitter will be owned by the allocator.
             SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, *paint, pmap, ix, iy, &allocator,
                                                          fRC->clipShader());
+            blitter = this->clipBlitter(blitter, &allocator);
             if (blitter) {
                 SkScan::FillIRect(SkIRect::MakeXYWH(ix, iy, pmap.width(), pmap.height()),
                                   *fRC, blitter);
@@ -1167,6 +1294,7 @@ void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& ori
         SkSTArenaAlloc<kSkBlitterContextSize> allocator;
         SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, paint, pmap, x, y, &allocator,
                                                      fRC->clipShader());
+        blitter = this->clipBlitter(blitter, &allocator);
         if (blitter) {
             SkScan::FillIRect(bounds, *fRC, blitter);
             return;
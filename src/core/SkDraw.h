@@ -17,6 +17,7 @@
 #include "src/core/SkGlyphRunPainter.h"
 #include "src/core/SkMask.h"
 
+class SkArenaAlloc;
 class SkBitmap;
 class SkClipStack;
 class SkBaseDevice;
@@ -125,6 +126,13 @@ public:
     static RectType ComputeRectType(const SkRect&, const SkPaint&, const SkMatrix&,
                                     SkPoint* strokeSize);
 
+    /**
+     *  If fBlitClip is set, returns a blitter (allocated from alloc) that forwards to blitter
+     *  only the pixels inside fBlitClip; otherwise returns blitter unchanged. Returns null if
+     *  blitter is null.
+     */
+    SkBlitter* clipBlitter(SkBlitter* blitter, SkArenaAlloc* alloc) const;
+
 private:
 #if defined(SK_SUPPORT_LEGACY_ALPHA_BITMAP_AS_COVERAGE)
     void drawBitmapAsMask(const SkBitmap&, const SkSamplingOptions&, const SkPaint&) const;
@@ -168,6 +176,10 @@ public:
     const SkRasterClip*     fRC{nullptr};              // required
     const SkSurfaceProps*   fProps{nullptr};           // optional
 
+    // Optional, in the same space as fDst. Geometry is still rasterized against fRC, so the pixels
+    // written inside fBlitClip are exactly those a draw without it would write.
+    const SkIRect*          fBlitClip{nullptr};
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
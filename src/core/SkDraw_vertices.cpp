@@ -399,9 +399,10 @@ void SkDraw::drawFixedVertices(const SkVertices* vertices,
         shaderPaint.setShader(blendShader);
 
         if (!texCoords) {  // only tricolor shader
-            auto blitter = SkCreateRasterPipelineBlitter(fDst, shaderPaint, *fMatrixProvider,
-                                                         outerAlloc, this->fRC->clipShader(),
-                                                         props);
+            auto blitter = this->clipBlitter(
+                    SkCreateRasterPipelineBlitter(fDst, shaderPaint, *fMatrixProvider, outerAlloc,
+                                                  this->fRC->clipShader(), props),
+                    outerAlloc);
             if (!blitter) {
                 return false;
             }
@@ -438,8 +439,10 @@ void SkDraw::drawFixedVertices(const SkVertices* vertices,
                 }
             }
 
-            auto blitter = SkCreateRasterPipelineBlitter(
-                    fDst, shaderPaint, pipeline, isOpaque, outerAlloc, fRC->clipShader());
+            auto blitter = this->clipBlitter(
+                    SkCreateRasterPipelineBlitter(
+                            fDst, shaderPaint, pipeline, isOpaque, outerAlloc, fRC->clipShader()),
+                    outerAlloc);
             if (!blitter) {
                 return false;
             }
@@ -477,9 +480,10 @@ void SkDraw::drawFixedVertices(const SkVertices* vertices,
                 }
 
                 // It'd be nice if we could detect this will fail earlier.
-                auto blitter = SkCreateRasterPipelineBlitter(fDst, shaderPaint, *matrixProvider,
-                                                             &innerAlloc, this->fRC->clipShader(),
-                                                             props);
+                auto blitter = this->clipBlitter(
+                        SkCreateRasterPipelineBlitter(fDst, shaderPaint, *matrixProvider,
+                                                      &innerAlloc, this->fRC->clipShader(), props),
+                        &innerAlloc);
                 if (!blitter) {
                     return false;
                 }
@@ -505,8 +509,10 @@ void SkDraw::drawFixedVertices(const SkVertices* vertices,
 
         SkPaint shaderPaint{paint};
         shaderPaint.setShader(std::move(blenderShader));
-        auto blitter = SkVMBlitter::Make(
-                fDst, shaderPaint, *fMatrixProvider, outerAlloc, this->fRC->clipShader());
+        auto blitter = this->clipBlitter(
+                SkVMBlitter::Make(
+                        fDst, shaderPaint, *fMatrixProvider, outerAlloc, this->fRC->clipShader()),
+                outerAlloc);
         if (!blitter) {
             return;
         }
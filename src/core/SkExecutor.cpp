@@ -10,8 +10,12 @@
 #include "include/private/SkSemaphore.h"
 #include "include/private/SkSpinlock.h"
 #include "include/private/SkTArray.h"
+#include <atomic>
+#include <climits>
 #include <deque>
+#include <memory>
 #include <thread>
+#include <vector>
 
 #if defined(SK_BUILD_FOR_WIN)
     #include "src/core/SkLeanWindows.h"
@@ -139,6 +143,400 @@ private:
     bool                  fAllowBorrowing;
 };
 
+// A Chase-Lev work-stealing deque of Work pointers.
+// Only its owning thread may push() and pop(), both at the bottom; any thread may steal() from
+// the top.  None of these operations take a lock.
+//
+// See "Dynamic Circular Work-Stealing Deque" (Chase, Lev 2005) and, for the memory orderings,
+// "Correct and Efficient Work-Stealing for Weak Memory Models" (Le, Pop, Cohen, Zappa Nardelli).
+template <typename Work>
+class SkWorkStealingDeque {
+public:
+    SkWorkStealingDeque() : fRing(new Ring(kInitialCapacity)) { fRings.emplace_back(fRing.load()); }
+
+    void push(Work* work) {
+        int64_t b = fBottom.load(std::memory_order_relaxed),
+                t = fTop   .load(std::memory_order_acquire);
+        Ring* ring = fRing.load(std::memory_order_relaxed);
+        if (b - t >= ring->capacity()) {
+            ring = this->grow(ring, t, b);
+        }
+        ring->put(b, work);
+        std::atomic_thread_fence(std::memory_order_release);
+        fBottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    Work* pop() {
+        int64_t b = fBottom.load(std::memory_order_relaxed) - 1;
+        Ring* ring = fRing.load(std::memory_order_relaxed);
+        fBottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = fTop.load(std::memory_order_relaxed);
+
+        Work* work = nullptr;
+        if (t <= b) {
+            work = ring->get(b);
+            if (t == b) {
+                // Last item: race any thieves for it.
+                if (!fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                            std::memory_order_relaxed)) {
+                    work = nullptr;
+                }
+                fBottom.store(b + 1, std::memory_order_relaxed);
+            }
+        } else {
+            fBottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return work;
+    }
+
+    // Returns nullptr only if the deque was empty.  Losing a race for the top item means another
+    // thread took it, so we just try again for the next.
+    Work* steal() {
+        for (;;) {
+            int64_t t = fTop.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t b = fBottom.load(std::memory_order_acquire);
+            if (t >= b) {
+                return nullptr;
+            }
+            Work* work = fRing.load(std::memory_order_acquire)->get(t);
+            if (fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                       std::memory_order_relaxed)) {
+                return work;
+            }
+        }
+    }
+
+private:
+    static constexpr int64_t kInitialCapacity = 256;
+
+    class Ring {
+    public:
+        explicit Ring(int64_t capacity)
+            : fMask(capacity - 1)
+            , fSlots(new std::atomic<Work*>[capacity]) {
+            SkASSERT(SkIsPow2(capacity));
+        }
+
+        int64_t capacity() const { return fMask + 1; }
+
+        Work* get(int64_t i) const { return fSlots[i & fMask].load(std::memory_order_relaxed); }
+        void put(int64_t i, Work* w) { fSlots[i & fMask].store(w, std::memory_order_relaxed); }
+
+    private:
+        const int64_t                       fMask;
+        std::unique_ptr<std::atomic<Work*>[]> fSlots;
+    };
+
+    Ring* grow(Ring* old, int64_t t, int64_t b) {
+        Ring* ring = new Ring(2 * old->capacity());
+        for (int64_t i = t; i < b; i++) {
+            ring->put(i, old->get(i));
+        }
+        // Thieves may still be reading the old ring, so we keep every ring until we're destroyed.
+        fRings.emplace_back(ring);
+        fRing.store(ring, std::memory_order_release);
+        return ring;
+    }
+
+    std::atomic<int64_t>               fTop{0},
+                                       fBottom{0};
+    std::atomic<Ring*>                 fRing;
+    std::vector<std::unique_ptr<Ring>> fRings;  // Owned by the deque's thread.
+};
+
+// An SkWorkStealingPool is an executor that runs work on a fixed pool of OS threads, each with its
+// own SkWorkStealingDeque.  Work added by a pool thread goes on that thread's deque; work added
+// from elsewhere goes on a shared, locked injection queue.  fWorkAvailable counts work in all the
+// queues together, so a thread that acquires it is guaranteed to find (eventually) some work.
+// Idle threads, and the destructor waiting for work to drain, sleep on semaphores.
+class SkWorkStealingPool final : public SkExecutor {
+public:
+    explicit SkWorkStealingPool(int threads, bool allowBorrowing)
+            : fAllowBorrowing(allowBorrowing)
+            , fDeques(threads) {
+        for (int i = 0; i < threads; i++) {
+            fThreads.emplace_back(&Loop, this, i);
+        }
+    }
+
+    ~SkWorkStealingPool() override {
+        // Shutdown signals could be found ahead of real work in another queue, so first wait for
+        // all the work to run, including anything it adds as it goes.  Registering before checking
+        // fPending means whichever work finishes last will see us and signal.
+        fDraining.store(true);
+        while (fPending.load() > 0) {
+            fDrained.wait();
+        }
+        // Signal each thread that it's time to shut down.
+        for (int i = 0; i < fThreads.count(); i++) {
+            this->add(nullptr);
+        }
+        // Wait for each thread to shut down.
+        for (int i = 0; i < fThreads.count(); i++) {
+            fThreads[i].join();
+        }
+        SkASSERT(fInject.empty());
+    }
+
+    void add(std::function<void(void)> work) override {
+        if (work) {
+            fPending.fetch_add(1, std::memory_order_relaxed);
+        }
+        auto w = new Work(std::move(work));
+        if (tlsPool == this) {
+            fDeques[tlsIndex].push(w);
+        } else {
+            SkAutoMutexExclusive lock(fInjectLock);
+            fInject.push_back(w);
+        }
+        fAdded.fetch_add(1);
+        if (int starved = fStarved.load()) {
+            fWorkAdded.signal(starved);
+        }
+        fWorkAvailable.signal(1);
+    }
+
+    void borrow() override {
+        // If there is work waiting and we're allowed to borrow work, do it.
+        if (fAllowBorrowing && fWorkAvailable.try_wait()) {
+            SkAssertResult(this->do_work());
+        }
+    }
+
+private:
+    using Work = std::function<void(void)>;
+
+    // This method should be called only when fWorkAvailable indicates there's work to do.
+    bool do_work() {
+        std::unique_ptr<Work> work;
+        const int self = tlsPool == this ? tlsIndex : -1;
+        for (int attempt = 0;; attempt++) {
+            const uint32_t added = fAdded.load();
+            work.reset(this->find_work(self, attempt));
+            if (work) {
+                break;
+            }
+            // Work we were promised can only be missed if it was added after we looked in its
+            // queue, so sleep until more is added before looking again.
+            fStarved.fetch_add(1);
+            if (fAdded.load() == added) {
+                fWorkAdded.wait();
+            }
+            fStarved.fetch_sub(1);
+        }
+
+        if (!*work) {
+            return false;  // This is Loop()'s signal to shut down.
+        }
+
+        (*work)();
+        if (fPending.fetch_sub(1) == 1 && fDraining.load()) {
+            fDrained.signal(1);
+        }
+        return true;
+    }
+
+    // Our own deque first (most recently added, likely still in cache), then the injection queue,
+    // then steal from everyone else, starting at a different victim on each attempt.
+    Work* find_work(int self, int attempt) {
+        if (self >= 0) {
+            if (Work* w = fDeques[self].pop()) {
+                return w;
+            }
+        }
+        {
+            SkAutoMutexExclusive lock(fInjectLock);
+            if (!fInject.empty()) {
+                Work* w = fInject.front();
+                fInject.pop_front();
+                return w;
+            }
+        }
+        const int n = (int)fDeques.size();
+        for (int i = 0; i < n; i++) {
+            int victim = (self + 1 + attempt + i) % n;
+            if (victim == self) {
+                continue;
+            }
+            if (Work* w = fDeques[victim].steal()) {
+                return w;
+            }
+        }
+        return nullptr;
+    }
+
+    static void Loop(SkWorkStealingPool* pool, int index) {
+        tlsPool  = pool;
+        tlsIndex = index;
+        do {
+            pool->fWorkAvailable.wait();
+        } while (pool->do_work());
+    }
+
+    static thread_local SkWorkStealingPool* tlsPool;
+    static thread_local int                 tlsIndex;
+
+    SkTArray<std::thread>                   fThreads;
+    bool                                    fAllowBorrowing;
+    std::vector<SkWorkStealingDeque<Work>>  fDeques;
+    SkMutex                                 fInjectLock;
+    std::deque<Work*>                       fInject;
+    SkSemaphore                             fWorkAvailable;
+    std::atomic<uint32_t>                   fAdded{0};    // How much work has ever been added.
+    std::atomic<int>                        fStarved{0};  // Threads sleeping on fWorkAdded.
+    SkSemaphore                             fWorkAdded;
+    std::atomic<int>                        fPending{0};  // Work added but not yet finished.
+    std::atomic<bool>                       fDraining{false};  // Is the destructor waiting?
+    SkSemaphore                             fDrained;
+};
+
+thread_local SkWorkStealingPool* SkWorkStealingPool::tlsPool  = nullptr;
+thread_local int                 SkWorkStealingPool::tlsIndex = -1;
+
+// An SkDeterministicPool runs work on a fixed pool of OS threads such that which thread runs a
+// piece of work, and what that thread ran before it, depend only on the order work was added.
+// Each thread then makes the same calls in the same order every time, which is what a record/
+// replay runtime needs to replay it; nothing here depends on how fast any thread runs.
+//
+//   - Work added from outside the pool is dealt out round robin, in the order of a counter
+//     taken under an ordered lock, onto each thread's external queue.
+//   - Work added by a pool thread goes on that thread's own local queue, and only that thread
+//     ever runs it: when it is done with its current work, or while it waits in borrow().
+//   - A thread always empties its local queue before taking its next external work.
+//
+// Nothing is ever stolen, so a pool task may only wait for work it added itself, which it can
+// run while waiting; work added by any other thread might be queued behind the waiting task.
+// Threads outside the pool can't run anything, so they block until some work finishes.
+class SkDeterministicPool final : public SkExecutor {
+public:
+    explicit SkDeterministicPool(int threads)
+            : fAddLock("SkDeterministicPool.fAddLock")
+            , fWorkers(threads) {
+        for (int i = 0; i < threads; i++) {
+            fThreads.emplace_back(&Loop, this, i);
+        }
+    }
+
+    ~SkDeterministicPool() override {
+        // Queue one shutdown signal behind each thread's external work, then wait for them.
+        for (int i = 0; i < fThreads.count(); i++) {
+            this->addExternal(nullptr);
+        }
+        for (int i = 0; i < fThreads.count(); i++) {
+            fThreads[i].join();
+        }
+    }
+
+    void add(std::function<void(void)> work) override {
+        fPending.fetch_add(1);
+        if (tlsPool == this) {
+            fWorkers[tlsIndex].fLocal.push_back(std::move(work));
+        } else {
+            this->addExternal(std::move(work));
+        }
+    }
+
+    void borrow() override {
+        if (tlsPool == this) {
+            // A pool thread may only run its own local work; anything else would change which
+            // thread runs it.  Any work the caller added itself and hasn't run yet is there.
+            Worker* worker = &fWorkers[tlsIndex];
+            SkASSERTF(!worker->fLocal.empty(),
+                      "SkDeterministicPool tasks may only wait for work they added themselves.");
+            this->runLocal(worker, 1);
+            return;
+        }
+
+        // Registering before checking fPending means the finish of any work still pending
+        // will see us and signal.  (Both sequentially consistent, so one sees the other.)
+        fExternalWaiters.fetch_add(1);
+        if (fPending.load() > 0) {
+            fWorkFinished.wait();
+        }
+        fExternalWaiters.fetch_sub(1);
+    }
+
+    bool isDeterministic() const override { return true; }
+
+private:
+    using Work = std::function<void(void)>;
+
+    struct Worker {
+        std::deque<Work> fLocal;      // Only touched by this worker's thread.
+        SkMutex          fExternalLock;
+        std::deque<Work> fExternal SK_GUARDED_BY(fExternalLock);
+        SkSemaphore      fExternalAvailable;
+    };
+
+    void run(Work& work) {
+        work();
+        fPending.fetch_sub(1);
+        if (int waiters = fExternalWaiters.load()) {
+            fWorkFinished.signal(waiters);
+        }
+    }
+
+    void addExternal(Work work) {
+        Worker* worker;
+        {
+            SkAutoMutexExclusive lock(fAddLock);
+            worker = &fWorkers[fNextWorker];
+            fNextWorker = (fNextWorker + 1) % (int)fWorkers.size();
+
+            // Still holding fAddLock, so each worker sees its work in the order it was added.
+            SkAutoMutexExclusive workerLock(worker->fExternalLock);
+            worker->fExternal.push_back(std::move(work));
+        }
+        worker->fExternalAvailable.signal(1);
+    }
+
+    // Run up to max pieces of work from worker's local queue, oldest first.
+    void runLocal(Worker* worker, int max) {
+        for (int i = 0; i < max && !worker->fLocal.empty(); i++) {
+            Work work = std::move(worker->fLocal.front());
+            worker->fLocal.pop_front();
+            this->run(work);
+        }
+    }
+
+    static void Loop(SkDeterministicPool* pool, int index) {
+        tlsPool  = pool;
+        tlsIndex = index;
+        Worker* worker = &pool->fWorkers[index];
+        for (;;) {
+            pool->runLocal(worker, INT_MAX);
+
+            worker->fExternalAvailable.wait();
+            Work work;
+            {
+                SkAutoMutexExclusive lock(worker->fExternalLock);
+                work = std::move(worker->fExternal.front());
+                worker->fExternal.pop_front();
+            }
+            if (!work) {
+                return;  // Time to shut down.
+            }
+            pool->run(work);
+        }
+    }
+
+    static thread_local SkDeterministicPool* tlsPool;
+    static thread_local int                  tlsIndex;
+
+    SkTArray<std::thread> fThreads;
+    SkMutex               fAddLock;
+    int                   fNextWorker SK_GUARDED_BY(fAddLock) = 0;
+    std::vector<Worker>   fWorkers;
+    std::atomic<int>      fPending{0};          // Work added but not yet finished.
+    std::atomic<int>      fExternalWaiters{0};  // Threads outside the pool blocked in borrow().
+    SkSemaphore           fWorkFinished;
+};
+
+thread_local SkDeterministicPool* SkDeterministicPool::tlsPool  = nullptr;
+thread_local int                  SkDeterministicPool::tlsIndex = -1;
+
 std::unique_ptr<SkExecutor> SkExecutor::MakeFIFOThreadPool(int threads, bool allowBorrowing) {
     using WorkList = std::deque<std::function<void(void)>>;
     return std::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores(),
@@ -149,3 +547,10 @@ std::unique_ptr<SkExecutor> SkExecutor::MakeLIFOThreadPool(int threads, bool all
     return std::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores(),
                                                     allowBorrowing);
 }
+std::unique_ptr<SkExecutor> SkExecutor::MakeWorkStealingPool(int threads, bool allowBorrowing) {
+    return std::make_unique<SkWorkStealingPool>(threads > 0 ? threads : num_cores(),
+                                                allowBorrowing);
+}
+std::unique_ptr<SkExecutor> SkExecutor::MakeDeterministicPool(int threads) {
+    return std::make_unique<SkDeterministicPool>(threads > 0 ? threads : num_cores());
+}
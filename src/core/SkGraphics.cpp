@@ -27,6 +27,7 @@
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkTSearch.h"
 #include "src/core/SkTypefaceCache.h"
+#include "src/core/SkVMBlitter.h"
 
 #include <stdlib.h>
 
@@ -47,6 +48,7 @@ void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
     SkImageFilter_Base::PurgeCache();
+    SkVMBlitter::PurgeProgramCache();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -159,3 +161,23 @@ extern bool gSkVMAllowJIT;
 void SkGraphics::AllowJIT() {
     gSkVMAllowJIT = true;
 }
+
+size_t SkGraphics::GetVMProgramCacheTotalBytesUsed() {
+    return SkVMBlitter::GetProgramCacheBytesUsed();
+}
+
+size_t SkGraphics::GetVMProgramCacheTotalByteLimit() {
+    return SkVMBlitter::GetProgramCacheByteLimit();
+}
+
+size_t SkGraphics::SetVMProgramCacheTotalByteLimit(size_t newLimit) {
+    return SkVMBlitter::SetProgramCacheByteLimit(newLimit);
+}
+
+SkGraphics::VMProgramCacheStats SkGraphics::GetVMProgramCacheStats() {
+    return SkVMBlitter::GetProgramCacheStats();
+}
+
+void SkGraphics::SetVMProgramPersistentCache(VMProgramPersistentCache* cache) {
+    SkVMBlitter::SetProgramPersistentCache(cache);
+}
@@ -80,6 +80,15 @@ public:
         return fMap.count();
     }
 
+    // Removes the least recently used entry, returning its value. The cache must not be empty.
+    V removeLRU() {
+        Entry* entry = fLRU.tail();
+        SkASSERT(entry);
+        V value = std::move(entry->fValue);
+        this->remove(entry->fKey);
+        return value;
+    }
+
     template <typename Fn>  // f(K*, V*)
     void foreach(Fn&& fn) {
         typename SkTInternalLList<Entry>::Iter iter;
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkLayerPixelPool.h"
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkImageInfo.h"
+#include "include/private/SkMalloc.h"
+#include "include/private/SkTemplates.h"
+
+// Each block starts with a header recording its size, so ReleaseProc() knows what it's returning.
+// It's padded to keep the pixels as aligned as sk_malloc() would.
+static constexpr size_t kHeaderSize = 16;
+
+SkLayerPixelPool::~SkLayerPixelPool() {
+    // Every allocation holds a ref on the pool, so nothing can be recycled after this.
+    for (const Block& block : fRetained) {
+        sk_free(block.fAddr);
+    }
+}
+
+bool SkLayerPixelPool::allocPixels(const SkImageInfo& info, SkBitmap* bitmap) {
+    const size_t rowBytes = info.minRowBytes(),
+                 size     = info.computeByteSize(rowBytes);
+    if (SkImageInfo::ByteSizeOverflowed(size) || size > SIZE_MAX - kHeaderSize) {
+        return false;
+    }
+
+    Block block = {nullptr, 0};
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        int best = -1;
+        for (int i = 0; i < (int)fRetained.size(); i++) {
+            const size_t candidate = fRetained[i].fSize;
+            if (size <= candidate && candidate / 2 <= size &&
+                    (best < 0 || candidate < fRetained[best].fSize)) {
+                best = i;
+            }
+        }
+        if (best >= 0) {
+            block = fRetained[best];
+            fRetained.erase(fRetained.begin() + best);
+            fRetainedBytes -= block.fSize;
+        }
+    }
+
+    if (block.fAddr) {
+        sk_bzero(SkTAddOffset<void>(block.fAddr, kHeaderSize), size);
+    } else {
+        // Fresh memory comes zeroed from calloc(), which is often cheaper than clearing it.
+        block = {sk_calloc_canfail(size + kHeaderSize), size};
+        if (!block.fAddr) {
+            return false;
+        }
+    }
+    *static_cast<size_t*>(block.fAddr) = block.fSize;
+
+    this->ref();  // Balanced in ReleaseProc(), which installPixels() calls even if it fails.
+    return bitmap->installPixels(info, SkTAddOffset<void>(block.fAddr, kHeaderSize), rowBytes,
+                                 ReleaseProc, this);
+}
+
+void SkLayerPixelPool::ReleaseProc(void* addr, void* ctx) {
+    auto pool = sk_sp<SkLayerPixelPool>(static_cast<SkLayerPixelPool*>(ctx));
+    void* base = SkTAddOffset<void>(addr, -(ptrdiff_t)kHeaderSize);
+    pool->recycle({base, *static_cast<size_t*>(base)});
+}
+
+void SkLayerPixelPool::recycle(const Block& block) {
+    if (block.fSize > fBudget) {
+        sk_free(block.fAddr);
+        return;
+    }
+
+    SkAutoMutexExclusive lock(fMutex);
+    fRetained.push_back(block);
+    fRetainedBytes += block.fSize;
+
+    size_t evicted = 0;
+    while (fRetainedBytes > fBudget) {
+        sk_free(fRetained[evicted].fAddr);
+        fRetainedBytes -= fRetained[evicted].fSize;
+        evicted++;
+    }
+    fRetained.erase(fRetained.begin(), fRetained.begin() + evicted);
+}
+
+size_t SkLayerPixelPool::retainedBytes() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fRetainedBytes;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkLayerPixelPool_DEFINED
+#define SkLayerPixelPool_DEFINED
+
+#include "include/core/SkRefCnt.h"
+#include "include/private/SkMutex.h"
+
+#include <vector>
+
+class SkBitmap;
+struct SkImageInfo;
+
+// Recycles the pixel memory of raster saveLayer() devices.  An SkCanvas that makes many layers,
+// frame after frame, would otherwise malloc and zero a fresh backing store for each one.
+//
+// Each allocation is wrapped in its own pixel ref, so a layer's pixels can safely outlive the
+// layer (e.g. in an image filter cache): the memory only returns to the pool when the last ref
+// goes away, from any thread.  Returned memory is kept, oldest first, up to a byte budget.
+class SkLayerPixelPool : public SkRefCnt {
+public:
+    static constexpr size_t kDefaultBudget = 16 << 20;
+
+    explicit SkLayerPixelPool(size_t budget = kDefaultBudget) : fBudget(budget) {}
+    ~SkLayerPixelPool() override;
+
+    // Installs pixels for info into bitmap, cleared to zero (i.e. transparent).  Reuses retained
+    // memory that's big enough, but no more than twice as big, so small layers don't pin large
+    // blocks.  Returns false if the memory can't be allocated.
+    bool allocPixels(const SkImageInfo& info, SkBitmap* bitmap);
+
+    size_t retainedBytes() const;
+
+private:
+    struct Block {
+        void*  fAddr;
+        size_t fSize;
+    };
+
+    static void ReleaseProc(void* addr, void* ctx);
+    void recycle(const Block&);
+
+    const size_t       fBudget;
+    mutable SkMutex    fMutex;
+    std::vector<Block> fRetained      SK_GUARDED_BY(fMutex);  // Oldest first.
+    size_t             fRetainedBytes SK_GUARDED_BY(fMutex) = 0;
+};
+
+#endif
@@ -14,6 +14,8 @@
 #include "src/core/SkMipmapAccessor.h"
 #include "src/image/SkImage_Base.h"
 
+#include <cmath>
+
 // Try to load from the base image, or from the cache
 static sk_sp<const SkMipmap> try_load_mips(const SkImage_Base* image) {
     sk_sp<const SkMipmap> mips = image->refMips();
@@ -27,7 +29,7 @@ static sk_sp<const SkMipmap> try_load_mips(const SkImage_Base* image) {
 }
 
 SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& inv,
-                                   SkMipmapMode requestedMode) {
+                                   SkMipmapMode requestedMode, bool allowScaledDecode) {
     SkMipmapMode resolvedMode = requestedMode;
     fLowerWeight = 0;
 
@@ -40,13 +42,31 @@ SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& in
         }
     };
 
+    // Lazy images that can decode natively at a reduced size (e.g. JPEG DCT scaling) don't need
+    // to be decoded at full size when the draw only samples them at (sx, sy).
+    auto load_upper_scaled = [&](float sx, float sy) {
+        SkISize minSize = {sk_float_ceil2int(image->width()  * sx),
+                           sk_float_ceil2int(image->height() * sy)};
+        if (!allowScaledDecode || minSize.isEmpty()) {
+            return false;
+        }
+        auto dContext = as_IB(image)->directContext();
+        if (!image->getScaledROPixels(dContext, minSize, &fBaseStorage)) {
+            return false;
+        }
+        fUpper.reset(fBaseStorage.info(), fBaseStorage.getPixels(), fBaseStorage.rowBytes());
+        return true;
+    };
+
+    SkSize invScale;
+    const bool hasScale = inv.decomposeScale(&invScale, nullptr);
+
     float level = 0;
     if (requestedMode != SkMipmapMode::kNone) {
-        SkSize scale;
-        if (!inv.decomposeScale(&scale, nullptr)) {
+        if (!hasScale) {
             resolvedMode = SkMipmapMode::kNone;
         } else {
-            level = SkMipmap::ComputeLevel({1/scale.width(), 1/scale.height()});
+            level = SkMipmap::ComputeLevel({1/invScale.width(), 1/invScale.height()});
             if (level <= 0) {
                 resolvedMode = SkMipmapMode::kNone;
                 level = 0;
@@ -66,6 +86,18 @@ SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& in
     float lowerWeight = level - levelNum;   // fract(level)
     SkASSERT(levelNum >= 0);
 
+    if (resolvedMode == SkMipmapMode::kNone && hasScale &&
+        invScale.width() > 1 && invScale.height() > 1) {
+        load_upper_scaled(1/invScale.width(), 1/invScale.height());
+    } else if (resolvedMode == SkMipmapMode::kNearest && levelNum > 0) {
+        // Decoding at the chosen level's size stands in for that level of the mip chain.
+        float levelScale = std::ldexp(1.0f, -levelNum);
+        if (load_upper_scaled(levelScale, levelScale)) {
+            levelNum = 0;
+            resolvedMode = SkMipmapMode::kNone;
+        }
+    }
+
     if (levelNum == 0) {
         load_upper_from_base();
     }
@@ -103,8 +135,9 @@ SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& in
 }
 
 SkMipmapAccessor* SkMipmapAccessor::Make(SkArenaAlloc* alloc, const SkImage* image,
-                                         const SkMatrix& inv, SkMipmapMode mipmap) {
-    auto* access = alloc->make<SkMipmapAccessor>(as_IB(image), inv, mipmap);
+                                         const SkMatrix& inv, SkMipmapMode mipmap,
+                                         bool allowScaledDecode) {
+    auto* access = alloc->make<SkMipmapAccessor>(as_IB(image), inv, mipmap, allowScaledDecode);
     // return null if we failed to get the level (so the caller won't try to use it)
     return access->fUpper.addr() ? access : nullptr;
 }
@@ -18,8 +18,11 @@ class SkImage_Base;
 
 class SkMipmapAccessor : ::SkNoncopyable {
 public:
-    // Returns null on failure
-    static SkMipmapAccessor* Make(SkArenaAlloc*, const SkImage*, const SkMatrix& inv, SkMipmapMode);
+    // Returns null on failure. If allowScaledDecode is true, a lazy image that is minified by inv
+    // may be decoded at a reduced size instead of at its full resolution; callers that will later
+    // sample with a different matrix than inv (e.g. through SkTransformShader) must pass false.
+    static SkMipmapAccessor* Make(SkArenaAlloc*, const SkImage*, const SkMatrix& inv, SkMipmapMode,
+                                  bool allowScaledDecode = true);
 
     std::pair<SkPixmap, SkMatrix> level() const {
         SkASSERT(fUpper.addr() != nullptr);
@@ -47,7 +50,8 @@ private:
 
 public:
     // Don't call publicly -- this is only public for SkArenaAlloc to access it inside Make()
-    SkMipmapAccessor(const SkImage_Base*, const SkMatrix& inv, SkMipmapMode requestedMode);
+    SkMipmapAccessor(const SkImage_Base*, const SkMatrix& inv, SkMipmapMode requestedMode,
+                     bool allowScaledDecode);
 };
 
 #endif
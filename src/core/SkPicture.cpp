@@ -7,19 +7,28 @@
 
 #include "include/core/SkPicture.h"
 
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkSerialProcs.h"
+#include "include/private/SkTHash.h"
 #include "include/private/SkTo.h"
+#include "src/core/SkBigPicture.h"
 #include "src/core/SkCanvasPriv.h"
+#include "src/core/SkDeferredPicture.h"
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkPictureData.h"
 #include "src/core/SkPicturePlayback.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkPictureRecord.h"
+#include "src/core/SkRecordDraw.h"
 #include "src/core/SkRecordReplay.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkTaskGroup.h"
+
 #include <atomic>
+#include <vector>
 
 #if SK_SUPPORT_GPU
 #include "include/private/chromium/Slug.h"
@@ -141,14 +150,22 @@ sk_sp<SkPicture> SkPicture::Forwardport(const SkPictInfo& info,
     if (!data->opData()) {
         return nullptr;
     }
+    // Pictures serialized with an op index were recorded with a BBH, so keep one.
+    const uint32_t* offsets;
+    const SkRect* bounds;
+    int count;
+    SkRTreeFactory factory;
+    const bool hasBBH = data->readOpIndex(&offsets, &bounds, &count);
+
     SkPicturePlayback playback(data);
     SkPictureRecorder r;
-    playback.draw(r.beginRecording(info.fCullRect), nullptr/*no callback*/, buffer);
+    playback.draw(r.beginRecording(info.fCullRect, hasBBH ? &factory : nullptr),
+                  nullptr/*no callback*/, buffer);
     return r.finishRecordingAsPicture();
 }
 
 sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkDeserialProcs* procs) {
-    return MakeFromStream(stream, procs, nullptr);
+    return MakeFromStream(stream, procs, nullptr, nullptr);
 }
 
 sk_sp<SkPicture> SkPicture::MakeFromData(const void* data, size_t size,
@@ -157,7 +174,7 @@ sk_sp<SkPicture> SkPicture::MakeFromData(const void* data, size_t size,
         return nullptr;
     }
     SkMemoryStream stream(data, size);
-    return MakeFromStream(&stream, procs, nullptr);
+    return MakeFromStream(&stream, procs, nullptr, nullptr);
 }
 
 sk_sp<SkPicture> SkPicture::MakeFromData(const SkData* data, const SkDeserialProcs* procs) {
@@ -165,11 +182,21 @@ sk_sp<SkPicture> SkPicture::MakeFromData(const SkData* data, const SkDeserialPro
         return nullptr;
     }
     SkMemoryStream stream(data->data(), data->size());
-    return MakeFromStream(&stream, procs, nullptr);
+    return MakeFromStream(&stream, procs, nullptr, nullptr);
+}
+
+sk_sp<SkPicture> SkPicture::MakeFromDataDeferred(sk_sp<SkData> data,
+                                                 const SkDeserialProcs* procs) {
+    if (!data) {
+        return nullptr;
+    }
+    SkMemoryStream stream(data);
+    return MakeFromStream(&stream, procs, nullptr, std::move(data));
 }
 
 sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkDeserialProcs* procsPtr,
-                                           SkTypefacePlayback* typefaces) {
+                                           SkTypefacePlayback* typefaces,
+                                           sk_sp<SkData> deferredBacking) {
     SkPictInfo info;
     if (!StreamIsSKP(stream, &info)) {
         return nullptr;
@@ -184,8 +211,16 @@ sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkDeserialPro
     if (!stream->readU8(&trailingStreamByteAfterPictInfo)) { return nullptr; }
     switch (trailingStreamByteAfterPictInfo) {
         case kPictureData_TrailingStreamByteAfterPictInfo: {
+            const bool deferred = deferredBacking != nullptr;
             std::unique_ptr<SkPictureData> data(
-                    SkPictureData::CreateFromStream(stream, info, procs, typefaces));
+                    SkPictureData::CreateFromStream(stream, info, procs, typefaces,
+                                                    std::move(deferredBacking)));
+            if (deferred) {
+                if (!data || !data->opData()) {
+                    return nullptr;
+                }
+                return sk_make_sp<SkDeferredPicture>(info.fCullRect, std::move(data));
+            }
             return Forwardport(info, data.get(), nullptr);
         }
         case kCustom_TrailingStreamByteAfterPictInfo: {
@@ -231,7 +266,33 @@ sk_sp<SkPicture> SkPicturePriv::MakeFromBuffer(SkReadBuffer& buffer) {
 
 SkPictureData* SkPicture::backport() const {
     SkPictInfo info = this->createHeader();
-    SkPictureRecord rec(info.fCullRect.roundOut(), 0/*flags*/);
+    const SkBigPicture* big = this->asSkBigPicture();
+    SkPictureRecord rec(info.fCullRect.roundOut(),
+                        big && big->contentInterned() ? SkPictureRecord::kDedupPaints_RecordFlag
+                                                      : 0);
+
+    // Pictures recorded with a BBH get an op index, so their deserialized forms can seek to
+    // ops by index or by bounds without decoding everything before them.
+    if (big && big->bbh()) {
+        const SkRecord& record = *big->record();
+        std::vector<uint32_t> offsets;
+        offsets.reserve(record.count() + 1);
+
+        rec.beginRecording();
+            big->indexedPlayback(&rec, [&](int) {
+                offsets.push_back(SkToU32(rec.writeStream().bytesWritten()));
+            });
+        rec.endRecording();
+
+        SkAutoTMalloc<SkRect> bounds(record.count());
+        SkAutoTMalloc<SkBBoxHierarchy::Metadata> meta(record.count());
+        SkRecordFillBounds(this->cullRect(), record, bounds, meta);
+
+        auto data = new SkPictureData(rec, info);
+        data->setOpIndex(offsets.data(), bounds, record.count());
+        return data;
+    }
+
     rec.beginRecording();
         this->playback(&rec);
     rec.endRecording();
@@ -307,6 +368,177 @@ void SkPicture::serialize(SkWStream* stream, const SkSerialProcs* procsPtr,
     }
 }
 
+namespace {
+// Encodes the images and typefaces a picture serializes ahead of time, in parallel, then hands
+// the results to an otherwise ordinary serialization pass.  A first, throwaway pass finds them.
+class PreEncoder {
+public:
+    explicit PreEncoder(const SkSerialProcs& procs) : fProcs(procs) {}
+
+    // These procs just note each image and typeface serialized.
+    SkSerialProcs collectProcs() {
+        SkSerialProcs procs;
+        procs.fImageProc = [](SkImage* image, void* ctx) {
+            static_cast<PreEncoder*>(ctx)->fImages.add(image);
+            return SkData::MakeEmpty();
+        };
+        procs.fImageCtx = this;
+        procs.fTypefaceProc = [](SkTypeface* typeface, void* ctx) {
+            static_cast<PreEncoder*>(ctx)->fTypefaces.add(typeface);
+            return SkData::MakeEmpty();
+        };
+        procs.fTypefaceCtx = this;
+        this->setPictureProc(&procs);
+        return procs;
+    }
+
+    void encode(SkExecutor* executor) {
+        auto encodeImage = [this](int i) {
+            SkImage* image = fImages.objects[i].get();
+            sk_sp<SkData> data;
+            if (fProcs.fImageProc) {
+                data = fProcs.fImageProc(image, fProcs.fImageCtx);
+            }
+            // This is what SkBinaryWriteBuffer::writeImage() would do with a null proc result.
+            fImages.data[i] = data ? std::move(data) : image->encodeToData();
+        };
+        auto encodeTypeface = [this](int i) {
+            SkTypeface* typeface = fTypefaces.objects[i].get();
+            sk_sp<SkData> data;
+            if (fProcs.fTypefaceProc) {
+                data = fProcs.fTypefaceProc(typeface, fProcs.fTypefaceCtx);
+            }
+            // This is what SkPictureData::WriteTypefaces() would do with a null proc result.
+            fTypefaces.data[i] = data ? std::move(data) : typeface->serialize();
+        };
+
+        const int images    = (int)fImages.objects.size(),
+                  typefaces = (int)fTypefaces.objects.size();
+        fImages.data.resize(images);
+        fTypefaces.data.resize(typefaces);
+
+        // Reading back texture-backed images needs their context, so they stay on this thread.
+        for (int i = 0; i < images; i++) {
+            if (fImages.objects[i]->isTextureBacked()) {
+                encodeImage(i);
+            }
+        }
+        SkTaskGroup tg(*executor);
+        tg.batch(images + typefaces, [&](int i) {
+            if (i >= images) {
+                encodeTypeface(i - images);
+            } else if (!fImages.objects[i]->isTextureBacked()) {
+                encodeImage(i);
+            }
+        });
+        tg.wait();
+    }
+
+    // These procs return what encode() produced.
+    SkSerialProcs encodedProcs() {
+        SkSerialProcs procs;
+        procs.fImageProc = [](SkImage* image, void* ctx) {
+            auto self = static_cast<PreEncoder*>(ctx);
+            if (const int* i = self->fImages.index.find(image)) {
+                return self->fImages.data[*i];
+            }
+            return self->fProcs.fImageProc ? self->fProcs.fImageProc(image, self->fProcs.fImageCtx)
+                                           : nullptr;
+        };
+        procs.fImageCtx = this;
+        procs.fTypefaceProc = [](SkTypeface* typeface, void* ctx) {
+            auto self = static_cast<PreEncoder*>(ctx);
+            if (const int* i = self->fTypefaces.index.find(typeface)) {
+                return self->fTypefaces.data[*i];
+            }
+            return self->fProcs.fTypefaceProc
+                    ? self->fProcs.fTypefaceProc(typeface, self->fProcs.fTypefaceCtx)
+                    : nullptr;
+        };
+        procs.fTypefaceCtx = this;
+        this->setPictureProc(&procs);
+        return procs;
+    }
+
+private:
+    // The caller's picture proc decides which sub-pictures we serialize at all, so both passes
+    // must see the same answers.  We call it once per picture and remember what it said.
+    void setPictureProc(SkSerialProcs* procs) {
+        if (!fProcs.fPictureProc) {
+            return;
+        }
+        procs->fPictureProc = [](SkPicture* picture, void* ctx) {
+            auto self = static_cast<PreEncoder*>(ctx);
+            if (sk_sp<SkData>* data = self->fPictures.find(picture)) {
+                return *data;
+            }
+            self->fPicturesSeen.push_back(sk_ref_sp(picture));
+            return *self->fPictures.set(picture,
+                                        self->fProcs.fPictureProc(picture,
+                                                                  self->fProcs.fPictureCtx));
+        };
+        procs->fPictureCtx = this;
+    }
+
+    template <typename T>
+    struct Pool {
+        SkTHashMap<const T*, int>  index;
+        std::vector<sk_sp<T>>      objects;  // Refs keep our keys' pointers from being reused.
+        std::vector<sk_sp<SkData>> data;
+
+        void add(T* obj) {
+            if (!index.find(obj)) {
+                index.set(obj, (int)objects.size());
+                objects.push_back(sk_ref_sp(obj));
+            }
+        }
+    };
+
+    const SkSerialProcs                          fProcs;
+    Pool<SkImage>                                fImages;
+    Pool<SkTypeface>                             fTypefaces;
+    SkTHashMap<const SkPicture*, sk_sp<SkData>> fPictures;
+    std::vector<sk_sp<SkPicture>>                fPicturesSeen;
+};
+}  // namespace
+
+sk_sp<SkData> SkPicture::serialize(const SkSerialProcs* procsPtr, SkExecutor* executor) const {
+    if (!executor) {
+        return this->serialize(procsPtr);
+    }
+    SkSerialProcs procs;
+    if (procsPtr) {
+        procs = *procsPtr;
+    }
+
+    PreEncoder encoder(procs);
+    const SkSerialProcs collectProcs = encoder.collectProcs();
+
+    // We backport once for both passes; for a big picture it's the most expensive part of them.
+    std::unique_ptr<SkPictureData> data;
+    if (!custom_serialize(this, collectProcs)) {
+        data.reset(this->backport());
+    }
+    if (data) {
+        SkNullWStream devnull;
+        data->serialize(&devnull, collectProcs, nullptr);
+        encoder.encode(executor);
+    }
+
+    const SkSerialProcs encodedProcs = encoder.encodedProcs();
+    SkDynamicMemoryWStream stream;
+    if (data) {
+        // This mirrors the private serialize() above.
+        SkPictInfo info = this->createHeader();
+        stream.write(&info, sizeof(info));
+        stream.write8(kPictureData_TrailingStreamByteAfterPictInfo);
+        data->serialize(&stream, encodedProcs, nullptr);
+    } else {
+        this->serialize(&stream, &encodedProcs, nullptr);
+    }
+    return stream.detachAsData();
+}
+
 void SkPicturePriv::Flatten(const sk_sp<const SkPicture> picture, SkWriteBuffer& buffer) {
     SkPictInfo info = picture->createHeader();
     std::unique_ptr<SkPictureData> data(picture->backport());
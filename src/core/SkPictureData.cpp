@@ -223,6 +223,11 @@ void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
     write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
     stream->write(fOpData->bytes(), fOpData->size());
 
+    if (fOpIndex) {
+        write_tag_size(stream, SK_PICT_OP_INDEX_TAG, fOpIndex->size());
+        stream->write(fOpIndex->bytes(), fOpIndex->size());
+    }
+
     // We serialize all typefaces into the typeface section of the top-level picture.
     SkRefCntSet localTypefaceSet;
     SkRefCntSet* typefaceSet = topLevelTypeFaceSet ? topLevelTypeFaceSet : &localTypefaceSet;
@@ -305,11 +310,20 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
     switch (tag) {
         case SK_PICT_READER_TAG:
             SkASSERT(nullptr == fOpData);
-            fOpData = SkData::MakeFromStream(stream, size);
+            // SkPicturePlayback reads ops with an SkReadBuffer, which needs 4-byte alignment.
+            fOpData = this->readData(stream, size, /*requireAlign4=*/true);
             if (!fOpData) {
                 return false;
             }
             break;
+        case SK_PICT_OP_INDEX_TAG:
+            SkASSERT(nullptr == fOpIndex);
+            // We read the index in place, so it needs 4-byte alignment too.
+            fOpIndex = this->readData(stream, size, /*requireAlign4=*/true);
+            if (!fOpIndex) {
+                return false;
+            }
+            break;
         case SK_PICT_FACTORY_TAG: {
             if (!stream->readU32(&size)) { return false; }
             fFactoryPlayback = std::make_unique<SkFactoryPlayback>(size);
@@ -346,7 +360,8 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             fPictures.reserve_back(SkToInt(size));
 
             for (uint32_t i = 0; i < size; i++) {
-                auto pic = SkPicture::MakeFromStream(stream, &procs, topLevelTFPlayback);
+                auto pic = SkPicture::MakeFromStream(stream, &procs, topLevelTFPlayback,
+                                                     fDeferredBacking);
                 if (!pic) {
                     return false;
                 }
@@ -354,39 +369,91 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
+            if (fDeferredBacking) {
+                SkASSERT(nullptr == fDeferredArrays);
+                if (!fFactoryPlayback) {
+                    return false;
+                }
+                fDeferredArrays = this->readData(stream, size, /*requireAlign4=*/false);
+                if (!fDeferredArrays) {
+                    return false;
+                }
+                fDeferredProcs = procs;
+                // Newer .skp files serialize all typefaces with the top picture, which may
+                // be gone by the time we decode our arrays, so hold on to our own refs.
+                if (fTFPlayback.count() == 0 && topLevelTFPlayback != &fTFPlayback) {
+                    fTFPlayback.setCount(topLevelTFPlayback->count());
+                    for (size_t i = 0; i < topLevelTFPlayback->count(); ++i) {
+                        fTFPlayback[i] = (*topLevelTFPlayback)[i];
+                    }
+                }
+                break;
+            }
+
             SkAutoMalloc storage(size);
             if (stream->read(storage.get(), size) != size) {
                 return false;
             }
+            return this->parseArrays(storage.get(), size, procs, topLevelTFPlayback);
+        }
+    }
+    return true;    // success
+}
 
-            SkReadBuffer buffer(storage.get(), size);
-            buffer.setVersion(fInfo.getVersion());
+bool SkPictureData::parseArrays(const void* data, size_t size,
+                                const SkDeserialProcs& procs,
+                                SkTypefacePlayback* topLevelTFPlayback) {
+    SkReadBuffer buffer(data, size);
+    buffer.setVersion(fInfo.getVersion());
 
-            if (!fFactoryPlayback) {
-                return false;
-            }
-            fFactoryPlayback->setupBuffer(buffer);
-            buffer.setDeserialProcs(procs);
-
-            if (fTFPlayback.count() > 0) {
-                // .skp files <= v43 have typefaces serialized with each sub picture.
-                fTFPlayback.setupBuffer(buffer);
-            } else {
-                // Newer .skp files serialize all typefaces with the top picture.
-                topLevelTFPlayback->setupBuffer(buffer);
-            }
+    if (!fFactoryPlayback) {
+        return false;
+    }
+    fFactoryPlayback->setupBuffer(buffer);
+    buffer.setDeserialProcs(procs);
+
+    if (fTFPlayback.count() > 0) {
+        // .skp files <= v43 have typefaces serialized with each sub picture.
+        fTFPlayback.setupBuffer(buffer);
+    } else {
+        // Newer .skp files serialize all typefaces with the top picture.
+        topLevelTFPlayback->setupBuffer(buffer);
+    }
 
-            while (!buffer.eof() && buffer.isValid()) {
-                tag = buffer.readUInt();
-                size = buffer.readUInt();
-                this->parseBufferTag(buffer, tag, size);
-            }
-            if (!buffer.isValid()) {
-                return false;
+    while (!buffer.eof() && buffer.isValid()) {
+        uint32_t tag  = buffer.readUInt(),
+                 size = buffer.readUInt();
+        this->parseBufferTag(buffer, tag, size);
+    }
+    return buffer.isValid();
+}
+
+sk_sp<SkData> SkPictureData::readData(SkStream* stream, size_t size, bool requireAlign4) {
+    if (fDeferredBacking && stream->getMemoryBase() == fDeferredBacking->data()) {
+        const size_t offset = stream->getPosition();
+        if (!requireAlign4 || SkIsAlign4((uintptr_t)fDeferredBacking->bytes() + offset)) {
+            if (stream->skip(size) != size) {
+                return nullptr;
             }
-        } break;
+            return SkData::MakeSubset(fDeferredBacking.get(), offset, size);
+        }
     }
-    return true;    // success
+    return SkData::MakeFromStream(stream, size);
+}
+
+bool SkPictureData::parseDeferredArrays() {
+    sk_sp<SkData> arrays = std::move(fDeferredArrays);
+    if (!arrays) {
+        return true;
+    }
+    // Our view into fDeferredBacking may not be aligned well enough for SkReadBuffer.
+    // Decoding copies everything it needs, so a temporary copy will do.
+    SkAutoMalloc storage;
+    const void* data = arrays->data();
+    if (!SkIsAlign4((uintptr_t)data)) {
+        data = memcpy(storage.reset(arrays->size()), arrays->data(), arrays->size());
+    }
+    return this->parseArrays(data, arrays->size(), fDeferredProcs, &fTFPlayback);
 }
 
 static sk_sp<SkImage> create_image_from_buffer(SkReadBuffer& buffer) {
@@ -493,8 +560,10 @@ void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
 SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
                                                const SkPictInfo& info,
                                                const SkDeserialProcs& procs,
-                                               SkTypefacePlayback* topLevelTFPlayback) {
+                                               SkTypefacePlayback* topLevelTFPlayback,
+                                               sk_sp<SkData> deferredBacking) {
     std::unique_ptr<SkPictureData> data(new SkPictureData(info));
+    data->fDeferredBacking = std::move(deferredBacking);
     if (!topLevelTFPlayback) {
         topLevelTFPlayback = &data->fTFPlayback;
     }
@@ -553,6 +622,47 @@ bool SkPictureData::parseBuffer(SkReadBuffer& buffer) {
     return true;
 }
 
+void SkPictureData::setOpIndex(const uint32_t offsets[], const SkRect bounds[], int count) {
+    SkASSERT(count >= 0);
+    const size_t offsetBytes = (count + 1) * sizeof(uint32_t),
+                 boundsBytes = count * sizeof(SkRect);
+
+    sk_sp<SkData> index = SkData::MakeUninitialized(sizeof(uint32_t) + offsetBytes + boundsBytes);
+    char* ptr = static_cast<char*>(index->writable_data());
+    const uint32_t n = SkToU32(count);
+    memcpy(ptr, &n, sizeof(uint32_t));
+    memcpy(ptr + sizeof(uint32_t), offsets, offsetBytes);
+    memcpy(ptr + sizeof(uint32_t) + offsetBytes, bounds, boundsBytes);
+    fOpIndex = std::move(index);
+}
+
+bool SkPictureData::readOpIndex(const uint32_t** offsets, const SkRect** bounds,
+                                int* count) const {
+    if (!fOpIndex || !fOpData || fOpIndex->size() < 2 * sizeof(uint32_t)) {
+        return false;
+    }
+    const uint32_t* words = static_cast<const uint32_t*>(fOpIndex->data());
+    const uint32_t n = words[0];
+    if (n > (fOpIndex->size() - 2 * sizeof(uint32_t)) / (sizeof(uint32_t) + sizeof(SkRect)) ||
+        fOpIndex->size() != (n + 2) * sizeof(uint32_t) + n * sizeof(SkRect)) {
+        return false;
+    }
+
+    // The offsets must be 4-byte aligned, in order, and within the op stream.  Playback
+    // validates the ops it finds there like any others.
+    const uint32_t* o = words + 1;
+    for (uint32_t i = 0; i <= n; i++) {
+        if (!SkIsAlign4(o[i]) || o[i] > fOpData->size() || (i > 0 && o[i] < o[i-1])) {
+            return false;
+        }
+    }
+
+    *offsets = o;
+    *bounds  = reinterpret_cast<const SkRect*>(o + n + 1);
+    *count   = SkToInt(n);
+    return true;
+}
+
 const SkPaint* SkPictureData::optionalPaint(SkReadBuffer* reader) const {
     int index = reader->readInt();
     if (index == 0) {
@@ -11,6 +11,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkDrawable.h"
 #include "include/core/SkPicture.h"
+#include "include/core/SkSerialProcs.h"
 #include "include/private/SkTArray.h"
 #include "src/core/SkPictureFlat.h"
 
@@ -54,6 +55,8 @@ public:
 #define SK_PICT_TYPEFACE_TAG   SkSetFourByteTag('t', 'p', 'f', 'c')
 #define SK_PICT_PICTURE_TAG    SkSetFourByteTag('p', 'c', 't', 'r')
 #define SK_PICT_DRAWABLE_TAG   SkSetFourByteTag('d', 'r', 'a', 'w')
+// Optional, written for pictures with a BBH.  See SkPictureData::setOpIndex().
+#define SK_PICT_OP_INDEX_TAG   SkSetFourByteTag('o', 'p', 'i', 'x')
 
 // This tag specifies the size of the ReadBuffer, needed for the following tags
 #define SK_PICT_BUFFER_SIZE_TAG     SkSetFourByteTag('a', 'r', 'a', 'y')
@@ -78,10 +81,14 @@ class SkPictureData {
 public:
     SkPictureData(const SkPictureRecord& record, const SkPictInfo&);
     // Does not affect ownership of SkStream.
+    // If deferredBacking is set, the stream reads from it.  Sections of the stream are then kept
+    // as views into deferredBacking where possible, and the paints, paths, etc. are left undecoded
+    // until parseDeferredArrays() is called.
     static SkPictureData* CreateFromStream(SkStream*,
                                            const SkPictInfo&,
                                            const SkDeserialProcs&,
-                                           SkTypefacePlayback*);
+                                           SkTypefacePlayback*,
+                                           sk_sp<SkData> deferredBacking = nullptr);
     static SkPictureData* CreateFromBuffer(SkReadBuffer&, const SkPictInfo&);
 
     void serialize(SkWStream*, const SkSerialProcs&, SkRefCntSet*, bool textBlobsOnly=false) const;
@@ -91,6 +98,21 @@ public:
 
     const sk_sp<SkData>& opData() const { return fOpData; }
 
+    // Decodes the paints, paths, etc. left undecoded by a deferred CreateFromStream().
+    // Returns false if they're invalid.  Not thread safe: callers must call this exactly once,
+    // before any playback.
+    bool parseDeferredArrays();
+
+    const SkTArray<sk_sp<const SkPicture>>& pictures() const { return fPictures; }
+
+    // The op index maps each op of the SkRecord this picture was recorded from to the range of
+    // the op stream it was written as, [offsets[i], offsets[i+1]), and to its bounds.  It's laid
+    // out as a count N, then N+1 uint32_t offsets, then N SkRects.
+    void setOpIndex(const uint32_t offsets[], const SkRect bounds[], int count);
+
+    // Returns false if there's no op index, or it's invalid.
+    bool readOpIndex(const uint32_t** offsets, const SkRect** bounds, int* count) const;
+
 protected:
     explicit SkPictureData(const SkPictInfo& info);
 
@@ -145,6 +167,10 @@ private:
     // Does not affect ownership of SkStream.
     bool parseStreamTag(SkStream*, uint32_t tag, uint32_t size,
                         const SkDeserialProcs&, SkTypefacePlayback*);
+    bool parseArrays(const void* data, size_t size,
+                     const SkDeserialProcs&, SkTypefacePlayback*);
+    // Reads the next size bytes of the stream, as a view into fDeferredBacking if possible.
+    sk_sp<SkData> readData(SkStream*, size_t size, bool requireAlign4);
     void parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
     void flattenToBuffer(SkWriteBuffer&, bool textBlobsOnly) const;
 
@@ -152,6 +178,7 @@ private:
     SkTArray<SkPath>   fPaths;
 
     sk_sp<SkData>   fOpData;    // opcodes and parameters
+    sk_sp<SkData>   fOpIndex;   // optional, see setOpIndex()
 
     const SkPath    fEmptyPath;
     const SkBitmap  fEmptyBitmap;
@@ -169,6 +196,11 @@ private:
     SkTypefacePlayback                 fTFPlayback;
     std::unique_ptr<SkFactoryPlayback> fFactoryPlayback;
 
+    // Only set when deferred: the data we're reading from, and our undecoded arrays.
+    sk_sp<SkData>      fDeferredBacking;
+    sk_sp<SkData>      fDeferredArrays;
+    SkDeserialProcs    fDeferredProcs;
+
     const SkPictInfo fInfo;
 
     static void WriteFactories(SkWStream* stream, const SkFactorySet& rec);
@@ -49,31 +49,66 @@ void SkPicturePlayback::draw(SkCanvas* canvas,
 
     SkAutoCanvasRestore acr(canvas, false);
 
-    while (!reader.eof() && reader.isValid()) {
-        if (callback && callback->abort()) {
+    this->drawOps(&reader, fPictureData->opData()->size(), canvas, callback, initialMatrix);
+
+    // need to propagate invalid state to the parent reader
+    if (buffer) {
+        buffer->validate(reader.isValid());
+    }
+}
+
+void SkPicturePlayback::draw(SkCanvas* canvas,
+                             SkSpan<const OpRange> ranges,
+                             SkPicture::AbortCallback* callback) {
+    AutoResetOpID aroi(this);
+    SkASSERT(0 == fCurOffset);
+
+    SkReadBuffer reader(fPictureData->opData()->bytes(),
+                        fPictureData->opData()->size());
+    reader.setVersion(fPictureData->info().getVersion());
+
+    SkM44 initialMatrix = canvas->getLocalToDevice();
+
+    SkAutoCanvasRestore acr(canvas, false);
+
+    for (const OpRange& range : ranges) {
+        SkASSERT(range.fBegin <= range.fEnd);
+        // A clip that came out empty may already have skipped us past the start of this range.
+        if (range.fBegin > reader.offset()) {
+            reader.skip(range.fBegin - reader.offset());
+        }
+        if (!this->drawOps(&reader, range.fEnd, canvas, callback, initialMatrix)) {
             return;
         }
+    }
+}
 
-        fCurOffset = reader.offset();
+bool SkPicturePlayback::drawOps(SkReadBuffer* reader,
+                                size_t end,
+                                SkCanvas* canvas,
+                                SkPicture::AbortCallback* callback,
+                                const SkM44& initialMatrix) {
+    while (reader->offset() < end && !reader->eof() && reader->isValid()) {
+        if (callback && callback->abort()) {
+            return false;
+        }
 
-        uint32_t bits = reader.readInt();
+        fCurOffset = reader->offset();
+
+        uint32_t bits = reader->readInt();
         uint32_t op   = bits >> 24,
                  size = bits & 0xffffff;
         if (size == 0xffffff) {
-            size = reader.readInt();
+            size = reader->readInt();
         }
 
-        if (!reader.validate(size > 0 && op > UNUSED && op <= LAST_DRAWTYPE_ENUM)) {
-            return;
+        if (!reader->validate(size > 0 && op > UNUSED && op <= LAST_DRAWTYPE_ENUM)) {
+            return false;
         }
 
-        this->handleOp(&reader, (DrawType)op, size, canvas, initialMatrix);
-    }
-
-    // need to propagate invalid state to the parent reader
-    if (buffer) {
-        buffer->validate(reader.isValid());
+        this->handleOp(reader, (DrawType)op, size, canvas, initialMatrix);
     }
+    return reader->isValid();
 }
 
 static void validate_offsetToRestore(SkReadBuffer* reader, size_t offsetToRestore) {
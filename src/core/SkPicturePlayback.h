@@ -8,6 +8,7 @@
 #ifndef SkPicturePlayback_DEFINED
 #define SkPicturePlayback_DEFINED
 
+#include "include/core/SkSpan.h"
 #include "src/core/SkPictureFlat.h"
 
 class SkBitmap;
@@ -25,6 +26,14 @@ public:
 
     void draw(SkCanvas* canvas, SkPicture::AbortCallback*, SkReadBuffer* buffer);
 
+    // A range of byte offsets into the op stream, [fBegin, fEnd), holding whole ops.
+    struct OpRange {
+        size_t fBegin, fEnd;
+    };
+
+    // Draws only the ops in these ranges, which must be sorted and must not overlap.
+    void draw(SkCanvas* canvas, SkSpan<const OpRange>, SkPicture::AbortCallback*);
+
     // TODO: remove the curOp calls after cleaning up GrGatherDevice
     // Return the ID of the operation currently being executed when playing
     // back. 0 indicates no call is active.
@@ -37,6 +46,13 @@ private:
     // The offset of the current operation when within the draw method
     size_t fCurOffset;
 
+    // Draws ops until reader reaches offset end.  Returns false if drawing should stop.
+    bool drawOps(SkReadBuffer* reader,
+                 size_t end,
+                 SkCanvas* canvas,
+                 SkPicture::AbortCallback*,
+                 const SkM44& initialMatrix);
+
     void handleOp(SkReadBuffer* reader,
                   DrawType op,
                   uint32_t size,
@@ -37,6 +37,11 @@ public:
         return picture->asSkBigPicture();
     }
 
+    // Returns NULL if this is not an SkDeferredPicture.
+    static const SkDeferredPicture* AsSkDeferredPicture(const sk_sp<const SkPicture>& picture) {
+        return picture->asSkDeferredPicture();
+    }
+
     static uint64_t MakeSharedID(uint32_t pictureID) {
         uint64_t sharedID = SkSetFourByteTag('p', 'i', 'c', 't');
         return (sharedID << 32) | pictureID;
@@ -105,6 +110,7 @@ public:
     // V91: Added raw image shaders
     // V92: Added anisotropic filtering to SkSamplingOptions
     // V94: Removed local matrices from SkShaderBase. Local matrices always use SkLocalMatrixShader.
+    // V95: Optional op index (per-op stream offsets and bounds) for pictures with a BBH.
 
     enum Version {
         kPictureShaderFilterParam_Version   = 82,
@@ -120,6 +126,7 @@ public:
         kAnisotropicFilter                  = 92,
         kBlend4fColorFilter                 = 93,
         kNoShaderLocalMatrix                = 94,
+        kOpIndex_Version                    = 95,
 
         // Only SKPs within the min/current picture version range (inclusive) can be read.
         //
@@ -145,7 +152,7 @@ public:
         // Contact the Infra Gardener (or directly ping rmistry@) if the above steps do not work
         // for you.
         kMin_Version     = kPictureShaderFilterParam_Version,
-        kCurrent_Version = kNoShaderLocalMatrix
+        kCurrent_Version = kOpIndex_Version
     };
 };
 
@@ -14,6 +14,7 @@
 #include "src/core/SkCanvasPriv.h"
 #include "src/core/SkDrawShadowInfo.h"
 #include "src/core/SkMatrixPriv.h"
+#include "src/core/SkOpts.h"
 #include "src/core/SkSamplingPriv.h"
 #include "src/core/SkTSearch.h"
 #include "src/image/SkImage_Base.h"
@@ -844,13 +845,47 @@ void SkPictureRecord::addMatrix(const SkMatrix& matrix) {
     fWriter.writeMatrix(matrix);
 }
 
+uint32_t SkPictureRecord::PaintHash::operator()(const SkPaint& paint) const {
+    struct {
+        const void* effects[6];
+        SkColor4f   color;
+        SkScalar    width, miter;
+        uint32_t    bits;
+    } key;
+    sk_bzero(&key, sizeof(key));  // Zero any padding so it hashes consistently.
+
+    // SkPaint's operator== compares effects by pointer, so hashing their pointers is enough.
+    key.effects[0] = paint.getPathEffect();
+    key.effects[1] = paint.getShader();
+    key.effects[2] = paint.getMaskFilter();
+    key.effects[3] = paint.getColorFilter();
+    key.effects[4] = paint.getImageFilter();
+    key.effects[5] = paint.getBlender();
+    key.color = paint.getColor4f();
+    key.width = paint.getStrokeWidth();
+    key.miter = paint.getStrokeMiter();
+    key.bits  = (uint32_t)paint.isAntiAlias()
+              | (uint32_t)paint.isDither()      << 1
+              | (uint32_t)paint.getStrokeCap()  << 2
+              | (uint32_t)paint.getStrokeJoin() << 4
+              | (uint32_t)paint.getStyle()      << 6;
+    return SkOpts::hash(&key, sizeof(key));
+}
+
 void SkPictureRecord::addPaintPtr(const SkPaint* paint) {
-    if (paint) {
-        fPaints.push_back(*paint);
-        this->addInt(fPaints.count());
-    } else {
+    if (!paint) {
         this->addInt(0);
+        return;
+    }
+    if (fRecordFlags & kDedupPaints_RecordFlag) {
+        if (int* index = fPaintIndices.find(*paint)) {
+            this->addInt(*index);
+            return;
+        }
+        fPaintIndices.set(*paint, fPaints.count() + 1);
     }
+    fPaints.push_back(*paint);
+    this->addInt(fPaints.count());
 }
 
 int SkPictureRecord::addPathToHeap(const SkPath& path) {
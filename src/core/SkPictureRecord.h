@@ -32,6 +32,11 @@
 
 class SkPictureRecord : public SkCanvasVirtualEnforcer<SkCanvas> {
 public:
+    enum RecordFlags {
+        // Write equal paints once, sharing one index.
+        kDedupPaints_RecordFlag = 1 << 0,
+    };
+
     SkPictureRecord(const SkISize& dimensions, uint32_t recordFlags);
 
     SkPictureRecord(const SkIRect& dimensions, uint32_t recordFlags);
@@ -244,6 +249,13 @@ protected:
 private:
     SkTArray<SkPaint>  fPaints;
 
+    // With kDedupPaints_RecordFlag, equal paints share one entry in fPaints (and so in the
+    // serialized picture).
+    struct PaintHash {
+        uint32_t operator()(const SkPaint&) const;
+    };
+    SkTHashMap<SkPaint, int, PaintHash> fPaintIndices;
+
     struct PathHash {
         uint32_t operator()(const SkPath& p) { return p.getGenerationID(); }
     };
@@ -26,16 +26,19 @@ SkPictureRecorder::SkPictureRecorder() {
 SkPictureRecorder::~SkPictureRecorder() {}
 
 SkCanvas* SkPictureRecorder::beginRecording(const SkRect& userCullRect,
-                                            sk_sp<SkBBoxHierarchy> bbh) {
+                                            sk_sp<SkBBoxHierarchy> bbh,
+                                            uint32_t recordFlags) {
     const SkRect cullRect = userCullRect.isEmpty() ? SkRect::MakeEmpty() : userCullRect;
 
     fCullRect = cullRect;
     fBBH = std::move(bbh);
+    fRecordFlags = recordFlags;
 
     if (!fRecord) {
         fRecord.reset(new SkRecord);
     }
     fRecorder->reset(fRecord.get(), cullRect);
+    fRecorder->setInternContent(recordFlags & kInternContent_RecordFlag);
     fActivelyRecording = true;
     return this->getRecordingCanvas();
 }
@@ -57,16 +60,25 @@ public:
     SkRect cullRect()             const override { return SkRect::MakeEmpty(); }
 };
 
+void SkPictureRecorder::optimize() {
+    // Culling first lets SkRecordOptimize() drop any save/restore pairs left with nothing to draw.
+    if (fRecordFlags & kCullOccludedDraws_RecordFlag) {
+        SkRecordNoopOccludedDraws(fRecord.get());
+    }
+    SkRecordOptimize(fRecord.get());
+}
+
 sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture() {
     fActivelyRecording = false;
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
+    fRecorder->setInternContent(false);  // The recorded ops keep what they need of the pools.
 
     if (fRecord->count() == 0) {
         return sk_make_sp<SkEmptyPicture>();
     }
 
     // TODO: delay as much of this work until just before first playback?
-    SkRecordOptimize(fRecord.get());
+    this->optimize();
 
     SkDrawableList* drawableList = fRecorder->getDrawableList();
     std::unique_ptr<SkBigPicture::SnapshotArray> pictList{
@@ -90,7 +102,9 @@ sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture() {
         fCullRect = bbhBound;
     }
 
-    size_t subPictureBytes = fRecorder->approxBytesUsedBySubPictures();
+    // Interned path and vertices payloads live outside the SkRecord too, so count them alongside.
+    size_t subPictureBytes = fRecorder->approxBytesUsedBySubPictures()
+                           + fRecorder->approxBytesUsedByPathsAndVertices();
     for (int i = 0; pictList && i < pictList->count(); i++) {
         subPictureBytes += pictList->begin()[i]->approximateBytesUsed();
     }
@@ -98,7 +112,8 @@ sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture() {
                                     std::move(fRecord),
                                     std::move(pictList),
                                     std::move(fBBH),
-                                    subPictureBytes);
+                                    subPictureBytes,
+                                    SkToBool(fRecordFlags & kInternContent_RecordFlag));
 }
 
 sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPictureWithCull(const SkRect& cullRect) {
@@ -125,8 +140,9 @@ void SkPictureRecorder::partialReplay(SkCanvas* canvas) const {
 sk_sp<SkDrawable> SkPictureRecorder::finishRecordingAsDrawable() {
     fActivelyRecording = false;
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
+    fRecorder->setInternContent(false);
 
-    SkRecordOptimize(fRecord.get());
+    this->optimize();
 
     if (fBBH) {
         SkAutoTMalloc<SkRect> bounds(fRecord->count());
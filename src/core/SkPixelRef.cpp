@@ -76,7 +76,8 @@ uint32_t SkPixelRef::getGenerationID() const {
         // if we got here via the else path (pretty unlikely, but possible).
     }
 
-    SkRecordReplayAssert("[RUN-593-1863] SkPixelRef::getGenerationID %u", id);
+    SkRecordReplayAssertValues(SK_RECORD_REPLAY_SITE("[RUN-593-1863] SkPixelRef::getGenerationID"),
+                               id);
 
     return id & ~1u;  // Mask off bottom unique bit.
 }
@@ -7,8 +7,17 @@
 
 #include "src/core/SkRTree.h"
 
+#include "include/core/SkExecutor.h"
+#include "include/private/SkVx.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
+#include <cmath>
+
 SkRTree::SkRTree() : fCount(0) {}
 
+SkRTree::SkRTree(SkExecutor* executor) : fCount(0), fExecutor(executor) {}
+
 void SkRTree::insert(const SkRect boundsArray[], int N) {
     SkASSERT(0 == fCount);
 
@@ -23,37 +32,19 @@ void SkRTree::insert(const SkRect boundsArray[], int N) {
 
         Branch b;
         b.fBounds = bounds;
-        b.fOpIndex = i;
+        b.fChild.fOpIndex = i;
         branches.push_back(b);
     }
 
     fCount = (int)branches.size();
     if (fCount) {
-        if (1 == fCount) {
-            fNodes.reserve(1);
-            Node* n = this->allocateNodeAtLevel(0);
-            n->fNumChildren = 1;
-            n->fChildren[0] = branches[0];
-            fRoot.fSubtree = n;
-            fRoot.fBounds  = branches[0].fBounds;
-        } else {
-            fNodes.reserve(CountNodes(fCount));
-            fRoot = this->bulkLoad(&branches);
-        }
+        // bulkLoad() always packs level 0 into nodes, so even a single rect gets a leaf root.
+        fNodes.reserve(CountNodes(fCount));
+        fRoot = this->bulkLoad(&branches);
     }
 }
 
-SkRTree::Node* SkRTree::allocateNodeAtLevel(uint16_t level) {
-    SkDEBUGCODE(Node* p = fNodes.data());
-    fNodes.push_back(Node{});
-    Node& out = fNodes.back();
-    SkASSERT(fNodes.data() == p);  // If this fails, we didn't reserve() enough.
-    out.fNumChildren = 0;
-    out.fLevel = level;
-    return &out;
-}
-
-// This function parallels bulkLoad, but just counts how many nodes bulkLoad would allocate.
+// This function parallels GroupBranches(), but just counts how many nodes bulkLoad() allocates.
 int SkRTree::CountNodes(int branches) {
     if (branches == 1) {
         return 1;
@@ -80,25 +71,13 @@ int SkRTree::CountNodes(int branches) {
             }
         }
         nodes++;
-        currentBranch++;
-        for (int k = 1; k < incrementBy && currentBranch < branches; ++k) {
-            currentBranch++;
-        }
+        currentBranch = std::min(currentBranch + incrementBy, branches);
     }
     return nodes + CountNodes(nodes);
 }
 
-SkRTree::Branch SkRTree::bulkLoad(std::vector<Branch>* branches, int level) {
-    if (branches->size() == 1) { // Only one branch.  It will be the root.
-        return (*branches)[0];
-    }
-
-    // We might sort our branches here, but we expect Blink gives us a reasonable x,y order.
-    // Skipping a call to sort (in Y) here resulted in a 17% win for recording with negligible
-    // difference in playback speed.
-    int remainder   = (int)branches->size() % kMaxChildren;
-    int newBranches = 0;
-
+void SkRTree::GroupBranches(int branches, std::vector<int>* starts) {
+    int remainder = branches % kMaxChildren;
     if (remainder > 0) {
         // If the remainder isn't enough to fill a node, we'll add fewer nodes to other branches.
         if (remainder >= kMinChildren) {
@@ -108,8 +87,9 @@ SkRTree::Branch SkRTree::bulkLoad(std::vector<Branch>* branches, int level) {
         }
     }
 
+    starts->clear();
     int currentBranch = 0;
-    while (currentBranch < (int)branches->size()) {
+    while (currentBranch < branches) {
         int incrementBy = kMaxChildren;
         if (remainder != 0) {
             // if need be, omit some nodes to make up for remainder
@@ -121,39 +101,162 @@ SkRTree::Branch SkRTree::bulkLoad(std::vector<Branch>* branches, int level) {
                 remainder -= kMaxChildren - kMinChildren;
             }
         }
-        Node* n = allocateNodeAtLevel(level);
-        n->fNumChildren = 1;
-        n->fChildren[0] = (*branches)[currentBranch];
-        Branch b;
-        b.fBounds = (*branches)[currentBranch].fBounds;
-        b.fSubtree = n;
-        ++currentBranch;
-        for (int k = 1; k < incrementBy && currentBranch < (int)branches->size(); ++k) {
-            b.fBounds.join((*branches)[currentBranch].fBounds);
-            n->fChildren[k] = (*branches)[currentBranch];
-            ++n->fNumChildren;
-            ++currentBranch;
+        starts->push_back(currentBranch);
+        currentBranch = std::min(currentBranch + incrementBy, branches);
+    }
+    starts->push_back(branches);
+}
+
+namespace {
+    // Sorts [begin,end) by sorting fixed-size chunks in parallel, then merging pairs of sorted
+    // runs in parallel.  The chunking doesn't depend on the executor's thread count, so the
+    // result is the same on every run and every machine.
+    template <typename T, typename Less>
+    void parallel_sort(SkExecutor* executor, T* begin, T* end, Less less) {
+        static constexpr ptrdiff_t kChunk = SkRTree::kParallelThreshold;
+        const ptrdiff_t n = end - begin;
+        if (n <= kChunk) {
+            std::sort(begin, end, less);
+            return;
+        }
+
+        SkTaskGroup tg(*executor);
+        const int chunks = (int)((n + kChunk - 1) / kChunk);
+        tg.batch(chunks, [&](int i) {
+            std::sort(begin + i*kChunk, begin + std::min(n, (i+1)*kChunk), less);
+        });
+        tg.wait();
+
+        for (ptrdiff_t run = kChunk; run < n; run *= 2) {
+            const int merges = (int)((n + 2*run - 1) / (2*run));
+            tg.batch(merges, [&](int i) {
+                T* lo  = begin + i*2*run;
+                T* mid = begin + std::min(n, i*2*run + run);
+                T* hi  = begin + std::min(n, i*2*run + 2*run);
+                std::inplace_merge(lo, mid, hi, less);
+            });
+            tg.wait();
+        }
+    }
+}  // namespace
+
+void SkRTree::sortTileRecursive(std::vector<Branch>* branches) const {
+    // Sort everything by x into vertical slices of about sqrt(nodes) nodes each, then sort each
+    // slice by y, so each run of kMaxChildren branches covers a compact tile.
+    auto byX = [](const Branch& a, const Branch& b) {
+        return a.fBounds.centerX() < b.fBounds.centerX();
+    };
+    auto byY = [](const Branch& a, const Branch& b) {
+        return a.fBounds.centerY() < b.fBounds.centerY();
+    };
+
+    const int n      = (int)branches->size(),
+              nodes  = (n + kMaxChildren - 1) / kMaxChildren,
+              slices = (int)std::ceil(std::sqrt((double)nodes)),
+              slice  = ((nodes + slices - 1) / slices) * kMaxChildren;
+
+    Branch* data = branches->data();
+    parallel_sort(fExecutor, data, data + n, byX);
+
+    SkTaskGroup tg(*fExecutor);
+    tg.batch((n + slice - 1) / slice, [&](int i) {
+        std::sort(data + i*slice, data + std::min(n, (i+1)*slice), byY);
+    });
+    tg.wait();
+}
+
+SkRTree::Branch SkRTree::bulkLoad(std::vector<Branch>* branches, int level) {
+    if (branches->size() == 1 && level > 0) {  // Only one branch.  It will be the root.
+        return (*branches)[0];
+    }
+
+    // Without an executor we don't sort our branches here, since we expect Blink gives us a
+    // reasonable x,y order.  Skipping a call to sort (in Y) here resulted in a 17% win for
+    // recording with negligible difference in playback speed.
+    const bool parallel = fExecutor && (int)branches->size() >= kParallelThreshold;
+    if (parallel) {
+        this->sortTileRecursive(branches);
+        fSortResults = true;
+    }
+
+    std::vector<int> starts;
+    GroupBranches((int)branches->size(), &starts);
+    const int newBranches = (int)starts.size() - 1;
+
+    SkASSERT(fNodes.size() + newBranches <= fNodes.capacity());  // Did we reserve() enough?
+    const size_t firstNode = fNodes.size();
+    fNodes.resize(firstNode + newBranches);
+
+    std::vector<Branch> packed(newBranches);
+    auto pack = [&](int i) {
+        Node* n = &fNodes[firstNode + i];
+        n->fNumChildren = SkToU16(starts[i+1] - starts[i]);
+        n->fLevel       = SkToU16(level);
+
+        Branch& b = packed[i];
+        b.fChild.fSubtree = n;
+        b.fBounds = (*branches)[starts[i]].fBounds;
+        for (int k = 0; k < kPaddedChildren; ++k) {
+            if (k < n->fNumChildren) {
+                const Branch& child = (*branches)[starts[i] + k];
+                b.fBounds.join(child.fBounds);
+                n->fChildren[k] = child.fChild;
+                n->fLeft  [k] = child.fBounds.fLeft;
+                n->fTop   [k] = child.fBounds.fTop;
+                n->fRight [k] = child.fBounds.fRight;
+                n->fBottom[k] = child.fBounds.fBottom;
+            } else {
+                n->fLeft  [k] = n->fTop   [k] = +SK_FloatInfinity;
+                n->fRight [k] = n->fBottom[k] = -SK_FloatInfinity;
+            }
+        }
+    };
+    if (parallel) {
+        SkTaskGroup tg(*fExecutor);
+        tg.batch(newBranches, pack);
+        tg.wait();
+    } else {
+        for (int i = 0; i < newBranches; i++) {
+            pack(i);
         }
-        (*branches)[newBranches] = b;
-        ++newBranches;
     }
-    branches->resize(newBranches);
+
+    *branches = std::move(packed);
     return this->bulkLoad(branches, level + 1);
 }
 
 void SkRTree::search(const SkRect& query, std::vector<int>* results) const {
     if (fCount > 0 && SkRect::Intersects(fRoot.fBounds, query)) {
-        this->search(fRoot.fSubtree, query, results);
+        const size_t first = results->size();
+        this->search(fRoot.fChild.fSubtree, query, results);
+        if (fSortResults) {
+            std::sort(results->begin() + first, results->end());
+        }
     }
 }
 
-void SkRTree::search(Node* node, const SkRect& query, std::vector<int>* results) const {
-    for (int i = 0; i < node->fNumChildren; ++i) {
-        if (SkRect::Intersects(node->fChildren[i].fBounds, query)) {
-            if (0 == node->fLevel) {
-                results->push_back(node->fChildren[i].fOpIndex);
-            } else {
-                this->search(node->fChildren[i].fSubtree, query, results);
+void SkRTree::search(const Node* node, const SkRect& query, std::vector<int>* results) const {
+    // The query and all children are non-empty (the caller checked the query against fRoot),
+    // so SkRect::Intersects() reduces to these four comparisons.
+    const skvx::float4 l(query.fLeft),
+                       t(query.fTop),
+                       r(query.fRight),
+                       b(query.fBottom);
+    for (int i = 0; i < node->fNumChildren; i += 4) {
+        auto hit = (skvx::float4::Load(node->fLeft   + i) < r)
+                 & (skvx::float4::Load(node->fTop    + i) < b)
+                 & (l < skvx::float4::Load(node->fRight  + i))
+                 & (t < skvx::float4::Load(node->fBottom + i));
+        if (!any(hit)) {
+            continue;
+        }
+        for (int j = i; j < std::min(i + 4, (int)node->fNumChildren); ++j) {
+            if (hit[j - i]) {
+                if (0 == node->fLevel) {
+                    results->push_back(node->fChildren[j].fOpIndex);
+                } else {
+                    this->search(node->fChildren[j].fSubtree, query, results);
+                }
             }
         }
     }
@@ -11,12 +11,17 @@
 #include "include/core/SkBBHFactory.h"
 #include "include/core/SkRect.h"
 
+class SkExecutor;
+
 /**
  * An R-Tree implementation. In short, it is a balanced n-ary tree containing a hierarchy of
  * bounding rectangles.
  *
  * It only supports bulk-loading, i.e. creation from a batch of bounding rectangles.
- * This performs a bottom-up bulk load using the STR (sort-tile-recursive) algorithm.
+ * This performs a bottom-up bulk load.  By default it packs rects in the order given, which is
+ * cheap and works well for the roughly x,y ordered rects we get from recording.  When given an
+ * SkExecutor, large levels are instead sorted into tiles (STR, sort-tile-recursive) with the
+ * sorting and packing spread across the executor's threads.
  *
  * TODO: Experiment with other bulk-load algorithms (in particular the Hilbert pack variant,
  * which groups rects by position on the Hilbert curve, is probably worth a look). There also
@@ -30,6 +35,8 @@
 class SkRTree : public SkBBoxHierarchy {
 public:
     SkRTree();
+    // Builds large trees with STR on this executor, which must outlive insert().
+    explicit SkRTree(SkExecutor*);
 
     void insert(const SkRect[], int N) override;
     void search(const SkRect& query, std::vector<int>* results) const override;
@@ -38,7 +45,7 @@ public:
     // Methods and constants below here are only public for tests.
 
     // Return the depth of the tree structure.
-    int getDepth() const { return fCount ? fRoot.fSubtree->fLevel + 1 : 0; }
+    int getDepth() const { return fCount ? fRoot.fChild.fSubtree->fLevel + 1 : 0; }
     // Insertion count (not overall node count, which may be greater).
     int getCount() const { return fCount; }
 
@@ -46,37 +53,57 @@ public:
     static const int kMinChildren = 6,
                      kMaxChildren = 11;
 
+    // Levels with at least this many branches are sorted and packed in parallel.
+    static const int kParallelThreshold = 1 << 14;
+
 private:
     struct Node;
 
+    union Child {
+        Node* fSubtree;
+        int fOpIndex;
+    };
+
     struct Branch {
-        union {
-            Node* fSubtree;
-            int fOpIndex;
-        };
+        Child  fChild;
         SkRect fBounds;
     };
 
+    // Children's bounds are stored edge by edge, so search() can test 4 children at a time.
+    // Slots past fNumChildren hold inverted bounds that never intersect anything.
+    static const int kPaddedChildren = (kMaxChildren + 3) & ~3;
+
     struct Node {
         uint16_t fNumChildren;
         uint16_t fLevel;
-        Branch fChildren[kMaxChildren];
+        float fLeft  [kPaddedChildren],
+              fTop   [kPaddedChildren],
+              fRight [kPaddedChildren],
+              fBottom[kPaddedChildren];
+        Child fChildren[kMaxChildren];
     };
 
-    void search(Node* root, const SkRect& query, std::vector<int>* results) const;
+    void search(const Node* root, const SkRect& query, std::vector<int>* results) const;
 
     // Consumes the input array.
     Branch bulkLoad(std::vector<Branch>* branches, int level = 0);
 
-    // How many times will bulkLoad() call allocateNodeAtLevel()?
+    // Reorders a level's branches into STR tiles of roughly kMaxChildren nearby branches.
+    void sortTileRecursive(std::vector<Branch>* branches) const;
+
+    // How many nodes will bulkLoad() allocate?
     static int CountNodes(int branches);
 
-    Node* allocateNodeAtLevel(uint16_t level);
+    // Fills in *starts with the index of each node's first branch, plus a final end index.
+    static void GroupBranches(int branches, std::vector<int>* starts);
 
     // This is the count of data elements (rather than total nodes in the tree)
     int fCount;
     Branch fRoot;
     std::vector<Node> fNodes;
+    SkExecutor* fExecutor = nullptr;
+    // STR reorders the ops, so search() must sort its results back into op order.
+    bool fSortResults = false;
 };
 
 #endif
@@ -128,9 +128,16 @@ struct skcms_TransferFunction;
 // The largest number of pixels we handle at a time. We have a separate value for the largest number
 // of pixels we handle in the highp pipeline. Many of the context structs in this file are only used
 // by stages that have no lowp implementation. They can therefore use the (smaller) highp value to
-// save memory in the arena.
+// save memory in the arena. Only builds that can pick the SKX stages at runtime need room for their
+// wider strides.
+#if defined(SK_CPU_X86) && \
+        (!defined(SK_ENABLE_OPTIMIZE_SIZE) || SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX)
+inline static constexpr int SkRasterPipeline_kMaxStride = 32;
+inline static constexpr int SkRasterPipeline_kMaxStride_highp = 16;
+#else
 inline static constexpr int SkRasterPipeline_kMaxStride = 16;
 inline static constexpr int SkRasterPipeline_kMaxStride_highp = 8;
+#endif
 
 // Structs representing the arguments to some common stages.
 
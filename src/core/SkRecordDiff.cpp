@@ -0,0 +1,573 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkRecordDiff.h"
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkM44.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkRSXform.h"
+#include "include/core/SkRegion.h"
+#include "include/core/SkTextBlob.h"
+#include "include/core/SkVertices.h"
+#include "include/private/SkTHash.h"
+#include "src/core/SkBigPicture.h"
+#include "src/core/SkMatrixPriv.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkPathPriv.h"
+#include "src/core/SkPicturePriv.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecords.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+using namespace SkRecords;
+
+namespace {
+
+// Two independently seeded 32-bit hashes, so a collision that would hide a change is
+// vanishingly unlikely even across many frames.
+class Hasher {
+public:
+    explicit Hasher(uint64_t seed = 0) : fLo((uint32_t)seed), fHi((uint32_t)(seed >> 32) ^ 1) {}
+
+    uint64_t value() const { return (uint64_t)fHi << 32 | fLo; }
+
+    void bytes(const void* data, size_t bytes) {
+        fLo = SkOpts::hash(data, bytes, fLo);
+        fHi = SkOpts::hash(data, bytes, fHi);
+    }
+
+    // Scalars, enums, and structs of nothing but floats.
+    template <typename T> void add(const T& v) {
+        AssertHashable<T>();
+        this->bytes(&v, sizeof(v));
+    }
+    template <typename T> void add(const T* array, int count) {
+        AssertHashable<T>();
+        this->add(count);
+        if (array) {
+            this->bytes(array, count * sizeof(T));
+        }
+    }
+    template <typename T> void add(const PODArray<T>& array, int count) {
+        this->add((const T*)array, count);
+    }
+    template <typename T> void add(const Optional<T>& optional) {
+        this->add((const T*)optional);
+    }
+
+    // Immutable objects that are only ever compared by identity.  The records being compared keep
+    // them alive, so a pointer can't be reused for a different object while we're diffing.
+    void addPtr(const void* ptr) { this->bytes(&ptr, sizeof(ptr)); }
+
+    void add(const SkMatrix& m) {
+        SkScalar values[9];
+        m.get9(values);
+        this->bytes(values, sizeof(values));
+    }
+    void add(const SkM44& m) {
+        SkScalar values[16];
+        m.getColMajor(values);
+        this->bytes(values, sizeof(values));
+    }
+    void add(const TypedMatrix& m)   { this->add((const SkMatrix&)m); }
+    void add(const PreCachedPath& p) { this->add((const SkPath&)p); }
+    void add(const SkRRect& rrect) {
+        char buffer[SkRRect::kSizeInMemory];
+        rrect.writeToMemory(buffer);
+        this->bytes(buffer, sizeof(buffer));
+    }
+    void add(const SkPath& path) {
+        // Paths are often rebuilt from scratch each frame, so compare their contents.
+        this->add(path.getFillType());
+        this->add(path.isInverseFillType());
+        this->add(SkPathPriv::VerbData(path), path.countVerbs());
+        this->add(SkPathPriv::PointData(path), path.countPoints());
+        this->add(SkPathPriv::ConicWeightData(path), SkPathPriv::ConicWeightCnt(path));
+    }
+    void add(const SkRegion& region) {
+        for (SkRegion::Iterator iter(region); !iter.done(); iter.next()) {
+            this->add(iter.rect());
+        }
+    }
+    void add(const SkSamplingOptions& sampling) {
+        this->add(sampling.maxAniso);
+        this->add(sampling.useCubic);
+        this->add(sampling.cubic.B);
+        this->add(sampling.cubic.C);
+        this->add(sampling.filter);
+        this->add(sampling.mipmap);
+    }
+    void add(const SkPaint& paint) {
+        this->addPtr(paint.getPathEffect());
+        this->addPtr(paint.getShader());
+        this->addPtr(paint.getMaskFilter());
+        this->addPtr(paint.getColorFilter());
+        this->addPtr(paint.getImageFilter());
+        this->addPtr(paint.getBlender());
+        this->add(paint.getColor4f());
+        this->add(paint.getStrokeWidth());
+        this->add(paint.getStrokeMiter());
+        this->add(paint.isAntiAlias());
+        this->add(paint.isDither());
+        this->add(paint.getStrokeCap());
+        this->add(paint.getStrokeJoin());
+        this->add(paint.getStyle());
+    }
+    void add(const SkPaint* paint) {
+        this->add(paint != nullptr);
+        if (paint) {
+            this->add(*paint);
+        }
+    }
+    void add(const SkRect* rect) {
+        this->add(rect != nullptr);
+        if (rect) {
+            this->add(*rect);
+        }
+    }
+    void add(const SkImage* image) {
+        this->add(image ? image->uniqueID() : SK_InvalidUniqueID);
+    }
+
+private:
+    template <typename T> static void AssertHashable() {
+        static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value ||
+                      std::is_same<T, SkPoint>::value || std::is_same<T, SkRect>::value ||
+                      std::is_same<T, SkIRect>::value || std::is_same<T, SkColor4f>::value ||
+                      std::is_same<T, SkRSXform>::value || std::is_same<T, SkPoint3>::value,
+                      "Only types without padding or cached fields can be hashed as bytes.");
+    }
+
+    uint32_t fLo, fHi;
+};
+
+// Hashes the type and every field that can change what an op draws.
+class HashOp {
+public:
+    template <typename T> uint64_t operator()(const T& op) {
+        Hasher h;
+        h.add((int)T::kType);
+        this->fields(&h, op);
+        return h.value();
+    }
+
+private:
+    void fields(Hasher*, const NoOp&) {}
+    void fields(Hasher*, const Flush&) {}
+    void fields(Hasher* h, const Restore& op) { h->add(op.matrix); }
+    void fields(Hasher*, const Save&) {}
+    void fields(Hasher* h, const SaveLayer& op) {
+        h->add(op.bounds);
+        h->add(op.paint);
+        h->addPtr(op.backdrop.get());
+        h->add(op.saveLayerFlags);
+        h->add(op.backdropScale);
+    }
+    void fields(Hasher* h, const SaveBehind& op) { h->add(op.subset); }
+    void fields(Hasher* h, const SetMatrix& op)  { h->add(op.matrix); }
+    void fields(Hasher* h, const SetM44& op)     { h->add(op.matrix); }
+    void fields(Hasher* h, const Concat& op)     { h->add(op.matrix); }
+    void fields(Hasher* h, const Concat44& op)   { h->add(op.matrix); }
+    void fields(Hasher* h, const Translate& op)  { h->add(op.dx); h->add(op.dy); }
+    void fields(Hasher* h, const Scale& op)      { h->add(op.sx); h->add(op.sy); }
+    void fields(Hasher* h, const ClipPath& op) {
+        h->add(op.path);
+        h->add(op.opAA.op());
+        h->add(op.opAA.aa());
+    }
+    void fields(Hasher* h, const ClipRRect& op) {
+        h->add(op.rrect);
+        h->add(op.opAA.op());
+        h->add(op.opAA.aa());
+    }
+    void fields(Hasher* h, const ClipRect& op) {
+        h->add(op.rect);
+        h->add(op.opAA.op());
+        h->add(op.opAA.aa());
+    }
+    void fields(Hasher* h, const ClipRegion& op) { h->add(op.region); h->add(op.op); }
+    void fields(Hasher* h, const ClipShader& op) { h->addPtr(op.shader.get()); h->add(op.op); }
+    void fields(Hasher*, const ResetClip&) {}
+
+    void fields(Hasher* h, const DrawArc& op) {
+        h->add(op.paint);
+        h->add(op.oval);
+        h->add(op.startAngle);
+        h->add(op.sweepAngle);
+        h->add(op.useCenter);
+    }
+    void fields(Hasher* h, const DrawDRRect& op) {
+        h->add(op.paint);
+        h->add(op.outer);
+        h->add(op.inner);
+    }
+    void fields(Hasher* h, const DrawDrawable& op) {
+        h->add(op.matrix ? *op.matrix : SkMatrix::I());
+        h->add(op.worstCaseBounds);
+        h->add(op.index);
+    }
+    void fields(Hasher* h, const DrawImage& op) {
+        h->add(op.paint);
+        h->add(op.image.get());
+        h->add(op.left);
+        h->add(op.top);
+        h->add(op.sampling);
+    }
+    void fields(Hasher* h, const DrawImageLattice& op) {
+        h->add(op.paint);
+        h->add(op.image.get());
+        h->add(op.xDivs, op.xCount);
+        h->add(op.yDivs, op.yCount);
+        h->add(op.flags, op.flagCount);
+        h->add(op.colors, op.flags ? op.flagCount : 0);
+        h->add(op.src);
+        h->add(op.dst);
+        h->add(op.filter);
+    }
+    void fields(Hasher* h, const DrawImageRect& op) {
+        h->add(op.paint);
+        h->add(op.image.get());
+        h->add(op.src);
+        h->add(op.dst);
+        h->add(op.sampling);
+        h->add(op.constraint);
+    }
+    void fields(Hasher* h, const DrawOval& op)   { h->add(op.paint); h->add(op.oval); }
+    void fields(Hasher* h, const DrawPaint& op)  { h->add(op.paint); }
+    void fields(Hasher* h, const DrawBehind& op) { h->add(op.paint); }
+    void fields(Hasher* h, const DrawPath& op)   { h->add(op.paint); h->add(op.path); }
+    void fields(Hasher* h, const DrawPicture& op) {
+        h->add(op.paint);
+        h->add(op.picture->uniqueID());
+        h->add(op.matrix);
+    }
+    void fields(Hasher* h, const DrawPoints& op) {
+        h->add(op.paint);
+        h->add(op.mode);
+        h->add(op.pts, (int)op.count);
+    }
+    void fields(Hasher* h, const DrawRRect& op)  { h->add(op.paint); h->add(op.rrect); }
+    void fields(Hasher* h, const DrawRect& op)   { h->add(op.paint); h->add(op.rect); }
+    void fields(Hasher* h, const DrawRegion& op) { h->add(op.paint); h->add(op.region); }
+    void fields(Hasher* h, const DrawTextBlob& op) {
+        h->add(op.paint);
+        h->add(op.blob->uniqueID());
+        h->add(op.x);
+        h->add(op.y);
+    }
+#if SK_SUPPORT_GPU
+    void fields(Hasher* h, const DrawSlug& op) { h->addPtr(op.slug.get()); }
+#else
+    void fields(Hasher*, const DrawSlug&) {}
+#endif
+    void fields(Hasher* h, const DrawPatch& op) {
+        h->add(op.paint);
+        h->add(op.cubics, 12);
+        h->add(op.colors, op.colors ? 4 : 0);
+        h->add(op.texCoords, op.texCoords ? 4 : 0);
+        h->add(op.bmode);
+    }
+    void fields(Hasher* h, const DrawAtlas& op) {
+        h->add(op.paint);
+        h->add(op.atlas.get());
+        h->add(op.xforms, op.count);
+        h->add(op.texs, op.count);
+        h->add(op.colors, op.colors ? op.count : 0);
+        h->add(op.mode);
+        h->add(op.sampling);
+        h->add(op.cull);
+    }
+    void fields(Hasher* h, const DrawVertices& op) {
+        h->add(op.paint);
+        h->add(op.vertices->uniqueID());
+        h->add(op.bmode);
+    }
+    void fields(Hasher* h, const DrawShadowRec& op) {
+        h->add(op.path);
+        h->add(op.rec.fZPlaneParams);
+        h->add(op.rec.fLightPos);
+        h->add(op.rec.fLightRadius);
+        h->add(op.rec.fAmbientColor);
+        h->add(op.rec.fSpotColor);
+        h->add(op.rec.fFlags);
+    }
+    void fields(Hasher* h, const DrawAnnotation& op) {
+        h->add(op.rect);
+        h->bytes(op.key.c_str(), op.key.size());
+        h->addPtr(op.value.get());
+    }
+    void fields(Hasher* h, const DrawEdgeAAQuad& op) {
+        h->add(op.rect);
+        h->add(op.clip, op.clip ? 4 : 0);
+        h->add(op.aa);
+        h->add(op.color);
+        h->add(op.mode);
+    }
+    void fields(Hasher* h, const DrawEdgeAAImageSet& op) {
+        h->add(op.paint);
+        int clips = 0,
+            matrices = 0;
+        for (int i = 0; i < op.count; i++) {
+            const SkCanvas::ImageSetEntry& entry = op.set[i];
+            h->add(entry.fImage.get());
+            h->add(entry.fSrcRect);
+            h->add(entry.fDstRect);
+            h->add(entry.fMatrixIndex);
+            h->add(entry.fAlpha);
+            h->add(entry.fAAFlags);
+            h->add(entry.fHasClip);
+            clips   += entry.fHasClip ? 4 : 0;
+            matrices = std::max(matrices, entry.fMatrixIndex + 1);
+        }
+        h->add(op.dstClips, op.dstClips ? clips : 0);
+        for (int i = 0; i < matrices; i++) {
+            h->add(op.preViewMatrices[i]);
+        }
+        h->add(op.sampling);
+        h->add(op.constraint);
+    }
+};
+
+static uint64_t combine(uint64_t state, uint64_t op) {
+    Hasher h(state);
+    h.add(op);
+    return h.value();
+}
+
+struct KeyedOp {
+    uint64_t key;
+    int      index;
+};
+
+// Gives every op that can touch pixels a key combining its own hash with the hashes of all the
+// matrix, clip and saveLayer ops it draws under.  Two ops with the same key draw the same pixels,
+// except where earlier ops left different pixels for them to blend with.
+class KeyOps {
+public:
+    KeyOps(std::vector<KeyedOp>* ops, uint64_t drawableSalt)
+            : fOps(ops), fDrawableSalt(drawableSalt) {
+        fStates.push_back(0);
+    }
+
+    // Set when the record holds something that reads back pixels it didn't draw itself, so damage
+    // can spread beyond the bounds of the ops that changed.
+    bool sawBarrier() const { return fBarrier; }
+
+    void setCurrentOp(int currentOp) { fCurrentOp = currentOp; }
+
+    template <typename T> void operator()(const T& op) {
+        this->key(op, HashOp()(op));
+    }
+
+private:
+    uint64_t& state() { return fStates.back(); }
+
+    void emit(uint64_t key) { fOps->push_back({key, fCurrentOp}); }
+
+    void key(const Save&, uint64_t hash) { fStates.push_back(combine(this->state(), hash)); }
+    void key(const SaveLayer& op, uint64_t hash) {
+        fBarrier |= op.backdrop || (op.saveLayerFlags & SkCanvas::kInitWithPrevious_SaveLayerFlag);
+        fStates.push_back(combine(this->state(), hash));
+    }
+    void key(const SaveBehind& op, uint64_t hash) {
+        fBarrier = true;
+        fStates.push_back(combine(this->state(), hash));
+    }
+    void key(const Restore&, uint64_t hash) {
+        // A Restore composites any layer its Save started, so it draws under that Save's state.
+        this->emit(combine(this->state(), hash));
+        if (fStates.size() > 1) {
+            fStates.pop_back();
+        }
+    }
+
+    void key(const SetMatrix&, uint64_t hash)  { this->state() = combine(this->state(), hash); }
+    void key(const SetM44&, uint64_t hash)     { this->state() = combine(this->state(), hash); }
+    void key(const Concat&, uint64_t hash)     { this->state() = combine(this->state(), hash); }
+    void key(const Concat44&, uint64_t hash)   { this->state() = combine(this->state(), hash); }
+    void key(const Translate&, uint64_t hash)  { this->state() = combine(this->state(), hash); }
+    void key(const Scale&, uint64_t hash)      { this->state() = combine(this->state(), hash); }
+    void key(const ClipPath&, uint64_t hash)   { this->state() = combine(this->state(), hash); }
+    void key(const ClipRRect&, uint64_t hash)  { this->state() = combine(this->state(), hash); }
+    void key(const ClipRect&, uint64_t hash)   { this->state() = combine(this->state(), hash); }
+    void key(const ClipRegion&, uint64_t hash) { this->state() = combine(this->state(), hash); }
+    void key(const ClipShader&, uint64_t hash) { this->state() = combine(this->state(), hash); }
+    void key(const ResetClip&, uint64_t hash)  { this->state() = combine(this->state(), hash); }
+
+    // These never touch pixels.
+    void key(const NoOp&, uint64_t)           {}
+    void key(const Flush&, uint64_t)          {}
+    void key(const DrawAnnotation&, uint64_t) {}
+
+    // A drawable can draw something different every time it's played back, so salting its key
+    // differently in each record keeps it from ever matching.
+    void key(const DrawDrawable&, uint64_t hash) {
+        this->emit(combine(this->state(), hash ^ fDrawableSalt));
+    }
+    void key(const DrawBehind&, uint64_t hash) {
+        fBarrier = true;
+        this->emit(combine(this->state(), hash));
+    }
+
+    template <typename T> void key(const T&, uint64_t hash) {
+        this->emit(combine(this->state(), hash));
+    }
+
+    std::vector<KeyedOp>* fOps;
+    std::vector<uint64_t> fStates;
+    const uint64_t        fDrawableSalt;
+    int                   fCurrentOp = 0;
+    bool                  fBarrier = false;
+};
+
+static bool key_ops(const SkRecord& record, uint64_t drawableSalt, std::vector<KeyedOp>* ops) {
+    ops->reserve(record.count());
+    KeyOps visitor(ops, drawableSalt);
+    for (int i = 0; i < record.count(); i++) {
+        visitor.setCurrentOp(i);
+        record.visit(i, visitor);
+    }
+    return !visitor.sawBarrier();
+}
+
+// Damages the device pixels bounds could touch once drawn under deviceMatrix.
+static void damage_op(const SkM44& deviceMatrix, const SkRect& bounds, SkRegion* damage) {
+    if (bounds.isEmpty()) {
+        return;
+    }
+    // Anti-aliasing can touch the pixels just outside an op's geometric bounds.
+    const SkIRect r = SkMatrixPriv::MapRect(deviceMatrix, bounds).makeOutset(1, 1).roundOut();
+    if (!r.isEmpty()) {
+        damage->op(r, SkRegion::kUnion_Op);
+    }
+}
+
+}  // namespace
+
+void SkRecordComputeDamage(const SkM44& deviceMatrix,
+                           const SkRect& beforeCull, const SkRecord& before,
+                           const SkRect& afterCull,  const SkRecord& after,
+                           SkRegion* damage) {
+    damage->setEmpty();
+
+    std::vector<KeyedOp> a, b;
+    if (!key_ops(before, 0x5eed0000, &a) || !key_ops(after, 0x5eed0001, &b)) {
+        damage_op(deviceMatrix, beforeCull, damage);
+        damage_op(deviceMatrix, afterCull,  damage);
+        return;
+    }
+
+    // Typical frames share long runs at either end, so match those directly.
+    const size_t n = std::min(a.size(), b.size());
+    size_t prefix = 0,
+           suffix = 0;
+    while (prefix < n && a[prefix].key == b[prefix].key) {
+        prefix++;
+    }
+    while (suffix < n - prefix && a[a.size() - 1 - suffix].key == b[b.size() - 1 - suffix].key) {
+        suffix++;
+    }
+
+    // In between, walk the ops of after in order, matching each with the earliest unclaimed op of
+    // before with the same key that still comes after the last match.  Matches never cross, so
+    // every pixel outside the damage sees the same ops draw in the same order in both records.
+    std::vector<bool> matchedA(a.size(), false),
+                      matchedB(b.size(), false);
+    std::fill(matchedA.begin(), matchedA.begin() + prefix, true);
+    std::fill(matchedB.begin(), matchedB.begin() + prefix, true);
+    std::fill(matchedA.end() - suffix, matchedA.end(), true);
+    std::fill(matchedB.end() - suffix, matchedB.end(), true);
+
+    const size_t endA = a.size() - suffix,
+                 endB = b.size() - suffix;
+    std::vector<int> byKey;  // Indices into a, sorted by key then position.
+    for (size_t i = prefix; i < endA; i++) {
+        byKey.push_back((int)i);
+    }
+    std::sort(byKey.begin(), byKey.end(), [&](int x, int y) {
+        return a[x].key != a[y].key ? a[x].key < a[y].key : x < y;
+    });
+    SkTHashMap<uint64_t, size_t> cursors;  // Next candidate in byKey for each key.
+    for (size_t i = byKey.size(); i-- > 0;) {
+        cursors.set(a[byKey[i]].key, i);
+    }
+
+    int lastA = (int)prefix - 1;
+    for (size_t j = prefix; j < endB; j++) {
+        size_t* cursor = cursors.find(b[j].key);
+        if (!cursor) {
+            continue;
+        }
+        while (*cursor < byKey.size() && a[byKey[*cursor]].key == b[j].key &&
+               byKey[*cursor] <= lastA) {
+            ++*cursor;
+        }
+        if (*cursor < byKey.size() && a[byKey[*cursor]].key == b[j].key) {
+            lastA = byKey[(*cursor)++];
+            matchedA[lastA] = true;
+            matchedB[j]     = true;
+        }
+    }
+
+    auto damage_unmatched = [&](const SkRect& cull, const SkRecord& record,
+                                const std::vector<KeyedOp>& ops, const std::vector<bool>& matched) {
+        if (std::all_of(matched.begin(), matched.end(), [](bool m) { return m; })) {
+            return;
+        }
+        std::vector<SkRect> bounds(record.count());
+        std::vector<SkBBoxHierarchy::Metadata> meta(record.count());
+        SkRecordFillBounds(cull, record, bounds.data(), meta.data());
+        for (size_t i = 0; i < ops.size(); i++) {
+            if (!matched[i]) {
+                damage_op(deviceMatrix, bounds[ops[i].index], damage);
+            }
+        }
+    };
+    damage_unmatched(beforeCull, before, a, matchedA);
+    damage_unmatched(afterCull,  after,  b, matchedB);
+}
+
+void SkPictureComputeDamage(const SkM44& deviceMatrix,
+                            const SkPicture& before, const SkPicture& after, SkRegion* damage) {
+    if (before.uniqueID() == after.uniqueID()) {
+        damage->setEmpty();
+        return;
+    }
+
+    const SkBigPicture* a = SkPicturePriv::AsSkBigPicture(sk_ref_sp(&before)),
+                      * b = SkPicturePriv::AsSkBigPicture(sk_ref_sp(&after));
+    if (a && b) {
+        SkRecordComputeDamage(deviceMatrix,
+                              a->cullRect(), *a->record(), b->cullRect(), *b->record(), damage);
+        return;
+    }
+
+    damage->setEmpty();
+    damage_op(deviceMatrix, before.cullRect(), damage);
+    damage_op(deviceMatrix, after.cullRect(),  damage);
+}
+
+void SkPictureDrawDamage(const SkPicture& picture, const SkM44& deviceMatrix,
+                         const SkRegion& damage, SkCanvas* canvas) {
+    if (damage.isEmpty()) {
+        return;
+    }
+
+    // clipRegion() is in device space and never anti-aliased, so exactly the damaged pixels are
+    // cleared and redrawn.
+    SkAutoCanvasRestore acr(canvas, true);
+    canvas->clipRegion(damage);
+    canvas->clear(SK_ColorTRANSPARENT);
+    canvas->setMatrix(deviceMatrix);
+    picture.playback(canvas);
+}
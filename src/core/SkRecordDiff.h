@@ -0,0 +1,47 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRecordDiff_DEFINED
+#define SkRecordDiff_DEFINED
+
+#include "include/core/SkRect.h"
+#include "src/core/SkRecord.h"
+
+class SkCanvas;
+class SkM44;
+class SkPicture;
+class SkRegion;
+
+// Sets damage to the device space region where drawing after could produce different pixels
+// than drawing before, e.g. two consecutive frames of an animation, when both are drawn under
+// deviceMatrix.
+//
+// Each op is keyed by a structural hash of its fields and paint combined with the matrix, clip and
+// layer state it draws under.  Ops are matched by key in order, and the SkRecordFillBounds()
+// bounds of every unmatched op, from either record, are mapped to device space and damaged along
+// with a device pixel of slop for anti-aliasing.  Images, text blobs, pictures and paint effects
+// are compared by identity, paths and other geometry by value.  Drawables can change between any
+// two playbacks, so they are always damaged.
+void SkRecordComputeDamage(const SkM44& deviceMatrix,
+                           const SkRect& beforeCull, const SkRecord& before,
+                           const SkRect& afterCull,  const SkRecord& after,
+                           SkRegion* damage);
+
+// SkRecordComputeDamage() for two pictures.  Pictures that aren't backed by an SkRecord (e.g. very
+// small or deferred pictures) are damaged over their whole cull rect unless they're the same.
+void SkPictureComputeDamage(const SkM44& deviceMatrix,
+                            const SkPicture& before, const SkPicture& after, SkRegion* damage);
+
+// Re-rasterizes only the device space damage of picture, drawn under deviceMatrix, into a canvas
+// that already holds an older rendering of it under that same matrix.  The damaged pixels are
+// cleared to transparent and then redrawn, just as if the whole picture were drawn into a freshly
+// cleared surface.  deviceMatrix replaces the canvas' matrix while drawing.  (Under perspective,
+// image filters are resolved relative to the clip, so their output may differ slightly.)
+void SkPictureDrawDamage(const SkPicture&, const SkM44& deviceMatrix, const SkRegion& damage,
+                         SkCanvas*);
+
+#endif//SkRecordDiff_DEFINED
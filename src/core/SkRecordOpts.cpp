@@ -7,10 +7,17 @@
 
 #include "src/core/SkRecordOpts.h"
 
+#include "include/core/SkImage.h"
+#include "include/core/SkRegion.h"
+#include "include/core/SkShader.h"
 #include "include/private/SkTDArray.h"
 #include "src/core/SkCanvasPriv.h"
+#include "src/core/SkRecordDraw.h"
 #include "src/core/SkRecordPattern.h"
 #include "src/core/SkRecords.h"
+#include "src/core/SkRectPriv.h"
+
+#include <vector>
 
 using namespace SkRecords;
 
@@ -280,6 +287,214 @@ void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Walks the record front to back, tracking just enough canvas state to know, for each draw at the
+// top layer, the device-space rect it is guaranteed to paint opaquely (or replace with kSrc).
+// Everything here errs towards reporting less coverage: unknown clips and matrices give none.
+class OccluderFinder {
+public:
+    OccluderFinder(int count) : fCoverage(count, SkIRect::MakeEmpty()), fBarrier(count, false) {
+        fStack.push_back({SkMatrix::I(), SkRectPriv::MakeILarge(), false});
+    }
+
+    void setIndex(int i) { fIndex = i; }
+
+    const std::vector<SkIRect>& coverage() const { return fCoverage; }
+    const std::vector<bool>&    barriers() const { return fBarrier; }
+
+    template <typename T> void operator()(const T&) {}
+
+    void operator()(const Save&)    { fStack.push_back(fStack.back()); }
+    void operator()(const Restore&) { if (fStack.size() > 1) { fStack.pop_back(); } }
+
+    void operator()(const SaveLayer& op) {
+        // Layers initialized from or filtering what's already drawn can smear pixels from under
+        // an occluder out past it, so nothing before them may be culled by anything after.
+        if (op.backdrop || (op.saveLayerFlags & SkCanvas::kInitWithPrevious_SaveLayerFlag)) {
+            fBarrier[fIndex] = true;
+        }
+        fStack.push_back(fStack.back());
+        fStack.back().inLayer = true;
+    }
+    void operator()(const SaveBehind&) {
+        fBarrier[fIndex] = true;
+        fStack.push_back(fStack.back());
+        fStack.back().inLayer = true;
+    }
+    // Whatever was drawn before a flush may be observed at that flush.
+    void operator()(const Flush&)        { fBarrier[fIndex] = true; }
+    void operator()(const DrawBehind&)   { fBarrier[fIndex] = true; }
+    void operator()(const DrawDrawable&) { fBarrier[fIndex] = true; }
+
+    void operator()(const SetMatrix& op) { fStack.back().ctm = op.matrix; }
+    void operator()(const SetM44& op)    { fStack.back().ctm = op.matrix.asM33(); }
+    void operator()(const Concat& op)    { fStack.back().ctm.preConcat(op.matrix); }
+    void operator()(const Concat44& op)  { fStack.back().ctm.preConcat(op.matrix.asM33()); }
+    void operator()(const Translate& op) { fStack.back().ctm.preTranslate(op.dx, op.dy); }
+    void operator()(const Scale& op)     { fStack.back().ctm.preScale(op.sx, op.sy); }
+
+    void operator()(const ClipRect& op) { this->clipRect(op.rect, op.opAA.op()); }
+    void operator()(const ClipRRect& op) {
+        this->clipRect(op.rrect.isRect() ? op.rrect.rect() : SkRect::MakeEmpty(), op.opAA.op());
+    }
+    void operator()(const ClipPath& op) {
+        SkRect r;
+        this->clipRect(op.path.isRect(&r) && !op.path.isInverseFillType() ? r : SkRect::MakeEmpty(),
+                       op.opAA.op());
+    }
+    void operator()(const ClipRegion& op) {
+        // Regions are already in device space.
+        SkIRect& clip = fStack.back().clip;
+        if (op.op != SkClipOp::kIntersect || !op.region.isRect() ||
+            !clip.intersect(op.region.getBounds())) {
+            clip.setEmpty();
+        }
+    }
+    void operator()(const ClipShader&) { fStack.back().clip.setEmpty(); }
+    void operator()(const ResetClip&)  { fStack.back().clip = SkRectPriv::MakeILarge(); }
+
+    void operator()(const DrawPaint& op) {
+        if (PaintIsOpaque(&op.paint, nullptr)) {
+            this->cover(SkRect::Make(fStack.back().clip), /*mapped=*/true);
+        }
+    }
+    void operator()(const DrawRect& op) {
+        if (PaintIsOpaque(&op.paint, nullptr)) {
+            this->cover(op.rect);
+        }
+    }
+    void operator()(const DrawImage& op) {
+        if (PaintIsOpaque(op.paint, op.image.get())) {
+            this->cover(SkRect::MakeXYWH(op.left, op.top, op.image->width(), op.image->height()));
+        }
+    }
+    void operator()(const DrawImageRect& op) {
+        // A src hanging off the image is trimmed at draw time, shrinking dst to match, so only
+        // the part of dst mapped from the image's own pixels is sure to be painted.
+        SkRect src = op.src;
+        if (PaintIsOpaque(op.paint, op.image.get()) &&
+            src.intersect(SkRect::Make(op.image->bounds()))) {
+            this->cover(SkMatrix::RectToRect(op.src, op.dst).mapRect(src));
+        }
+    }
+
+private:
+    // Does a fill with this paint (and image, if any) leave only its own color in covered pixels?
+    static bool PaintIsOpaque(const SkPaint* paint, const SkImage* image) {
+        SkPaint defaultPaint;
+        if (!paint) {
+            paint = &defaultPaint;
+        }
+        if (paint->getStyle() != SkPaint::kFill_Style || paint->getPathEffect() ||
+            paint->getMaskFilter() || paint->getColorFilter() || paint->getImageFilter()) {
+            return false;
+        }
+        auto mode = paint->asBlendMode();
+        if (mode == SkBlendMode::kSrc || mode == SkBlendMode::kClear) {
+            return true;
+        }
+        return mode == SkBlendMode::kSrcOver
+            && paint->getAlpha() == 0xFF
+            && (!paint->getShader() || paint->getShader()->isOpaque())
+            && (!image || image->isOpaque());
+    }
+
+    void clipRect(const SkRect& rect, SkClipOp op) {
+        State& s = fStack.back();
+        if (op != SkClipOp::kIntersect || !s.ctm.rectStaysRect() ||
+            !s.clip.intersect(s.ctm.mapRect(rect).roundIn())) {
+            s.clip.setEmpty();
+        }
+    }
+
+    void cover(const SkRect& rect, bool mapped = false) {
+        const State& s = fStack.back();
+        if (s.inLayer || (!mapped && !s.ctm.rectStaysRect())) {
+            return;
+        }
+        // Rounding in keeps only pixels the draw covers entirely.  Insetting by another pixel
+        // keeps the result correct when played back with a fractional translate or a scale up.
+        SkIRect covered = (mapped ? rect : s.ctm.mapRect(rect)).roundIn();
+        covered.inset(1, 1);
+        if (covered.intersect(s.clip)) {
+            fCoverage[fIndex] = covered;
+        }
+    }
+
+    struct State {
+        SkMatrix ctm;
+        SkIRect  clip;     // A device-space rect entirely inside the current clip.
+        bool     inLayer;  // Are we drawing into any layer above the base device?
+    };
+    std::vector<State>   fStack;
+    std::vector<SkIRect> fCoverage;
+    std::vector<bool>    fBarrier;
+    int                  fIndex = 0;
+};
+
+// Which draws may we turn into NoOps when they're covered?
+struct IsOccludable {
+    // Annotations and nested pictures (which may hold annotations) matter even when unseen.
+    bool operator()(const DrawAnnotation&) { return false; }
+    bool operator()(const DrawDrawable&)   { return false; }
+    bool operator()(const DrawBehind&)     { return false; }
+    bool operator()(const DrawPicture&)    { return false; }
+
+    template <typename T>
+    std::enable_if_t<(T::kTags & kDraw_Tag) == kDraw_Tag, bool> operator()(const T&) {
+        return true;
+    }
+    template <typename T>
+    std::enable_if_t<!(T::kTags & kDraw_Tag), bool> operator()(const T&) { return false; }
+};
+
+void SkRecordNoopOccludedDraws(SkRecord* record, SkRecordOcclusionStats* stats) {
+    const int count = record->count();
+    if (count == 0) {
+        return;
+    }
+
+    OccluderFinder finder(count);
+    for (int i = 0; i < count; i++) {
+        finder.setIndex(i);
+        record->visit(i, finder);
+    }
+
+    // Bounds are computed against a huge cull rather than the picture's, so that draws spilling
+    // outside the cull are still judged by all the pixels they touch.
+    std::vector<SkRect> bounds(count);
+    std::vector<SkBBoxHierarchy::Metadata> meta(count);
+    SkRecordFillBounds(SkRectPriv::MakeLargeS32(), *record, bounds.data(), meta.data());
+
+    // Past this many rects in the occluded region we stop growing it; unions of huge numbers of
+    // tiny occluders aren't worth the time.
+    static constexpr int kMaxRegionComplexity = 64;
+
+    SkRegion occluded;
+    for (int i = count - 1; i >= 0; i--) {
+        if (finder.barriers()[i]) {
+            occluded.setEmpty();
+            continue;
+        }
+        if (!occluded.isEmpty() && record->visit(i, IsOccludable())) {
+            const SkIRect b = bounds[i].roundOut();
+            if (occluded.contains(b)) {
+                record->replace<NoOp>(i);
+                if (stats) {
+                    stats->fOps++;
+                    stats->fPixels += b.width64() * b.height64();
+                }
+                continue;
+            }
+        }
+        const SkIRect& covered = finder.coverage()[i];
+        if (!covered.isEmpty() && occluded.computeRegionComplexity() < kMaxRegionComplexity) {
+            occluded.op(covered, SkRegion::kUnion_Op);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SkRecordOptimize(SkRecord* record) {
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
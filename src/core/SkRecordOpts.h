@@ -26,6 +26,23 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
+struct SkRecordOcclusionStats {
+    int     fOps    = 0;  // Draws turned into NoOps.
+    int64_t fPixels = 0;  // Sum of those draws' device-space bounds areas.
+};
+
+// Turns draws that are entirely covered by later opaque draws at the top layer into no-ops.
+// Occluders are simple rect-shaped fills (drawPaint, drawRect, drawImage, drawImageRect) with
+// paints that can't let anything underneath show through. If stats is non-null, the eliminated
+// ops and pixels are added to it.
+//
+// Coverage is judged on the record's own pixel grid, so this is only safe for records that will
+// be played back under a translate or an axis-aligned upscale. Downscaled, rotated, or perspective
+// playback can antialias an occluder's edge over a culled draw. That's why SkRecordOptimize()
+// doesn't run it; SkPictureRecorder runs it for pictures recorded with
+// kCullOccludedDraws_RecordFlag, whose callers promise such playback.
+void SkRecordNoopOccludedDraws(SkRecord*, SkRecordOcclusionStats* stats = nullptr);
+
 // Experimental optimizers
 void SkRecordOptimize2(SkRecord*);
 
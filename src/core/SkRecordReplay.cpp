@@ -17,6 +17,7 @@
 #include <stdarg.h>
 #include <string.h>
 
+#include <memory>
 #include <string>
 
 
@@ -29,6 +30,7 @@ static bool gHasDisabledFeatures;
 static void (*gRecordReplayPrint)(const char* format, va_list args);
 static void (*gRecordReplayWarning)(const char* format, va_list args);
 static void (*gRecordReplayAssert)(const char*, va_list);
+static void (*gRecordReplayAssertBytes)(const char* why, const void* buf, size_t size);
 static void (*gRecordReplayDiagnostic)(const char*, va_list);
 static void (*gRecordReplayRegisterPointer)(const void* ptr);
 static void (*gRecordReplayUnregisterPointer)(const void* ptr);
@@ -69,6 +71,7 @@ static inline bool EnsureInitialized() {
     RecordReplayLoadSymbol("RecordReplayPrint", gRecordReplayPrint);
     RecordReplayLoadSymbol("RecordReplayWarning", gRecordReplayWarning);
     RecordReplayLoadSymbol("RecordReplayAssert", gRecordReplayAssert);
+    RecordReplayLoadSymbol("RecordReplayAssertBytes", gRecordReplayAssertBytes);
     RecordReplayLoadSymbol("RecordReplayDiagnostic", gRecordReplayDiagnostic);
     RecordReplayLoadSymbol("RecordReplayRegisterPointer", gRecordReplayRegisterPointer);
     RecordReplayLoadSymbol("RecordReplayUnregisterPointer", gRecordReplayUnregisterPointer);
@@ -108,8 +111,15 @@ void SkRecordReplayWarning(const char* format, ...) {
   }
 }
 
+// Binary assertions buffered by this thread, created on its first binary assertion. Flushed
+// when the thread exits.
+static thread_local std::unique_ptr<SkRecordReplayAssertStream> tlsAssertStream;
+
 void SkRecordReplayAssert(const char* format, ...) {
   if (EnsureInitialized()) {
+    // Keep this thread's binary and string assertions in the order they were made.
+    SkRecordReplayFlushAsserts();
+
     va_list ap;
     va_start(ap, format);
     gRecordReplayAssert(format, ap);
@@ -117,6 +127,60 @@ void SkRecordReplayAssert(const char* format, ...) {
   }
 }
 
+static void AssertFormatted(const char* format, ...) {
+  va_list ap;
+  va_start(ap, format);
+  gRecordReplayAssert(format, ap);
+  va_end(ap);
+}
+
+static void AssertBytes(const void* data, size_t size) {
+  gRecordReplayAssertBytes("SkRecordReplayAssertBinary", data, size);
+}
+
+void SkRecordReplayAssertBinary(const SkRecordReplayAssertSite& site,
+                                const uint64_t values[], int count) {
+  if (!EnsureInitialized() || !gRecordingOrReplaying) {
+    return;
+  }
+
+  if (!gRecordReplayAssertBytes) {
+    std::string text = site.fName;
+    for (int i = 0; i < count; i++) {
+      text += " " + std::to_string(values[i]);
+    }
+    AssertFormatted("%s", text.c_str());
+    return;
+  }
+
+  if (!tlsAssertStream) {
+    tlsAssertStream = std::make_unique<SkRecordReplayAssertStream>(AssertBytes);
+  }
+  tlsAssertStream->append(site.fId, values, count);
+}
+
+void SkRecordReplayFlushAsserts() {
+  if (tlsAssertStream) {
+    tlsAssertStream->flush();
+  }
+}
+
+void SkRecordReplaySetAssertsForTesting(
+        void (*assertFormatted)(const char* format, va_list args),
+        void (*assertBytes)(const char* why, const void* data, size_t size)) {
+  EnsureInitialized();
+  SkRecordReplayFlushAsserts();
+
+  static bool runtimeRecordingOrReplaying = gRecordingOrReplaying;
+  static auto runtimeAssert = gRecordReplayAssert;
+  static auto runtimeAssertBytes = gRecordReplayAssertBytes;
+
+  bool install = assertFormatted != nullptr;
+  gRecordingOrReplaying = install || runtimeRecordingOrReplaying;
+  gRecordReplayAssert = install ? assertFormatted : runtimeAssert;
+  gRecordReplayAssertBytes = install ? assertBytes : runtimeAssertBytes;
+}
+
 void SkRecordReplayDiagnostic(const char* format, ...) {
   if (EnsureInitialized()) {
     va_list ap;
@@ -8,6 +8,12 @@
 #ifndef SkRecordReplay_DEFINED
 #define SkRecordReplay_DEFINED
 
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
 extern void SkRecordReplayPrint(const char* format, ...);
 extern void SkRecordReplayWarning(const char* format, ...);
 extern void SkRecordReplayAssert(const char* format, ...);
@@ -35,4 +41,90 @@ extern bool SkRecordReplayHasDivergedFromRecording();
 extern bool SkRecordReplayAreEventsUnavailable(const char* why);
 extern uintptr_t SkRecordReplayValue(const char* why, uintptr_t v);
 
+// Binary assertions, for hot paths where SkRecordReplayAssert's formatting is too expensive.
+// A site is named by a string literal whose hash is computed at compile time; its integer values
+// are appended to a per-thread buffer that is handed to the runtime in batches:
+//
+//     SkRecordReplayAssertValues(SK_RECORD_REPLAY_SITE("SkFoo::bar"), index, found);
+//
+// If the runtime cannot take binary assertions, each one is formatted and passed to
+// SkRecordReplayAssert instead.
+struct SkRecordReplayAssertSite {
+    const char* fName;
+    uint32_t    fId;
+};
+
+constexpr uint32_t SkRecordReplayHashSite(const char* name) {
+    uint32_t hash = 2166136261u;  // FNV-1a
+    for (; *name; name++) {
+        hash = (hash ^ static_cast<uint8_t>(*name)) * 16777619u;
+    }
+    return hash;
+}
+
+#define SK_RECORD_REPLAY_SITE(name)                                                \
+    (SkRecordReplayAssertSite{                                                     \
+            name, std::integral_constant<uint32_t, SkRecordReplayHashSite(name)>::value})
+
+extern void SkRecordReplayAssertBinary(const SkRecordReplayAssertSite& site,
+                                       const uint64_t values[], int count);
+
+// Hand this thread's buffered binary assertions to the runtime now.
+extern void SkRecordReplayFlushAsserts();
+
+// Tests and benches only: act as if recording or replaying, with these in place of the runtime's
+// string and binary assertion functions.  Nothing else the runtime provides is stood in for, so
+// only assertions may be made while they're installed.  Passing nullptrs goes back to the
+// runtime.  Either way this thread's buffered assertions are flushed first; other threads must
+// flush or exit before the switch.
+extern void SkRecordReplaySetAssertsForTesting(
+        void (*assertFormatted)(const char* format, va_list args),
+        void (*assertBytes)(const char* why, const void* data, size_t size));
+
+template <typename... Values>
+inline void SkRecordReplayAssertValues(const SkRecordReplayAssertSite& site, Values... values) {
+    static_assert((std::is_integral<Values>::value && ...), "only integers can be asserted");
+    const uint64_t payload[] = {static_cast<uint64_t>(values)..., 0};
+    SkRecordReplayAssertBinary(site, payload, sizeof...(Values));
+}
+
+// Buffers one thread's binary assertions and hands them to a sink in batches. Each entry is a
+// header word, (site id << 32 | value count), followed by its values.
+class SkRecordReplayAssertStream {
+public:
+    using Sink = void (*)(const void* data, size_t bytes);
+
+    static constexpr int kMaxValues = 64;
+
+    explicit SkRecordReplayAssertStream(Sink sink) : fSink(sink) {}
+    ~SkRecordReplayAssertStream() { this->flush(); }
+
+    SkRecordReplayAssertStream(const SkRecordReplayAssertStream&) = delete;
+    SkRecordReplayAssertStream& operator=(const SkRecordReplayAssertStream&) = delete;
+
+    void append(uint32_t siteId, const uint64_t values[], int count) {
+        count = count < kMaxValues ? count : kMaxValues;
+        if (fUsed + 1 + count > kCapacity) {
+            this->flush();
+        }
+        fWords[fUsed++] = static_cast<uint64_t>(siteId) << 32 | static_cast<uint32_t>(count);
+        memcpy(fWords + fUsed, values, count * sizeof(uint64_t));
+        fUsed += count;
+    }
+
+    void flush() {
+        if (fUsed > 0) {
+            fSink(fWords, fUsed * sizeof(uint64_t));
+            fUsed = 0;
+        }
+    }
+
+private:
+    static constexpr int kCapacity = 1024;
+
+    Sink     fSink;
+    int      fUsed = 0;
+    uint64_t fWords[kCapacity];
+};
+
 #endif
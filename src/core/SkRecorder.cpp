@@ -11,9 +11,13 @@
 #include "include/core/SkPicture.h"
 #include "include/core/SkSurface.h"
 #include "include/private/SkTo.h"
+#include "include/private/SkTHash.h"
 #include "include/private/chromium/Slug.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkCanvasPriv.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkPathPriv.h"
+#include "src/core/SkVerticesPriv.h"
 #include "src/text/GlyphRun.h"
 #include "src/utils/SkPatchUtils.h"
 
@@ -42,6 +46,76 @@ void SkDrawableList::append(SkDrawable* drawable) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
+// Pools of the path and vertices payloads recorded so far, keyed by content.
+class SkRecordInterner {
+public:
+    // Returns the pooled path equal to path, and whether it was newly added to the pool.
+    std::pair<SkPath, bool> intern(const SkPath& path) {
+        if (const SkPath* found = fPaths.find(path)) {
+            return {*found, false};
+        }
+        fPaths.add(path);
+        return {path, true};
+    }
+
+    std::pair<sk_sp<SkVertices>, bool> intern(const SkVertices* vertices) {
+        VerticesKey key{sk_ref_sp(const_cast<SkVertices*>(vertices))};
+        if (const VerticesKey* found = fVertices.find(key)) {
+            return {found->vertices, false};
+        }
+        fVertices.add(key);
+        return {std::move(key.vertices), true};
+    }
+
+private:
+    struct PathHash {
+        uint32_t operator()(const SkPath& path) const {
+            const int verbs = path.countVerbs(),
+                      points = path.countPoints(),
+                      weights = SkPathPriv::ConicWeightCnt(path);
+            uint32_t hash = SkOpts::hash(SkPathPriv::VerbData(path), verbs,
+                                         (uint32_t)path.getFillType());
+            hash = SkOpts::hash(SkPathPriv::PointData(path), points * sizeof(SkPoint), hash);
+            return SkOpts::hash(SkPathPriv::ConicWeightData(path),
+                                weights * sizeof(SkScalar), hash);
+        }
+    };
+
+    struct VerticesKey {
+        sk_sp<SkVertices> vertices;
+
+        bool operator==(const VerticesKey& that) const {
+            const SkVerticesPriv a = vertices->priv(),
+                                 b = that.vertices->priv();
+            if (a.mode() != b.mode() || a.vertexCount() != b.vertexCount() ||
+                a.indexCount() != b.indexCount() || a.hasTexCoords() != b.hasTexCoords() ||
+                a.hasColors() != b.hasColors()) {
+                return false;
+            }
+            const size_t n = a.vertexCount();
+            return 0 == memcmp(a.positions(), b.positions(), n * sizeof(SkPoint))
+                && (!a.hasTexCoords() ||
+                    0 == memcmp(a.texCoords(), b.texCoords(), n * sizeof(SkPoint)))
+                && (!a.hasColors() || 0 == memcmp(a.colors(), b.colors(), n * sizeof(SkColor)))
+                && (!a.hasIndices() ||
+                    0 == memcmp(a.indices(), b.indices(), a.indexCount() * sizeof(uint16_t)));
+        }
+    };
+    struct VerticesHash {
+        uint32_t operator()(const VerticesKey& key) const {
+            // Hashing positions alone is enough to tell nearly all vertices apart.
+            const SkVerticesPriv v = key.vertices->priv();
+            return SkOpts::hash(v.positions(), v.vertexCount() * sizeof(SkPoint),
+                                (uint32_t)v.mode());
+        }
+    };
+
+    SkTHashSet<SkPath, PathHash>          fPaths;
+    SkTHashSet<VerticesKey, VerticesHash> fVertices;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+
 static SkIRect safe_picture_bounds(const SkRect& bounds) {
     SkIRect picBounds = bounds.roundOut();
     // roundOut() saturates the float edges to +/-SK_MaxS32FitsInFloat (~2billion), but this is
@@ -70,6 +144,8 @@ SkRecorder::SkRecorder(SkRecord* record, const SkRect& bounds)
     SkASSERT(this->imageInfo().width() >= 0 && this->imageInfo().height() >= 0);
 }
 
+SkRecorder::~SkRecorder() = default;
+
 void SkRecorder::reset(SkRecord* record, const SkRect& bounds) {
     this->forgetRecord();
     fRecord = record;
@@ -80,7 +156,45 @@ void SkRecorder::reset(SkRecord* record, const SkRect& bounds) {
 void SkRecorder::forgetRecord() {
     fDrawableList.reset(nullptr);
     fApproxBytesUsedBySubPictures = 0;
+    fApproxBytesUsedByPathsAndVertices = 0;
     fRecord = nullptr;
+    fInterner.reset();
+}
+
+void SkRecorder::setInternContent(bool intern) {
+    if (!intern) {
+        fInterner.reset();
+    } else if (!fInterner) {
+        fInterner = std::make_unique<SkRecordInterner>();
+    }
+}
+
+SkPath SkRecorder::intern(const SkPath& path) {
+    if (!fInterner) {
+        return path;
+    }
+    // Volatile paths are likely to be drawn once and thrown away, so aren't worth pooling.
+    if (path.isVolatile()) {
+        fApproxBytesUsedByPathsAndVertices += path.approximateBytesUsed() - sizeof(SkPath);
+        return path;
+    }
+    // Each pooled path is counted once, when it's first added.
+    auto [pooled, added] = fInterner->intern(path);
+    if (added) {
+        fApproxBytesUsedByPathsAndVertices += pooled.approximateBytesUsed() - sizeof(SkPath);
+    }
+    return pooled;
+}
+
+sk_sp<SkVertices> SkRecorder::intern(const SkVertices* vertices) {
+    if (!fInterner) {
+        return sk_ref_sp(const_cast<SkVertices*>(vertices));
+    }
+    auto [pooled, added] = fInterner->intern(vertices);
+    if (added) {
+        fApproxBytesUsedByPathsAndVertices += pooled->approximateSize();
+    }
+    return pooled;
 }
 
 // To make appending to fRecord a little less verbose.
@@ -184,7 +298,7 @@ void SkRecorder::onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) {
 }
 
 void SkRecorder::onDrawPath(const SkPath& path, const SkPaint& paint) {
-    this->append<SkRecords::DrawPath>(paint, path);
+    this->append<SkRecords::DrawPath>(paint, this->intern(path));
 }
 
 void SkRecorder::onDrawImage2(const SkImage* image, SkScalar x, SkScalar y,
@@ -238,9 +352,7 @@ void SkRecorder::onDrawPicture(const SkPicture* pic, const SkMatrix* matrix, con
 
 void SkRecorder::onDrawVerticesObject(const SkVertices* vertices, SkBlendMode bmode,
                                       const SkPaint& paint) {
-    this->append<SkRecords::DrawVertices>(paint,
-                                          sk_ref_sp(const_cast<SkVertices*>(vertices)),
-                                          bmode);
+    this->append<SkRecords::DrawVertices>(paint, this->intern(vertices), bmode);
 }
 
 void SkRecorder::onDrawPatch(const SkPoint cubics[12], const SkColor colors[4],
@@ -269,7 +381,7 @@ void SkRecorder::onDrawAtlas2(const SkImage* atlas, const SkRSXform xform[], con
 }
 
 void SkRecorder::onDrawShadowRec(const SkPath& path, const SkDrawShadowRec& rec) {
-    this->append<SkRecords::DrawShadowRec>(path, rec);
+    this->append<SkRecords::DrawShadowRec>(this->intern(path), rec);
 }
 
 void SkRecorder::onDrawAnnotation(const SkRect& rect, const char key[], SkData* value) {
@@ -356,7 +468,7 @@ void SkRecorder::onClipRRect(const SkRRect& rrect, SkClipOp op, ClipEdgeStyle ed
 void SkRecorder::onClipPath(const SkPath& path, SkClipOp op, ClipEdgeStyle edgeStyle) {
     INHERITED(onClipPath, path, op, edgeStyle);
     SkRecords::ClipOpAndAA opAA(op, kSoft_ClipEdgeStyle == edgeStyle);
-    this->append<SkRecords::ClipPath>(path, opAA);
+    this->append<SkRecords::ClipPath>(this->intern(path), opAA);
 }
 
 void SkRecorder::onClipShader(sk_sp<SkShader> cs, SkClipOp op) {
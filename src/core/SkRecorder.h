@@ -16,6 +16,7 @@
 #include "src/core/SkRecords.h"
 
 class SkBBHFactory;
+class SkRecordInterner;
 
 class SkDrawableList : SkNoncopyable {
 public:
@@ -37,16 +38,25 @@ private:
 
 // SkRecorder provides an SkCanvas interface for recording into an SkRecord.
 
-class SkRecorder final : public SkCanvasVirtualEnforcer<SkNoDrawCanvas> {
+class SkRecorder : public SkCanvasVirtualEnforcer<SkNoDrawCanvas> {
 public:
     // Does not take ownership of the SkRecord.
     SkRecorder(SkRecord*, int width, int height);   // TODO: remove
     SkRecorder(SkRecord*, const SkRect& bounds);
+    ~SkRecorder() override;
 
     void reset(SkRecord*, const SkRect& bounds);
 
+    // When enabled, paths and vertices with the same contents are recorded as references to one
+    // shared copy. This costs a hash of each payload, so is best for repetitive content.
+    void setInternContent(bool);
+
     size_t approxBytesUsedBySubPictures() const { return fApproxBytesUsedBySubPictures; }
 
+    // Paths and vertices keep their payloads outside the SkRecord. While interning, this
+    // approximates the bytes of the payloads recorded, counting each pooled one once.
+    size_t approxBytesUsedByPathsAndVertices() const { return fApproxBytesUsedByPathsAndVertices; }
+
     SkDrawableList* getDrawableList() const { return fDrawableList.get(); }
     std::unique_ptr<SkDrawableList> detachDrawableList() { return std::move(fDrawableList); }
 
@@ -132,9 +142,14 @@ private:
     template<typename T, typename... Args>
     void append(Args&&...);
 
+    SkPath intern(const SkPath&);
+    sk_sp<SkVertices> intern(const SkVertices*);
+
     size_t fApproxBytesUsedBySubPictures;
+    size_t fApproxBytesUsedByPathsAndVertices = 0;
     SkRecord* fRecord;
     std::unique_ptr<SkDrawableList> fDrawableList;
+    std::unique_ptr<SkRecordInterner> fInterner;
 };
 
 #endif//SkRecorder_DEFINED
@@ -45,6 +45,11 @@ static inline bool SkShouldPostMessageToBus(
     #define SK_DEFAULT_IMAGE_CACHE_LIMIT     (32 * 1024 * 1024)
 #endif
 
+// The global cache is split into 1 << SK_RESOURCE_CACHE_SHARD_BITS shards.
+#ifndef SK_RESOURCE_CACHE_SHARD_BITS
+    #define SK_RESOURCE_CACHE_SHARD_BITS     3
+#endif
+
 void SkResourceCache::Key::init(void* nameSpace, uint64_t sharedID, size_t dataSize) {
     SkASSERT(SkAlign4(dataSize) == dataSize);
 
@@ -91,6 +96,9 @@ void SkResourceCache::init() {
     fTotalBytesUsed = 0;
     fCount = 0;
     fSingleAllocationByteLimit = 0;
+    fSharedBytesUsed = nullptr;
+    fShardCount = 1;
+    fShardBytesUsed = nullptr;
 
     // One of these should be explicit set by the caller after we return.
     fTotalByteLimit = 0;
@@ -125,7 +133,7 @@ bool SkResourceCache::find(const Key& key, FindVisitor visitor, void* context) {
     this->checkMessages();
 
     auto found = fHash->find(key);
-    SkRecordReplayAssert("[RUN-593] SkResourceCache::find %d", !!found);
+    SkRecordReplayAssertValues(SK_RECORD_REPLAY_SITE("[RUN-593] SkResourceCache::find"), !!found);
     if (found) {
         Rec* rec = *found;
         if (visitor(*rec, context)) {
@@ -203,6 +211,10 @@ void SkResourceCache::remove(Rec* rec) {
 
     fTotalBytesUsed -= used;
     fCount -= 1;
+    if (fSharedBytesUsed) {
+        fSharedBytesUsed->fetch_sub(used, std::memory_order_relaxed);
+        fShardBytesUsed->store(fTotalBytesUsed, std::memory_order_relaxed);
+    }
 
     //SkDebugf("-RC count [%3d] bytes %d\n", fCount, fTotalBytesUsed);
 
@@ -222,7 +234,7 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
     int    countLimit;
 
     if (fDiscardableFactory) {
-        countLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
+        countLimit = std::max(SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT / fShardCount, 1);
         byteLimit = UINT32_MAX;  // no limit based on bytes
     } else {
         countLimit = SK_MaxS32; // no limit based on count
@@ -231,7 +243,7 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
 
     Rec* rec = fTail;
     while (rec) {
-        if (!forcePurge && fTotalBytesUsed < byteLimit && fCount < countLimit) {
+        if (!forcePurge && !this->overBudget(byteLimit, countLimit)) {
             break;
         }
 
@@ -243,6 +255,18 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
     }
 }
 
+bool SkResourceCache::overBudget(size_t byteLimit, int countLimit) const {
+    if (fCount >= countLimit) {
+        return true;
+    }
+    if (fTotalBytesUsed < byteLimit) {
+        return false;
+    }
+    // A shard over its share only has to give it back once the shards together are over budget.
+    return !fSharedBytesUsed ||
+           fSharedBytesUsed->load(std::memory_order_relaxed) >= byteLimit * fShardCount;
+}
+
 //#define SK_TRACK_PURGE_SHAREDID_HITRATE
 
 #ifdef SK_TRACK_PURGE_SHAREDID_HITRATE
@@ -381,6 +405,10 @@ void SkResourceCache::addToHead(Rec* rec) {
     }
     fTotalBytesUsed += rec->bytesUsed();
     fCount += 1;
+    if (fSharedBytesUsed) {
+        fSharedBytesUsed->fetch_add(rec->bytesUsed(), std::memory_order_relaxed);
+        fShardBytesUsed->store(fTotalBytesUsed, std::memory_order_relaxed);
+    }
 
     this->validate();
 }
@@ -477,95 +505,196 @@ void SkResourceCache::checkMessages() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-static SkResourceCache* gResourceCache = nullptr;
-static SkMutex& resource_cache_mutex() {
-    static SkMutex& mutex = *(new SkMutex("SkResourceCache"));
-    return mutex;
-}
+/**
+ *  The global cache: 1 << SK_RESOURCE_CACHE_SHARD_BITS SkResourceCaches, each guarded by its own
+ *  mutex. A key always maps to the same shard, picked by the top bits of its hash (each shard's
+ *  hash table indexes by the low bits). The shards split the byte budget evenly, but a shard may
+ *  hold more than its share while the shards together are within the budget, so single large
+ *  entries fit just as they did in one unsharded cache.
+ *
+ *  Purge messages fan out to every shard on their own: each shard has its own inbox, and
+ *  SkShouldPostMessageToBus() delivers every message to every inbox.
+ */
+class SkResourceCache::GlobalCache {
+public:
+    static constexpr int kShardBits = SK_RESOURCE_CACHE_SHARD_BITS;
+    static constexpr int kShardCount = 1 << kShardBits;
+    static_assert(kShardBits >= 0 && kShardBits < 32, "bad SK_RESOURCE_CACHE_SHARD_BITS");
+
+    struct Shard {
+        SkMutex             fMutex{"SkResourceCache"};
+        SkResourceCache*    fCache SK_GUARDED_BY(fMutex);
+        std::atomic<size_t> fBytesUsed{0};  // fCache's bytes used, readable without fMutex.
+    };
+
+    static GlobalCache& Get() {
+        static GlobalCache& cache = *(new GlobalCache);
+        return cache;
+    }
+
+    Shard& shardFor(const Key& key) {
+        return fShards[kShardBits ? key.hash() >> (32 - kShardBits) : 0];
+    }
+
+    template <typename Fn>
+    void forEachShard(Fn&& fn) {
+        for (Shard& shard : fShards) {
+            SkAutoMutexExclusive am(shard.fMutex);
+            fn(shard.fCache);
+        }
+    }
+
+    DiscardableFactory discardableFactory() const { return fDiscardableFactory; }
+    size_t totalBytesUsed() const { return fTotalBytesUsed.load(std::memory_order_relaxed); }
+    size_t totalByteLimit() const { return fTotalByteLimit.load(std::memory_order_relaxed); }
+
+    size_t setTotalByteLimit(size_t newLimit) {
+        size_t prevLimit = fTotalByteLimit.exchange(newLimit, std::memory_order_relaxed);
+        this->forEachShard([&](SkResourceCache* cache) {
+            cache->setTotalByteLimit(ShareOf(newLimit));
+        });
+        return prevLimit;
+    }
 
-/** Must hold resource_cache_mutex() when calling. */
-static SkResourceCache* get_cache() {
-    // resource_cache_mutex() is always held when this is called, so we don't need to be fancy in here.
-    resource_cache_mutex().assertHeld();
-    if (nullptr == gResourceCache) {
+    size_t setSingleAllocationByteLimit(size_t newLimit) {
+        return fSingleAllocationByteLimit.exchange(newLimit, std::memory_order_relaxed);
+    }
+    size_t singleAllocationByteLimit() const {
+        return fSingleAllocationByteLimit.load(std::memory_order_relaxed);
+    }
+
+    // Same as SkResourceCache::getEffectiveSingleAllocationByteLimit(), against the whole budget.
+    size_t effectiveSingleAllocationByteLimit() const {
+        size_t limit = this->singleAllocationByteLimit();
+        if (nullptr == fDiscardableFactory) {
+            size_t totalLimit = this->totalByteLimit();
+            limit = (0 == limit) ? totalLimit : std::min(limit, totalLimit);
+        }
+        return limit;
+    }
+
+    // A shard only purges its own LRU list, so an add() that pushes the whole cache over budget
+    // may leave the excess in other shards. Only shards over their share have anything to give
+    // back, so only those are locked, and we stop once the cache is back within budget. Called
+    // without any shard mutex held.
+    void purgeIfOverBudget() {
+        if (fDiscardableFactory) {
+            return;
+        }
+        const size_t limit = this->totalByteLimit(),
+                     share = ShareOf(limit);
+        for (Shard& shard : fShards) {
+            if (this->totalBytesUsed() < limit) {
+                break;
+            }
+            if (shard.fBytesUsed.load(std::memory_order_relaxed) >= share) {
+                SkAutoMutexExclusive am(shard.fMutex);
+                shard.fCache->purgeAsNeeded();
+            }
+        }
+    }
+
+private:
+    GlobalCache() {
 #ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
-        gResourceCache = new SkResourceCache(SkDiscardableMemory::Create);
+        fDiscardableFactory = SkDiscardableMemory::Create;
+        fTotalByteLimit = 0;
 #else
-        gResourceCache = new SkResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
+        fDiscardableFactory = nullptr;
+        fTotalByteLimit = SK_DEFAULT_IMAGE_CACHE_LIMIT;
 #endif
+        for (Shard& shard : fShards) {
+            SkAutoMutexExclusive am(shard.fMutex);
+            shard.fCache = fDiscardableFactory
+                                 ? new SkResourceCache(fDiscardableFactory)
+                                 : new SkResourceCache(ShareOf(SK_DEFAULT_IMAGE_CACHE_LIMIT));
+            shard.fCache->fSharedBytesUsed = &fTotalBytesUsed;
+            shard.fCache->fShardCount = kShardCount;
+            shard.fCache->fShardBytesUsed = &shard.fBytesUsed;
+        }
     }
-    return gResourceCache;
-}
+
+    static size_t ShareOf(size_t limit) {
+        return limit / kShardCount + (limit % kShardCount ? 1 : 0);
+    }
+
+    Shard                fShards[kShardCount];
+    DiscardableFactory   fDiscardableFactory;
+    std::atomic<size_t>  fTotalBytesUsed{0};
+    std::atomic<size_t>  fTotalByteLimit;
+    std::atomic<size_t>  fSingleAllocationByteLimit{0};
+};
 
 size_t SkResourceCache::GetTotalBytesUsed() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->getTotalBytesUsed();
+    return GlobalCache::Get().totalBytesUsed();
 }
 
 size_t SkResourceCache::GetTotalByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->getTotalByteLimit();
+    return GlobalCache::Get().totalByteLimit();
 }
 
 size_t SkResourceCache::SetTotalByteLimit(size_t newLimit) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->setTotalByteLimit(newLimit);
+    return GlobalCache::Get().setTotalByteLimit(newLimit);
 }
 
 SkResourceCache::DiscardableFactory SkResourceCache::GetDiscardableFactory() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->discardableFactory();
+    return GlobalCache::Get().discardableFactory();
 }
 
 SkCachedData* SkResourceCache::NewCachedData(size_t bytes) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->newCachedData(bytes);
+    // Allocating doesn't touch any shard's state, so there is no need to lock one.
+    if (DiscardableFactory factory = GlobalCache::Get().discardableFactory()) {
+        SkDiscardableMemory* dm = factory(bytes);
+        return dm ? new SkCachedData(bytes, dm) : nullptr;
+    }
+    return new SkCachedData(sk_malloc_throw(bytes), bytes);
 }
 
 void SkResourceCache::Dump() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    get_cache()->dump();
+    GlobalCache::Get().forEachShard([](SkResourceCache* cache) { cache->dump(); });
 }
 
 size_t SkResourceCache::SetSingleAllocationByteLimit(size_t size) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->setSingleAllocationByteLimit(size);
+    return GlobalCache::Get().setSingleAllocationByteLimit(size);
 }
 
 size_t SkResourceCache::GetSingleAllocationByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->getSingleAllocationByteLimit();
+    return GlobalCache::Get().singleAllocationByteLimit();
 }
 
 size_t SkResourceCache::GetEffectiveSingleAllocationByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->getEffectiveSingleAllocationByteLimit();
+    return GlobalCache::Get().effectiveSingleAllocationByteLimit();
 }
 
 void SkResourceCache::PurgeAll() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->purgeAll();
+    GlobalCache::Get().forEachShard([](SkResourceCache* cache) { cache->purgeAll(); });
 }
 
 void SkResourceCache::CheckMessages() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->checkMessages();
+    GlobalCache::Get().forEachShard([](SkResourceCache* cache) { cache->checkMessages(); });
 }
 
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    bool rv = get_cache()->find(key, visitor, context);
+    GlobalCache::Shard& shard = GlobalCache::Get().shardFor(key);
+    SkAutoMutexExclusive am(shard.fMutex);
+    bool rv = shard.fCache->find(key, visitor, context);
     return rv;
 }
 
 void SkResourceCache::Add(Rec* rec, void* payload) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    get_cache()->add(rec, payload);
+    GlobalCache& global = GlobalCache::Get();
+    {
+        GlobalCache::Shard& shard = global.shardFor(rec->getKey());
+        SkAutoMutexExclusive am(shard.fMutex);
+        shard.fCache->add(rec, payload);
+    }
+    global.purgeIfOverBudget();
 }
 
 void SkResourceCache::VisitAll(Visitor visitor, void* context) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    get_cache()->visitAll(visitor, context);
+    GlobalCache::Get().forEachShard([&](SkResourceCache* cache) {
+        cache->visitAll(visitor, context);
+    });
 }
 
 void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
@@ -12,6 +12,8 @@
 #include "include/private/SkTDArray.h"
 #include "src/core/SkMessageBus.h"
 
+#include <atomic>
+
 class SkCachedData;
 class SkDiscardableMemory;
 class SkTraceMemoryDump;
@@ -25,6 +27,8 @@ class SkTraceMemoryDump;
  *
  *  As a convenience, a global instance is also defined, which can be safely
  *  access across threads via the static methods (e.g. FindAndLock, etc.).
+ *  The global instance is split into shards by key hash, each with its own
+ *  mutex and LRU list, so threads looking up unrelated keys do not contend.
  */
 class SkResourceCache {
 public:
@@ -258,6 +262,8 @@ public:
     void dump() const;
 
 private:
+    class GlobalCache;
+
     Rec*    fHead;
     Rec*    fTail;
 
@@ -271,10 +277,18 @@ private:
     size_t  fSingleAllocationByteLimit;
     int     fCount;
 
+    // Set when this cache is one shard of the global cache. fTotalByteLimit is then this shard's
+    // share of the budget; the shard may run over it as long as all shards together fit.
+    std::atomic<size_t>* fSharedBytesUsed;
+    int                  fShardCount;
+    // Also set for a shard: mirrors fTotalBytesUsed, for readers not holding the shard's mutex.
+    std::atomic<size_t>* fShardBytesUsed;
+
     SkMessageBus<PurgeSharedIDMessage, uint32_t>::Inbox fPurgeSharedIDInbox;
 
     void checkMessages();
     void purgeAsNeeded(bool forcePurge = false);
+    bool overBudget(size_t byteLimit, int countLimit) const;
 
     // linklist management
     void moveToHead(Rec*);
@@ -37,7 +37,8 @@ SkScalerCache::SkScalerCache(
         , fFontMetrics{use_or_generate_metrics(fontMetrics, fScalerContext.get())}
         , fRoundingSpec{fScalerContext->isSubpixel(),
                         fScalerContext->computeAxisAlignmentForHText()}
-        , fMu("SkScalerCache.fMu") {
+        , fMu("SkScalerCache.fMu")
+        , fPublishGlyphs{!SkRecordReplayIsRecordingOrReplaying()} {
     SkASSERT(fScalerContext != nullptr);
 }
 
@@ -50,7 +51,8 @@ std::tuple<SkGlyphDigest, size_t> SkScalerCache::digest(SkPackedGlyphID packedGl
     SkGlyphDigest* digest = fDigestForPackedGlyphID.find(packedGlyphID);
 
     // https://linear.app/replay/issue/RUN-480
-    SkRecordReplayAssert("SkScalerCache::digest %d %d", packedGlyphID, !!digest);
+    SkRecordReplayAssertValues(SK_RECORD_REPLAY_SITE("SkScalerCache::digest"),
+                               packedGlyphID.value(), !!digest);
 
     if (digest != nullptr) {
         return {*digest, 0};
@@ -72,6 +74,59 @@ SkGlyphDigest SkScalerCache::addGlyph(SkGlyph* glyph) {
     return digest;
 }
 
+const SkScalerCache::PublishedGlyph* SkScalerCache::findPublished(
+        SkPackedGlyphID packedID) const {
+    const PublishedTable* table = fPublished.load(std::memory_order_acquire);
+    if (table == nullptr) {
+        return nullptr;
+    }
+    for (uint32_t i = packedID.hash() & table->fMask;; i = (i + 1) & table->fMask) {
+        const PublishedGlyph* published = table->fSlots[i].load(std::memory_order_acquire);
+        if (published == nullptr || published->fPackedID == packedID) {
+            return published;
+        }
+    }
+}
+
+size_t SkScalerCache::publish(SkGlyph* glyph, SkGlyphDigest digest) {
+    if (!fPublishGlyphs || this->findPublished(glyph->getPackedID()) != nullptr) {
+        return 0;
+    }
+
+    auto insert = [](const PublishedTable& table, const PublishedGlyph* published) {
+        uint32_t i = published->fPackedID.hash() & table.fMask;
+        while (table.fSlots[i].load(std::memory_order_relaxed) != nullptr) {
+            i = (i + 1) & table.fMask;
+        }
+        table.fSlots[i].store(published, std::memory_order_release);
+    };
+
+    size_t delta = 0;
+    const PublishedTable* table = fPublished.load(std::memory_order_relaxed);
+    if (table == nullptr || 2 * (fPublishedCount + 1) > table->fMask + 1) {
+        const uint32_t capacity = table ? 2 * (table->fMask + 1) : kMinPublishedCapacity;
+        auto grown = fAlloc.make<PublishedTable>(PublishedTable{
+                fAlloc.makeArray<std::atomic<const PublishedGlyph*>>(capacity), capacity - 1});
+        if (table != nullptr) {
+            for (uint32_t i = 0; i <= table->fMask; ++i) {
+                if (auto published = table->fSlots[i].load(std::memory_order_relaxed)) {
+                    insert(*grown, published);
+                }
+            }
+        }
+        fPublished.store(grown, std::memory_order_release);
+        table = grown;
+        delta += sizeof(PublishedTable) + capacity * sizeof(grown->fSlots[0]);
+    }
+
+    SkASSERT(glyph->setImageHasBeenCalled());
+    auto published = fAlloc.make<PublishedGlyph>(
+            PublishedGlyph{glyph->getPackedID(), digest, glyph, glyph->image()});
+    insert(*table, published);
+    fPublishedCount += 1;
+    return delta + sizeof(PublishedGlyph);
+}
+
 size_t SkScalerCache::preparePath(SkGlyph* glyph) {
     size_t delta = 0;
     if (glyph->setPath(&fAlloc, fScalerContext.get())) {
@@ -200,12 +255,27 @@ size_t SkScalerCache::glyphIDsToPaths(SkSpan<sktext::IDOrPath> idsOrPaths) {
 std::tuple<SkSpan<const SkGlyph*>, size_t> SkScalerCache::prepareImages(
         SkSpan<const SkPackedGlyphID> glyphIDs, const SkGlyph* results[]) {
     const SkGlyph** cursor = results;
+
+    // Warm glyphs need no lock; stop at the first one that has not been published.
+    size_t start = 0;
+    for (; start < glyphIDs.size(); ++start) {
+        const PublishedGlyph* published = this->findPublished(glyphIDs[start]);
+        if (published == nullptr) {
+            break;
+        }
+        *cursor++ = published->fGlyph;
+    }
+    if (start == glyphIDs.size()) {
+        return {{results, glyphIDs.size()}, 0};
+    }
+
     SkAutoMutexExclusive lock{fMu};
     size_t delta = 0;
-    for (auto glyphID : glyphIDs) {
+    for (auto glyphID : glyphIDs.subspan(start)) {
         auto[glyph, glyphSize] = this->glyph(glyphID);
         auto[_, imageSize] = this->prepareImage(glyph);
         delta += glyphSize + imageSize;
+        delta += this->publish(glyph, *fDigestForPackedGlyphID.find(glyphID));
         *cursor++ = glyph;
     }
 
@@ -254,18 +324,23 @@ std::tuple<SkScalar, size_t> SkScalerCache::findMaximumGlyphDimension(
 }
 
 template <typename Fn>
-size_t SkScalerCache::commonFilterLoop(SkDrawableGlyphBuffer* accepted, Fn&& fn) {
+size_t SkScalerCache::commonFilterLoop(
+        SkZip<SkGlyphVariant, SkPoint> input, size_t start, Fn&& fn) {
     size_t total = 0;
-    for (auto [i, packedID, pos] : SkMakeEnumerate(accepted->input())) {
+    for (auto [i, packedID, pos] : SkMakeEnumerate(input).last(input.size() - start)) {
         // https://linear.app/replay/issue/RUN-480
-        SkRecordReplayAssert("SkScalerCache::commonFilterLoop #2 %d %d %d",
-                             i, packedID, SkScalarsAreFinite(pos.x(), pos.y()));
+        SkRecordReplayAssertValues(SK_RECORD_REPLAY_SITE("SkScalerCache::commonFilterLoop #2"),
+                                   i, packedID.packedID().value(),
+                                   SkScalarsAreFinite(pos.x(), pos.y()));
 
         if (SkScalarsAreFinite(pos.x(), pos.y())) {
             auto [digest, size] = this->digest(packedID);
             total += size;
             if (!digest.isEmpty()) {
                 fn(i, digest, pos);
+            } else {
+                // There is nothing to prepare for an empty glyph, so it is final already.
+                total += this->publish(fGlyphForIndex[digest.index()], digest);
             }
         }
     }
@@ -273,9 +348,31 @@ size_t SkScalerCache::commonFilterLoop(SkDrawableGlyphBuffer* accepted, Fn&& fn)
 }
 
 size_t SkScalerCache::prepareForDrawingMasksCPU(SkDrawableGlyphBuffer* accepted) {
+    SkZip<SkGlyphVariant, SkPoint> input = accepted->input();
+
+    // Warm glyphs need no lock; stop at the first one that has not been published. Accepting
+    // glyph i only overwrites entries at or before i, so the locked loop can pick up from there.
+    size_t start = 0;
+    for (; start < input.size(); ++start) {
+        auto [packedID, pos] = input[start];
+        if (!SkScalarsAreFinite(pos.x(), pos.y())) {
+            continue;
+        }
+        const PublishedGlyph* published = this->findPublished(packedID.packedID());
+        if (published == nullptr) {
+            break;
+        }
+        if (!published->fDigest.isEmpty() && published->fImage != nullptr) {
+            accepted->accept(published->fGlyph, start);
+        }
+    }
+    if (start == input.size()) {
+        return 0;
+    }
+
     SkAutoMutexExclusive lock{fMu};
     size_t imageDelta = 0;
-    size_t delta = this->commonFilterLoop(accepted,
+    size_t delta = this->commonFilterLoop(input, start,
         [&](size_t i, SkGlyphDigest digest, SkPoint pos) SK_REQUIRES(fMu) {
             // If the glyph is too large, then no image is created.
             SkGlyph* glyph = fGlyphForIndex[digest.index()];
@@ -284,6 +381,7 @@ size_t SkScalerCache::prepareForDrawingMasksCPU(SkDrawableGlyphBuffer* accepted)
                 accepted->accept(glyph, i);
                 imageDelta += imageSize;
             }
+            imageDelta += this->publish(glyph, digest);
         });
 
     return delta + imageDelta;
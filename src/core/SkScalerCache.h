@@ -17,6 +17,7 @@
 #include "src/core/SkGlyph.h"
 #include "src/core/SkGlyphRunPainter.h"
 
+#include <atomic>
 #include <memory>
 
 class SkScalerContext;
@@ -109,7 +110,8 @@ public:
 
 private:
     template <typename Fn>
-    size_t commonFilterLoop(SkDrawableGlyphBuffer* accepted, Fn&& fn) SK_REQUIRES(fMu);
+    size_t commonFilterLoop(SkZip<SkGlyphVariant, SkPoint> input, size_t start, Fn&& fn)
+            SK_REQUIRES(fMu);
 
     // Return a glyph. Create it if it doesn't exist, and initialize the glyph with metrics and
     // advances using a scaler.
@@ -128,6 +130,28 @@ private:
     // If the drawable has never been set, then use the scaler context to add the glyph.
     size_t prepareDrawable(SkGlyph*) SK_REQUIRES(fMu);
 
+    // A glyph whose digest and image are final, so it can be read without holding fMu.
+    struct PublishedGlyph {
+        SkPackedGlyphID fPackedID;
+        SkGlyphDigest   fDigest;
+        SkGlyph*        fGlyph;
+        const void*     fImage;
+    };
+
+    // An open addressed table of PublishedGlyphs, at most half full.
+    struct PublishedTable {
+        std::atomic<const PublishedGlyph*>* fSlots;
+        uint32_t                            fMask;
+    };
+
+    // Return the published glyph for packedID, or nullptr. Takes no lock; a miss only means the
+    // caller must take fMu and use the regular path.
+    const PublishedGlyph* findPublished(SkPackedGlyphID packedID) const;
+
+    // Make a glyph whose image has been prepared visible to findPublished. Returns the number of
+    // bytes allocated.
+    size_t publish(SkGlyph* glyph, SkGlyphDigest digest) SK_REQUIRES(fMu);
+
     enum PathDetail {
         kMetricsOnly,
         kMetricsAndPath
@@ -160,6 +184,16 @@ private:
     inline static constexpr size_t kMinAllocAmount = kMinGlyphImageSize * kMinGlyphCount;
 
     SkArenaAlloc            fAlloc SK_GUARDED_BY(fMu) {kMinAllocAmount};
+
+    // Glyphs are only published when not recording or replaying: a lock free hit depends on
+    // thread timing, which would let a replay take a different path than the recording.
+    const bool fPublishGlyphs;
+
+    // Append only: tables and entries live in fAlloc, and a full table is replaced by a copy
+    // twice its size, so readers holding an old table still see valid (if incomplete) data.
+    std::atomic<const PublishedTable*> fPublished{nullptr};
+    uint32_t fPublishedCount SK_GUARDED_BY(fMu) = 0;
+    inline static constexpr uint32_t kMinPublishedCapacity = 64;
 };
 
 #endif  // SkStrike_DEFINED
@@ -5,8 +5,10 @@
  * found in the LICENSE file.
  */
 
+#include "include/private/SkMutex.h"
 #include "include/private/SkSemaphore.h"
 #include "src/core/SkLeanWindows.h"
+#include "src/core/SkTraceEvent.h"
 
 #ifndef _WIN32
 #include <dlfcn.h>
@@ -16,45 +18,83 @@
 
 static void* LookupRecordReplaySymbol(const char* name) {
 #ifndef _WIN32
-  void* fnptr = dlsym(RTLD_DEFAULT, name);
+  return dlsym(RTLD_DEFAULT, name);
 #else
   HMODULE module = GetModuleHandleA("windows-recordreplay.dll");
-  void* fnptr = module ? (void*)GetProcAddress(module, name) : nullptr;
+  return module ? (void*)GetProcAddress(module, name) : nullptr;
 #endif
-  return fnptr ? fnptr : reinterpret_cast<void*>(1);
+}
+
+// Resolved by SkRecordReplayProbeOrderedLocks() before it publishes gSkRecordReplayOrderedLocks,
+// and only written again by SkRecordReplaySetOrderedLocksForTesting().
+static int  (*gCreateOrderedLock)(const char*);
+static void (*gOrderedLock)(int);
+static void (*gOrderedUnlock)(int);
+
+std::atomic<int> gSkRecordReplayOrderedLocks{-1};
+
+bool SkRecordReplayProbeOrderedLocks() {
+  static SkOnce once;
+  once([] {
+    gCreateOrderedLock = reinterpret_cast<int(*)(const char*)>(
+        LookupRecordReplaySymbol("RecordReplayCreateOrderedLock"));
+    gOrderedLock = reinterpret_cast<void(*)(int)>(
+        LookupRecordReplaySymbol("RecordReplayOrderedLock"));
+    gOrderedUnlock = reinterpret_cast<void(*)(int)>(
+        LookupRecordReplaySymbol("RecordReplayOrderedUnlock"));
+    bool available = gCreateOrderedLock && gOrderedLock && gOrderedUnlock;
+    gSkRecordReplayOrderedLocks.store(available ? 1 : 0, std::memory_order_release);
+  });
+  return gSkRecordReplayOrderedLocks.load(std::memory_order_acquire) != 0;
+}
+
+void SkRecordReplaySetOrderedLocksForTesting(int (*createLock)(const char*),
+                                             void (*lock)(int),
+                                             void (*unlock)(int)) {
+  bool runtimeHasLocks = SkRecordReplayProbeOrderedLocks();
+  static int  (*runtimeCreateOrderedLock)(const char*) = gCreateOrderedLock;
+  static void (*runtimeOrderedLock)(int) = gOrderedLock;
+  static void (*runtimeOrderedUnlock)(int) = gOrderedUnlock;
+  static bool runtimeAvailable = runtimeHasLocks;
+
+  bool install = createLock && lock && unlock;
+  gCreateOrderedLock = install ? createLock : runtimeCreateOrderedLock;
+  gOrderedLock = install ? lock : runtimeOrderedLock;
+  gOrderedUnlock = install ? unlock : runtimeOrderedUnlock;
+  gSkRecordReplayOrderedLocks.store(install || runtimeAvailable ? 1 : 0,
+                                    std::memory_order_release);
 }
 
 int SkRecordReplayCreateOrderedLock(const char* ordered_name) {
-  static void* fnptr;
-  if (!fnptr) {
-    fnptr = LookupRecordReplaySymbol("RecordReplayCreateOrderedLock");
-  }
-  if (fnptr != reinterpret_cast<void*>(1)) {
-    return reinterpret_cast<int(*)(const char*)>(fnptr)(ordered_name);
+  if (SkRecordReplayHasOrderedLocks()) {
+    return gCreateOrderedLock(ordered_name);
   }
   return 0;
 }
 
+// Only reached with a lock id from SkRecordReplayCreateOrderedLock(), so already probed.
 void SkRecordReplayOrderedLock(int lock) {
-  static void* fnptr;
-  if (!fnptr) {
-    fnptr = LookupRecordReplaySymbol("RecordReplayOrderedLock");
-  }
-  if (fnptr != reinterpret_cast<void*>(1)) {
-    reinterpret_cast<void(*)(int)>(fnptr)(lock);
-  }
+  SkASSERT(gOrderedLock);
+  gOrderedLock(lock);
 }
 
 void SkRecordReplayOrderedUnlock(int lock) {
-  static void* fnptr;
-  if (!fnptr) {
-    fnptr = LookupRecordReplaySymbol("RecordReplayOrderedUnlock");
-  }
-  if (fnptr != reinterpret_cast<void*>(1)) {
-    reinterpret_cast<void(*)(int)>(fnptr)(lock);
-  }
+  SkASSERT(gOrderedUnlock);
+  gOrderedUnlock(lock);
 }
 
+#if defined(SK_MUTEX_STATS)
+#if defined(SK_BUILD_FOR_ANDROID_FRAMEWORK)
+    #error "SK_MUTEX_STATS reports through SkEventTracer, which ATrace builds don't use."
+#endif
+
+void SkMutexReportStats(const char* name, uint32_t acquisitions, uint32_t contentions) {
+    TRACE_COUNTER2("skia.mutex", name,
+                   "acquisitions", acquisitions,
+                   "contentions", contentions);
+}
+#endif
+
 #if defined(SK_BUILD_FOR_MAC) || defined(SK_BUILD_FOR_IOS)
     #include <dispatch/dispatch.h>
 
@@ -6,8 +6,12 @@
  */
 
 #include "include/core/SkExecutor.h"
+#include "src/core/SkRecordReplay.h"
 #include "src/core/SkTaskGroup.h"
 
+#include <algorithm>
+#include <memory>
+
 SkTaskGroup::SkTaskGroup(SkExecutor& executor) : fPending(0), fExecutor(executor) {}
 
 void SkTaskGroup::add(std::function<void(void)> fn) {
@@ -19,11 +23,52 @@ void SkTaskGroup::add(std::function<void(void)> fn) {
 }
 
 void SkTaskGroup::batch(int N, std::function<void(int)> fn) {
-    // TODO: I really thought we had some sort of more clever chunking logic.
-    fPending.fetch_add(+N, std::memory_order_relaxed);
-    for (int i = 0; i < N; i++) {
-        fExecutor.add([=] {
-            fn(i);
+    if (N <= 0) {
+        return;
+    }
+    // Rather than adding N tiny tasks, add a few tasks that each claim chunks of indices from a
+    // shared counter until none are left.  This keeps executor queue traffic proportional to the
+    // number of threads rather than to N, and still balances load when some fn(i) are slower.
+    struct Batch {
+        std::function<void(int)> fn;
+        int                      N, chunk;
+        std::atomic<int>         next{0};
+    };
+    const int tasks = std::min(N, kMaxBatchTasks);
+    auto shared = std::make_shared<Batch>();
+    shared->fn    = std::move(fn);
+    shared->N     = N;
+    shared->chunk = std::max(1, N / (tasks * 4));
+
+    fPending.fetch_add(+tasks, std::memory_order_relaxed);
+    if (fExecutor.isDeterministic()) {
+        // Which task claims which chunk would depend on timing, so deal the chunks out up front.
+        for (int t = 0; t < tasks; t++) {
+            fExecutor.add([this, shared, t, tasks] {
+                const int stride = tasks * shared->chunk;
+                for (int start = t * shared->chunk; start < shared->N; start += stride) {
+                    int end = std::min(start + shared->chunk, shared->N);
+                    for (int i = start; i < end; i++) {
+                        shared->fn(i);
+                    }
+                }
+                fPending.fetch_add(-1, std::memory_order_release);
+            });
+        }
+        return;
+    }
+    for (int t = 0; t < tasks; t++) {
+        fExecutor.add([this, shared] {
+            for (;;) {
+                int start = shared->next.fetch_add(shared->chunk, std::memory_order_relaxed);
+                if (start >= shared->N) {
+                    break;
+                }
+                int end = std::min(start + shared->chunk, shared->N);
+                for (int i = start; i < end; i++) {
+                    shared->fn(i);
+                }
+            }
             fPending.fetch_add(-1, std::memory_order_release);
         });
     }
@@ -45,7 +90,10 @@ void SkTaskGroup::wait() {
 
 SkTaskGroup::Enabler::Enabler(int threads) {
     if (threads) {
-        fThreadPool = SkExecutor::MakeLIFOThreadPool(threads);
+        // When recording or replaying, work must run the same way both times.
+        fThreadPool = SkRecordReplayIsRecordingOrReplaying()
+                              ? SkExecutor::MakeDeterministicPool(threads)
+                              : SkExecutor::MakeLIFOThreadPool(threads);
         SkExecutor::SetDefault(fThreadPool.get());
     }
 }
@@ -41,6 +41,9 @@ public:
     };
 
 private:
+    // batch() splits its N calls across at most this many executor tasks.
+    static constexpr int kMaxBatchTasks = 64;
+
     std::atomic<int32_t> fPending;
     SkExecutor&          fExecutor;
 };
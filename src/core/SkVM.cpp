@@ -102,7 +102,7 @@ bool gSkVMJITViaDylib{false};
 
 namespace skvm {
 
-    static Features detect_features() {
+    Features detect_features() {
         static const bool fma =
         #if defined(SK_CPU_X86)
             SkCpu::Supports(SkCpu::HSW);
@@ -2697,6 +2697,13 @@ namespace skvm {
     int  Program::loop () const { return fImpl->loop; }
     bool Program::empty() const { return fImpl->instructions.empty(); }
 
+    size_t Program::approximateBytesUsed() const {
+        return sizeof(Impl)
+             + fImpl->instructions.capacity() * sizeof(InterpreterInstruction)
+             + fImpl->strides.capacity()      * sizeof(int)
+             + fImpl->jit_size;
+    }
+
     // Translate OptimizedInstructions to InterpreterInstructions.
     void Program::setupInterpreter(const std::vector<OptimizedInstruction>& instructions) {
         // Register each instruction is assigned to.
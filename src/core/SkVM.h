@@ -600,6 +600,9 @@ namespace skvm {
         bool fp16  = false;
     };
 
+    // The Features a Builder targets by default on this CPU.
+    Features detect_features();
+
     class TraceHook {
     public:
         virtual ~TraceHook() = default;
@@ -625,6 +628,10 @@ namespace skvm {
         std::vector<Instruction> program() const { return fProgram; }
         std::vector<OptimizedInstruction> optimize(viz::Visualizer* visualizer = nullptr) const;
 
+        // With optimize(), everything done() passes to Program's constructor.
+        const std::vector<int>&        strides()    const { return fStrides;    }
+        const std::vector<TraceHook*>& traceHooks() const { return fTraceHooks; }
+
         // Returns a trace-hook ID which must be passed to the trace opcodes.
         int attachTraceHook(TraceHook*);
 
@@ -1072,6 +1079,8 @@ namespace skvm {
         int  loop () const;
         bool empty() const;
 
+        size_t approximateBytesUsed() const;  // Interpreter instructions plus any JIT code.
+
         bool hasJIT() const;         // Has this Program been JITted?
         bool hasTraceHooks() const;  // Is this program instrumented for debugging?
 
@@ -7,9 +7,13 @@
 
 #include "include/private/SkImageInfoPriv.h"
 #include "include/private/SkMacros.h"
+#include "include/core/SkData.h"
+#include "include/core/SkStream.h"
+#include "include/private/SkMutex.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkBlendModePriv.h"
 #include "src/core/SkBlenderBase.h"
+#include "src/core/SkBuffer.h"
 #include "src/core/SkColorFilterBase.h"
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkColorSpaceXformSteps.h"
@@ -19,9 +23,11 @@
 #include "src/core/SkOpts.h"
 #include "src/core/SkPaintPriv.h"
 #include "src/core/SkRecordReplay.h"
+#include "src/core/SkSharedMutex.h"
 #include "src/core/SkVM.h"
 #include "src/core/SkVMBlitter.h"
 #include "src/shaders/SkColorFilterShader.h"
+#include "src/utils/SkVMVisualizer.h"
 
 #include <cinttypes>
 
@@ -539,33 +545,280 @@ SkVMBlitter::SkVMBlitter(const SkPixmap& device,
         , fParams(EffectiveParams(device, sprite, paint, matrices, std::move(clip)))
         , fKey(CacheKey(fParams, &fUniforms, &fAlloc, ok)) {}
 
-SkVMBlitter::~SkVMBlitter() {
-    if (fStoreToCache) {
-        if (SkLRUCache<Key, skvm::Program>* cache = TryAcquireProgramCache()) {
-            auto cache_program = [&](SkTLazy<skvm::Program>& program, Coverage coverage) {
-                if (program.isValid() && !program->hasTraceHooks()) {
-                    cache->insert_or_update(fKey.withCoverage(coverage), std::move(*program));
-                }
+SkVMBlitter::~SkVMBlitter() = default;
+
+#if !defined(SK_DEFAULT_VM_PROGRAM_CACHE_LIMIT)
+    #define SK_DEFAULT_VM_PROGRAM_CACHE_LIMIT (4 * 1024 * 1024)
+#endif
+
+sk_sp<SkVMBlitter::SharedProgram> SkVMBlitter::ProgramCache::find(const Key& key) {
+    Entry* entry = fLRU.find(key);
+    return entry ? entry->program : nullptr;
+}
+
+void SkVMBlitter::ProgramCache::insert_or_update(const Key& key, sk_sp<SharedProgram> program) {
+    const size_t bytes = program->program.approximateBytesUsed();
+    if (Entry* entry = fLRU.find(key)) {
+        fBytesUsed -= entry->bytes;
+        *entry = {std::move(program), bytes};
+    } else {
+        fLRU.insert(key, {std::move(program), bytes});
+    }
+    fBytesUsed += bytes;
+    this->purgeAsNeeded();
+}
+
+size_t SkVMBlitter::ProgramCache::setByteLimit(size_t newLimit) {
+    size_t prev = fByteLimit;
+    fByteLimit = newLimit;
+    this->purgeAsNeeded();
+    return prev;
+}
+
+void SkVMBlitter::ProgramCache::purgeAsNeeded() {
+    while (fBytesUsed > fByteLimit) {
+        fBytesUsed -= fLRU.removeLRU().bytes;
+    }
+}
+
+void SkVMBlitter::ProgramCache::reset() {
+    fLRU.reset();
+    fBytesUsed = 0;
+}
+
+namespace {
+    // Serialized programs carry no version of their own.  Instead the persistent key folds in
+    // kPersistentVersion, bumped whenever the format below changes, the skvm op list, and the
+    // CPU features the program was optimized for.
+    static constexpr uint32_t kPersistentVersion = 1;
+
+    static constexpr int kOpCount = 0
+    #define M(op) + 1
+        SKVM_OPS(M)
+    #undef M
+        ;
+
+    struct PersistentKey {
+        uint32_t version;
+        uint32_t opsHash;
+        uint8_t  fma,
+                 fp16;
+        uint16_t padding{0};
+    };
+
+    // mutex guards the ProgramCache.  persistentMutex is held shared for the whole of each
+    // load() or store(), pinning persistent without making lookups wait on each other's I/O, and
+    // exclusively to replace it, which waits for the calls in flight on the old one.
+    struct ProgramCacheGlobals {
+        SkMutex                              mutex;
+        SkSharedMutex                        persistentMutex;
+        SkGraphics::VMProgramPersistentCache* persistent SK_GUARDED_BY(persistentMutex) = nullptr;
+        std::atomic<int64_t>                 hits{0},
+                                             misses{0},
+                                             persistentHits{0};
+    };
+
+    static ProgramCacheGlobals& program_cache_globals() {
+        static auto* globals = new ProgramCacheGlobals;
+        return *globals;
+    }
+
+    static sk_sp<SkData> persistent_key(const void* key, size_t keySize) {
+        static const char kOps[] =
+        #define M(op) #op ","
+            SKVM_OPS(M)
+        #undef M
+            ;
+        const skvm::Features features = skvm::detect_features();
+        const PersistentKey header = {
+            kPersistentVersion,
+            SkOpts::hash(kOps, sizeof(kOps)),
+            features.fma,
+            features.fp16,
+        };
+
+        SkDynamicMemoryWStream stream;
+        stream.write(&header, sizeof(header));
+        stream.write(key, keySize);
+        return stream.detachAsData();
+    }
+
+    // Each instruction is written as kInstructionFields int32_t.
+    static constexpr size_t kInstructionFields = 10;
+
+    static sk_sp<SkData> serialize_program(
+            const std::vector<int>& strides,
+            const std::vector<skvm::OptimizedInstruction>& instructions) {
+        SkDynamicMemoryWStream stream;
+        stream.write32(SkToU32(strides.size()));
+        for (int stride : strides) {
+            stream.write32(stride);
+        }
+        stream.write32(SkToU32(instructions.size()));
+        for (const skvm::OptimizedInstruction& inst : instructions) {
+            const int32_t fields[kInstructionFields] = {
+                (int32_t)inst.op,
+                inst.x, inst.y, inst.z, inst.w,
+                inst.immA, inst.immB, inst.immC,
+                inst.death,
+                inst.can_hoist,
             };
-            for (int c = 0; c < Coverage::kCount; c++) {
-                cache_program(fPrograms[c], static_cast<Coverage>(c));
+            stream.write(fields, sizeof(fields));
+        }
+        return stream.detachAsData();
+    }
+
+    // This rejects truncated or malformed data, but can't prove the program itself is sound.
+    static bool deserialize_program(const SkData& data,
+                                    std::vector<int>* strides,
+                                    std::vector<skvm::OptimizedInstruction>* instructions) {
+        SkRBuffer buffer(data.data(), data.size());
+
+        uint32_t count;
+        if (!buffer.readU32(&count) || count > buffer.available() / sizeof(int32_t)) {
+            return false;
+        }
+        strides->resize(count);
+        for (int& stride : *strides) {
+            if (!buffer.readS32(&stride) || stride < 0) {
+                return false;
             }
+        }
 
-            ReleaseProgramCache();
+        if (!buffer.readU32(&count) ||
+            count > buffer.available() / (kInstructionFields * sizeof(int32_t))) {
+            return false;
         }
+        instructions->resize(count);
+        for (uint32_t i = 0; i < count; i++) {
+            int32_t f[kInstructionFields];
+            if (!buffer.read(f, sizeof(f))) {
+                return false;
+            }
+            // Arguments must be earlier instructions, and death no later than the end.
+            auto valid = [i](skvm::Val id) { return id == skvm::NA || (0 <= id && id < (int)i); };
+            if (f[0] < 0 || f[0] >= kOpCount ||
+                !valid(f[1]) || !valid(f[2]) || !valid(f[3]) || !valid(f[4]) ||
+                f[8] < 0 || f[8] > (int)count) {
+                return false;
+            }
+            (*instructions)[i] = {(skvm::Op)f[0], f[1], f[2], f[3], f[4],
+                                  f[5], f[6], f[7], f[8], f[9] != 0};
+        }
+        return buffer.available() == 0;
     }
+}  // namespace
+
+SkVMBlitter::ProgramCache* SkVMBlitter::AcquireProgramCache() SK_NO_THREAD_SAFETY_ANALYSIS {
+    ProgramCacheGlobals& globals = program_cache_globals();
+    globals.mutex.acquire();
+    static auto* cache = new ProgramCache{SK_DEFAULT_VM_PROGRAM_CACHE_LIMIT};
+    return cache;
+}
+
+void SkVMBlitter::ReleaseProgramCache() SK_NO_THREAD_SAFETY_ANALYSIS {
+    program_cache_globals().mutex.release();
 }
 
-SkLRUCache<SkVMBlitter::Key, skvm::Program>* SkVMBlitter::TryAcquireProgramCache() {
-#if defined(SKVM_JIT)
-    thread_local static SkLRUCache<Key, skvm::Program> cache{64};
-    return &cache;
-#else
-    // iOS now supports thread_local since iOS 9.
-    // On the other hand, we'll never be able to JIT there anyway.
-    // It's probably fine to not cache any interpreted programs, anywhere.
+sk_sp<SkVMBlitter::SharedProgram> SkVMBlitter::FindProgram(const Key& key) {
+    ProgramCacheGlobals& globals = program_cache_globals();
+
+    {
+        ProgramCache* cache = AcquireProgramCache();
+        sk_sp<SharedProgram> program = cache->find(key);
+        ReleaseProgramCache();
+
+        if (program) {
+            globals.hits.fetch_add(1, std::memory_order_relaxed);
+            return program;
+        }
+        globals.misses.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    sk_sp<SkData> data;
+    {
+        SkAutoSharedMutexShared pin(globals.persistentMutex);
+        if (globals.persistent) {
+            data = globals.persistent->load(*persistent_key(&key, sizeof(key)));
+        }
+    }
+
+    // JITing happens outside the lock, so it won't stall other threads' lookups.
+    std::vector<int> strides;
+    std::vector<skvm::OptimizedInstruction> instructions;
+    if (data && deserialize_program(*data, &strides, &instructions)) {
+        auto program = sk_make_sp<SharedProgram>();
+        program->program = skvm::Program(instructions, /*visualizer=*/nullptr, strides,
+                                         /*traceHooks=*/{}, DebugName(key).c_str(),
+                                         /*allow_jit=*/true);
+        if (!program->program.empty()) {
+            globals.persistentHits.fetch_add(1, std::memory_order_relaxed);
+            ProgramCache* cache = AcquireProgramCache();
+            cache->insert_or_update(key, program);
+            ReleaseProgramCache();
+            return program;
+        }
+    }
     return nullptr;
-#endif
+}
+
+void SkVMBlitter::StoreProgram(const Key& key, sk_sp<SharedProgram> program,
+                               const std::vector<int>& strides,
+                               const std::vector<skvm::OptimizedInstruction>& instructions) {
+    ProgramCacheGlobals& globals = program_cache_globals();
+
+    ProgramCache* cache = AcquireProgramCache();
+    cache->insert_or_update(key, std::move(program));
+    ReleaseProgramCache();
+
+    SkAutoSharedMutexShared pin(globals.persistentMutex);
+    if (globals.persistent) {
+        if (sk_sp<SkData> data = serialize_program(strides, instructions)) {
+            globals.persistent->store(*persistent_key(&key, sizeof(key)), *data);
+        }
+    }
+}
+
+size_t SkVMBlitter::GetProgramCacheBytesUsed() {
+    ProgramCache* cache = AcquireProgramCache();
+    size_t used = cache->bytesUsed();
+    ReleaseProgramCache();
+    return used;
+}
+
+size_t SkVMBlitter::GetProgramCacheByteLimit() {
+    ProgramCache* cache = AcquireProgramCache();
+    size_t limit = cache->byteLimit();
+    ReleaseProgramCache();
+    return limit;
+}
+
+size_t SkVMBlitter::SetProgramCacheByteLimit(size_t newLimit) {
+    ProgramCache* cache = AcquireProgramCache();
+    size_t prev = cache->setByteLimit(newLimit);
+    ReleaseProgramCache();
+    return prev;
+}
+
+SkGraphics::VMProgramCacheStats SkVMBlitter::GetProgramCacheStats() {
+    const ProgramCacheGlobals& globals = program_cache_globals();
+    SkGraphics::VMProgramCacheStats stats;
+    stats.hits           = globals.hits.load(std::memory_order_relaxed);
+    stats.misses         = globals.misses.load(std::memory_order_relaxed);
+    stats.persistentHits = globals.persistentHits.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SkVMBlitter::SetProgramPersistentCache(SkGraphics::VMProgramPersistentCache* persistent) {
+    ProgramCacheGlobals& globals = program_cache_globals();
+    SkAutoSharedMutexExclusive lock(globals.persistentMutex);
+    globals.persistent = persistent;
+}
+
+void SkVMBlitter::PurgeProgramCache() {
+    ProgramCache* cache = AcquireProgramCache();
+    cache->reset();
+    ReleaseProgramCache();
 }
 
 SkString SkVMBlitter::DebugName(const Key& key) {
@@ -580,31 +833,21 @@ SkString SkVMBlitter::DebugName(const Key& key) {
                           key.coverage);
 }
 
-void SkVMBlitter::ReleaseProgramCache() {}
-
 skvm::Program* SkVMBlitter::buildProgram(Coverage coverage) {
     // eg, blitter re-use...
-    if (fProgramPtrs[coverage]) {
-        return fProgramPtrs[coverage];
+    if (fPrograms[coverage]) {
+        return &fPrograms[coverage]->program;
     }
 
     // Next, cache lookup...
     Key key = fKey.withCoverage(coverage);
-    {
-        skvm::Program* p = nullptr;
-        if (SkLRUCache<Key, skvm::Program>* cache = TryAcquireProgramCache()) {
-            p = cache->find(key);
-            ReleaseProgramCache();
-        }
-        if (p) {
-            SkASSERT(!p->empty());
-            fProgramPtrs[coverage] = p;
-            return p;
-        }
+    if (sk_sp<SharedProgram> cached = FindProgram(key)) {
+        SkASSERT(!cached->program.empty());
+        fPrograms[coverage] = std::move(cached);
+        return &fPrograms[coverage]->program;
     }
 
     // Okay, let's build it...
-    fStoreToCache = true;
 
     // We don't really _need_ to rebuild fUniforms here.
     // It's just more natural to have effects unconditionally emit them,
@@ -617,14 +860,19 @@ skvm::Program* SkVMBlitter::buildProgram(Coverage coverage) {
     SkASSERTF(fUniforms.buf.size() == prev,
               "%zu, prev was %zu", fUniforms.buf.size(), prev);
 
-    skvm::Program program = builder.done(DebugName(key).c_str());
+    // This is builder.done(), keeping the optimized instructions around to serialize.
+    std::vector<skvm::OptimizedInstruction> optimized = builder.optimize();
+    auto program = sk_make_sp<SharedProgram>();
+    program->program = skvm::Program(optimized, /*visualizer=*/nullptr, builder.strides(),
+                                     builder.traceHooks(), DebugName(key).c_str(),
+                                     /*allow_jit=*/true);
     if ((false)) {
         static std::atomic<int> missed{0},
                                 total{0};
-        if (!program.hasJIT()) {
+        if (!program->program.hasJIT()) {
             SkDebugf("\ncouldn't JIT %s\n", DebugName(key).c_str());
             builder.dump();
-            program.dump();
+            program->program.dump();
 
             missed++;
         }
@@ -633,8 +881,11 @@ skvm::Program* SkVMBlitter::buildProgram(Coverage coverage) {
                                 total.load(), missed.load()); });
         }
     }
-    fProgramPtrs[coverage] = fPrograms[coverage].set(std::move(program));
-    return fProgramPtrs[coverage];
+    if (!program->program.hasTraceHooks()) {
+        StoreProgram(key, program, builder.strides(), optimized);
+    }
+    fPrograms[coverage] = std::move(program);
+    return &fPrograms[coverage]->program;
 }
 
 void SkVMBlitter::updateUniforms(int right, int y) {
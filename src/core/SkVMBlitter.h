@@ -8,12 +8,14 @@
 #ifndef SkVMBlitter_DEFINED
 #define SkVMBlitter_DEFINED
 
+#include "include/core/SkGraphics.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkBlitter.h"
 #include "src/core/SkLRUCache.h"
-#include "src/core/SkTLazy.h"
 #include "src/core/SkVM.h"
 
+#include <climits>
+
 class SkVMBlitter final : public SkBlitter {
 public:
     static SkVMBlitter* Make(const SkPixmap& dst,
@@ -39,6 +41,14 @@ public:
 
     ~SkVMBlitter() override;
 
+    // The process-wide program cache behind SkGraphics::{Get,Set}VMProgramCache*().
+    static size_t GetProgramCacheBytesUsed();
+    static size_t GetProgramCacheByteLimit();
+    static size_t SetProgramCacheByteLimit(size_t newLimit);
+    static SkGraphics::VMProgramCacheStats GetProgramCacheStats();
+    static void SetProgramPersistentCache(SkGraphics::VMProgramPersistentCache*);
+    static void PurgeProgramCache();
+
 private:
     enum Coverage { Full, UniformF, MaskA8, MaskLCD16, Mask3D, kCount };
     struct Key {
@@ -71,6 +81,44 @@ private:
         Params withCoverage(Coverage c) const;
     };
 
+    // Cached programs are shared by blitters on all threads, and stay alive while any blitter
+    // uses them, even once evicted from the cache.
+    struct SharedProgram : public SkNVRefCnt<SharedProgram> {
+        skvm::Program program;
+    };
+
+    // An LRU cache of programs that evicts to keep their total size under a byte limit.
+    class ProgramCache {
+    public:
+        explicit ProgramCache(size_t byteLimit) : fByteLimit(byteLimit) {}
+
+        sk_sp<SharedProgram> find(const Key&);
+        void insert_or_update(const Key&, sk_sp<SharedProgram>);
+
+        size_t bytesUsed() const { return fBytesUsed; }
+        size_t byteLimit() const { return fByteLimit; }
+        size_t setByteLimit(size_t newLimit);  // Returns the old limit.
+
+        template <typename Fn>  // f(const Key*, sk_sp<SharedProgram>*)
+        void foreach(Fn&& fn) {
+            fLRU.foreach([&](const Key* key, Entry* entry) { fn(key, &entry->program); });
+        }
+
+        void reset();
+
+    private:
+        struct Entry {
+            sk_sp<SharedProgram> program;
+            size_t               bytes;  // As of insertion; Viewer may swap the program later.
+        };
+
+        void purgeAsNeeded();
+
+        SkLRUCache<Key, Entry> fLRU{INT_MAX};
+        size_t                 fBytesUsed = 0;
+        size_t                 fByteLimit;
+    };
+
     static Params EffectiveParams(const SkPixmap& device,
                                   const SkPixmap* sprite,
                                   SkPaint paint,
@@ -81,9 +129,14 @@ private:
                              skvm::Uniforms* uniforms, SkArenaAlloc* alloc);
     static Key CacheKey(const Params& params,
                         skvm::Uniforms* uniforms, SkArenaAlloc* alloc, bool* ok);
-    static SkLRUCache<Key, skvm::Program>* TryAcquireProgramCache();
-    static SkString DebugName(const Key& key);
+    // Locks the program cache until ReleaseProgramCache().
+    static ProgramCache* AcquireProgramCache();
     static void ReleaseProgramCache();
+    static sk_sp<SharedProgram> FindProgram(const Key& key);
+    static void StoreProgram(const Key& key, sk_sp<SharedProgram> program,
+                             const std::vector<int>& strides,
+                             const std::vector<skvm::OptimizedInstruction>& instructions);
+    static SkString DebugName(const Key& key);
 
     skvm::Program* buildProgram(Coverage coverage);
     void updateUniforms(int right, int y);
@@ -102,9 +155,7 @@ private:
     SkArenaAlloc    fAlloc{2*sizeof(void*)};  // but a few effects need to ref large content.
     const Params    fParams;
     const Key       fKey;
-    bool            fStoreToCache = false;
-    skvm::Program*         fProgramPtrs[Coverage::kCount] = {nullptr};
-    SkTLazy<skvm::Program> fPrograms[Coverage::kCount];
+    sk_sp<SharedProgram> fPrograms[Coverage::kCount];
 
     friend class Viewer;
 };
@@ -19,7 +19,7 @@
 // GrContexts and those contexts may be in use concurrently on different threads.
 namespace {
 #if !defined(SK_BUILD_FOR_ANDROID_FRAMEWORK)
-static SkSpinlock gProcessorSpinlock;
+static SkSpinlock gProcessorSpinlock{"GrProcessor.gProcessorSpinlock"};
 #endif
 class MemoryPoolAccessor {
 public:
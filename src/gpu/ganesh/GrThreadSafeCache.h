@@ -310,7 +310,7 @@ private:
     std::tuple<sk_sp<VertexData>, sk_sp<SkData>> internalAddVerts(
             const skgpu::UniqueKey&, sk_sp<VertexData>, IsNewerBetter)  SK_REQUIRES(fSpinLock);
 
-    mutable SkSpinlock fSpinLock;
+    mutable SkSpinlock fSpinLock{"GrThreadSafeCache.fSpinLock"};
 
     SkTDynamicHash<Entry, skgpu::UniqueKey> fUniquelyKeyedEntryMap  SK_GUARDED_BY(fSpinLock);
     // The head of this list is the MRU
@@ -160,6 +160,14 @@ public:
     virtual bool getROPixels(GrDirectContext*, SkBitmap*,
                              CachingHint = kAllow_CachingHint) const = 0;
 
+    // Like getROPixels(), but for images that can be produced natively at a reduced size: returns
+    // a read-only copy of the pixels scaled to the smallest such size that is at least minSize.
+    // Returns false if there is no size smaller than the image's own, in which case callers should
+    // use getROPixels().
+    virtual bool getScaledROPixels(GrDirectContext*, SkISize minSize, SkBitmap*) const {
+        return false;
+    }
+
     virtual sk_sp<SkImage> onMakeSubset(const SkIRect&, GrDirectContext*) const = 0;
 
     virtual sk_sp<SkData> onRefEncoded() const { return nullptr; }
@@ -16,6 +16,8 @@
 #include "src/core/SkImagePriv.h"
 #include "src/core/SkNextID.h"
 
+#include <algorithm>
+
 #if SK_SUPPORT_GPU
 #include "include/gpu/GrDirectContext.h"
 #include "include/gpu/GrRecordingContext.h"
@@ -179,6 +181,53 @@ bool SkImage_Lazy::getROPixels(GrDirectContext* ctx, SkBitmap* bitmap,
     return true;
 }
 
+// Returns the smallest size the generator can decode to natively that still covers minSize, or
+// the generator's own dimensions if there is none.
+static SkISize smallest_scaled_dimensions(const SkImageGenerator* generator, SkISize minSize) {
+    const SkISize full = generator->getInfo().dimensions();
+    float scale = std::max((float)minSize.width()  / full.width(),
+                           (float)minSize.height() / full.height());
+    // getScaledDimensions() returns the *closest* native size, which may round below the request,
+    // so nudge the scale up until the result is large enough.
+    for (; scale < 1; scale += 1.0f / 16) {
+        SkISize scaled = generator->getScaledDimensions(scale);
+        if (scaled.width() >= minSize.width() && scaled.height() >= minSize.height()) {
+            return scaled;
+        }
+    }
+    return full;
+}
+
+bool SkImage_Lazy::getScaledROPixels(GrDirectContext*, SkISize minSize, SkBitmap* bitmap) const {
+    if (minSize.width() >= this->width() || minSize.height() >= this->height()) {
+        return false;
+    }
+    SkISize scaledSize;
+    {
+        ScopedGenerator generator(fSharedGenerator);
+        scaledSize = smallest_scaled_dimensions(generator, minSize);
+    }
+    if (scaledSize == this->dimensions()) {
+        return false;
+    }
+
+    auto desc = SkBitmapCacheDesc::MakeScaled(this, scaledSize);
+    if (SkBitmapCache::Find(desc, bitmap)) {
+        return true;
+    }
+
+    SkPixmap pmap;
+    SkBitmapCache::RecPtr cacheRec =
+            SkBitmapCache::Alloc(desc, this->imageInfo().makeDimensions(scaledSize), &pmap);
+    if (!cacheRec || !ScopedGenerator(fSharedGenerator)->getPixels(pmap)) {
+        return false;
+    }
+    SkBitmapCache::Add(std::move(cacheRec), bitmap);
+    this->notifyAddedToRasterCache();
+    SkASSERT(bitmap->isImmutable());
+    return true;
+}
+
 bool SkImage_Lazy::readPixelsProxy(GrDirectContext* ctx, const SkPixmap& pixmap) const {
 #if SK_SUPPORT_GPU
     if (!ctx) {
@@ -120,6 +120,10 @@ void SkSurface_Base::onAsyncRescaleAndReadPixelsYUV420(
     callback(context, nullptr);
 }
 
+bool SkSurface_Base::onReadPixels(const SkPixmap& pm, int srcX, int srcY) {
+    return this->getCachedCanvas()->readPixels(pm, srcX, srcY);
+}
+
 bool SkSurface_Base::outstandingImageSnapshot() const {
     return fCachedImage && !fCachedImage->unique();
 }
@@ -218,6 +222,7 @@ sk_sp<const SkCapabilities> SkSurface::capabilities() {
 }
 
 sk_sp<SkImage> SkSurface::makeImageSnapshot() {
+    asSB(this)->onFlushPendingDraws();
     return asSB(this)->refCachedImage();
 }
 
@@ -253,7 +258,7 @@ bool SkSurface::peekPixels(SkPixmap* pmap) {
 }
 
 bool SkSurface::readPixels(const SkPixmap& pm, int srcX, int srcY) {
-    return this->getCanvas()->readPixels(pm, srcX, srcY);
+    return asSB(this)->onReadPixels(pm, srcX, srcY);
 }
 
 bool SkSurface::readPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRowBytes,
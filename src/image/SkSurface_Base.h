@@ -68,6 +68,17 @@ public:
 
     virtual void onWritePixels(const SkPixmap&, int x, int y) = 0;
 
+    /**
+     *  Default implementation reads through the cached canvas.
+     */
+    virtual bool onReadPixels(const SkPixmap&, int srcX, int srcY);
+
+    /**
+     *  Surfaces whose canvas buffers draws rather than executing them (e.g. the tiled raster
+     *  surface) rasterize the buffered work here. Called before a full snapshot is returned.
+     */
+    virtual void onFlushPendingDraws() {}
+
     /**
      * Default implementation calls onAsyncRescaleAndReadPixels with default rescale params.
      */
@@ -0,0 +1,477 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkCapabilities.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkMallocPixelRef.h"
+#include "include/private/SkMutex.h"
+#include "include/private/SkTemplates.h"
+#include "src/core/SkBigPicture.h"
+#include "src/core/SkBitmapDevice.h"
+#include "src/core/SkImagePriv.h"
+#include "src/core/SkSurfacePriv.h"
+#include "src/core/SkRTree.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecorder.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/image/SkSurface_Base.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <utility>
+#include <vector>
+
+class SkSurface_RasterTiled;
+
+// The canvas handed out by SkSurface_RasterTiled.  It records like any SkRecorder, but reports
+// the surface's real image info and exposes the surface's pixels (after flushing) when peeked.
+class SkTiledRasterRecorder final : public SkRecorder {
+public:
+    SkTiledRasterRecorder(SkSurface_RasterTiled* surface, SkRecord* record, const SkRect& bounds)
+        : SkRecorder(record, bounds)
+        , fSurface(surface) {}
+
+protected:
+    SkImageInfo onImageInfo() const override;
+    bool onPeekPixels(SkPixmap*) override;
+
+private:
+    SkSurface_RasterTiled* fSurface;
+};
+
+// A raster surface that buffers its draws in an SkRecord, then rasterizes them tile-by-tile on an
+// SkExecutor.  Every tile draws into the same full-size bitmap with the full device clip, so all
+// geometry is rasterized exactly as a serial raster draw would; only the blits are limited to the
+// tile (see SkBitmapDevice::setBlitClip()), so the pixels match serial drawing exactly.  Layers
+// without image filters are made the same way: one serial-sized layer is shared by every tile,
+// and each tile draws only its own part of it.
+class SkSurface_RasterTiled : public SkSurface_Base {
+public:
+    SkSurface_RasterTiled(const SkImageInfo&, sk_sp<SkPixelRef>, SkExecutor&,
+                          const SkSurfaceProps*);
+    ~SkSurface_RasterTiled() override;
+
+    SkCanvas* onNewCanvas() override;
+    sk_sp<SkSurface> onNewSurface(const SkImageInfo&) override;
+    sk_sp<SkImage> onNewImageSnapshot(const SkIRect* subset) override;
+    void onWritePixels(const SkPixmap&, int x, int y) override;
+    bool onReadPixels(const SkPixmap&, int srcX, int srcY) override;
+    void onFlushPendingDraws() override;
+    void onDraw(SkCanvas*, SkScalar, SkScalar, const SkSamplingOptions&, const SkPaint*) override;
+    bool onCopyOnWrite(ContentChangeMode) override;
+    void onRestoreBackingMutability() override;
+    sk_sp<const SkCapabilities> onCapabilities() override;
+
+    const SkBitmap& bitmap() const { return fBitmap; }
+
+    // Tiles are square; small enough to balance load across workers, large enough that per-tile
+    // setup (canvas construction, BBH query) stays negligible next to rasterization.
+    static constexpr int kTileSize = 256;
+
+private:
+    SkBitmap                   fBitmap;
+    SkExecutor&                fExecutor;
+    std::unique_ptr<SkRecord>  fRecord;
+    SkTiledRasterRecorder*     fRecorder = nullptr;  // Owned by SkSurface_Base as its canvas.
+
+    // Draw ops before this index have already been rasterized into fBitmap.  Control ops before
+    // it are still replayed so later draws see the right matrix and clip.
+    int                        fFlushedOps = 0;
+
+    using INHERITED = SkSurface_Base;
+};
+
+SkImageInfo SkTiledRasterRecorder::onImageInfo() const {
+    return fSurface->bitmap().info();
+}
+
+bool SkTiledRasterRecorder::onPeekPixels(SkPixmap* pmap) {
+    fSurface->onFlushPendingDraws();
+    return fSurface->bitmap().peekPixels(pmap);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+enum class SaveKind { kNone, kSave, kLayer, kRestore };
+
+struct ClassifySave {
+    SaveKind operator()(const SkRecords::Save&)       { return SaveKind::kSave;    }
+    SaveKind operator()(const SkRecords::SaveLayer&)  { return SaveKind::kLayer;   }
+    SaveKind operator()(const SkRecords::SaveBehind&) { return SaveKind::kLayer;   }
+    SaveKind operator()(const SkRecords::Restore&)    { return SaveKind::kRestore; }
+    template <typename T>
+    SaveKind operator()(const T&)                     { return SaveKind::kNone;    }
+};
+
+// Returns the index of the first layer in [start, record.count()) that is still open at the end
+// of the record, or record.count() if there is none.  Nothing drawn inside an open layer has
+// reached the base device yet, so we only flush up to that point.  Ops before start are known not
+// to contain open layers, so unmatched Restores there only close plain Saves.
+int first_open_layer(const SkRecord& record, int start) {
+    std::vector<std::pair<int, SaveKind>> stack;
+    for (int i = start; i < record.count(); i++) {
+        switch (SaveKind kind = record.visit(i, ClassifySave())) {
+            case SaveKind::kSave:
+            case SaveKind::kLayer:   stack.push_back({i, kind}); break;
+            case SaveKind::kRestore: if (!stack.empty()) { stack.pop_back(); } break;
+            case SaveKind::kNone:    break;
+        }
+    }
+    for (const auto& [index, kind] : stack) {
+        if (kind == SaveKind::kLayer) {
+            return index;
+        }
+    }
+    return record.count();
+}
+
+// Backdrop filters, SaveBehind and layers initialized with the previous contents read back device
+// pixels outside the tile being drawn, which other tiles may still be writing.
+struct ReadsDevice {
+    bool operator()(const SkRecords::SaveLayer& r) {
+        return r.backdrop || (r.saveLayerFlags & SkCanvas::kInitWithPrevious_SaveLayerFlag);
+    }
+    bool operator()(const SkRecords::SaveBehind&) { return true; }
+    template <typename T>
+    bool operator()(const T&) { return false; }
+};
+
+// Returns the number of tiles along a side of length size.  A last tile one pixel long is merged
+// into the one before it, so that every tile is at least two pixels long whenever the side is.
+int tile_count(int size, int tileSize) {
+    return std::max(1, (size - 2) / tileSize + 1);
+}
+
+// Returns the [start, end) span of tile i along a side of length size split into count tiles.
+std::pair<int, int> tile_span(int i, int count, int size, int tileSize) {
+    return {i * tileSize, i == count - 1 ? size : (i + 1) * tileSize};
+}
+
+// The pixels of the layers made while replaying one flush, shared by all of its tiles.  Each tile
+// writes only its own part of a layer (see SkBitmapDevice::setBlitClip()), so a layer costs what
+// it would when drawing serially, however many tiles it covers.  Layers are identified by the op
+// that made them and their order among that op's layers (a picture op can make several), and are
+// released once every tile that replays that op has finished with them.
+class SharedLayers {
+public:
+    SharedLayers(int start, int stop, const std::vector<std::vector<int>>& tileOps)
+        : fStart(start)
+        , fUsers(new std::atomic<int>[stop - start]) {
+        for (int i = 0; i < stop - start; i++) {
+            fUsers[i].store(0, std::memory_order_relaxed);
+        }
+        for (const std::vector<int>& ops : tileOps) {
+            for (int op : ops) {
+                if (op >= start && op < stop) {
+                    fUsers[op - start].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    bool alloc(int op, int ordinal, const SkImageInfo& info, SkBitmap* bitmap) {
+        SkASSERT(op >= fStart);
+        sk_sp<SkPixelRef> pixels;
+        {
+            SkAutoMutexExclusive lock(fMutex);
+            sk_sp<SkPixelRef>& layer = fLayers[{op, ordinal}];
+            if (!layer) {
+                layer = SkMallocPixelRef::MakeAllocate(info, info.minRowBytes());  // Zeroed.
+                if (!layer) {
+                    fLayers.erase({op, ordinal});
+                    return false;
+                }
+            }
+            SkASSERT(layer->width() == info.width() && layer->height() == info.height());
+            pixels = layer;
+        }
+        // Each tile gets its own pixel ref over the shared pixels, since the canvas marks a
+        // layer's pixel ref immutable when that tile restores it while other tiles still draw.
+        auto unref = [](void*, void* pr) { static_cast<SkPixelRef*>(pr)->unref(); };
+        SkPixelRef* pr = pixels.release();
+        return bitmap->installPixels(info, pr->pixels(), pr->rowBytes(), unref, pr);
+    }
+
+    // Called by each tile once it's done with the layers made by op.
+    void release(int op) {
+        if (op >= fStart && 1 == fUsers[op - fStart].fetch_sub(1, std::memory_order_acq_rel)) {
+            SkAutoMutexExclusive lock(fMutex);
+            fLayers.erase(fLayers.lower_bound({op, 0}), fLayers.lower_bound({op + 1, 0}));
+        }
+    }
+
+private:
+    const int                              fStart;
+    std::unique_ptr<std::atomic<int>[]>    fUsers;  // Tiles that replay each op in the flush.
+    SkMutex                                fMutex;
+    std::map<std::pair<int, int>, sk_sp<SkPixelRef>> fLayers SK_GUARDED_BY(fMutex);
+};
+
+// Replays ops into a tile canvas.  Ops that were already rasterized by an earlier flush only have
+// their effect on canvas state replayed: draws are skipped and their layers become plain saves.
+// Layers made by the ops being rasterized take their pixels from SharedLayers.
+class TileReplay final : public SkBitmapDevice::LayerAllocator {
+public:
+    TileReplay(SkCanvas* canvas, SharedLayers* layers,
+               const SkBigPicture::SnapshotArray* drawables)
+        : fCanvas(canvas)
+        , fLayers(layers)
+        , fDraw(canvas,
+                drawables ? drawables->begin() : nullptr,
+                nullptr,
+                drawables ? drawables->count() : 0) {}
+
+    void visit(const SkRecord& record, int op, bool alreadyFlushed) {
+        fOp = op;
+        fOrdinal = 0;
+        fAlreadyFlushed = alreadyFlushed;
+        switch (record.visit(op, ClassifySave())) {
+            case SaveKind::kNone:
+                record.visit(op, *this);
+                fLayers->release(op);
+                break;
+            case SaveKind::kSave:
+            case SaveKind::kLayer:
+                record.visit(op, *this);
+                fOpenSaves.push_back(op);
+                break;
+            case SaveKind::kRestore:
+                record.visit(op, *this);
+                if (!fOpenSaves.empty()) {
+                    fLayers->release(fOpenSaves.back());
+                    fOpenSaves.pop_back();
+                }
+                break;
+        }
+    }
+
+    bool allocLayer(const SkImageInfo& info, SkBitmap* bitmap) override {
+        return fLayers->alloc(fOp, fOrdinal++, info, bitmap);
+    }
+
+    template <typename T>
+    void operator()(const T& r) {
+        if (fAlreadyFlushed && (T::kTags & SkRecords::kDraw_Tag)) {
+            return;
+        }
+        fDraw(r);
+    }
+    void operator()(const SkRecords::SaveLayer& r)  { this->saveOrLayer(r); }
+    void operator()(const SkRecords::SaveBehind& r) { this->saveOrLayer(r); }
+
+private:
+    template <typename T>
+    void saveOrLayer(const T& r) {
+        if (fAlreadyFlushed) {
+            fCanvas->save();
+        } else {
+            fDraw(r);
+        }
+    }
+
+    SkCanvas*        fCanvas;
+    SharedLayers*    fLayers;
+    SkRecords::Draw  fDraw;
+    std::vector<int> fOpenSaves;  // The ops that made each open save, to release at restore.
+    int              fOp = -1;
+    int              fOrdinal = 0;
+    bool             fAlreadyFlushed = false;
+};
+
+}  // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkSurface_RasterTiled::SkSurface_RasterTiled(const SkImageInfo& info, sk_sp<SkPixelRef> pr,
+                                             SkExecutor& executor, const SkSurfaceProps* props)
+    : INHERITED(pr->width(), pr->height(), props)
+    , fExecutor(executor)
+    , fRecord(std::make_unique<SkRecord>()) {
+    fBitmap.setInfo(info, pr->rowBytes());
+    fBitmap.setPixelRef(std::move(pr), 0, 0);
+}
+
+SkSurface_RasterTiled::~SkSurface_RasterTiled() {
+    // Our canvas outlives fRecord; close any open saves while it can still record the Restores.
+    if (fRecorder) {
+        fRecorder->restoreToCount(1);
+    }
+}
+
+SkCanvas* SkSurface_RasterTiled::onNewCanvas() {
+    fRecorder = new SkTiledRasterRecorder(this, fRecord.get(), SkRect::Make(fBitmap.bounds()));
+    return fRecorder;
+}
+
+sk_sp<SkSurface> SkSurface_RasterTiled::onNewSurface(const SkImageInfo& info) {
+    return SkSurface::MakeRasterTiled(info, &fExecutor, &this->props());
+}
+
+void SkSurface_RasterTiled::onFlushPendingDraws() {
+    const int count = fRecord->count();
+    if (count == fFlushedOps) {
+        return;
+    }
+    const int stop = first_open_layer(*fRecord, fFlushedOps);
+    if (stop == fFlushedOps) {
+        return;
+    }
+
+    // Recorded draws don't go through SkCanvas::predrawNotify(), so fork away from any
+    // outstanding snapshot (and drop our cached one) before we touch the pixels.
+    this->notifyContentWillChange(kRetain_ContentChangeMode);
+
+    const SkRect bounds = SkRect::Make(fBitmap.bounds());
+    SkRTree bbh;
+    {
+        SkAutoTMalloc<SkRect> opBounds(count);
+        SkAutoTMalloc<SkBBoxHierarchy::Metadata> meta(count);
+        SkRecordFillBounds(bounds, *fRecord, opBounds, meta);
+        bbh.insert(opBounds, count);
+    }
+
+    std::unique_ptr<SkBigPicture::SnapshotArray> drawables;
+    if (SkDrawableList* list = fRecorder->getDrawableList()) {
+        drawables.reset(list->newDrawableSnapshot());
+    }
+
+    // Ops that read back the device need every earlier draw finished everywhere, so we draw them
+    // (and everything else in this flush) as one tile.
+    bool readsDevice = false;
+    for (int i = fFlushedOps; i < stop && !readsDevice; i++) {
+        readsDevice = fRecord->visit(i, ReadsDevice());
+    }
+
+    const int tilesX = readsDevice ? 1 : tile_count(fBitmap.width(),  kTileSize),
+              tilesY = readsDevice ? 1 : tile_count(fBitmap.height(), kTileSize);
+    std::vector<SkIRect> tiles(tilesX * tilesY);
+    std::vector<std::vector<int>> tileOps(tilesX * tilesY);
+    for (int t = 0; t < tilesX * tilesY; t++) {
+        const auto [left, right] = tile_span(t % tilesX, tilesX, fBitmap.width(),  kTileSize);
+        const auto [top, bottom] = tile_span(t / tilesX, tilesY, fBitmap.height(), kTileSize);
+        tiles[t] = SkIRect::MakeLTRB(left, top, right, bottom);
+
+        // Outset like SkCanvas::getLocalClipBounds(), to catch antialiased edges and hairlines.
+        bbh.search(SkRect::Make(tiles[t].makeOutset(1, 1)), &tileOps[t]);
+        tileOps[t].erase(std::lower_bound(tileOps[t].begin(), tileOps[t].end(), stop),
+                         tileOps[t].end());
+    }
+    SharedLayers layers(fFlushedOps, stop, tileOps);
+
+    SkTaskGroup tg(fExecutor);
+    tg.batch(tilesX * tilesY, [&](int t) {
+        auto device = sk_make_sp<SkBitmapDevice>(fBitmap, this->props());
+        SkCanvas canvas(device);
+
+        TileReplay replay(&canvas, &layers, drawables.get());
+        device->setBlitClip(tiles[t], &replay);
+        for (int op : tileOps[t]) {
+            replay.visit(*fRecord, op, op < fFlushedOps);
+        }
+    });
+    tg.wait();
+    fFlushedOps = stop;
+
+    // If the canvas is back to its initial state we can start over with an empty record.
+    // Otherwise we keep the record so that future flushes can replay its matrix and clip state.
+    if (fFlushedOps == count &&
+        fRecorder->getSaveCount() == 1 &&
+        fRecorder->getTotalMatrix().isIdentity() &&
+        fRecorder->isClipRect() &&
+        fRecorder->getDeviceClipBounds().contains(fBitmap.bounds())) {
+        fRecord = std::make_unique<SkRecord>();
+        fRecorder->reset(fRecord.get(), bounds);
+        fFlushedOps = 0;
+    }
+}
+
+void SkSurface_RasterTiled::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y,
+                                   const SkSamplingOptions& sampling, const SkPaint* paint) {
+    this->onFlushPendingDraws();
+    canvas->drawImage(fBitmap.asImage().get(), x, y, sampling, paint);
+}
+
+sk_sp<SkImage> SkSurface_RasterTiled::onNewImageSnapshot(const SkIRect* subset) {
+    this->onFlushPendingDraws();
+    if (subset) {
+        SkASSERT(SkIRect::MakeWH(fBitmap.width(), fBitmap.height()).contains(*subset));
+        SkBitmap dst;
+        dst.allocPixels(fBitmap.info().makeDimensions(subset->size()));
+        SkAssertResult(fBitmap.readPixels(dst.pixmap(), subset->left(), subset->top()));
+        dst.setImmutable(); // key, so MakeFromBitmap doesn't make a copy of the buffer
+        return dst.asImage();
+    }
+
+    // SkImage_raster requires these pixels are immutable for its full lifetime.
+    // We'll undo this via onRestoreBackingMutability() if we can avoid the COW.
+    if (SkPixelRef* pr = fBitmap.pixelRef()) {
+        pr->setTemporarilyImmutable();
+    }
+    return SkMakeImageFromRasterBitmap(fBitmap, kIfMutable_SkCopyPixelsMode);
+}
+
+void SkSurface_RasterTiled::onWritePixels(const SkPixmap& src, int x, int y) {
+    this->onFlushPendingDraws();
+    fBitmap.writePixels(src, x, y);
+}
+
+bool SkSurface_RasterTiled::onReadPixels(const SkPixmap& dst, int srcX, int srcY) {
+    this->onFlushPendingDraws();
+    return dst.addr() && fBitmap.readPixels(dst, srcX, srcY);
+}
+
+void SkSurface_RasterTiled::onRestoreBackingMutability() {
+    SkASSERT(!this->hasCachedImage());  // Shouldn't be any snapshots out there.
+    if (SkPixelRef* pr = fBitmap.pixelRef()) {
+        pr->restoreMutability();
+    }
+}
+
+bool SkSurface_RasterTiled::onCopyOnWrite(ContentChangeMode mode) {
+    // Unlike SkSurface_Raster there's no canvas backend to retarget: each flush makes its tile
+    // canvases from fBitmap, so replacing fBitmap's pixels is enough.
+    sk_sp<SkImage> cached(this->refCachedImage());
+    SkASSERT(cached);
+    if (SkBitmapImageGetPixelRef(cached.get()) == fBitmap.pixelRef()) {
+        SkBitmap prev(fBitmap);
+        if (!fBitmap.tryAllocPixels()) {
+            return false;
+        }
+        if (kRetain_ContentChangeMode == mode) {
+            SkASSERT(prev.info() == fBitmap.info());
+            SkASSERT(prev.rowBytes() == fBitmap.rowBytes());
+            memcpy(fBitmap.getPixels(), prev.getPixels(), fBitmap.computeByteSize());
+        }
+    }
+    return true;
+}
+
+sk_sp<const SkCapabilities> SkSurface_RasterTiled::onCapabilities() {
+    return SkCapabilities::RasterBackend();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+sk_sp<SkSurface> SkSurface::MakeRasterTiled(const SkImageInfo& info, SkExecutor* executor,
+                                            const SkSurfaceProps* props) {
+    if (!SkSurfaceValidateRasterInfo(info)) {
+        return nullptr;
+    }
+
+    sk_sp<SkPixelRef> pr = SkMallocPixelRef::MakeAllocate(info, 0);
+    if (!pr) {
+        return nullptr;
+    }
+    return sk_make_sp<SkSurface_RasterTiled>(info, std::move(pr),
+                                             executor ? *executor : SkExecutor::GetDefault(),
+                                             props);
+}
@@ -174,6 +174,9 @@ bool SkJpegEncoderMgr::setParams(const SkImageInfo& srcInfo, const SkJpegEncoder
     // for the image.  This improves compression at the cost of
     // slower encode performance.
     fCInfo.optimize_coding = TRUE;
+
+    // Zero, the default, writes no restart markers.
+    fCInfo.restart_in_rows = options.fRestartRows;
     return true;
 }
 
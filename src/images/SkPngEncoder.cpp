@@ -15,6 +15,7 @@
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkMath.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkStream.h"
@@ -25,12 +26,15 @@
 #include "include/private/SkTemplates.h"
 #include "src/codec/SkPngPriv.h"
 #include "src/core/SkMSAN.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/images/SkImageEncoderFns.h"
 #include "src/images/SkImageEncoderPriv.h"
 
 #include <algorithm>
 #include <csetjmp>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
@@ -38,6 +42,7 @@
 
 #include <png.h>
 #include <pngconf.h>
+#include <zlib.h>
 
 static_assert(PNG_FILTER_NONE  == (int)SkPngEncoder::FilterFlag::kNone,  "Skia libpng filter err.");
 static_assert(PNG_FILTER_SUB   == (int)SkPngEncoder::FilterFlag::kSub,   "Skia libpng filter err.");
@@ -478,9 +483,274 @@ bool SkPngEncoder::onEncodeRows(int numRows) {
     return true;
 }
 
+// Parallel encoding splits the image into strips of about this many bytes of filtered data, like
+// pigz's blocks.  Each strip costs a few bytes of sync flush, but has the previous strip's data as
+// its dictionary, so it compresses about as well as a single stream would.
+static constexpr size_t kStripBytes = 256 * 1024;
+static constexpr size_t kDeflateWindow = 32 * 1024;
+
+static int paeth_predictor(int a, int b, int c) {
+    const int p = a + b - c,
+              pa = abs(p - a),
+              pb = abs(p - b),
+              pc = abs(p - c);
+    return pa <= pb && pa <= pc ? a
+         : pb <= pc             ? b
+         :                        c;
+}
+
+// Writes the filter type and then row filtered against prev.  a, b, and c are the bytes to the
+// left, above, and above-left, as in the PNG spec.
+template <typename Predictor>
+static void apply_filter(uint8_t type, Predictor predict, uint8_t* dst,
+                         const uint8_t* row, const uint8_t* prev, size_t rowBytes, size_t bpp) {
+    *dst++ = type;
+    for (size_t i = 0; i < bpp && i < rowBytes; i++) {
+        dst[i] = row[i] - predict(0, prev[i], 0);
+    }
+    for (size_t i = bpp; i < rowBytes; i++) {
+        dst[i] = row[i] - predict(row[i - bpp], prev[i], prev[i - bpp]);
+    }
+}
+
+static void apply_filter(uint8_t type, uint8_t* dst,
+                         const uint8_t* row, const uint8_t* prev, size_t rowBytes, size_t bpp) {
+    switch (type) {
+        case PNG_FILTER_VALUE_NONE:
+            dst[0] = type;
+            memcpy(dst + 1, row, rowBytes);
+            break;
+        case PNG_FILTER_VALUE_SUB:
+            apply_filter(type, [](int a, int  , int  ) { return a; },
+                         dst, row, prev, rowBytes, bpp);
+            break;
+        case PNG_FILTER_VALUE_UP:
+            apply_filter(type, [](int  , int b, int  ) { return b; },
+                         dst, row, prev, rowBytes, bpp);
+            break;
+        case PNG_FILTER_VALUE_AVG:
+            apply_filter(type, [](int a, int b, int  ) { return (a + b) >> 1; },
+                         dst, row, prev, rowBytes, bpp);
+            break;
+        case PNG_FILTER_VALUE_PAETH:
+            apply_filter(type, paeth_predictor, dst, row, prev, rowBytes, bpp);
+            break;
+    }
+}
+
+// Filters row into dst with the allowed filter that leaves the smallest sum of absolute values of
+// its bytes taken as signed, the heuristic libpng uses.  scratch must hold rowBytes + 1 bytes.
+static void filter_row(int filters, uint8_t* dst, uint8_t* scratch,
+                       const uint8_t* row, const uint8_t* prev, size_t rowBytes, size_t bpp) {
+    static constexpr struct { int flag; uint8_t type; } kFilters[] = {
+        { PNG_FILTER_NONE,  PNG_FILTER_VALUE_NONE  },
+        { PNG_FILTER_SUB,   PNG_FILTER_VALUE_SUB   },
+        { PNG_FILTER_UP,    PNG_FILTER_VALUE_UP    },
+        { PNG_FILTER_AVG,   PNG_FILTER_VALUE_AVG   },
+        { PNG_FILTER_PAETH, PNG_FILTER_VALUE_PAETH },
+    };
+    if (SkIsPow2(filters)) {
+        for (const auto& filter : kFilters) {
+            if (filters == filter.flag) {
+                apply_filter(filter.type, dst, row, prev, rowBytes, bpp);
+            }
+        }
+        return;
+    }
+
+    uint64_t best = UINT64_MAX;
+    for (const auto& filter : kFilters) {
+        if (!(filters & filter.flag)) {
+            continue;
+        }
+        uint8_t* candidate = best == UINT64_MAX ? dst : scratch;
+        apply_filter(filter.type, candidate, row, prev, rowBytes, bpp);
+
+        uint64_t sum = 0;
+        for (size_t i = 1; i <= rowBytes; i++) {
+            sum += abs((int8_t)candidate[i]);
+        }
+        if (sum < best) {
+            best = sum;
+            if (candidate != dst) {
+                memcpy(dst, candidate, rowBytes + 1);
+            }
+        }
+    }
+}
+
+static bool write_u32(SkWStream* stream, uint32_t v) {
+    const uint8_t bytes[4] = {(uint8_t)(v >> 24), (uint8_t)(v >> 16), (uint8_t)(v >> 8), (uint8_t)v};
+    return stream->write(bytes, sizeof(bytes));
+}
+
+// Encodes the image data of src as IDAT chunks and finishes the png with IEND, after libpng has
+// written everything up to the first IDAT.  Strips of rows are filtered, then deflated, in
+// parallel, and concatenated into one zlib stream whose Adler-32 is combined from the strips'.
+// Each strip gets its own IDAT, whose CRC is likewise combined from one taken on the strip's
+// thread.
+static bool encode_strips(SkWStream* dst, SkPngEncoderMgr* mgr, const SkPixmap& src,
+                          const SkPngEncoder::Options& options) {
+    const size_t bpp          = mgr->pngBytesPerPixel(),
+                 rowBytes     = bpp * src.width(),
+                 filteredRow  = rowBytes + 1;
+    const int    rowsPerStrip = (int)std::max<size_t>(1, kStripBytes / filteredRow),
+                 stripCount   = (src.height() + rowsPerStrip - 1) / rowsPerStrip;
+
+    int filters = (int)options.fFilterFlags & PNG_ALL_FILTERS;
+    if (!filters) {
+        filters = PNG_FILTER_NONE;
+    }
+    const int zlibLevel = std::min(std::max(0, options.fZLibLevel), 9);
+    // libpng's default strategy.
+    const int strategy = filters == PNG_FILTER_NONE ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+
+    struct Strip {
+        std::vector<uint8_t> fDeflated;
+        uLong                fAdler = 0,
+                             fCrc   = 0;
+        bool                 fOK    = false;
+    };
+    std::vector<Strip> strips(stripCount);
+    SkAutoTMalloc<uint8_t> filtered(filteredRow * src.height());
+
+    auto transform = [&](int y, uint8_t* row) {
+        const void* srcRow = src.addr(0, y);
+        sk_msan_assert_initialized(srcRow,
+                                   (const uint8_t*)srcRow + (src.width() << src.shiftPerPixel()));
+        mgr->proc()((char*)row, (const char*)srcRow, src.width(),
+                    SkColorTypeBytesPerPixel(src.colorType()));
+    };
+
+    SkTaskGroup tg(*options.fExecutor);
+    // Filtering a row needs the row above unfiltered, so each strip transforms that row again.
+    tg.batch(stripCount, [&](int s) {
+        const int top    = s * rowsPerStrip,
+                  bottom = std::min(top + rowsPerStrip, src.height());
+        SkAutoTMalloc<uint8_t> storage(2 * rowBytes + filteredRow);
+        uint8_t* row     = storage.get();
+        uint8_t* prev    = row + rowBytes;
+        uint8_t* scratch = prev + rowBytes;
+        if (top == 0) {
+            sk_bzero(prev, rowBytes);
+        } else {
+            transform(top - 1, prev);
+        }
+        for (int y = top; y < bottom; y++) {
+            transform(y, row);
+            filter_row(filters, filtered.get() + y * filteredRow, scratch, row, prev, rowBytes, bpp);
+            std::swap(row, prev);
+        }
+    });
+    tg.wait();
+
+    tg.batch(stripCount, [&](int s) {
+        const size_t start = s * rowsPerStrip * filteredRow,
+                     end   = std::min(start + rowsPerStrip * filteredRow,
+                                      src.height() * filteredRow);
+        const bool   last  = s == stripCount - 1;
+        Strip& strip = strips[s];
+
+        z_stream z = {};
+        if (Z_OK != deflateInit2(&z, zlibLevel, Z_DEFLATED, -15 /*raw*/, 8, strategy)) {
+            return;
+        }
+        if (start > 0) {
+            const size_t dictionary = std::min(start, kDeflateWindow);
+            deflateSetDictionary(&z, filtered.get() + start - dictionary, (uInt)dictionary);
+        }
+        z.next_in  = filtered.get() + start;
+        z.avail_in = (uInt)(end - start);
+
+        // Every strip but the last ends byte-aligned, without a final block, so the next one can
+        // start right after it.
+        const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+        strip.fDeflated.resize(deflateBound(&z, end - start) + 16);
+        for (;;) {
+            z.next_out  = strip.fDeflated.data() + z.total_out;
+            z.avail_out = (uInt)(strip.fDeflated.size() - z.total_out);
+            const int result = deflate(&z, flush);
+            if (last ? result == Z_STREAM_END : (result == Z_OK && z.avail_out > 0)) {
+                break;
+            }
+            if (result != Z_OK && result != Z_BUF_ERROR) {
+                deflateEnd(&z);
+                return;
+            }
+            strip.fDeflated.resize(2 * strip.fDeflated.size());
+        }
+        strip.fDeflated.resize(z.total_out);
+        deflateEnd(&z);
+
+        strip.fAdler = adler32(adler32(0, nullptr, 0), filtered.get() + start, (uInt)(end - start));
+        strip.fCrc   = crc32(0, strip.fDeflated.data(), (uInt)strip.fDeflated.size());
+        strip.fOK    = true;
+    });
+    tg.wait();
+
+    // The zlib header is the same as zlib would write for a 32K window at this level.
+    const int levelFlags = zlibLevel < 2 ? 0 : zlibLevel < 6 ? 1 : zlibLevel == 6 ? 2 : 3;
+    uint16_t header = 0x7800 | levelFlags << 6;
+    header += 31 - header % 31;
+    const uint8_t headerBytes[2] = {(uint8_t)(header >> 8), (uint8_t)header};
+
+    uLong adler = adler32(0, nullptr, 0);
+    for (int s = 0; s < stripCount; s++) {
+        const Strip& strip = strips[s];
+        if (!strip.fOK || strip.fDeflated.size() > PNG_UINT_31_MAX - 6) {
+            return false;
+        }
+        const size_t stripBytes = std::min((size_t)rowsPerStrip,
+                                           (size_t)(src.height() - s * rowsPerStrip)) * filteredRow;
+        adler = adler32_combine(adler, strip.fAdler, (z_off_t)stripBytes);
+
+        const bool first = s == 0,
+                   last  = s == stripCount - 1;
+        uint8_t adlerBytes[4] = {(uint8_t)(adler >> 24), (uint8_t)(adler >> 16),
+                                 (uint8_t)(adler >>  8), (uint8_t)adler};
+        const size_t length = (first ? sizeof(headerBytes) : 0) + strip.fDeflated.size() +
+                              (last  ? sizeof(adlerBytes)  : 0);
+
+        uLong crc = crc32(0, (const Bytef*)"IDAT", 4);
+        if (first) {
+            crc = crc32(crc, headerBytes, sizeof(headerBytes));
+        }
+        crc = crc32_combine(crc, strip.fCrc, (z_off_t)strip.fDeflated.size());
+        if (last) {
+            crc = crc32(crc, adlerBytes, sizeof(adlerBytes));
+        }
+
+        if (!write_u32(dst, (uint32_t)length) ||
+            !dst->write("IDAT", 4) ||
+            (first && !dst->write(headerBytes, sizeof(headerBytes))) ||
+            !dst->write(strip.fDeflated.data(), strip.fDeflated.size()) ||
+            (last && !dst->write(adlerBytes, sizeof(adlerBytes))) ||
+            !write_u32(dst, (uint32_t)crc)) {
+            return false;
+        }
+    }
+
+    return write_u32(dst, 0)
+        && dst->write("IEND", 4)
+        && write_u32(dst, (uint32_t)crc32(0, (const Bytef*)"IEND", 4));
+}
+
 bool SkPngEncoder::Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
     auto encoder = SkPngEncoder::Make(dst, src, options);
-    return encoder.get() && encoder->encodeRows(src.height());
+    if (!encoder) {
+        return false;
+    }
+
+    // Opaque F16 rows are written with an alpha channel for libpng to strip, so they stay serial,
+    // as do images that would fit in a single strip anyway.
+    SkPngEncoderMgr* mgr = static_cast<SkPngEncoder*>(encoder.get())->fEncoderMgr.get();
+    const bool filler = kRGBA_F16_SkColorType == src.colorType() &&
+                        kOpaque_SkAlphaType   == src.alphaType();
+    const size_t filteredRow = mgr->pngBytesPerPixel() * (size_t)src.width() + 1;
+    if (options.fExecutor && !filler && src.height() * filteredRow > kStripBytes) {
+        return encode_strips(dst, mgr, src, options);
+    }
+    return encoder->encodeRows(src.height());
 }
 
 #endif
@@ -11,6 +11,7 @@
 #include "include/core/SkData.h"
 #include "include/core/SkTypes.h"
 #include "modules/skcms/skcms.h"
+#include "src/core/SkRasterPipeline.h"
 #include "src/core/SkUtils.h"  // unaligned_{load,store}
 #include <cstdint>
 
@@ -341,7 +342,236 @@ namespace SK_OPTS_NS {
         }
     }
 
-#elif defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#elif defined(JUMPER_IS_SKX)
+    // These are __m512 and __m512i, but friendlier and strongly-typed.
+    template <typename T> using V = T __attribute__((ext_vector_type(16)));
+    using F   = V<float   >;
+    using I32 = V< int32_t>;
+    using U64 = V<uint64_t>;
+    using U32 = V<uint32_t>;
+    using U16 = V<uint16_t>;
+    using U8  = V<uint8_t >;
+
+    SI F   mad(F f, F m, F a) { return _mm512_fmadd_ps(f,m,a); }
+    SI F   min(F a, F b)      { return _mm512_min_ps(a,b);     }
+    SI F   max(F a, F b)      { return _mm512_max_ps(a,b);     }
+    SI F   abs_  (F v)        { return _mm512_and_ps(v, 0-v);  }
+    SI F   floor_(F v)        { return _mm512_roundscale_ps(v, _MM_FROUND_FLOOR); }
+    SI F   sqrt_ (F v)        { return _mm512_sqrt_ps(v);      }
+
+    // _mm512_rcp14_ps() and _mm512_rsqrt14_ps() are more precise than the AVX estimates, so using
+    // them would draw slightly differently than HSW.  Take the AVX estimates of each half instead.
+    SI F rcp_fast(F v) {
+        __m256 lo = _mm256_rcp_ps(_mm512_castps512_ps256(v)),
+               hi = _mm256_rcp_ps(_mm512_extractf32x8_ps(v, 1));
+        return _mm512_insertf32x8(_mm512_castps256_ps512(lo), hi, 1);
+    }
+    SI F rsqrt(F v) {
+        __m256 lo = _mm256_rsqrt_ps(_mm512_castps512_ps256(v)),
+               hi = _mm256_rsqrt_ps(_mm512_extractf32x8_ps(v, 1));
+        return _mm512_insertf32x8(_mm512_castps256_ps512(lo), hi, 1);
+    }
+    SI F rcp_precise (F v) {
+        F e = rcp_fast(v);
+        return _mm512_fnmadd_ps(v, e, _mm512_set1_ps(2.0f)) * e;
+    }
+
+    SI U32 round (F v, F scale) { return _mm512_cvtps_epi32(v*scale); }
+    // These saturate like _mm_packus_epi32() and _mm_packus_epi16(), treating v as signed.
+    SI U16 pack(U32 v) {
+        return _mm512_cvtusepi32_epi16(_mm512_max_epi32(v, _mm512_setzero_si512()));
+    }
+    SI U8 pack(U16 v) {
+        return _mm256_cvtusepi16_epi8(_mm256_max_epi16(v, _mm256_setzero_si256()));
+    }
+
+    SI F if_then_else(I32 c, F t, F e) {
+        return _mm512_mask_blend_ps(_mm512_movepi32_mask(c), e,t);
+    }
+
+    template <typename T>
+    SI V<T> gather(const T* p, U32 ix) {
+        return { p[ix[ 0]], p[ix[ 1]], p[ix[ 2]], p[ix[ 3]],
+                 p[ix[ 4]], p[ix[ 5]], p[ix[ 6]], p[ix[ 7]],
+                 p[ix[ 8]], p[ix[ 9]], p[ix[10]], p[ix[11]],
+                 p[ix[12]], p[ix[13]], p[ix[14]], p[ix[15]], };
+    }
+    SI F   gather(const float*    p, U32 ix) { return _mm512_i32gather_ps   (ix, p, 4); }
+    SI U32 gather(const uint32_t* p, U32 ix) { return _mm512_i32gather_epi32(ix, p, 4); }
+    SI U64 gather(const uint64_t* p, U32 ix) {
+        __m512i parts[] = {
+            _mm512_i32gather_epi64(_mm512_castsi512_si256(ix),        p, 8),
+            _mm512_i32gather_epi64(_mm512_extracti64x4_epi64(ix, 1), p, 8),
+        };
+        return sk_bit_cast<U64>(parts);
+    }
+
+    // A mask of the lanes of a register covering elements [skip, skip+lanes) that are among the
+    // first n elements.  Tails use these for masked loads and stores, which never touch memory
+    // past the end of the row.
+    SI uint32_t tail_mask(size_t n, size_t skip, size_t lanes) {
+        size_t active = n <= skip         ? 0
+                      : n - skip > lanes ? lanes
+                      :                    n - skip;
+        return (uint32_t)((uint64_t(1) << active) - 1);
+    }
+
+    SI void load2(const uint16_t* ptr, size_t tail, U16* r, U16* g) {
+        // Each 32-bit lane holds one pixel, r in its low half and g in its high half.
+        __m512i rg = __builtin_expect(tail,0) ? _mm512_maskz_loadu_epi32(tail_mask(tail,0,16), ptr)
+                                              : _mm512_loadu_si512(ptr);
+        *r = _mm512_cvtepi32_epi16(rg);
+        *g = _mm512_cvtepi32_epi16(_mm512_srli_epi32(rg, 16));
+    }
+    SI void store2(uint16_t* ptr, size_t tail, U16 r, U16 g) {
+        __m512i rg = _mm512_or_si512(_mm512_cvtepu16_epi32(r),
+                                     _mm512_slli_epi32(_mm512_cvtepu16_epi32(g), 16));
+        if (__builtin_expect(tail,0)) {
+            _mm512_mask_storeu_epi32(ptr, tail_mask(tail,0,16), rg);
+        } else {
+            _mm512_storeu_si512(ptr, rg);
+        }
+    }
+
+    SI void load3(const uint16_t* ptr, size_t tail, U16* r, U16* g, U16* b) {
+        // 16 pixels are 48 uint16_t: 32 in _lo, and the rest in the bottom half of _hi.
+        __m512i _lo, _hi;
+        if (__builtin_expect(tail,0)) {
+            _lo = _mm512_maskz_loadu_epi16(tail_mask(3*tail, 0,32), ptr +  0);
+            _hi = _mm512_maskz_loadu_epi16(tail_mask(3*tail,32,32), ptr + 32);
+        } else {
+            _lo = _mm512_loadu_si512(ptr);
+            _hi = _mm512_castsi256_si512(_mm256_loadu_si256((const __m256i*)(ptr + 32)));
+        }
+        const U16 ix = {0,3,6,9,12,15,18,21,24,27,30,33,36,39,42,45};
+        auto channel = [&](U16 idx) -> U16 {
+            return _mm512_castsi512_si256(
+                    _mm512_permutex2var_epi16(_lo, _mm512_castsi256_si512(idx), _hi));
+        };
+        *r = channel(ix+0);
+        *g = channel(ix+1);
+        *b = channel(ix+2);
+    }
+    SI void load4(const uint16_t* ptr, size_t tail, U16* r, U16* g, U16* b, U16* a) {
+        // Each 64-bit lane holds one pixel, pixels 0-7 in _lo and 8-15 in _hi.
+        __m512i _lo, _hi;
+        if (__builtin_expect(tail,0)) {
+            _lo = _mm512_maskz_loadu_epi64(tail_mask(tail,0,8), ptr +  0);
+            _hi = _mm512_maskz_loadu_epi64(tail_mask(tail,8,8), ptr + 32);
+        } else {
+            _lo = _mm512_loadu_si512(ptr +  0);
+            _hi = _mm512_loadu_si512(ptr + 32);
+        }
+        // Keeps the low 16 bits of each pixel.
+        auto channel = [](__m512i lo, __m512i hi) -> U16 {
+            return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm512_cvtepi64_epi16(lo)),
+                                           _mm512_cvtepi64_epi16(hi), 1);
+        };
+        *r = channel(_lo, _hi);
+        *g = channel(_mm512_srli_epi64(_lo, 16), _mm512_srli_epi64(_hi, 16));
+        *b = channel(_mm512_srli_epi64(_lo, 32), _mm512_srli_epi64(_hi, 32));
+        *a = channel(_mm512_srli_epi64(_lo, 48), _mm512_srli_epi64(_hi, 48));
+    }
+    SI void store4(uint16_t* ptr, size_t tail, U16 r, U16 g, U16 b, U16 a) {
+        auto pixels = [](__m128i R, __m128i G, __m128i B, __m128i A) {
+            return _mm512_or_si512(
+                    _mm512_or_si512(                  _mm512_cvtepu16_epi64(R),
+                                    _mm512_slli_epi64(_mm512_cvtepu16_epi64(G), 16)),
+                    _mm512_or_si512(_mm512_slli_epi64(_mm512_cvtepu16_epi64(B), 32),
+                                    _mm512_slli_epi64(_mm512_cvtepu16_epi64(A), 48)));
+        };
+        __m512i _lo = pixels(_mm256_castsi256_si128(r), _mm256_castsi256_si128(g),
+                             _mm256_castsi256_si128(b), _mm256_castsi256_si128(a)),
+                _hi = pixels(_mm256_extracti128_si256(r, 1), _mm256_extracti128_si256(g, 1),
+                             _mm256_extracti128_si256(b, 1), _mm256_extracti128_si256(a, 1));
+        if (__builtin_expect(tail,0)) {
+            _mm512_mask_storeu_epi64(ptr +  0, tail_mask(tail,0,8), _lo);
+            _mm512_mask_storeu_epi64(ptr + 32, tail_mask(tail,8,8), _hi);
+        } else {
+            _mm512_storeu_si512(ptr +  0, _lo);
+            _mm512_storeu_si512(ptr + 32, _hi);
+        }
+    }
+
+    SI void load2(const float* ptr, size_t tail, F* r, F* g) {
+        F _lo, _hi;  // Pixels 0-7 and 8-15.
+        if (__builtin_expect(tail,0)) {
+            _lo = _mm512_maskz_loadu_ps(tail_mask(2*tail, 0,16), ptr +  0);
+            _hi = _mm512_maskz_loadu_ps(tail_mask(2*tail,16,16), ptr + 16);
+        } else {
+            _lo = _mm512_loadu_ps(ptr +  0);
+            _hi = _mm512_loadu_ps(ptr + 16);
+        }
+        const I32 ix = {0,2,4,6,8,10,12,14,16,18,20,22,24,26,28,30};
+        *r = _mm512_permutex2var_ps(_lo, ix+0, _hi);
+        *g = _mm512_permutex2var_ps(_lo, ix+1, _hi);
+    }
+    SI void store2(float* ptr, size_t tail, F r, F g) {
+        const I32 ix = {0,16,1,17,2,18,3,19,4,20,5,21,6,22,7,23};
+        F _lo = _mm512_permutex2var_ps(r, ix+0, g),  // r0 g0 r1 g1 ... r7 g7
+          _hi = _mm512_permutex2var_ps(r, ix+8, g);  // r8 g8 ...
+        if (__builtin_expect(tail,0)) {
+            _mm512_mask_storeu_ps(ptr +  0, tail_mask(2*tail, 0,16), _lo);
+            _mm512_mask_storeu_ps(ptr + 16, tail_mask(2*tail,16,16), _hi);
+        } else {
+            _mm512_storeu_ps(ptr +  0, _lo);
+            _mm512_storeu_ps(ptr + 16, _hi);
+        }
+    }
+
+    SI void load4(const float* ptr, size_t tail, F* r, F* g, F* b, F* a) {
+        F _0123, _4567, _89ab, _cdef;
+        if (__builtin_expect(tail,0)) {
+            _0123 = _mm512_maskz_loadu_ps(tail_mask(4*tail, 0,16), ptr +  0);
+            _4567 = _mm512_maskz_loadu_ps(tail_mask(4*tail,16,16), ptr + 16);
+            _89ab = _mm512_maskz_loadu_ps(tail_mask(4*tail,32,16), ptr + 32);
+            _cdef = _mm512_maskz_loadu_ps(tail_mask(4*tail,48,16), ptr + 48);
+        } else {
+            _0123 = _mm512_loadu_ps(ptr +  0);
+            _4567 = _mm512_loadu_ps(ptr + 16);
+            _89ab = _mm512_loadu_ps(ptr + 32);
+            _cdef = _mm512_loadu_ps(ptr + 48);
+        }
+
+        const I32 rg = {0,4,8,12,16,20,24,28, 1,5,9,13,17,21,25,29},
+                  lo = {0,1,2,3,4,5,6,7, 16,17,18,19,20,21,22,23};
+        F rg01234567 = _mm512_permutex2var_ps(_0123, rg+0, _4567),  // r0 ... r7 g0 ... g7
+          ba01234567 = _mm512_permutex2var_ps(_0123, rg+2, _4567),  // b0 ... b7 a0 ... a7
+          rg89abcdef = _mm512_permutex2var_ps(_89ab, rg+0, _cdef),
+          ba89abcdef = _mm512_permutex2var_ps(_89ab, rg+2, _cdef);
+
+        *r = _mm512_permutex2var_ps(rg01234567, lo+0, rg89abcdef);
+        *g = _mm512_permutex2var_ps(rg01234567, lo+8, rg89abcdef);
+        *b = _mm512_permutex2var_ps(ba01234567, lo+0, ba89abcdef);
+        *a = _mm512_permutex2var_ps(ba01234567, lo+8, ba89abcdef);
+    }
+    SI void store4(float* ptr, size_t tail, F r, F g, F b, F a) {
+        const I32 lo = {0,1,2,3,4,5,6,7, 16,17,18,19,20,21,22,23},
+                  px = {0,8,16,24, 1,9,17,25, 2,10,18,26, 3,11,19,27};
+        F rg01234567 = _mm512_permutex2var_ps(r, lo+0, g),  // r0 ... r7 g0 ... g7
+          rg89abcdef = _mm512_permutex2var_ps(r, lo+8, g),
+          ba01234567 = _mm512_permutex2var_ps(b, lo+0, a),  // b0 ... b7 a0 ... a7
+          ba89abcdef = _mm512_permutex2var_ps(b, lo+8, a);
+
+        F _0123 = _mm512_permutex2var_ps(rg01234567, px+0, ba01234567),  // r0 g0 b0 a0 r1 ...
+          _4567 = _mm512_permutex2var_ps(rg01234567, px+4, ba01234567),
+          _89ab = _mm512_permutex2var_ps(rg89abcdef, px+0, ba89abcdef),
+          _cdef = _mm512_permutex2var_ps(rg89abcdef, px+4, ba89abcdef);
+
+        if (__builtin_expect(tail,0)) {
+            _mm512_mask_storeu_ps(ptr +  0, tail_mask(4*tail, 0,16), _0123);
+            _mm512_mask_storeu_ps(ptr + 16, tail_mask(4*tail,16,16), _4567);
+            _mm512_mask_storeu_ps(ptr + 32, tail_mask(4*tail,32,16), _89ab);
+            _mm512_mask_storeu_ps(ptr + 48, tail_mask(4*tail,48,16), _cdef);
+        } else {
+            _mm512_storeu_ps(ptr +  0, _0123);
+            _mm512_storeu_ps(ptr + 16, _4567);
+            _mm512_storeu_ps(ptr + 32, _89ab);
+            _mm512_storeu_ps(ptr + 48, _cdef);
+        }
+    }
+
+#elif defined(JUMPER_IS_HSW)
     // These are __m256 and __m256i, but friendlier and strongly-typed.
     template <typename T> using V = T __attribute__((ext_vector_type(8)));
     using F   = V<float   >;
@@ -352,7 +582,7 @@ namespace SK_OPTS_NS {
     using U8  = V<uint8_t >;
 
     SI F mad(F f, F m, F a)  {
-    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+    #if defined(JUMPER_IS_HSW)
         return _mm256_fmadd_ps(f,m,a);
     #else
         return f*m+a;
@@ -368,7 +598,7 @@ namespace SK_OPTS_NS {
     SI F   sqrt_ (F v)   { return _mm256_sqrt_ps (v);    }
     SI F rcp_precise (F v) {
         F e = rcp_fast(v);
-        #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+        #if defined(JUMPER_IS_HSW)
             return _mm256_fnmadd_ps(v, e, _mm256_set1_ps(2.0f)) * e;
         #else
             return e * (2.0f - v * e);
@@ -393,7 +623,7 @@ namespace SK_OPTS_NS {
         return { p[ix[0]], p[ix[1]], p[ix[2]], p[ix[3]],
                  p[ix[4]], p[ix[5]], p[ix[6]], p[ix[7]], };
     }
-    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+    #if defined(JUMPER_IS_HSW)
         SI F   gather(const float*    p, U32 ix) { return _mm256_i32gather_ps   (p, ix, 4); }
         SI U32 gather(const uint32_t* p, U32 ix) { return _mm256_i32gather_epi32(p, ix, 4); }
         SI U64 gather(const uint64_t* p, U32 ix) {
@@ -1000,7 +1230,10 @@ SI F from_half(U16 h) {
     && !defined(SK_BUILD_FOR_GOOGLE3)  // Temporary workaround for some Google3 builds.
     return vcvt_f32_f16(h);
 
-#elif defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#elif defined(JUMPER_IS_SKX)
+    return _mm512_cvtph_ps(h);
+
+#elif defined(JUMPER_IS_HSW)
     return _mm256_cvtph_ps(h);
 
 #else
@@ -1021,7 +1254,10 @@ SI U16 to_half(F f) {
     && !defined(SK_BUILD_FOR_GOOGLE3)  // Temporary workaround for some Google3 builds.
     return vcvt_f16_f32(f);
 
-#elif defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#elif defined(JUMPER_IS_SKX)
+    return _mm512_cvtps_ph(f, _MM_FROUND_CUR_DIRECTION);
+
+#elif defined(JUMPER_IS_HSW)
     return _mm256_cvtps_ph(f, _MM_FROUND_CUR_DIRECTION);
 
 #else
@@ -1039,6 +1275,7 @@ SI U16 to_half(F f) {
 
 // Our fundamental vector depth is our pixel stride.
 static const size_t N = sizeof(F) / sizeof(float);
+static_assert(N <= SkRasterPipeline_kMaxStride_highp, "Context buffers are sized for N pixels.");
 
 // We're finally going to get to what a Stage function looks like!
 //    tail == 0 ~~> work on a full N pixels
@@ -1252,6 +1489,10 @@ SI V load(const T* src, size_t tail) {
     __builtin_assume(tail < N);
     if (__builtin_expect(tail, 0)) {
         V v{};  // Any inactive lanes are zeroed.
+    #if defined(JUMPER_IS_SKX)
+        // With 16 lanes, one variable-length copy beats a 15-way switch.
+        memcpy(&v, src, tail*sizeof(T));
+    #else
         switch (tail) {
             case 7: v[6] = src[6]; [[fallthrough]];
             case 6: v[5] = src[5]; [[fallthrough]];
@@ -1261,6 +1502,7 @@ SI V load(const T* src, size_t tail) {
             case 2: memcpy(&v, src, 2*sizeof(T)); break;
             case 1: memcpy(&v, src, 1*sizeof(T)); break;
         }
+    #endif
         return v;
     }
 #endif
@@ -1272,6 +1514,9 @@ SI void store(T* dst, V v, size_t tail) {
 #if !defined(JUMPER_IS_SCALAR)
     __builtin_assume(tail < N);
     if (__builtin_expect(tail, 0)) {
+    #if defined(JUMPER_IS_SKX)
+        memcpy(dst, &v, tail*sizeof(T));
+    #else
         switch (tail) {
             case 7: dst[6] = v[6]; [[fallthrough]];
             case 6: dst[5] = v[5]; [[fallthrough]];
@@ -1281,6 +1526,7 @@ SI void store(T* dst, V v, size_t tail) {
             case 2: memcpy(dst, &v, 2*sizeof(T)); break;
             case 1: memcpy(dst, &v, 1*sizeof(T)); break;
         }
+    #endif
         return;
     }
 #endif
@@ -1398,7 +1644,7 @@ STAGE(seed_shader, Ctx::None) {
 
 STAGE(dither, const float* rate) {
     // Get [(dx,dy), (dx+1,dy), (dx+2,dy), ...] loaded up in integer vectors.
-    uint32_t iota[] = {0,1,2,3,4,5,6,7};
+    uint32_t iota[] = {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15};
     U32 X = dx + sk_unaligned_load<U32>(iota),
         Y = dy;
 
@@ -2525,7 +2771,22 @@ STAGE(matrix_perspective, const float* m) {
 SI void gradient_lookup(const SkRasterPipeline_GradientCtx* c, U32 idx, F t,
                         F* r, F* g, F* b, F* a) {
     F fr, br, fg, bg, fb, bb, fa, ba;
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    if (c->stopCount <=8) {
+        // fs and bs hold at least 8 floats; idx never reaches into the undefined upper half.
+        auto lookup = [&](const float* v) -> F {
+            return _mm512_permutexvar_ps(idx, _mm512_castps256_ps512(_mm256_loadu_ps(v)));
+        };
+        fr = lookup(c->fs[0]);
+        br = lookup(c->bs[0]);
+        fg = lookup(c->fs[1]);
+        bg = lookup(c->bs[1]);
+        fb = lookup(c->fs[2]);
+        bb = lookup(c->bs[2]);
+        fa = lookup(c->fs[3]);
+        ba = lookup(c->bs[3]);
+    } else
+#elif defined(JUMPER_IS_HSW)
     if (c->stopCount <=8) {
         fr = _mm256_permutevar8x32_ps(_mm256_loadu_ps(c->fs[0]), idx);
         br = _mm256_permutevar8x32_ps(_mm256_loadu_ps(c->bs[0]), idx);
@@ -2939,7 +3200,16 @@ namespace lowp {
 
 #else  // We are compiling vector code with Clang... let's make some lowp stages!
 
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    using U8  = uint8_t  __attribute__((ext_vector_type(32)));
+    using U16 = uint16_t __attribute__((ext_vector_type(32)));
+    using I16 =  int16_t __attribute__((ext_vector_type(32)));
+    using I32 =  int32_t __attribute__((ext_vector_type(32)));
+    using U32 = uint32_t __attribute__((ext_vector_type(32)));
+    using I64 =  int64_t __attribute__((ext_vector_type(32)));
+    using U64 = uint64_t __attribute__((ext_vector_type(32)));
+    using F   = float    __attribute__((ext_vector_type(32)));
+#elif defined(JUMPER_IS_HSW)
     using U8  = uint8_t  __attribute__((ext_vector_type(16)));
     using U16 = uint16_t __attribute__((ext_vector_type(16)));
     using I16 =  int16_t __attribute__((ext_vector_type(16)));
@@ -2960,6 +3230,7 @@ namespace lowp {
 #endif
 
 static const size_t N = sizeof(U16) / sizeof(uint16_t);
+static_assert(N <= SkRasterPipeline_kMaxStride, "Context buffers are sized for N pixels.");
 
 // Once again, some platforms benefit from a restricted Stage calling convention,
 // but others can pass tons and tons of registers and we're happy to exploit that.
@@ -3204,7 +3475,11 @@ SI U32 trunc_(F x) { return (U32)cast<I32>(x); }
 
 // Use approximate instructions and one Newton-Raphson step to calculate 1/x.
 SI F rcp_precise(F x) {
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    __m512 lo,hi;
+    split(x, &lo,&hi);
+    return join<F>(SK_OPTS_NS::rcp_precise(lo), SK_OPTS_NS::rcp_precise(hi));
+#elif defined(JUMPER_IS_HSW)
     __m256 lo,hi;
     split(x, &lo,&hi);
     return join<F>(SK_OPTS_NS::rcp_precise(lo), SK_OPTS_NS::rcp_precise(hi));
@@ -3221,7 +3496,11 @@ SI F rcp_precise(F x) {
 #endif
 }
 SI F sqrt_(F x) {
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    __m512 lo,hi;
+    split(x, &lo,&hi);
+    return join<F>(_mm512_sqrt_ps(lo), _mm512_sqrt_ps(hi));
+#elif defined(JUMPER_IS_HSW)
     __m256 lo,hi;
     split(x, &lo,&hi);
     return join<F>(_mm256_sqrt_ps(lo), _mm256_sqrt_ps(hi));
@@ -3256,7 +3535,12 @@ SI F floor_(F x) {
     float32x4_t lo,hi;
     split(x, &lo,&hi);
     return join<F>(vrndmq_f32(lo), vrndmq_f32(hi));
-#elif defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#elif defined(JUMPER_IS_SKX)
+    __m512 lo,hi;
+    split(x, &lo,&hi);
+    return join<F>(_mm512_roundscale_ps(lo, _MM_FROUND_FLOOR),
+                   _mm512_roundscale_ps(hi, _MM_FROUND_FLOOR));
+#elif defined(JUMPER_IS_HSW)
     __m256 lo,hi;
     split(x, &lo,&hi);
     return join<F>(_mm256_floor_ps(lo), _mm256_floor_ps(hi));
@@ -3276,7 +3560,9 @@ SI F floor_(F x) {
 // The result is a number on [-1, 1).
 // Note: on neon this is a saturating multiply while the others are not.
 SI I16 scaled_mult(I16 a, I16 b) {
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    return _mm512_mulhrs_epi16(a, b);
+#elif defined(JUMPER_IS_HSW)
     return _mm256_mulhrs_epi16(a, b);
 #elif defined(JUMPER_IS_SSE41) || defined(JUMPER_IS_AVX)
     return _mm_mulhrs_epi16(a, b);
@@ -3315,8 +3601,10 @@ SI F abs_(F x) { return sk_bit_cast<F>( sk_bit_cast<I32>(x) & 0x7fffffff ); }
 
 STAGE_GG(seed_shader, Ctx::None) {
     static const float iota[] = {
-        0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f,
-        8.5f, 9.5f,10.5f,11.5f,12.5f,13.5f,14.5f,15.5f,
+         0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f,
+         8.5f, 9.5f,10.5f,11.5f,12.5f,13.5f,14.5f,15.5f,
+        16.5f,17.5f,18.5f,19.5f,20.5f,21.5f,22.5f,23.5f,
+        24.5f,25.5f,26.5f,27.5f,28.5f,29.5f,30.5f,31.5f,
     };
     x = cast<F>(I32(dx)) + sk_unaligned_load<F>(iota);
     y = cast<F>(I32(dy)) + 0.5f;
@@ -3518,9 +3806,13 @@ SI U32 ix_and_ptr(T** ptr, const SkRasterPipeline_GatherCtx* ctx, I32 x, I32 y)
 template <typename V, typename T>
 SI V load(const T* ptr, size_t tail) {
     V v = 0;
+#if defined(JUMPER_IS_SKX)
+    // With 32 lanes, one variable-length copy beats a 31-way switch.
+    memcpy(&v, ptr, (tail ? tail : N)*sizeof(T));
+#else
     switch (tail & (N-1)) {
         case  0: memcpy(&v, ptr, sizeof(v)); break;
-    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+    #if defined(JUMPER_IS_HSW)
         case 15: v[14] = ptr[14]; [[fallthrough]];
         case 14: v[13] = ptr[13]; [[fallthrough]];
         case 13: v[12] = ptr[12]; [[fallthrough]];
@@ -3538,13 +3830,17 @@ SI V load(const T* ptr, size_t tail) {
         case  2: memcpy(&v, ptr,  2*sizeof(T)); break;
         case  1: v[ 0] = ptr[ 0];
     }
+#endif
     return v;
 }
 template <typename V, typename T>
 SI void store(T* ptr, size_t tail, V v) {
+#if defined(JUMPER_IS_SKX)
+    memcpy(ptr, &v, (tail ? tail : N)*sizeof(T));
+#else
     switch (tail & (N-1)) {
         case  0: memcpy(ptr, &v, sizeof(v)); break;
-    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+    #if defined(JUMPER_IS_HSW)
         case 15: ptr[14] = v[14]; [[fallthrough]];
         case 14: ptr[13] = v[13]; [[fallthrough]];
         case 13: ptr[12] = v[12]; [[fallthrough]];
@@ -3562,9 +3858,40 @@ SI void store(T* ptr, size_t tail, V v) {
         case  2: memcpy(ptr, &v,  2*sizeof(T)); break;
         case  1: ptr[ 0] = v[ 0];
     }
+#endif
 }
 
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    template <typename V, typename T>
+    SI V gather(const T* ptr, U32 ix) {
+        return V{ ptr[ix[ 0]], ptr[ix[ 1]], ptr[ix[ 2]], ptr[ix[ 3]],
+                  ptr[ix[ 4]], ptr[ix[ 5]], ptr[ix[ 6]], ptr[ix[ 7]],
+                  ptr[ix[ 8]], ptr[ix[ 9]], ptr[ix[10]], ptr[ix[11]],
+                  ptr[ix[12]], ptr[ix[13]], ptr[ix[14]], ptr[ix[15]],
+                  ptr[ix[16]], ptr[ix[17]], ptr[ix[18]], ptr[ix[19]],
+                  ptr[ix[20]], ptr[ix[21]], ptr[ix[22]], ptr[ix[23]],
+                  ptr[ix[24]], ptr[ix[25]], ptr[ix[26]], ptr[ix[27]],
+                  ptr[ix[28]], ptr[ix[29]], ptr[ix[30]], ptr[ix[31]], };
+    }
+
+    template<>
+    F gather(const float* ptr, U32 ix) {
+        __m512i lo, hi;
+        split(ix, &lo, &hi);
+
+        return join<F>(_mm512_i32gather_ps(lo, ptr, 4),
+                       _mm512_i32gather_ps(hi, ptr, 4));
+    }
+
+    template<>
+    U32 gather(const uint32_t* ptr, U32 ix) {
+        __m512i lo, hi;
+        split(ix, &lo, &hi);
+
+        return join<U32>(_mm512_i32gather_epi32(lo, ptr, 4),
+                         _mm512_i32gather_epi32(hi, ptr, 4));
+    }
+#elif defined(JUMPER_IS_HSW)
     template <typename V, typename T>
     SI V gather(const T* ptr, U32 ix) {
         return V{ ptr[ix[ 0]], ptr[ix[ 1]], ptr[ix[ 2]], ptr[ix[ 3]],
@@ -3602,7 +3929,14 @@ SI void store(T* ptr, size_t tail, V v) {
 // ~~~~~~ 32-bit memory loads and stores ~~~~~~ //
 
 SI void from_8888(U32 rgba, U16* r, U16* g, U16* b, U16* a) {
-#if 1 && defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if 1 && defined(JUMPER_IS_SKX)
+    // The values fit in 16 bits, so truncating each half is all we need.
+    auto cast_U16 = [](U32 v) -> U16 {
+        __m512i lo,hi;
+        split(v, &lo,&hi);
+        return join<U16>(_mm512_cvtepi32_epi16(lo), _mm512_cvtepi32_epi16(hi));
+    };
+#elif 1 && defined(JUMPER_IS_HSW)
     // Swap the middle 128-bit lanes to make _mm256_packus_epi32() in cast_U16() work out nicely.
     __m256i _01,_23;
     split(rgba, &_01, &_23);
@@ -4082,7 +4416,26 @@ SI void gradient_lookup(const SkRasterPipeline_GradientCtx* c, U32 idx, F t,
                         U16* r, U16* g, U16* b, U16* a) {
 
     F fr, fg, fb, fa, br, bg, bb, ba;
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    if (c->stopCount <=8) {
+        __m512i lo, hi;
+        split(idx, &lo, &hi);
+
+        // fs and bs hold at least 8 floats; idx never reaches into the undefined upper half.
+        auto lookup = [&](const float* v) -> F {
+            __m512 table = _mm512_castps256_ps512(_mm256_loadu_ps(v));
+            return join<F>(_mm512_permutexvar_ps(lo, table), _mm512_permutexvar_ps(hi, table));
+        };
+        fr = lookup(c->fs[0]);
+        br = lookup(c->bs[0]);
+        fg = lookup(c->fs[1]);
+        bg = lookup(c->bs[1]);
+        fb = lookup(c->fs[2]);
+        bb = lookup(c->bs[2]);
+        fa = lookup(c->fs[3]);
+        ba = lookup(c->bs[3]);
+    } else
+#elif defined(JUMPER_IS_HSW)
     if (c->stopCount <=8) {
         __m256i lo, hi;
         split(idx, &lo, &hi);
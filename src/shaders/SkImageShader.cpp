@@ -514,7 +514,8 @@ bool SkImageShader::doStages(const SkStageRec& rec, TransformShader* updater) co
     totalInverse.normalizePerspective();
 
     SkASSERT(!sampling.useCubic || sampling.mipmap == SkMipmapMode::kNone);
-    auto* access = SkMipmapAccessor::Make(alloc, fImage.get(), totalInverse, sampling.mipmap);
+    auto* access = SkMipmapAccessor::Make(alloc, fImage.get(), totalInverse, sampling.mipmap,
+                                          /*allowScaledDecode=*/updater == nullptr);
     if (!access) {
         return false;
     }
@@ -775,7 +776,8 @@ skvm::Color SkImageShader::makeProgram(
     if (sampling.isAniso()) {
         sampling = SkSamplingPriv::AnisoFallback(fImage->hasMipmaps());
     }
-    auto* access = SkMipmapAccessor::Make(alloc, fImage.get(), baseInv, sampling.mipmap);
+    auto* access = SkMipmapAccessor::Make(alloc, fImage.get(), baseInv, sampling.mipmap,
+                                          /*allowScaledDecode=*/coordShader == nullptr);
     if (!access) {
         return {};
     }
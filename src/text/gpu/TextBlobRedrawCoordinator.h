@@ -116,7 +116,7 @@ private:
 
     static const int kDefaultBudget = 1 << 22;
 
-    mutable SkSpinlock fSpinLock;
+    mutable SkSpinlock fSpinLock{"TextBlobRedrawCoordinator.fSpinLock"};
     TextBlobList fBlobList SK_GUARDED_BY(fSpinLock);
     SkTHashMap<uint32_t, BlobIDCacheEntry> fBlobIDCache SK_GUARDED_BY(fSpinLock);
     size_t fSizeBudget SK_GUARDED_BY(fSpinLock);
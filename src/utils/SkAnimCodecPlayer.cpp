@@ -22,6 +22,7 @@
 #include "include/core/SkSize.h"
 #include "include/core/SkTypes.h"
 #include "src/codec/SkCodecImageGenerator.h"
+#include "src/utils/SkCodecFrameCache.h"
 
 #include <algorithm>
 #include <cstddef>
@@ -29,10 +30,9 @@
 #include <utility>
 #include <vector>
 
-SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(std::move(codec)) {
-    fImageInfo = fCodec->getInfo();
-    fFrameInfos = fCodec->getFrameInfo();
-    fImages.resize(fFrameInfos.size());
+SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) {
+    fImageInfo = codec->getInfo();
+    fFrameInfos = codec->getFrameInfo();
 
     // change the interpretation of fDuration to a end-time for that frame
     size_t dur = 0;
@@ -45,20 +45,21 @@ SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(st
     if (!fTotalDuration) {
         // Static image -- may or may not have returned a single frame info.
         fFrameInfos.clear();
-        fImages.clear();
-        fImages.push_back(SkImage::MakeFromGenerator(
-                              SkCodecImageGenerator::MakeFromCodec(std::move(fCodec))));
+        fImage = SkImage::MakeFromGenerator(SkCodecImageGenerator::MakeFromCodec(std::move(codec)));
+        fImageIndex = 0;
+    } else {
+        fFrameCache = std::make_unique<SkCodecFrameCache>(std::move(codec),
+                                                          SkCodecFrameCache::Options());
     }
 }
 
 SkAnimCodecPlayer::~SkAnimCodecPlayer() {}
 
 SkISize SkAnimCodecPlayer::dimensions() const {
-    if (!fCodec) {
-        auto image = fImages.front();
-        return image ? image->dimensions() : SkISize::MakeEmpty();
+    if (!fFrameCache) {
+        return fImage ? fImage->dimensions() : SkISize::MakeEmpty();
     }
-    if (SkEncodedOriginSwapsWidthHeight(fCodec->getOrigin())) {
+    if (SkEncodedOriginSwapsWidthHeight(fFrameCache->codec()->getOrigin())) {
         return { fImageInfo.height(), fImageInfo.width() };
     }
     return { fImageInfo.width(), fImageInfo.height() };
@@ -67,73 +68,42 @@ SkISize SkAnimCodecPlayer::dimensions() const {
 sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
     SkASSERT((unsigned)index < fFrameInfos.size());
 
-    if (fImages[index]) {
-        return fImages[index];
+    if (index == fImageIndex) {
+        return fImage;
     }
 
-    size_t rb = fImageInfo.minRowBytes();
-    size_t size = fImageInfo.computeByteSize(rb);
-    auto data = SkData::MakeUninitialized(size);
-
-    SkCodec::Options opts;
-    opts.fFrameIndex = index;
-
-    const auto origin = fCodec->getOrigin();
-    const auto orientedDims = this->dimensions();
-    const auto originMatrix = SkEncodedOriginToMatrix(origin, orientedDims.width(),
-                                                              orientedDims.height());
-
-    SkPaint paint;
-    paint.setBlendMode(SkBlendMode::kSrc);
-
-    auto imageInfo = fImageInfo;
-    if (fFrameInfos[index].fAlphaType != kOpaque_SkAlphaType && imageInfo.isOpaque()) {
-        imageInfo = imageInfo.makeAlphaType(kPremul_SkAlphaType);
-    }
-    const int requiredFrame = fFrameInfos[index].fRequiredFrame;
-    if (requiredFrame != SkCodec::kNoFrame && fImages[requiredFrame]) {
-        auto requiredImage = fImages[requiredFrame];
-        auto canvas = SkCanvas::MakeRasterDirect(imageInfo, data->writable_data(), rb);
-        if (origin != kDefault_SkEncodedOrigin) {
-            // The required frame is stored after applying the origin. Undo that,
-            // because the codec decodes prior to applying the origin.
-            // FIXME: Another approach would be to decode the frame's delta on top
-            // of transparent black, and then draw that through the origin matrix
-            // onto the required frame. To do that, SkCodec needs to expose the
-            // rectangle of the delta and the blend mode, so we can handle
-            // kRestoreBGColor frames and Blend::kSrc.
-            SkMatrix inverse;
-            SkAssertResult(originMatrix.invert(&inverse));
-            canvas->concat(inverse);
-        }
-        canvas->drawImage(requiredImage, 0, 0, SkSamplingOptions(), &paint);
-        opts.fPriorFrame = requiredFrame;
-    }
-
-    if (SkCodec::kSuccess != fCodec->getPixels(imageInfo, data->writable_data(), rb, &opts)) {
+    // The frame cache composites each frame onto the frames it requires, so it returns frames
+    // prior to applying the origin.
+    auto image = fFrameCache->getFrame(index);
+    if (!image) {
         return nullptr;
     }
 
-    auto image = SkImage::MakeRasterData(imageInfo, std::move(data), rb);
+    const auto origin = fFrameCache->codec()->getOrigin();
     if (origin != kDefault_SkEncodedOrigin) {
-        imageInfo = imageInfo.makeDimensions(orientedDims);
-        rb = imageInfo.minRowBytes();
-        size = imageInfo.computeByteSize(rb);
-        data = SkData::MakeUninitialized(size);
+        const auto orientedDims = this->dimensions();
+        const auto imageInfo = image->imageInfo().makeDimensions(orientedDims);
+        const size_t rb = imageInfo.minRowBytes();
+        auto data = SkData::MakeUninitialized(imageInfo.computeByteSize(rb));
+
+        SkPaint paint;
+        paint.setBlendMode(SkBlendMode::kSrc);
         auto canvas = SkCanvas::MakeRasterDirect(imageInfo, data->writable_data(), rb);
-        canvas->concat(originMatrix);
+        canvas->concat(SkEncodedOriginToMatrix(origin, orientedDims.width(),
+                                                       orientedDims.height()));
         canvas->drawImage(image, 0, 0, SkSamplingOptions(), &paint);
         image = SkImage::MakeRasterData(imageInfo, std::move(data), rb);
     }
-    return fImages[index] = image;
+    fImageIndex = index;
+    return fImage = image;
 }
 
 sk_sp<SkImage> SkAnimCodecPlayer::getFrame() {
-    SkASSERT(fTotalDuration > 0 || fImages.size() == 1);
+    SkASSERT(fTotalDuration > 0 || fImageIndex == 0);
 
     return fTotalDuration > 0
         ? this->getFrameAt(fCurrIndex)
-        : fImages.front();
+        : fImage;
 }
 
 bool SkAnimCodecPlayer::seek(uint32_t msec) {
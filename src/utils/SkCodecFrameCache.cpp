@@ -0,0 +1,111 @@
+/*
+ * Copyright 2022 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/utils/SkCodecFrameCache.h"
+
+#include "include/core/SkData.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPixmap.h"
+#include "include/private/SkTo.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+// Every frame is the same size, so the budget amounts to a number of keyframes.
+static int keyframe_capacity(size_t budgetBytes, size_t frameBytes) {
+    size_t count = budgetBytes / std::max<size_t>(frameBytes, 1);
+    return SkToInt(std::clamp<size_t>(count, 1, SK_MaxS32));
+}
+
+SkCodecFrameCache::SkCodecFrameCache(std::unique_ptr<SkCodec> codec, const Options& options)
+        : fCodec(std::move(codec))
+        , fInfo(fCodec->getInfo())
+        , fFrameInfos(fCodec->getFrameInfo())
+        , fFrameCount(std::max(fCodec->getFrameCount(), 1))
+        , fFrameBytes(fInfo.computeMinByteSize())
+        , fKeyframeInterval(std::max(options.fKeyframeInterval, 1))
+        , fKeyframes(keyframe_capacity(options.fBudgetBytes, fFrameBytes)) {
+    if (fFrameBytes * fFrameCount <= options.fBudgetBytes) {
+        fKeyframeInterval = 1;
+    }
+}
+
+SkCodecFrameCache::~SkCodecFrameCache() = default;
+
+sk_sp<SkImage> SkCodecFrameCache::decodeFrame(int index, const sk_sp<SkImage>& prior) {
+    SkImageInfo info = fInfo;
+    if (!fFrameInfos.empty() && fFrameInfos[index].fAlphaType != kOpaque_SkAlphaType &&
+        info.isOpaque()) {
+        info = info.makeAlphaType(kPremul_SkAlphaType);
+    }
+    const size_t rb = info.minRowBytes();
+    auto data = SkData::MakeUninitialized(info.computeByteSize(rb));
+
+    SkCodec::Options opts;
+    opts.fFrameIndex = index;
+    if (prior) {
+        // The frames only differ in alpha type, so the prior frame's pixels can be copied as is.
+        SkPixmap pm;
+        SkAssertResult(prior->peekPixels(&pm));
+        SkASSERT(pm.rowBytes() == rb && pm.computeByteSize() == data->size());
+        memcpy(data->writable_data(), pm.addr(), data->size());
+        opts.fPriorFrame = this->requiredFrame(index);
+    }
+
+    if (SkCodec::kSuccess != fCodec->getPixels(info, data->writable_data(), rb, &opts)) {
+        return nullptr;
+    }
+    fStats.fFramesDecoded++;
+    return SkImage::MakeRasterData(info, std::move(data), rb);
+}
+
+sk_sp<SkImage> SkCodecFrameCache::getFrame(int index) {
+    if (index < 0 || index >= fFrameCount) {
+        return nullptr;
+    }
+    if (index == fLastIndex) {
+        fStats.fHits++;
+        return fLastFrame;
+    }
+    if (sk_sp<SkImage>* keyframe = fKeyframes.find(index)) {
+        fStats.fHits++;
+        fLastIndex = index;
+        return fLastFrame = *keyframe;
+    }
+    fStats.fMisses++;
+
+    // Walk back through the required frames until we reach one we already have (or one that
+    // doesn't need any), then decode forward from it.
+    std::vector<int> chain;
+    sk_sp<SkImage> frame;
+    for (int i = index; i != SkCodec::kNoFrame; i = this->requiredFrame(i)) {
+        if (i == fLastIndex) {
+            frame = fLastFrame;
+            break;
+        }
+        if (sk_sp<SkImage>* keyframe = fKeyframes.find(i)) {
+            frame = *keyframe;
+            break;
+        }
+        chain.push_back(i);
+    }
+
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        frame = this->decodeFrame(*it, frame);
+        if (!frame) {
+            return nullptr;
+        }
+        if (*it % fKeyframeInterval == 0) {
+            fKeyframes.insert(*it, frame);
+        }
+    }
+    fStats.fBytesUsed = fKeyframes.count() * fFrameBytes;
+
+    fLastIndex = index;
+    return fLastFrame = std::move(frame);
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2022 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCodecFrameCache_DEFINED
+#define SkCodecFrameCache_DEFINED
+
+#include "include/codec/SkCodec.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkRefCnt.h"
+#include "src/core/SkLRUCache.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class SkImage;
+
+/**
+ *  Random access to the composited frames of an animated image (GIF, WebP, APNG, ...).
+ *
+ *  Asking SkCodec for frame N on its own re-decodes the whole chain of required frames back to
+ *  the last independent one, so scrubbing through a long animation is quadratic. This keeps a
+ *  composited copy of every Nth frame it decodes (a keyframe) within a byte budget, evicting
+ *  the least recently used ones, along with the last frame returned. getFrame() walks the
+ *  required frame chain back to the nearest frame it has and decodes forward from there, so
+ *  seeking costs at most about one keyframe interval of decodes in either direction.
+ *
+ *  Frames are returned as decoded, i.e. before applying the codec's SkEncodedOrigin.
+ */
+class SkCodecFrameCache {
+public:
+    struct Options {
+        // Upper bound on the pixel bytes of the keyframes kept.
+        size_t fBudgetBytes      = 32 * 1024 * 1024;
+        // Keep every Nth frame decoded as a keyframe. If all of the frames fit in fBudgetBytes,
+        // every frame is kept.
+        int    fKeyframeInterval = 16;
+    };
+
+    struct Stats {
+        int    fHits          = 0;  // getFrame() calls answered without decoding
+        int    fMisses        = 0;  // getFrame() calls that decoded at least one frame
+        int    fFramesDecoded = 0;  // frames decoded across all misses
+        size_t fBytesUsed     = 0;  // pixel bytes of the keyframes currently kept
+    };
+
+    SkCodecFrameCache(std::unique_ptr<SkCodec>, const Options&);
+    ~SkCodecFrameCache();
+
+    SkCodec* codec() const { return fCodec.get(); }
+
+    int frameCount() const { return fFrameCount; }
+
+    /**
+     *  Returns the composited frame at index, or nullptr if index is out of range or decoding
+     *  failed.
+     */
+    sk_sp<SkImage> getFrame(int index);
+
+    const Stats& stats() const { return fStats; }
+
+private:
+    int requiredFrame(int index) const {
+        return fFrameInfos.empty() ? SkCodec::kNoFrame : fFrameInfos[index].fRequiredFrame;
+    }
+
+    // Decodes the frame at index. If prior is not null it holds the frame at
+    // requiredFrame(index), which index is composited on top of.
+    sk_sp<SkImage> decodeFrame(int index, const sk_sp<SkImage>& prior);
+
+    std::unique_ptr<SkCodec>              fCodec;
+    SkImageInfo                           fInfo;
+    std::vector<SkCodec::FrameInfo>       fFrameInfos;
+    int                                   fFrameCount;
+    size_t                                fFrameBytes;
+    int                                   fKeyframeInterval;
+
+    SkLRUCache<int, sk_sp<SkImage>>       fKeyframes;
+    int                                   fLastIndex = SkCodec::kNoFrame;
+    sk_sp<SkImage>                        fLastFrame;
+
+    Stats                                 fStats;
+};
+
+#endif
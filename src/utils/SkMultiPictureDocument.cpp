@@ -10,13 +10,16 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDocument.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkSerialProcs.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkTypeface.h"
 #include "include/private/SkTArray.h"
+#include "include/private/SkTHash.h"
 #include "include/private/SkTo.h"
 #include "include/utils/SkNWayCanvas.h"
 #include "src/utils/SkMultiPictureDocumentPriv.h"
@@ -27,18 +30,41 @@
 #include <cstdint>
 #include <functional>
 #include <string>
+#include <vector>
 
 /*
   File format:
       BEGINNING_OF_FILE:
         kMagic
-        uint32_t version_number (==2)
+        uint32_t version_number (==3)
+        {
+          skp file
+          encoded image * (images first used by this page)
+          serialized typeface * (typefaces first used by this page)
+        } * page_count
+      PAGE_TABLE:
         uint32_t page_count
         {
           float sizeX
           float sizeY
         } * page_count
-        skp file
+        uint32_t image_count
+        uint32_t typeface_count
+        {
+          uint64_t offset
+          uint64_t size
+        } * (page_count + image_count + typeface_count)
+        uint64_t offset of PAGE_TABLE
+
+  Each page is written as soon as it ends, so only one page is ever held in memory.  Each page is
+  its own skp file, with its images and typefaces written as indices into lists shared by all the
+  pages, so any page can be read without reading the ones before it.  The page table, found from
+  the end of the file, gives the offset (from BEGINNING_OF_FILE) and size of each page, then of
+  each image and typeface in index order.
+
+  Version 2 puts page_count and the page sizes right after the version, and has no other page
+  table or shared lists.  It stores all the pages in one skp file, each page drawn as a picture
+  followed by a kEndPage annotation.
 */
 
 namespace {
@@ -47,31 +73,110 @@ static constexpr char kMagic[] = "Skia Multi-Picture Doc\n\n";
 
 static constexpr char kEndPage[] = "SkMultiPictureEndPage";
 
-const uint32_t kVersion = 2;
+const uint32_t kVersion = 3;
+const uint32_t kMinVersion = 2;
 
-static SkSize join(const SkTArray<SkSize>& sizes) {
-    SkSize joined = {0, 0};
-    for (SkSize s : sizes) {
-        joined = SkSize{std::max(joined.width(), s.width()), std::max(joined.height(), s.height())};
-    }
-    return joined;
+static constexpr size_t kHeaderSize = sizeof(kMagic) - 1 + sizeof(uint32_t);
+
+// Returns true if stream holds bytes at offset.  Sizes read from a document can't be trusted, so
+// this is checked before allocating anything on the document's say-so.
+static bool fits_in_stream(const SkStreamSeekable* stream, uint64_t offset, uint64_t bytes) {
+    const uint64_t length = stream->getLength();
+    return offset <= length && bytes <= length - offset;
 }
 
+// Serial procs that write each distinct image and typeface once, into lists shared by every page,
+// and write their index in those lists into the page itself.
+struct SharingSerialProcs {
+    const SkSerialProcs fProcs;  // The caller's procs, which encode the shared copies.
+    SkTHashMap<uint32_t, uint32_t> fImageIndices, fTypefaceIndices;  // uniqueID -> index
+    // Images and typefaces first used by the page being serialized, to be written after it.
+    std::vector<sk_sp<SkData>> fNewImages, fNewTypefaces;
+
+    explicit SharingSerialProcs(const SkSerialProcs& procs) : fProcs(procs) {}
+
+    SkSerialProcs procs() {
+        SkSerialProcs procs = fProcs;
+        procs.fImageProc    = SerializeImage;
+        procs.fImageCtx     = this;
+        procs.fTypefaceProc = SerializeTypeface;
+        procs.fTypefaceCtx  = this;
+        return procs;
+    }
+
+    static sk_sp<SkData> Index(uint32_t index) { return SkData::MakeWithCopy(&index, sizeof(index)); }
+
+    static sk_sp<SkData> SerializeImage(SkImage* image, void* ctx) {
+        auto self = static_cast<SharingSerialProcs*>(ctx);
+        if (uint32_t* index = self->fImageIndices.find(image->uniqueID())) {
+            return Index(*index);
+        }
+        sk_sp<SkData> data;
+        if (self->fProcs.fImageProc) {
+            data = self->fProcs.fImageProc(image, self->fProcs.fImageCtx);
+        }
+        if (!data) {
+            data = image->encodeToData();
+        }
+        self->fNewImages.push_back(data ? std::move(data) : SkData::MakeEmpty());
+        const uint32_t index = self->fImageIndices.count();
+        return Index(*self->fImageIndices.set(image->uniqueID(), index));
+    }
+
+    static sk_sp<SkData> SerializeTypeface(SkTypeface* typeface, void* ctx) {
+        auto self = static_cast<SharingSerialProcs*>(ctx);
+        if (uint32_t* index = self->fTypefaceIndices.find(typeface->uniqueID())) {
+            return Index(*index);
+        }
+        sk_sp<SkData> data;
+        if (self->fProcs.fTypefaceProc) {
+            data = self->fProcs.fTypefaceProc(typeface, self->fProcs.fTypefaceCtx);
+        }
+        if (!data) {
+            data = typeface->serialize();
+        }
+        self->fNewTypefaces.push_back(std::move(data));
+        const uint32_t index = self->fTypefaceIndices.count();
+        return Index(*self->fTypefaceIndices.set(typeface->uniqueID(), index));
+    }
+};
+
 struct MultiPictureDocument final : public SkDocument {
-    const SkSerialProcs fProcs;
+    struct Chunk {
+        uint64_t fOffset;
+        uint64_t fSize;
+    };
+
+    SharingSerialProcs fSharing;
     SkPictureRecorder fPictureRecorder;
     SkSize fCurrentPageSize;
-    SkTArray<sk_sp<SkPicture>> fPages;
+    bool fWroteHeader = false;
     SkTArray<SkSize> fSizes;
+    std::vector<Chunk> fPageChunks, fImageChunks, fTypefaceChunks;
     std::function<void(const SkPicture*)> fOnEndPage;
     MultiPictureDocument(SkWStream* s, const SkSerialProcs* procs,
         std::function<void(const SkPicture*)> onEndPage)
         : SkDocument(s)
-        , fProcs(procs ? *procs : SkSerialProcs())
+        , fSharing(procs ? *procs : SkSerialProcs())
         , fOnEndPage(onEndPage)
     {}
     ~MultiPictureDocument() override { this->close(); }
 
+    void writeHeader(SkWStream* wStream) {
+        if (!fWroteHeader) {
+            SkASSERT(wStream->bytesWritten() == 0);
+            wStream->writeText(kMagic);
+            wStream->write32(kVersion);
+            fWroteHeader = true;
+        }
+    }
+
+    // Writes data, noting where it went in chunks.
+    static void WriteChunk(SkWStream* wStream, const SkData& data, std::vector<Chunk>* chunks) {
+        chunks->push_back({wStream->bytesWritten(), data.size()});
+        wStream->write(data.data(), data.size());
+    }
+
     SkCanvas* onBeginPage(SkScalar w, SkScalar h) override {
         fCurrentPageSize.set(w, h);
         return fPictureRecorder.beginRecording(w, h);
@@ -79,36 +184,46 @@ struct MultiPictureDocument final : public SkDocument {
     void onEndPage() override {
         fSizes.push_back(fCurrentPageSize);
         sk_sp<SkPicture> lastPage = fPictureRecorder.finishRecordingAsPicture();
-        fPages.push_back(lastPage);
         if (fOnEndPage) {
             fOnEndPage(lastPage.get());
         }
+
+        SkWStream* wStream = this->getStream();
+        this->writeHeader(wStream);
+        const SkSerialProcs procs = fSharing.procs();
+        const uint64_t offset = wStream->bytesWritten();
+        lastPage->serialize(wStream, &procs);
+        fPageChunks.push_back({offset, wStream->bytesWritten() - offset});
+        for (const sk_sp<SkData>& image : fSharing.fNewImages) {
+            WriteChunk(wStream, *image, &fImageChunks);
+        }
+        for (const sk_sp<SkData>& typeface : fSharing.fNewTypefaces) {
+            WriteChunk(wStream, *typeface, &fTypefaceChunks);
+        }
+        fSharing.fNewImages.clear();
+        fSharing.fNewTypefaces.clear();
     }
     void onClose(SkWStream* wStream) override {
         SkASSERT(wStream);
-        SkASSERT(wStream->bytesWritten() == 0);
-        wStream->writeText(kMagic);
-        wStream->write32(kVersion);
-        wStream->write32(SkToU32(fPages.count()));
+        this->writeHeader(wStream);
+        const uint64_t tableOffset = wStream->bytesWritten();
+        wStream->write32(SkToU32(fSizes.count()));
         for (SkSize s : fSizes) {
             wStream->write(&s, sizeof(s));
         }
-        SkSize bigsize = join(fSizes);
-        SkCanvas* c = fPictureRecorder.beginRecording(SkRect::MakeSize(bigsize));
-        for (const sk_sp<SkPicture>& page : fPages) {
-            c->drawPicture(page);
-            // Annotations must include some data.
-            c->drawAnnotation(SkRect::MakeEmpty(), kEndPage, SkData::MakeWithCString("X"));
+        wStream->write32(SkToU32(fImageChunks.size()));
+        wStream->write32(SkToU32(fTypefaceChunks.size()));
+        for (const std::vector<Chunk>* chunks : {&fPageChunks, &fImageChunks, &fTypefaceChunks}) {
+            wStream->write(chunks->data(), chunks->size() * sizeof(Chunk));
         }
-        sk_sp<SkPicture> p = fPictureRecorder.finishRecordingAsPicture();
-        p->serialize(wStream, &fProcs);
-        fPages.reset();
-        fSizes.reset();
-        return;
+        wStream->write(&tableOffset, sizeof(tableOffset));
+        this->onAbort();
     }
     void onAbort() override {
-        fPages.reset();
         fSizes.reset();
+        fPageChunks.clear();
+        fImageChunks.clear();
+        fTypefaceChunks.clear();
     }
 };
 }  // namespace
@@ -132,9 +247,21 @@ int SkMultiPictureDocumentReadPageCount(SkStreamSeekable* stream) {
         return 0;
     }
     uint32_t versionNumber;
-    if (!stream->readU32(&versionNumber) || versionNumber != kVersion) {
+    if (!stream->readU32(&versionNumber) || versionNumber < kMinVersion ||
+                                            versionNumber > kVersion) {
         return 0;
     }
+    if (versionNumber > 2) {
+        // The page count starts the page table, whose offset ends the file.
+        uint64_t tableOffset;
+        if (!stream->hasLength() || stream->getLength() < kHeaderSize + sizeof(tableOffset) ||
+            !stream->seek(stream->getLength() - sizeof(tableOffset)) ||
+            stream->read(&tableOffset, sizeof(tableOffset)) != sizeof(tableOffset) ||
+            tableOffset < kHeaderSize || tableOffset > stream->getLength() - sizeof(tableOffset) ||
+            !stream->seek(tableOffset)) {
+            return 0;
+        }
+    }
     uint32_t pageCount;
     if (!stream->readU32(&pageCount) || pageCount > INT_MAX) {
         return 0;
@@ -194,10 +321,35 @@ struct PagerCanvas : public SkNWayCanvas {
 };
 }  // namespace
 
+static bool read_version(SkStreamSeekable* stream, uint32_t* version) {
+    return SkMultiPictureDocumentReadPageCount(stream) > 0 &&
+           stream->seek(sizeof(kMagic) - 1) &&
+           stream->readU32(version);
+}
+
 bool SkMultiPictureDocumentRead(SkStreamSeekable* stream,
                                 SkDocumentPage* dstArray,
                                 int dstArrayCount,
                                 const SkDeserialProcs* procs) {
+    uint32_t version;
+    if (!read_version(stream, &version)) {
+        return false;
+    }
+    if (version > 2) {
+        SkMultiPictureDocumentReader reader(stream, procs);
+        if (!reader.readPageTable() || reader.pageCount() != dstArrayCount) {
+            return false;
+        }
+        for (int i = 0; i < dstArrayCount; ++i) {
+            dstArray[i].fSize    = reader.pageSize(i);
+            dstArray[i].fPicture = reader.readPage(i);
+            if (!dstArray[i].fPicture) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     if (!SkMultiPictureDocumentReadPageSizes(stream, dstArray, dstArrayCount)) {
         return false;
     }
@@ -222,3 +374,178 @@ bool SkMultiPictureDocumentRead(SkStreamSeekable* stream,
     }
     return true;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+SkMultiPictureDocumentReader::SkMultiPictureDocumentReader(SkStreamSeekable* stream,
+                                                           const SkDeserialProcs* procs)
+        : fStream(stream)
+        , fProcs(procs ? *procs : SkDeserialProcs()) {}
+
+SkMultiPictureDocumentReader::~SkMultiPictureDocumentReader() = default;
+
+std::unique_ptr<SkMultiPictureDocumentReader> SkMultiPictureDocumentReader::Make(
+        std::unique_ptr<SkStreamSeekable> stream, const SkDeserialProcs* procs) {
+    uint32_t version;
+    if (!stream || !read_version(stream.get(), &version)) {
+        return nullptr;
+    }
+    std::unique_ptr<SkMultiPictureDocumentReader> reader(
+            new SkMultiPictureDocumentReader(stream.get(), procs));
+    reader->fOwnedStream = std::move(stream);
+
+    if (version > 2) {
+        return reader->readPageTable() ? std::move(reader) : nullptr;
+    }
+
+    // Older documents can only be split into pages by decoding the whole thing.
+    std::vector<SkDocumentPage> pages(SkMultiPictureDocumentReadPageCount(reader->fStream));
+    if (!SkMultiPictureDocumentRead(reader->fStream, pages.data(), SkToInt(pages.size()), procs)) {
+        return nullptr;
+    }
+    for (const SkDocumentPage& page : pages) {
+        reader->fSizes.push_back(page.fSize);
+        reader->fPages.push_back(page.fPicture);
+    }
+    return reader;
+}
+
+bool SkMultiPictureDocumentReader::readPageTable() {
+    const int pageCount = SkMultiPictureDocumentReadPageCount(fStream);
+    if (pageCount < 1) {
+        return false;
+    }
+    // Pages, images and typefaces all come before the page table.
+    const uint64_t tableOffset = fStream->getPosition() - sizeof(uint32_t);
+
+    const size_t sizeBytes = pageCount * sizeof(SkSize);
+    if (!fits_in_stream(fStream, fStream->getPosition(), sizeBytes)) {
+        return false;
+    }
+    fSizes.resize(pageCount);
+    if (fStream->read(fSizes.data(), sizeBytes) != sizeBytes) {
+        return false;
+    }
+
+    uint32_t imageCount, typefaceCount;
+    if (!fStream->readU32(&imageCount) || !fStream->readU32(&typefaceCount) ||
+        imageCount > INT_MAX || typefaceCount > INT_MAX) {
+        return false;
+    }
+    const uint64_t bytes = ((uint64_t)pageCount + imageCount + typefaceCount) * sizeof(Chunk);
+    if (!fits_in_stream(fStream, fStream->getPosition(), bytes)) {
+        return false;
+    }
+    fImages   .resize(imageCount);
+    fTypefaces.resize(typefaceCount);
+    fChunks   .resize(bytes / sizeof(Chunk));
+    if (fStream->read(fChunks.data(), bytes) != bytes) {
+        return false;
+    }
+    return std::all_of(fChunks.begin(), fChunks.end(), [tableOffset](const Chunk& chunk) {
+        return chunk.fOffset >= kHeaderSize && chunk.fOffset <= tableOffset &&
+               chunk.fSize <= tableOffset - chunk.fOffset;
+    });
+}
+
+sk_sp<SkData> SkMultiPictureDocumentReader::readChunk(size_t i) {
+    SkASSERT(i < fChunks.size());
+    const uint64_t offset = fChunks[i].fOffset,
+                   size   = fChunks[i].fSize;
+    if (!SkTFitsIn<size_t>(offset + size) || !fits_in_stream(fStream, offset, size)) {
+        return nullptr;
+    }
+
+    // Memory-backed streams, e.g. mapped files, can be decoded in place.  Deserializing doesn't
+    // hold on to the data, so this is safe for as long as we hold the stream.
+    if (auto base = static_cast<const char*>(fStream->getMemoryBase())) {
+        return SkData::MakeWithoutCopy(base + offset, size);
+    }
+
+    if (!fStream->seek(offset)) {
+        return nullptr;
+    }
+    sk_sp<SkData> data = SkData::MakeUninitialized(size);
+    if (fStream->read(data->writable_data(), size) != size) {
+        return nullptr;
+    }
+    return data;
+}
+
+sk_sp<SkPicture> SkMultiPictureDocumentReader::readPage(int i) {
+    if (i < 0 || i >= this->pageCount()) {
+        return nullptr;
+    }
+    if (!fPages.empty()) {
+        return fPages[i];
+    }
+
+    sk_sp<SkData> data = this->readChunk(i);
+    if (!data) {
+        return nullptr;
+    }
+    SkDeserialProcs procs = fProcs;
+    procs.fImageProc    = DeserializeImage;
+    procs.fImageCtx     = this;
+    procs.fTypefaceProc = DeserializeTypeface;
+    procs.fTypefaceCtx  = this;
+    return SkPicture::MakeFromData(data.get(), &procs);
+}
+
+sk_sp<SkImage> SkMultiPictureDocumentReader::DeserializeImage(const void* data, size_t length,
+                                                               void* ctx) {
+    auto self = static_cast<SkMultiPictureDocumentReader*>(ctx);
+    uint32_t index;
+    if (length != sizeof(index)) {
+        return nullptr;
+    }
+    memcpy(&index, data, sizeof(index));
+    if (index >= self->fImages.size()) {
+        return nullptr;
+    }
+
+    sk_sp<SkImage>& image = self->fImages[index];
+    if (!image) {
+        sk_sp<SkData> encoded = self->readChunk(self->pageCount() + index);
+        if (encoded && self->fProcs.fImageProc) {
+            image = self->fProcs.fImageProc(encoded->data(), encoded->size(),
+                                            self->fProcs.fImageCtx);
+        }
+        if (encoded && !image) {
+            image = SkImage::MakeFromEncoded(SkData::MakeWithCopy(encoded->data(),
+                                                                  encoded->size()));
+        }
+    }
+    return image;
+}
+
+sk_sp<SkTypeface> SkMultiPictureDocumentReader::DeserializeTypeface(const void* data,
+                                                                     size_t length, void* ctx) {
+    // A picture's typefaces are read straight from its stream, so we get that stream here.
+    auto self = static_cast<SkMultiPictureDocumentReader*>(ctx);
+    SkStream* stream;
+    uint32_t index;
+    if (length != sizeof(stream)) {
+        return nullptr;
+    }
+    memcpy(&stream, data, sizeof(stream));
+    if (!stream->readU32(&index) || index >= self->fTypefaces.size()) {
+        return nullptr;
+    }
+
+    sk_sp<SkTypeface>& typeface = self->fTypefaces[index];
+    if (!typeface) {
+        sk_sp<SkData> serialized =
+                self->readChunk(self->pageCount() + self->fImages.size() + index);
+        if (serialized) {
+            SkMemoryStream typefaceStream(serialized);
+            if (self->fProcs.fTypefaceProc) {
+                SkStream* s = &typefaceStream;
+                typeface = self->fProcs.fTypefaceProc(&s, sizeof(s), self->fProcs.fTypefaceCtx);
+            } else {
+                typeface = SkTypeface::MakeDeserialize(&typefaceStream);
+            }
+        }
+    }
+    return typeface;
+}
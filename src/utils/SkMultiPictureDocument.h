@@ -10,16 +10,20 @@
 
 #include "include/core/SkPicture.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSerialProcs.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkTypes.h"
+#include "include/private/SkTo.h"
 
 #include <functional>
+#include <memory>
+#include <vector>
 
 class SkDocument;
+class SkImage;
 class SkStreamSeekable;
+class SkTypeface;
 class SkWStream;
-struct SkDeserialProcs;
-struct SkSerialProcs;
 
 /**
  *  Writes into a file format that is similar to SkPicture::serialize()
@@ -48,4 +52,53 @@ SK_SPI bool SkMultiPictureDocumentRead(SkStreamSeekable* src,
                                        int dstArrayCount,
                                        const SkDeserialProcs* = nullptr);
 
+/**
+ *  Reads pages of an SkMultiPictureDocument one at a time, on demand.  Opening a document only
+ *  reads its page table, so any page can be decoded without decoding the ones before it.  Images
+ *  and typefaces shared between pages are decoded once and reused.  If the stream has a memory
+ *  base (e.g. a file mapped by SkStream::MakeFromFile()), pages are decoded in place.
+ *
+ *  Documents written before the page table existed are decoded in full when opened.
+ *
+ *  Not thread safe.
+ */
+class SK_SPI SkMultiPictureDocumentReader {
+public:
+    static std::unique_ptr<SkMultiPictureDocumentReader> Make(std::unique_ptr<SkStreamSeekable>,
+                                                              const SkDeserialProcs* = nullptr);
+    ~SkMultiPictureDocumentReader();
+
+    int pageCount() const { return SkToInt(fSizes.size()); }
+    SkSize pageSize(int i) const { return fSizes[i]; }
+
+    /** Decodes page i, or returns null if it's out of range or can't be decoded. */
+    sk_sp<SkPicture> readPage(int i);
+
+private:
+    friend bool SkMultiPictureDocumentRead(SkStreamSeekable*, SkDocumentPage*, int,
+                                           const SkDeserialProcs*);
+
+    // Where a page, image or typeface is in the stream.
+    struct Chunk {
+        uint64_t fOffset;
+        uint64_t fSize;
+    };
+
+    SkMultiPictureDocumentReader(SkStreamSeekable*, const SkDeserialProcs*);
+    bool readPageTable();
+    sk_sp<SkData> readChunk(size_t i);
+
+    static sk_sp<SkImage> DeserializeImage(const void* data, size_t length, void* ctx);
+    static sk_sp<SkTypeface> DeserializeTypeface(const void* data, size_t length, void* ctx);
+
+    std::unique_ptr<SkStreamSeekable> fOwnedStream;
+    SkStreamSeekable*                 fStream;
+    const SkDeserialProcs             fProcs;      // The caller's procs.
+    std::vector<SkSize>               fSizes;
+    std::vector<Chunk>                fChunks;     // Pages, then images, then typefaces.
+    std::vector<sk_sp<SkImage>>       fImages;     // Decoded as pages use them.
+    std::vector<sk_sp<SkTypeface>>    fTypefaces;  // Decoded as pages use them.
+    std::vector<sk_sp<SkPicture>>     fPages;      // Only for documents without a page table.
+};
+
 #endif  // SkMultiPictureDocument_DEFINED
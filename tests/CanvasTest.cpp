@@ -38,6 +38,7 @@
 #include "include/utils/SkPaintFilterCanvas.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkImageFilter_Base.h"
+#include "src/core/SkLayerPixelPool.h"
 #include "src/core/SkRecord.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/utils/SkCanvasStack.h"
@@ -765,3 +766,91 @@ DEF_TEST(canvas_savelayer_destructor, reporter) {
     do_test(2, 0);
     check_pixels(SK_ColorRED);
 }
+
+DEF_TEST(canvas_savelayer_recycles_pixels, reporter) {
+    auto surf = SkSurface::MakeRasterN32Premul(8, 8);
+    auto canvas = surf->getCanvas();
+
+    SkBitmap bm;
+    bm.allocN32Pixels(8, 8);
+    auto check_pixels = [&](SkColor expected, int frame) {
+        REPORTER_ASSERT(reporter, surf->readPixels(bm, 0, 0));
+        const SkPMColor pmc = SkPreMultiplyColor(expected);
+        for (int y = 0; y < 8; ++y) {
+            for (int x = 0; x < 8; ++x) {
+                if (*bm.getAddr32(x, y) != pmc) {
+                    ERRORF(reporter, "frame %d: (%d,%d) is %08x, not %08x",
+                           frame, x, y, *bm.getAddr32(x, y), pmc);
+                    return;
+                }
+            }
+        }
+    };
+
+    // Each frame's layers reuse pixels that the last frame filled with red.  They must start out
+    // transparent again, or the red would show through.
+    for (int frame = 0; frame < 4; ++frame) {
+        canvas->clear(SK_ColorWHITE);
+        for (int i = 0; i < 3; ++i) {
+            canvas->saveLayer(nullptr, nullptr);
+        }
+        canvas->clear(SK_ColorRED);
+        canvas->restoreToCount(1);
+        check_pixels(SK_ColorRED, frame);
+
+        canvas->clear(SK_ColorWHITE);
+        for (int i = 0; i < 3; ++i) {
+            canvas->saveLayer(nullptr, nullptr);
+        }
+        canvas->restoreToCount(1);
+        check_pixels(SK_ColorWHITE, frame);
+    }
+}
+
+DEF_TEST(SkLayerPixelPool, reporter) {
+    auto pool = sk_make_sp<SkLayerPixelPool>(/*budget=*/3 * 64 * 64 * 4);
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(64, 64);
+
+    // Pixels go back to the pool when their last ref goes away, even if that's after the pool's.
+    SkBitmap a, b;
+    REPORTER_ASSERT(reporter, pool->allocPixels(info, &a));
+    REPORTER_ASSERT(reporter, pool->allocPixels(info, &b));
+    REPORTER_ASSERT(reporter, a.getPixels() != b.getPixels());
+    a.eraseColor(SK_ColorRED);
+    const void* addr = a.getPixels();
+    a.reset();
+    REPORTER_ASSERT(reporter, pool->retainedBytes() == info.computeMinByteSize());
+
+    // Reused pixels are cleared, and a smaller request can use a bigger block.
+    REPORTER_ASSERT(reporter, pool->allocPixels(info.makeWH(64, 40), &a));
+    REPORTER_ASSERT(reporter, a.getPixels() == addr);
+    REPORTER_ASSERT(reporter, pool->retainedBytes() == 0);
+    for (int y = 0; y < 40; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            REPORTER_ASSERT(reporter, *a.getAddr32(x, y) == 0);
+        }
+    }
+
+    // ... but not one so small it would waste most of the block.
+    a.reset();
+    SkBitmap tiny;
+    REPORTER_ASSERT(reporter, pool->allocPixels(info.makeWH(8, 8), &tiny));
+    REPORTER_ASSERT(reporter, tiny.getPixels() != addr);
+    REPORTER_ASSERT(reporter, pool->retainedBytes() == info.computeMinByteSize());
+
+    // The oldest pixels are freed once the pool is over budget.
+    SkBitmap more[4];
+    for (SkBitmap& bitmap : more) {
+        REPORTER_ASSERT(reporter, pool->allocPixels(info, &bitmap));
+    }
+    for (SkBitmap& bitmap : more) {
+        bitmap.reset();
+    }
+    REPORTER_ASSERT(reporter, pool->retainedBytes() == 3 * info.computeMinByteSize());
+
+    pool.reset();
+    b.eraseColor(SK_ColorBLUE);
+    REPORTER_ASSERT(reporter, *b.getAddr32(0, 0) == SkPreMultiplyColor(SK_ColorBLUE));
+    b.reset();
+    tiny.reset();
+}
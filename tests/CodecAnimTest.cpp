@@ -12,12 +12,15 @@
 #include "include/core/SkData.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTypes.h"
 #include "include/utils/SkAnimCodecPlayer.h"
+#include "include/utils/SkRandom.h"
+#include "src/utils/SkCodecFrameCache.h"
 #include "tests/CodecPriv.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
@@ -609,3 +612,77 @@ DEF_TEST(AnimCodecPlayer, r) {
                         "Mismatched size for frame at 500 ms of %s", test.fFile);
     }
 }
+
+DEF_TEST(CodecFrameCache, r) {
+    // Only check the animated formats this build can decode.
+    std::vector<const char*> files;
+#ifdef SK_HAS_WUFFS_LIBRARY
+    files.insert(files.end(), { "images/required.gif",
+                                "images/alphabetAnim.gif",
+                                "images/randPixelsAnim.gif",
+                                "images/colorTables.gif" });
+#endif
+#ifdef SK_CODEC_DECODES_WEBP
+    files.insert(files.end(), { "images/required.webp",
+                                "images/stoplight.webp",
+                                "images/blendBG.webp" });
+#endif
+    for (const char* file : files) {
+        sk_sp<SkData> data(GetResourceAsData(file));
+        if (!data) {
+            continue;
+        }
+        // The reference codec decodes every frame from scratch, including its required frames.
+        std::unique_ptr<SkCodec> reference(SkCodec::MakeFromData(data));
+        if (!reference) {
+            ERRORF(r, "Could not create codec for %s", file);
+            continue;
+        }
+        const int frameCount = reference->getFrameCount();
+
+        // Keep at most two keyframes, every other frame, so seeking evicts them.
+        SkCodecFrameCache::Options options;
+        options.fBudgetBytes = 2 * reference->getInfo().computeMinByteSize();
+        options.fKeyframeInterval = 2;
+        SkCodecFrameCache cache(SkCodec::MakeFromData(data), options);
+        REPORTER_ASSERT(r, cache.frameCount() == frameCount);
+
+        std::vector<int> order;
+        for (int i = 0; i < frameCount; ++i) {
+            order.push_back(i);
+        }
+        for (int i = frameCount - 1; i >= 0; --i) {
+            order.push_back(i);
+        }
+        SkRandom rand;
+        for (int i = 0; i < 2 * frameCount; ++i) {
+            order.push_back(rand.nextULessThan(frameCount));
+        }
+
+        for (int index : order) {
+            sk_sp<SkImage> frame = cache.getFrame(index);
+            if (!frame) {
+                ERRORF(r, "Failed to get frame %i of %s", index, file);
+                continue;
+            }
+            SkBitmap expected;
+            expected.allocPixels(frame->imageInfo());
+            SkCodec::Options opts;
+            opts.fFrameIndex = index;
+            REPORTER_ASSERT(r, SkCodec::kSuccess == reference->getPixels(expected.pixmap(), &opts));
+
+            SkPixmap actual;
+            REPORTER_ASSERT(r, frame->peekPixels(&actual));
+            REPORTER_ASSERT(r, ToolUtils::equal_pixels(actual, expected.pixmap()),
+                            "Mismatched frame %i of %s", index, file);
+        }
+
+        // Asking for the same frame again doesn't decode anything.
+        const auto before = cache.stats();
+        REPORTER_ASSERT(r, cache.getFrame(order.back()));
+        REPORTER_ASSERT(r, cache.stats().fHits == before.fHits + 1);
+        REPORTER_ASSERT(r, cache.stats().fFramesDecoded == before.fFramesDecoded);
+        REPORTER_ASSERT(r, cache.stats().fBytesUsed <= options.fBudgetBytes);
+        REPORTER_ASSERT(r, cache.getFrame(frameCount) == nullptr);
+    }
+}
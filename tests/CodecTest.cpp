@@ -19,6 +19,7 @@
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkData.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageEncoder.h"
 #include "include/core/SkImageGenerator.h"
@@ -52,7 +53,9 @@
 #include <png.h>
 
 #include <setjmp.h>
+#include <atomic>
 #include <cstring>
+#include <functional>
 #include <initializer_list>
 #include <memory>
 #include <utility>
@@ -1921,3 +1924,106 @@ DEF_TEST(Codec_noConversion, r) {
         REPORTER_ASSERT(r, bm.getColor(0, 0) == rec.color);
     }
 }
+
+DEF_TEST(Codec_jpeg_parallel, r) {
+    SkBitmap mandrill;
+    if (!GetResourceAsBitmap("images/mandrill_512.png", &mandrill)) {
+        return;
+    }
+    // Counts the tasks the codec hands out, so the test fails if it quietly decodes serially.
+    struct CountingExecutor final : public SkExecutor {
+        void add(std::function<void(void)> work) override {
+            fAdded++;
+            fPool->add(std::move(work));
+        }
+        void borrow() override { fPool->borrow(); }
+
+        std::unique_ptr<SkExecutor> fPool = SkExecutor::MakeFIFOThreadPool(4);
+        std::atomic<int>            fAdded{0};
+    };
+    CountingExecutor countingExecutor;
+    SkExecutor* executor = &countingExecutor;
+
+    auto check = [&](const char* name, sk_sp<SkData> data, const SkImageInfo& info) {
+        std::unique_ptr<SkCodec> serialCodec = SkCodec::MakeFromData(data),
+                                 parallelCodec = SkCodec::MakeFromData(data);
+        REPORTER_ASSERT(r, serialCodec && parallelCodec);
+        if (!serialCodec || !parallelCodec) {
+            return;
+        }
+
+        // Fill the bitmaps differently, so rows that the parallel decode misses will not match.
+        SkBitmap serial, parallel;
+        serial.allocPixels(info);
+        parallel.allocPixels(info);
+        serial.eraseColor(SK_ColorBLACK);
+        parallel.eraseColor(SK_ColorWHITE);
+
+        SkCodec::Options options;
+        SkCodec::Result serialResult = serialCodec->getPixels(serial.pixmap(), &options);
+        options.fExecutor = executor;
+        SkCodec::Result parallelResult = parallelCodec->getPixels(parallel.pixmap(), &options);
+        REPORTER_ASSERT(r, serialResult == parallelResult, "%s", name);
+        if (SkCodec::kSuccess == serialResult) {
+            REPORTER_ASSERT(r, 0 == memcmp(serial.getPixels(), parallel.getPixels(),
+                                           serial.computeByteSize()),
+                            "%s %dx%d color type %d", name, info.width(), info.height(),
+                            info.colorType());
+        }
+    };
+
+    const struct { SkJpegEncoder::Downsample downsample; const char* name; } kDownsamples[] = {
+        {SkJpegEncoder::Downsample::k420, "420"},
+        {SkJpegEncoder::Downsample::k422, "422"},
+        {SkJpegEncoder::Downsample::k444, "444"},
+    };
+    for (auto [downsample, name] : kDownsamples) {
+        for (int restartRows : {1, 3}) {
+            SkJpegEncoder::Options options;
+            options.fDownsample = downsample;
+            options.fRestartRows = restartRows;
+            SkDynamicMemoryWStream stream;
+            REPORTER_ASSERT(r, SkJpegEncoder::Encode(&stream, mandrill.pixmap(), options));
+            sk_sp<SkData> data = stream.detachAsData();
+
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+            const int addedBefore = countingExecutor.fAdded;
+            for (float scale : {1.0f, 0.5f, 0.375f, 0.125f}) {
+                SkImageInfo info = codec->getInfo().makeDimensions(
+                        codec->getScaledDimensions(scale));
+                for (SkColorType ct : {kRGBA_8888_SkColorType, kBGRA_8888_SkColorType,
+                                       kRGB_565_SkColorType, kRGBA_F16_SkColorType}) {
+                    check(name, data, info.makeColorType(ct));
+                }
+            }
+            REPORTER_ASSERT(r, countingExecutor.fAdded > addedBefore,
+                            "%s with restarts every %d rows never decoded in parallel",
+                            name, restartRows);
+
+            // A truncated file should fail the same way.
+            check(name, SkData::MakeSubset(data.get(), 0, data->size() / 2), codec->getInfo());
+        }
+    }
+
+    {
+        SkBitmap gray;
+        gray.allocPixels(mandrill.info().makeColorType(kGray_8_SkColorType));
+        SkAssertResult(mandrill.readPixels(gray.pixmap()));
+        SkJpegEncoder::Options options;
+        options.fRestartRows = 1;
+        SkDynamicMemoryWStream stream;
+        REPORTER_ASSERT(r, SkJpegEncoder::Encode(&stream, gray.pixmap(), options));
+        sk_sp<SkData> data = stream.detachAsData();
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+        check("gray", data, codec->getInfo());
+        check("gray", data, codec->getInfo().makeDimensions(codec->getScaledDimensions(0.25f)));
+    }
+
+    // An encoded file with a restart marker after each MCU row and a profile to convert from.
+    if (sk_sp<SkData> data = GetResourceAsData("images/icc-v2-gbr.jpg")) {
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+        SkImageInfo info = codec->getInfo().makeColorSpace(SkColorSpace::MakeSRGB());
+        check("icc-v2-gbr", data, info);
+        check("icc-v2-gbr", data, info.makeColorType(kRGBA_F16_SkColorType));
+    }
+}
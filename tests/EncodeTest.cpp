@@ -13,6 +13,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorPriv.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageEncoder.h"
 #include "include/core/SkStream.h"
@@ -330,6 +331,58 @@ DEF_TEST(Encode_PngOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 0));
 }
 
+DEF_TEST(Encode_PngParallel, r) {
+    SkBitmap mandrill;
+    if (!GetResourceAsBitmap("images/mandrill_512.png", &mandrill)) {
+        return;
+    }
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    // A few color types, each with translucent pixels where it can hold them.
+    for (SkColorType ct : {kN32_SkColorType, kRGB_565_SkColorType, kRGBA_F16_SkColorType}) {
+        SkBitmap src;
+        src.allocPixels(SkImageInfo::Make(mandrill.width(), mandrill.height(), ct,
+                                          ct == kRGB_565_SkColorType ? kOpaque_SkAlphaType
+                                                                     : kUnpremul_SkAlphaType));
+        src.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(src);
+        SkPaint paint;
+        paint.setAlphaf(0.75f);
+        canvas.drawImage(mandrill.asImage(), 0, 0, SkSamplingOptions(), &paint);
+
+        const struct { SkPngEncoder::FilterFlag filters; int zlibLevel; } kOptions[] = {
+            {SkPngEncoder::FilterFlag::kAll,  6},
+            {SkPngEncoder::FilterFlag::kAll,  0},
+            {SkPngEncoder::FilterFlag::kSub,  1},
+            {SkPngEncoder::FilterFlag::kNone, 9},
+        };
+        for (auto [filters, zlibLevel] : kOptions) {
+            SkPngEncoder::Options options;
+            options.fFilterFlags = filters;
+            options.fZLibLevel = zlibLevel;
+            SkDynamicMemoryWStream serial, parallel;
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&serial, src.pixmap(), options));
+            options.fExecutor = executor.get();
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&parallel, src.pixmap(), options));
+
+            // Decode both to the source's format; they must match exactly.
+            SkBitmap a, b;
+            a.allocPixels(src.info());
+            b.allocPixels(src.info());
+            auto codecA = SkCodec::MakeFromData(serial.detachAsData()),
+                 codecB = SkCodec::MakeFromData(parallel.detachAsData());
+            REPORTER_ASSERT(r, codecA && codecB);
+            if (!codecA || !codecB) {
+                continue;
+            }
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codecA->getPixels(a.pixmap()));
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codecB->getPixels(b.pixmap()));
+            REPORTER_ASSERT(r, 0 == memcmp(a.getPixels(), b.getPixels(), a.computeByteSize()),
+                            "%d filters, zlib level %d", (int)filters, zlibLevel);
+        }
+    }
+}
+
 #ifndef SK_BUILD_FOR_GOOGLE3
 DEF_TEST(Encode_WebpQuality, r) {
     SkBitmap bm;
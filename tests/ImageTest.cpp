@@ -5,12 +5,15 @@
  * found in the LICENSE file.
  */
 
+#include <algorithm>
+#include <cstdlib>
 #include <functional>
 #include <initializer_list>
 #include <vector>
 
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkColorPriv.h"
 #include "include/core/SkData.h"
 #include "include/core/SkImageEncoder.h"
 #include "include/core/SkImageGenerator.h"
@@ -18,6 +21,7 @@
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkRRect.h"
 #include "include/core/SkSerialProcs.h"
+#include "include/core/SkShader.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkSurface.h"
 #include "include/gpu/GrContextThreadSafeProxy.h"
@@ -25,6 +29,7 @@
 #include "src/core/SkAutoPixmapStorage.h"
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkImagePriv.h"
+#include "src/core/SkMipmap.h"
 #include "src/core/SkOpts.h"
 #include "src/gpu/ganesh/GrDirectContextPriv.h"
 #include "src/gpu/ganesh/GrGpu.h"
@@ -381,6 +386,130 @@ DEF_GANESH_TEST_FOR_RENDERING_CONTEXTS(SkImage_Gpu2Cpu,
     }
 }
 
+/*
+ *  Drawing a lazy JPEG minified into a raster surface should decode it at a reduced size (via DCT
+ *  scaling) and cache that, rather than the full resolution bitmap.
+ */
+DEF_TEST(SkImage_LazyScaledDecode, reporter) {
+    SkBitmap bm;
+    bm.allocN32Pixels(256, 256, /*isOpaque=*/true);
+    bm.eraseColor(SK_ColorBLUE);
+    sk_sp<SkData> encoded = SkEncodeBitmap(bm, SkEncodedImageFormat::kJPEG, 100);
+    if (!encoded) {
+        return;
+    }
+    sk_sp<SkImage> image = SkImage::MakeFromEncoded(std::move(encoded));
+    REPORTER_ASSERT(reporter, image && image->isLazyGenerated());
+
+    auto surface = SkSurface::MakeRasterN32Premul(64, 64);
+    surface->getCanvas()->drawImageRect(image, SkRect::MakeWH(64, 64), SkSamplingOptions());
+
+    SkBitmap cachedBitmap;
+    REPORTER_ASSERT(reporter, !SkBitmapCache::Find(SkBitmapCacheDesc::Make(image.get()),
+                                                   &cachedBitmap));
+    if (SkBitmapCache::Find(SkBitmapCacheDesc::MakeScaled(image.get(), {64, 64}),
+                            &cachedBitmap)) {
+        REPORTER_ASSERT(reporter, cachedBitmap.isImmutable());
+        REPORTER_ASSERT(reporter, cachedBitmap.dimensions() == SkISize::Make(64, 64));
+    } else {
+        // unexpected, but not really a bug, since the cache is global and this test may be
+        // run w/ other threads competing for its budget.
+        SkDebugf("SkImage_LazyScaledDecode : cachedBitmap was already purged\n");
+    }
+
+    SkBitmap result;
+    REPORTER_ASSERT(reporter, surface->makeImageSnapshot()->asLegacyBitmap(&result));
+    SkColor c = result.getColor(32, 32);
+    REPORTER_ASSERT(reporter, SkColorGetR(c) <= 2 && SkColorGetG(c) <= 2 && SkColorGetB(c) >= 253);
+}
+
+/*
+ *  A reduced size decode has to stand in for the full size image: a src rect has to be remapped
+ *  onto it, and for kNearest mipmapping it replaces the chosen level of the mip chain. Compare
+ *  both against the same draws of a full size decode.
+ */
+DEF_TEST(SkImage_LazyScaledDecodeMatchesFullSize, reporter) {
+    // A smooth pattern, so decoding at 1/4 scale stays close to filtering the full size image,
+    // that differs everywhere, so sampling the wrong part of the image doesn't.
+    SkBitmap bm;
+    bm.allocN32Pixels(256, 256, /*isOpaque=*/true);
+    for (int y = 0; y < 256; ++y) {
+        for (int x = 0; x < 256; ++x) {
+            *bm.getAddr32(x, y) = SkPackARGB32(0xFF, x, y, 255 - (x + y) / 2);
+        }
+    }
+    sk_sp<SkData> encoded = SkEncodeBitmap(bm, SkEncodedImageFormat::kJPEG, 100);
+    if (!encoded) {
+        return;
+    }
+    sk_sp<SkImage> full = SkImage::MakeFromEncoded(encoded)->makeRasterImage();
+    REPORTER_ASSERT(reporter, full && !full->isLazyGenerated());
+
+    auto render = [](const std::function<void(SkCanvas*)>& draw) {
+        SkBitmap result;
+        result.allocN32Pixels(64, 64);
+        result.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(result);
+        draw(&canvas);
+        return result;
+    };
+    auto check = [&](const char* name, const SkBitmap& expected, const SkBitmap& actual) {
+        constexpr int kTolerance = 6;
+        int maxDiff = 0;
+        for (int y = 0; y < expected.height(); ++y) {
+            for (int x = 0; x < expected.width(); ++x) {
+                SkColor e = expected.getColor(x, y),
+                        a = actual.getColor(x, y);
+                for (int shift : {0, 8, 16, 24}) {
+                    maxDiff = std::max(maxDiff, std::abs(int((e >> shift) & 0xFF) -
+                                                         int((a >> shift) & 0xFF)));
+                }
+            }
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= kTolerance, "%s: max diff %d", name, maxDiff);
+    };
+
+    // A filtered, unconstrained draw of an off-center src rect at 1/4 scale.
+    {
+        sk_sp<SkImage> lazy = SkImage::MakeFromEncoded(encoded);
+        auto draw = [](const sk_sp<SkImage>& image) {
+            return [image](SkCanvas* canvas) {
+                canvas->drawImageRect(image, SkRect::MakeLTRB(64, 32, 192, 224),
+                                      SkRect::MakeWH(32, 48),
+                                      SkSamplingOptions(SkFilterMode::kLinear), nullptr,
+                                      SkCanvas::kFast_SrcRectConstraint);
+            };
+        };
+        SkBitmap actual = render(draw(lazy));
+        SkBitmap cached;
+        REPORTER_ASSERT(reporter, !SkBitmapCache::Find(SkBitmapCacheDesc::Make(lazy.get()),
+                                                       &cached));
+        check("src rect", render(draw(full)), actual);
+    }
+
+    // An image shader drawn at 1/4 scale with kNearest mipmaps picks level 2, which the 64x64
+    // decode replaces.
+    {
+        sk_sp<SkImage> lazy = SkImage::MakeFromEncoded(encoded);
+        auto draw = [](const sk_sp<SkImage>& image) {
+            return [image](SkCanvas* canvas) {
+                SkPaint paint;
+                paint.setShader(image->makeShader(
+                        SkSamplingOptions(SkFilterMode::kLinear, SkMipmapMode::kNearest),
+                        SkMatrix::Scale(0.25f, 0.25f)));
+                canvas->drawRect(SkRect::MakeWH(64, 64), paint);
+            };
+        };
+        SkBitmap actual = render(draw(lazy));
+        SkBitmap cached;
+        REPORTER_ASSERT(reporter, !SkBitmapCache::Find(SkBitmapCacheDesc::Make(lazy.get()),
+                                                       &cached));
+        sk_sp<const SkMipmap> mips(SkMipmapCache::FindAndRef(SkBitmapCacheDesc::Make(lazy.get())));
+        REPORTER_ASSERT(reporter, !mips);
+        check("kNearest mipmap", render(draw(full)), actual);
+    }
+}
+
 DEF_GANESH_TEST_FOR_RENDERING_CONTEXTS(SkImage_makeTextureImage,
                                        reporter,
                                        contextInfo,
@@ -14,6 +14,7 @@
 #include "include/core/SkFont.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkPath.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkRRect.h"
@@ -23,6 +24,7 @@
 #include "include/core/SkString.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkTextBlob.h"
+#include "include/core/SkTypeface.h"
 #include "src/utils/SkMultiPictureDocument.h"
 #include "tests/Test.h"
 #include "tools/SkSharingProc.h"
@@ -170,6 +172,205 @@ DEF_TEST(SkMultiPictureDocument_Serialize_and_deserialize, reporter) {
     }
 }
 
+// Stands in for encoding images and typefaces, so the reader tests don't depend on which codecs
+// and font managers are built in.  Counts how often each side is asked for something.
+struct ObjectTable {
+    std::vector<sk_sp<SkImage>> fImages;
+    std::vector<sk_sp<SkTypeface>> fTypefaces;
+    int fImageDecodes = 0, fTypefaceDecodes = 0;
+
+    SkSerialProcs serialProcs() {
+        SkSerialProcs procs;
+        procs.fImageProc = [](SkImage* image, void* ctx) {
+            auto table = static_cast<ObjectTable*>(ctx);
+            table->fImages.push_back(sk_ref_sp(image));
+            uint32_t index = table->fImages.size() - 1;
+            return SkData::MakeWithCopy(&index, sizeof(index));
+        };
+        procs.fImageCtx = this;
+        procs.fTypefaceProc = [](SkTypeface* typeface, void* ctx) {
+            auto table = static_cast<ObjectTable*>(ctx);
+            table->fTypefaces.push_back(sk_ref_sp(typeface));
+            uint32_t index = table->fTypefaces.size() - 1;
+            return SkData::MakeWithCopy(&index, sizeof(index));
+        };
+        procs.fTypefaceCtx = this;
+        return procs;
+    }
+
+    SkDeserialProcs deserialProcs() {
+        SkDeserialProcs procs;
+        procs.fImageProc = [](const void* data, size_t length, void* ctx) -> sk_sp<SkImage> {
+            auto table = static_cast<ObjectTable*>(ctx);
+            uint32_t index;
+            SkASSERT_RELEASE(length == sizeof(index));
+            memcpy(&index, data, sizeof(index));
+            table->fImageDecodes++;
+            return table->fImages[index];
+        };
+        procs.fImageCtx = this;
+        procs.fTypefaceProc = [](const void* data, size_t length, void* ctx) -> sk_sp<SkTypeface> {
+            auto table = static_cast<ObjectTable*>(ctx);
+            SkStream* stream;
+            uint32_t index;
+            SkASSERT_RELEASE(length == sizeof(stream));
+            memcpy(&stream, data, sizeof(stream));
+            SkASSERT_RELEASE(stream->readU32(&index));
+            table->fTypefaceDecodes++;
+            return table->fTypefaces[index];
+        };
+        procs.fTypefaceCtx = this;
+        return procs;
+    }
+};
+
+static void draw_frame(SkCanvas* canvas, int seed, const sk_sp<SkImage>& image) {
+    canvas->drawColor(SK_ColorWHITE);
+    canvas->drawImage(image, 2*seed, seed);
+    SkPaint paint;
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawCircle(100, 50 + seed, 10 + seed, paint);
+    canvas->drawString(SkStringPrintf("Frame %d", seed), 20, 100,
+                       SkFont(ToolUtils::create_portable_typeface(), 12), paint);
+}
+
+static sk_sp<SkImage> render_page(const SkPicture& picture) {
+    auto surf = SkSurface::MakeRasterN32Premul(256, 256);
+    surf->getCanvas()->drawPicture(&picture);
+    return surf->makeImageSnapshot();
+}
+
+DEF_TEST(SkMultiPictureDocument_Reader, reporter) {
+    static const int NUM_FRAMES = 20;
+
+    auto surface(SkSurface::MakeRasterN32Premul(40, 40));
+    surface->getCanvas()->clear(SK_ColorGREEN);
+    sk_sp<SkImage> image(surface->makeImageSnapshot());
+
+    ObjectTable table;
+    SkDynamicMemoryWStream stream;
+    SkSerialProcs procs = table.serialProcs();
+    sk_sp<SkDocument> multipic = SkMakeMultiPictureDocument(&stream, &procs);
+    std::vector<sk_sp<SkImage>> expectedImages;
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        // Each page is written out as soon as it ends.
+        const size_t written = stream.bytesWritten();
+        draw_frame(multipic->beginPage(256, 128 + i), i, image);
+        multipic->endPage();
+        REPORTER_ASSERT(reporter, stream.bytesWritten() > written, "page %d", i);
+
+        SkPictureRecorder recorder;
+        draw_frame(recorder.beginRecording(256, 256), i, image);
+        expectedImages.push_back(render_page(*recorder.finishRecordingAsPicture()));
+    }
+    multipic->close();
+
+    // Every page draws the same image and typeface, but each is only written once.
+    REPORTER_ASSERT(reporter, table.fImages.size() == 1);
+    REPORTER_ASSERT(reporter, table.fTypefaces.size() == 1);
+
+    SkDeserialProcs dprocs = table.deserialProcs();
+    auto reader = SkMultiPictureDocumentReader::Make(stream.detachAsStream(), &dprocs);
+    REPORTER_ASSERT(reporter, reader);
+    if (!reader) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, reader->pageCount() == NUM_FRAMES);
+    REPORTER_ASSERT(reporter, !reader->readPage(-1) && !reader->readPage(NUM_FRAMES));
+
+    // Pages can be read in any order, and the image and typeface are only decoded once.
+    for (int i = NUM_FRAMES; i --> 0;) {
+        REPORTER_ASSERT(reporter, reader->pageSize(i) == SkSize::Make(256, 128 + i));
+        sk_sp<SkPicture> page = reader->readPage(i);
+        REPORTER_ASSERT(reporter, page);
+        if (page) {
+            REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(render_page(*page).get(),
+                                                              expectedImages[i].get()),
+                            "page %d", i);
+        }
+    }
+    REPORTER_ASSERT(reporter, table.fImageDecodes == 1);
+    REPORTER_ASSERT(reporter, table.fTypefaceDecodes == 1);
+}
+
+DEF_TEST(SkMultiPictureDocument_ReaderBadSizes, reporter) {
+    // Writes a document holding one page chunk, whose page table says it's at pageOffset, is
+    // pageSize bytes long, and is followed by imageCount images.
+    auto make_document = [](uint64_t pageOffset, uint64_t pageSize, uint32_t imageCount) {
+        SkDynamicMemoryWStream stream;
+        stream.writeText("Skia Multi-Picture Doc\n\n");
+        stream.write32(3);
+        stream.write("page", 4);
+        const uint64_t tableOffset = stream.bytesWritten();
+        stream.write32(1);
+        SkSize size = {256, 256};
+        stream.write(&size, sizeof(size));
+        stream.write32(imageCount);
+        stream.write32(0);  // typeface count
+        stream.write(&pageOffset, sizeof(pageOffset));
+        stream.write(&pageSize, sizeof(pageSize));
+        stream.write(&tableOffset, sizeof(tableOffset));
+        return SkMultiPictureDocumentReader::Make(stream.detachAsStream());
+    };
+    const uint64_t pageOffset = strlen("Skia Multi-Picture Doc\n\n") + sizeof(uint32_t);
+    REPORTER_ASSERT(reporter, make_document(pageOffset, 4, 0));
+
+    // A page table claiming far more entries than the file holds is rejected before we allocate.
+    REPORTER_ASSERT(reporter, !make_document(pageOffset, 4, 0x7FFFFFFF));
+
+    // So are pages that would run into the page table, or start in the header.
+    REPORTER_ASSERT(reporter, !make_document(pageOffset, 5, 0));
+    REPORTER_ASSERT(reporter, !make_document(0, 4, 0));
+
+    // A truncated file has lost its page table.
+    SkDynamicMemoryWStream docStream;
+    sk_sp<SkDocument> doc = SkMakeMultiPictureDocument(&docStream);
+    for (int i = 0; i < 2; i++) {
+        doc->beginPage(256, 256)->drawCircle(100, 50 + i, 10 + i, SkPaint());
+        doc->endPage();
+    }
+    doc->close();
+    sk_sp<SkData> data = docStream.detachAsData();
+    REPORTER_ASSERT(reporter, SkMultiPictureDocumentReader::Make(SkMemoryStream::Make(data)));
+    REPORTER_ASSERT(reporter, !SkMultiPictureDocumentReader::Make(
+            SkMemoryStream::Make(SkData::MakeSubset(data.get(), 0, data->size() - 16))));
+}
+
+DEF_TEST(SkMultiPictureDocument_ReaderVersion2, reporter) {
+    // Version 2 documents have no page table: all the pages are in one picture, split up by
+    // annotations.  The reader falls back to decoding them all up front.
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(256, 256);
+    std::vector<sk_sp<SkImage>> expectedImages;
+    for (int i = 0; i < 3; i++) {
+        SkPictureRecorder pageRecorder;
+        draw_frame(pageRecorder.beginRecording(256, 256), i, nullptr);
+        sk_sp<SkPicture> page = pageRecorder.finishRecordingAsPicture();
+        expectedImages.push_back(render_page(*page));
+        canvas->drawPicture(page);
+        canvas->drawAnnotation(SkRect::MakeEmpty(), "SkMultiPictureEndPage",
+                               SkData::MakeWithCString("X"));
+    }
+
+    SkDynamicMemoryWStream stream;
+    stream.writeText("Skia Multi-Picture Doc\n\n");
+    stream.write32(2);
+    stream.write32(3);
+    for (int i = 0; i < 3; i++) {
+        SkSize size = {256, 256};
+        stream.write(&size, sizeof(size));
+    }
+    recorder.finishRecordingAsPicture()->serialize(&stream);
+
+    auto reader = SkMultiPictureDocumentReader::Make(stream.detachAsStream());
+    REPORTER_ASSERT(reporter, reader && reader->pageCount() == 3);
+    for (int i = 0; reader && i < 3; i++) {
+        sk_sp<SkPicture> page = reader->readPage(i);
+        REPORTER_ASSERT(reporter, page && ToolUtils::equal_pixels(render_page(*page).get(),
+                                                                  expectedImages[i].get()));
+    }
+}
+
 
 #if SK_SUPPORT_GPU && defined(SK_BUILD_FOR_ANDROID) && __ANDROID_API__ >= 26
 
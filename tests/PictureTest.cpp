@@ -11,6 +11,7 @@
 #include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkFontStyle.h"
 #include "include/core/SkImage.h"
@@ -23,17 +24,26 @@
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
+#include "include/core/SkSerialProcs.h"
 #include "include/core/SkShader.h"
+#include "include/core/SkString.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
+#include "include/core/SkVertices.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkBigPicture.h"
+#include "src/core/SkDeferredPicture.h"
 #include "src/core/SkPicturePriv.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecords.h"
 #include "src/core/SkRectPriv.h"
 #include "tests/Test.h"
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <type_traits>
 
 class SkRRect;
 class SkRegion;
@@ -943,3 +953,322 @@ DEF_TEST(Picture_nested_op_count, r) {
     check(make_pic(10, leaf1),  10,  10);
     check(make_pic(10, leaf10), 10, 100);
 }
+
+DEF_TEST(Picture_Deferred, r) {
+    const SkRect bounds = SkRect::MakeWH(64, 64);
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(bounds);
+    canvas->drawCircle(8, 8, 6, SkPaint{});
+    canvas->drawRect({16, 16, 24, 24}, SkPaint{});
+    sk_sp<SkPicture> inner = recorder.finishRecordingAsPicture();
+
+    canvas = recorder.beginRecording(bounds);
+    canvas->clear(SK_ColorWHITE);
+    SkPath path;
+    path.moveTo(2, 60).cubicTo(10, 0, 50, 70, 62, 4).close();
+    SkPaint paint;
+    paint.setColor(SK_ColorBLUE);
+    paint.setAntiAlias(true);
+    canvas->drawPath(path, paint);
+    canvas->save();
+    canvas->translate(30, 30);
+    canvas->drawPicture(inner);
+    canvas->restore();
+    sk_sp<SkPicture> pic = recorder.finishRecordingAsPicture();
+
+    sk_sp<SkData> skp = pic->serialize();
+    sk_sp<SkPicture> eager    = SkPicture::MakeFromData(skp.get()),
+                     deferred = SkPicture::MakeFromDataDeferred(skp);
+    REPORTER_ASSERT(r, eager && deferred);
+    REPORTER_ASSERT(r, deferred->cullRect() == eager->cullRect());
+    REPORTER_ASSERT(r, deferred->approximateOpCount() == eager->approximateOpCount());
+
+    auto draw = [](const SkPicture* p) {
+        SkBitmap bm;
+        bm.allocN32Pixels(64, 64);
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas c(bm);
+        c.drawPicture(p);
+        return bm;
+    };
+    SkBitmap expected = draw(eager.get()),
+             actual   = draw(deferred.get());
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.computeByteSize()));
+
+    // Deferred pictures serialize like any other.
+    REPORTER_ASSERT(r, deferred->serialize()->equals(skp.get()));
+
+    // Garbage in the arrays isn't caught until playback, which then draws nothing.
+    sk_sp<SkData> corrupt = SkData::MakeWithCopy(skp->data(), skp->size());
+    const uint32_t arrayTag = SkSetFourByteTag('a', 'r', 'a', 'y');
+    for (size_t i = 0; i + 12 <= corrupt->size(); i++) {
+        if (0 == memcmp(corrupt->bytes() + i, &arrayTag, 4)) {
+            memset((char*)corrupt->writable_data() + i + 8, 0xff, 4);
+            break;
+        }
+    }
+    REPORTER_ASSERT(r, !SkPicture::MakeFromData(corrupt.get()));
+    sk_sp<SkPicture> lazyCorrupt = SkPicture::MakeFromDataDeferred(corrupt);
+    REPORTER_ASSERT(r, lazyCorrupt);
+    SkBitmap nothing = draw(lazyCorrupt.get());
+    REPORTER_ASSERT(r, nothing.getColor(32, 32) == 0);
+}
+
+DEF_TEST(Picture_DeferredOpIndex, r) {
+    // A 16x16 grid of cells, each drawn with its own save/translate/restore.
+    SkPictureRecorder recorder;
+    SkRTreeFactory factory;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(256, 256), &factory);
+    SkPaint paint;
+    for (int y = 0; y < 16; y++) {
+        for (int x = 0; x < 16; x++) {
+            paint.setColor(0xff000000 | (x * 16) << 16 | (y * 16) << 8);
+            canvas->save();
+            canvas->translate(x * 16.0f, y * 16.0f);
+            canvas->drawRect({1, 1, 15, 15}, paint);
+            canvas->restore();
+        }
+    }
+    sk_sp<SkPicture> pic = recorder.finishRecordingAsPicture();
+    const SkBigPicture* big = SkPicturePriv::AsSkBigPicture(pic);
+    REPORTER_ASSERT(r, big && big->bbh());
+
+    sk_sp<SkData> skp = pic->serialize();
+    sk_sp<SkPicture> deferred = SkPicture::MakeFromDataDeferred(skp);
+    const SkDeferredPicture* seekable = SkPicturePriv::AsSkDeferredPicture(deferred);
+    REPORTER_ASSERT(r, seekable);
+    REPORTER_ASSERT(r, seekable->indexedOpCount() == big->record()->count());
+
+    // Eagerly loaded pictures keep a BBH too, so they round trip with an index.
+    sk_sp<SkPicture> eager = SkPicture::MakeFromData(skp.get());
+    REPORTER_ASSERT(r, SkPicturePriv::AsSkBigPicture(eager)->bbh());
+
+    struct CountOps : public SkPicture::AbortCallback {
+        int fCount = 0;
+        bool abort() override { fCount++; return false; }
+    };
+    auto draw = [](const std::function<void(SkCanvas*)>& fn) {
+        SkBitmap bm;
+        bm.allocN32Pixels(256, 256);
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas c(bm);
+        fn(&c);
+        return bm;
+    };
+    auto same = [](const SkBitmap& a, const SkBitmap& b) {
+        return 0 == memcmp(a.getPixels(), b.getPixels(), a.computeByteSize());
+    };
+
+    // Clipped playback reads only the ops that intersect the clip.
+    const SkRect tile = SkRect::MakeXYWH(40, 40, 30, 30);
+    CountOps clipped;
+    SkBitmap expected = draw([&](SkCanvas* c) { c->clipRect(tile); pic->playback(c); }),
+             actual   = draw([&](SkCanvas* c) {
+                            c->clipRect(tile);
+                            deferred->playback(c, &clipped);
+                        });
+    REPORTER_ASSERT(r, same(expected, actual));
+    REPORTER_ASSERT(r, clipped.fCount > 0 && clipped.fCount < seekable->indexedOpCount() / 10);
+
+    // Partial playback matches SkBigPicture's.
+    const int start = 4 * 37, stop = 4 * 90;
+    expected = draw([&](SkCanvas* c) { big->partialPlayback(c, start, stop, SkM44()); });
+    actual   = draw([&](SkCanvas* c) {
+        REPORTER_ASSERT(r, seekable->partialPlayback(c, start, stop));
+    });
+    REPORTER_ASSERT(r, same(expected, actual));
+    draw([&](SkCanvas* c) { REPORTER_ASSERT(r, !seekable->partialPlayback(c, 5, 4)); });
+
+    // Pictures without a BBH don't get an index.
+    canvas = recorder.beginRecording(SkRect::MakeWH(256, 256));
+    canvas->drawRect({1, 1, 15, 15}, paint);
+    canvas->drawRect({3, 3, 15, 15}, paint);
+    sk_sp<SkPicture> unindexed = SkPicture::MakeFromDataDeferred(
+            recorder.finishRecordingAsPicture()->serialize());
+    REPORTER_ASSERT(r, 0 == SkPicturePriv::AsSkDeferredPicture(unindexed)->indexedOpCount());
+}
+
+DEF_TEST(Picture_InternContent, r) {
+    // Each path and vertices is built from scratch, so only its contents match the last.
+    auto makePath = [] {
+        SkPath path;
+        path.moveTo(10, 10).cubicTo(50, 0, 100, 80, 150, 20).close();
+        return path;
+    };
+    auto makeVertices = [] {
+        const SkPoint pts[] = {{0, 0}, {40, 10}, {20, 50}, {60, 60}};
+        return SkVertices::MakeCopy(SkVertices::kTriangleStrip_VertexMode, 4,
+                                    pts, nullptr, nullptr);
+    };
+    auto record = [&](uint32_t flags) {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(200, 200), nullptr, flags);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 50; i++) {
+            paint.setColor(i % 2 ? SK_ColorRED : SK_ColorBLUE);
+            canvas->save();
+            canvas->translate(i, i);
+            canvas->drawPath(makePath(), paint);
+            canvas->drawVertices(makeVertices(), SkBlendMode::kModulate, paint);
+            canvas->restore();
+        }
+        return recorder.finishRecordingAsPicture();
+    };
+    sk_sp<SkPicture> plain    = record(0),
+                     interned = record(SkPictureRecorder::kInternContent_RecordFlag);
+
+    // Every recorded path shares one SkPathRef, and every vertices is one object.
+    uint32_t pathID = 0;
+    const SkVertices* vertices = nullptr;
+    const SkRecord* rec = SkPicturePriv::AsSkBigPicture(interned)->record();
+    for (int i = 0; i < rec->count(); i++) {
+        rec->visit(i, [&](const auto& op) {
+            using T = std::decay_t<decltype(op)>;
+            if constexpr (std::is_same_v<T, SkRecords::DrawPath>) {
+                REPORTER_ASSERT(r, !pathID || pathID == op.path.getGenerationID());
+                pathID = op.path.getGenerationID();
+            } else if constexpr (std::is_same_v<T, SkRecords::DrawVertices>) {
+                REPORTER_ASSERT(r, !vertices || vertices == op.vertices.get());
+                vertices = op.vertices.get();
+            }
+        });
+    }
+    REPORTER_ASSERT(r, pathID && vertices);
+
+    // Only interned pictures count their path and vertices payloads, and each shared one once.
+    REPORTER_ASSERT(r, interned->approximateBytesUsed() - plain->approximateBytesUsed() ==
+                       makePath().approximateBytesUsed() - sizeof(SkPath) +
+                       makeVertices()->approximateSize());
+
+    // The sharing carries through serialization, and nothing changes what's drawn.
+    sk_sp<SkData> plainData    = plain->serialize(),
+                  internedData = interned->serialize();
+    REPORTER_ASSERT(r, internedData->size() < plainData->size());
+
+    auto render = [](const SkPicture* pic) {
+        SkBitmap bm;
+        bm.allocN32Pixels(200, 200);
+        bm.eraseColor(SK_ColorWHITE);
+        SkCanvas(bm).drawPicture(pic);
+        return bm;
+    };
+    SkBitmap expected = render(plain.get()),
+             actual   = render(SkPicture::MakeFromData(internedData.get()).get());
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.computeByteSize()));
+}
+
+DEF_TEST(Picture_CullOccludedDraws, r) {
+    auto record = [](uint32_t flags) {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100), nullptr, flags);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 10; i++) {
+            paint.setColor(SkColorSetARGB(0xFF, i * 20, 0, 255 - i * 20));
+            canvas->save();
+            canvas->translate(3.5f * i, 2.25f * i);
+            canvas->drawCircle(20, 20, 9.7f, paint);
+            canvas->restore();
+        }
+        paint.setColor(SK_ColorGREEN);
+        canvas->drawRect(SkRect::MakeLTRB(2.5f, 1.5f, 80.5f, 70.5f), paint);
+        paint.setColor(SK_ColorRED);
+        canvas->drawCircle(70, 70, 20, paint);
+        return recorder.finishRecordingAsPicture();
+    };
+    sk_sp<SkPicture> plain  = record(0),
+                     culled = record(SkPictureRecorder::kCullOccludedDraws_RecordFlag);
+
+    // The circles under the rect go, and their saves and restores with them.
+    REPORTER_ASSERT(r, culled->approximateOpCount() < plain->approximateOpCount());
+
+    auto render = [](const SkPicture* pic, const SkMatrix& m) {
+        SkBitmap bm;
+        bm.allocN32Pixels(200, 200);
+        bm.eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(bm);
+        canvas.concat(m);
+        canvas.drawPicture(pic);
+        return bm;
+    };
+    for (const SkMatrix& m : {SkMatrix::I(),
+                              SkMatrix::Translate(3.25f, 7.5f),
+                              SkMatrix::Scale(1.75f, 2)}) {
+        SkBitmap expected = render(plain.get(), m),
+                 actual   = render(culled.get(), m);
+        REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                       expected.computeByteSize()));
+    }
+}
+
+DEF_TEST(Picture_SerializeParallel, r) {
+    auto make_image = [](int i) {
+        SkBitmap bm;
+        bm.allocN32Pixels(16 + i, 16);
+        bm.eraseColor(SkColorSetARGB(0xFF, i * 10, 255 - i * 10, i * 3));
+        bm.setImmutable();
+        return bm.asImage();
+    };
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+    for (int i = 0; i < 3; i++) {
+        canvas->drawRect(SkRect::MakeXYWH(i, i, 10, 10), SkPaint());
+        canvas->drawImage(make_image(i), i, i);
+    }
+    sk_sp<SkPicture> nested = recorder.finishRecordingAsPicture();
+
+    canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+    SkPaint shaderPaint;
+    shaderPaint.setShader(make_image(20)->makeShader(SkSamplingOptions()));
+    canvas->drawPaint(shaderPaint);
+    for (int i = 0; i < 10; i++) {
+        sk_sp<SkImage> image = make_image(i);
+        canvas->drawImage(image, i, 0);
+        canvas->drawImage(image, 0, i);
+    }
+    canvas->drawString("hello", 10, 50, SkFont(), SkPaint());
+    canvas->drawPicture(nested);
+    sk_sp<SkPicture> pic = recorder.finishRecordingAsPicture();
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    // Default encoding.
+    sk_sp<SkData> serial   = pic->serialize(),
+                  parallel = pic->serialize(nullptr, executor.get());
+    REPORTER_ASSERT(r, serial->equals(parallel.get()));
+
+    // Custom procs, which may decline some images and encode the rest themselves.
+    struct Ctx {
+        std::atomic<int> imageCalls{0};
+        std::atomic<int> pictureCalls{0};
+    } ctx;
+    SkSerialProcs procs;
+    procs.fImageProc = [](SkImage* image, void* ctx) -> sk_sp<SkData> {
+        static_cast<Ctx*>(ctx)->imageCalls++;
+        if (image->width() % 2) {
+            return nullptr;
+        }
+        return SkData::MakeWithCString(SkStringPrintf("image %d", image->width()).c_str());
+    };
+    procs.fImageCtx = &ctx;
+    procs.fPictureProc = [](SkPicture*, void* ctx) -> sk_sp<SkData> {
+        static_cast<Ctx*>(ctx)->pictureCalls++;
+        return nullptr;
+    };
+    procs.fPictureCtx = &ctx;
+
+    serial = pic->serialize(&procs);
+    ctx.imageCalls = ctx.pictureCalls = 0;
+    parallel = pic->serialize(&procs, executor.get());
+    REPORTER_ASSERT(r, serial->equals(parallel.get()));
+    REPORTER_ASSERT(r, ctx.imageCalls == 14);   // 10 top-level, 1 in the shader, 3 nested.
+    REPORTER_ASSERT(r, ctx.pictureCalls == 2);  // The top-level picture and the nested one.
+
+    // No executor just means serialize(procs).
+    REPORTER_ASSERT(r, serial->equals(pic->serialize(&procs, nullptr).get()));
+}
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkExecutor.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkRTree.h"
 #include "tests/Test.h"
@@ -89,3 +90,39 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+DEF_TEST(RTree_Parallel, reporter) {
+    // Enough rects that the leaf level is built with STR on the executor.
+    static const int kNumRects = 3 * SkRTree::kParallelThreshold;
+
+    SkRandom rand;
+    std::vector<SkRect> rects(kNumRects);
+    for (SkRect& r : rects) {
+        r = random_rect(rand);
+        r.setXYWH(r.fLeft, r.fTop, r.width() / 50, r.height() / 50);
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkRTree serial, parallel(executor.get());
+    serial  .insert(rects.data(), kNumRects);
+    parallel.insert(rects.data(), kNumRects);
+    REPORTER_ASSERT(reporter, kNumRects == parallel.getCount());
+
+    for (size_t i = 0; i < NUM_QUERIES; ++i) {
+        SkRect query = random_rect(rand);
+
+        std::vector<int> expected, found;
+        for (int j = 0; j < kNumRects; ++j) {
+            if (SkRect::Intersects(query, rects[j])) {
+                expected.push_back(j);
+            }
+        }
+        parallel.search(query, &found);
+        REPORTER_ASSERT(reporter, found == expected);
+
+        // Results must match the serially built tree op for op, since they're drawn in order.
+        std::vector<int> hits;
+        serial.search(query, &hits);
+        REPORTER_ASSERT(reporter, hits == found);
+    }
+}
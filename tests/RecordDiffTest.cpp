@@ -0,0 +1,218 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "tests/Test.h"
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkM44.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkRegion.h"
+#include "include/core/SkSurface.h"
+#include "include/effects/SkImageFilters.h"
+#include "src/core/SkRecordDiff.h"
+
+#include <functional>
+
+static constexpr int W = 256, H = 256;
+
+// Records a little scene: a backdrop, a grid of tiles, a clipped path, and a blurred layer.
+// frame moves things around.  Paths are rebuilt from scratch each time, like a real app would, but
+// effects are shared across frames, since they're only compared by identity.
+static sk_sp<SkPicture> record_frame(int frame, const std::function<void(SkCanvas*)>& extra = {}) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(W, H));
+
+    SkPaint paint;
+    paint.setColor(SK_ColorWHITE);
+    canvas->drawRect(SkRect::MakeWH(W, H), paint);
+
+    paint.setAntiAlias(true);
+    for (int y = 0; y < 4; y++)
+    for (int x = 0; x < 4; x++) {
+        paint.setColor(0xff000000 | (x * 60) << 16 | (y * 60) << 8);
+        canvas->drawRect(SkRect::MakeXYWH(8 + x*32, 8 + y*32, 24, 24), paint);
+    }
+
+    canvas->save();
+        canvas->clipRect(SkRect::MakeXYWH(140, 8, 100, 100));
+        SkPath path;
+        path.moveTo(150 + frame, 20);
+        path.lineTo(200 + frame, 90);
+        path.lineTo(140 + frame, 60);
+        paint.setColor(SK_ColorMAGENTA);
+        canvas->drawPath(path, paint);
+    canvas->restore();
+
+    static const sk_sp<SkImageFilter> blur = SkImageFilters::Blur(3, 3, nullptr);
+    SkPaint layer;
+    layer.setImageFilter(blur);
+    canvas->saveLayer(nullptr, &layer);
+        paint.setColor(SK_ColorBLUE);
+        canvas->drawCircle(60 + 4*frame, 200, 20, paint);
+    canvas->restore();
+
+    if (extra) {
+        extra(canvas);
+    }
+    return recorder.finishRecordingAsPicture();
+}
+
+static SkBitmap render(const SkPicture& picture, const SkM44& matrix = SkM44()) {
+    SkBitmap bm;
+    bm.allocN32Pixels(W, H);
+    bm.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(bm);
+    canvas.setMatrix(matrix);
+    canvas.drawPicture(&picture);
+    return bm;
+}
+
+static SkRegion changed_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkRegion changed;
+    for (int y = 0; y < H; y++)
+    for (int x = 0; x < W; x++) {
+        if (*a.getAddr32(x, y) != *b.getAddr32(x, y)) {
+            changed.op(SkIRect::MakeXYWH(x, y, 1, 1), SkRegion::kUnion_Op);
+        }
+    }
+    return changed;
+}
+
+DEF_TEST(RecordDiff_Identical, r) {
+    // Separately recorded but identical frames have no damage, even though their paths differ.
+    SkRegion damage;
+    SkPictureComputeDamage(SkM44(), *record_frame(0), *record_frame(0), &damage);
+    REPORTER_ASSERT(r, damage.isEmpty());
+}
+
+DEF_TEST(RecordDiff_LocalChanges, r) {
+    auto before = record_frame(0);
+    auto after  = record_frame(0, [](SkCanvas* canvas) {
+        canvas->drawRect(SkRect::MakeXYWH(100, 100, 10, 10), SkPaint());
+    });
+
+    // Only the new rect is damaged, with a pixel of slop for anti-aliasing.
+    SkRegion damage;
+    SkPictureComputeDamage(SkM44(), *before, *after, &damage);
+    REPORTER_ASSERT(r, damage.isRect());
+    REPORTER_ASSERT(r, damage.getBounds() == SkIRect::MakeXYWH(99, 99, 12, 12));
+
+    // Changing a clip damages what draws under it, but not the rest of the frame.
+    after = record_frame(0, [](SkCanvas* canvas) {
+        canvas->clipRect(SkRect::MakeWH(W, H/2));
+        canvas->drawRect(SkRect::MakeXYWH(100, 100, 10, 10), SkPaint());
+    });
+    auto later = record_frame(0, [](SkCanvas* canvas) {
+        canvas->clipRect(SkRect::MakeWH(W, H/2 + 1));
+        canvas->drawRect(SkRect::MakeXYWH(100, 100, 10, 10), SkPaint());
+    });
+    SkPictureComputeDamage(SkM44(), *after, *later, &damage);
+    REPORTER_ASSERT(r, damage.getBounds() == SkIRect::MakeXYWH(99, 99, 12, 12));
+
+    // Reordering two overlapping draws damages both of them.
+    SkPaint red, green;
+    red.setColor(SK_ColorRED);
+    green.setColor(SK_ColorGREEN);
+    before = record_frame(0, [&](SkCanvas* canvas) {
+        canvas->drawRect(SkRect::MakeXYWH(100, 100, 20, 20), red);
+        canvas->drawRect(SkRect::MakeXYWH(110, 110, 20, 20), green);
+    });
+    after = record_frame(0, [&](SkCanvas* canvas) {
+        canvas->drawRect(SkRect::MakeXYWH(110, 110, 20, 20), green);
+        canvas->drawRect(SkRect::MakeXYWH(100, 100, 20, 20), red);
+    });
+    SkPictureComputeDamage(SkM44(), *before, *after, &damage);
+    REPORTER_ASSERT(r, damage.contains(SkIRect::MakeXYWH(110, 110, 10, 10)));
+}
+
+DEF_TEST(RecordDiff_PartialReplay, r) {
+    auto surface = SkSurface::MakeRasterN32Premul(W, H);
+    sk_sp<SkPicture> previous = record_frame(0);
+    surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+    surface->getCanvas()->drawPicture(previous);
+
+    for (int frame = 1; frame < 8; frame++) {
+        sk_sp<SkPicture> current = record_frame(frame);
+        SkRegion damage;
+        SkPictureComputeDamage(SkM44(), *previous, *current, &damage);
+
+        // Everything that changed must be damaged, and the grid of tiles never is.
+        SkRegion changed = changed_pixels(render(*previous), render(*current));
+        REPORTER_ASSERT(r, !changed.isEmpty());
+        REPORTER_ASSERT(r, !changed.op(damage, SkRegion::kDifference_Op));
+        REPORTER_ASSERT(r, !damage.intersects(SkIRect::MakeXYWH(8, 8, 120, 120)));
+
+        // Redrawing just the damage gives the same pixels as drawing the whole frame.
+        SkPictureDrawDamage(*current, SkM44(), damage, surface->getCanvas());
+        SkBitmap expected = render(*current),
+                 actual;
+        actual.allocN32Pixels(W, H);
+        REPORTER_ASSERT(r, surface->readPixels(actual, 0, 0));
+        REPORTER_ASSERT(r, changed_pixels(expected, actual).isEmpty(), "frame %d", frame);
+
+        previous = current;
+    }
+}
+
+DEF_TEST(RecordDiff_DeviceSpace, r) {
+    auto before = record_frame(0);
+    auto after  = record_frame(0, [](SkCanvas* canvas) {
+        canvas->drawRect(SkRect::MakeXYWH(50, 50, 10, 10), SkPaint());
+    });
+
+    // Damage is in device space, with a device pixel of slop for anti-aliasing.
+    SkRegion damage;
+    SkPictureComputeDamage(SkM44::Scale(2, 2), *before, *after, &damage);
+    REPORTER_ASSERT(r, damage.getBounds() == SkIRect::MakeXYWH(99, 99, 22, 22));
+    SkPictureComputeDamage(SkM44::Scale(0.25f, 0.25f), *before, *after, &damage);
+    REPORTER_ASSERT(r, damage.getBounds() == SkIRect::MakeLTRB(11, 11, 16, 16));
+
+    // Damage covers every changed pixel, and partial replay matches full rendering, under scaled
+    // down, rotated, and perspective matrices.  (Except that under perspective, a blur is resolved
+    // relative to the clip, so its pixels can't be expected to match exactly.)
+    const SkM44 perspective(SkMatrix::MakeAll(0.9f, 0.1f, 10,
+                                              0,    0.8f, 20,
+                                              1e-3f, 5e-4f, 1));
+    const struct {
+        SkM44 matrix;
+        bool  exact;
+    } tests[] = {
+        {SkM44::Scale(0.5f, 0.5f),                                        true},
+        {SkM44::Rotate({0, 0, 1}, 0.35f) * SkM44::Scale(0.75f, 0.75f),  true},
+        {perspective,                                                     false},
+    };
+    for (const auto& [matrix, exact] : tests) {
+        auto surface = SkSurface::MakeRasterN32Premul(W, H);
+        sk_sp<SkPicture> previous = record_frame(0);
+        surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+        surface->getCanvas()->setMatrix(matrix);
+        surface->getCanvas()->drawPicture(previous);
+        surface->getCanvas()->resetMatrix();
+
+        for (int frame = 1; frame < 4; frame++) {
+            sk_sp<SkPicture> current = record_frame(frame);
+            SkPictureComputeDamage(matrix, *previous, *current, &damage);
+
+            SkRegion changed = changed_pixels(render(*previous, matrix), render(*current, matrix));
+            REPORTER_ASSERT(r, !changed.isEmpty());
+            REPORTER_ASSERT(r, !changed.op(damage, SkRegion::kDifference_Op));
+
+            if (exact) {
+                SkPictureDrawDamage(*current, matrix, damage, surface->getCanvas());
+                SkBitmap actual;
+                actual.allocN32Pixels(W, H);
+                REPORTER_ASSERT(r, surface->readPixels(actual, 0, 0));
+                REPORTER_ASSERT(r, changed_pixels(render(*current, matrix), actual).isEmpty(),
+                                "frame %d", frame);
+            }
+
+            previous = current;
+        }
+    }
+}
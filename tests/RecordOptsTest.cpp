@@ -8,11 +8,14 @@
 #include "tests/RecordTestUtils.h"
 #include "tests/Test.h"
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkColorFilter.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkSurface.h"
 #include "include/effects/SkImageFilters.h"
 #include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
 #include "src/core/SkRecordOpts.h"
 #include "src/core/SkRecorder.h"
 #include "src/core/SkRecords.h"
@@ -414,3 +417,188 @@ DEF_TEST(savelayer_srcmode_alpha, r) {
     do_savelayer_srcmode(r, 0x80FF0000);
 }
 
+
+DEF_TEST(RecordOpts_NoopOccludedDraws, r) {
+    SkPaint opaque, translucent;
+    opaque.setColor(SK_ColorBLUE);
+    translucent.setColor(0x800000FF);
+
+    const SkRect small = SkRect::MakeXYWH(10, 10, 50, 50),
+                 full  = SkRect::MakeWH(W, H);
+
+    {   // Draws fully covered by a later opaque full-bleed rect go away, the occluder stays.
+        SkRecord record;
+        SkRecorder recorder(&record, W, H);
+        recorder.drawRect(small, translucent);
+        recorder.drawOval(small, opaque);
+        recorder.drawRect(full, opaque);
+
+        SkRecordOcclusionStats stats;
+        SkRecordNoopOccludedDraws(&record, &stats);
+        assert_type<SkRecords::NoOp>(r, record, 0);
+        assert_type<SkRecords::NoOp>(r, record, 1);
+        assert_type<SkRecords::DrawRect>(r, record, 2);
+        REPORTER_ASSERT(r, stats.fOps == 2);
+        REPORTER_ASSERT(r, stats.fPixels >= 2 * 50 * 50);
+    }
+    {   // Translucent occluders, occluders inside layers, and draws poking out aren't culled.
+        SkRecord record;
+        SkRecorder recorder(&record, W, H);
+        recorder.drawRect(small, opaque);
+        recorder.drawRect(full, translucent);
+        recorder.saveLayer(nullptr, nullptr);
+            recorder.drawRect(full, opaque);
+        recorder.restore();
+        recorder.drawRect(SkRect::MakeXYWH(10, 10, 100, 100), opaque);
+        recorder.drawRect(SkRect::MakeXYWH(20, 20, 100, 100), opaque);
+
+        SkRecordOcclusionStats stats;
+        SkRecordNoopOccludedDraws(&record, &stats);
+        REPORTER_ASSERT(r, 0 == count_instances_of_type<SkRecords::NoOp>(record));
+        REPORTER_ASSERT(r, stats.fOps == 0 && stats.fPixels == 0);
+    }
+    {   // Clips limit what an occluder covers.
+        SkRecord record;
+        SkRecorder recorder(&record, W, H);
+        recorder.drawRect(SkRect::MakeXYWH(100, 100, 50, 50), opaque);
+        recorder.drawRect(small, opaque);
+        recorder.save();
+            recorder.clipRect(SkRect::MakeWH(80, 80));
+            recorder.drawPaint(opaque);
+        recorder.restore();
+
+        SkRecordNoopOccludedDraws(&record);
+        assert_type<SkRecords::DrawRect>(r, record, 0);
+        assert_type<SkRecords::NoOp>(r, record, 1);
+        assert_type<SkRecords::DrawPaint>(r, record, 4);
+    }
+    {   // Backdrop layers can read what's beneath an occluder, and annotations always stay.
+        SkRecord record;
+        SkRecorder recorder(&record, W, H);
+        recorder.drawRect(small, opaque);
+        recorder.drawAnnotation(small, "key", nullptr);
+        recorder.saveLayer({nullptr, nullptr, SkImageFilters::Blur(3, 3, nullptr).get(), 0});
+        recorder.restore();
+        recorder.drawRect(full, opaque);
+
+        SkRecordNoopOccludedDraws(&record);
+        REPORTER_ASSERT(r, 0 == count_instances_of_type<SkRecords::NoOp>(record));
+    }
+}
+
+// Culling occluded draws must not change what a picture draws.
+DEF_TEST(RecordOpts_NoopOccludedDrawsRender, r) {
+    auto draw = [](SkCanvas* canvas) {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 20; i++) {
+            paint.setColor(0xFF000000 | (i * 0x0D0B07));
+            canvas->drawCircle(5.5f * i, 3.25f * i, 7.3f, paint);
+        }
+        canvas->translate(0.5f, 0.25f);
+        canvas->scale(1.5f, 1.5f);
+        paint.setColor(SK_ColorGREEN);
+        canvas->drawRect(SkRect::MakeLTRB(3.3f, 2.7f, 50.1f, 40.9f), paint);
+        canvas->clipRect(SkRect::MakeLTRB(40.2f, 30.6f, 80.8f, 70.1f), true);
+        paint.setColor(SK_ColorMAGENTA);
+        canvas->drawPaint(paint);
+    };
+
+    SkRecord record;
+    SkRecorder recorder(&record, 128, 128);
+    draw(&recorder);
+
+    SkRecordOcclusionStats stats;
+    SkRecordNoopOccludedDraws(&record, &stats);
+    REPORTER_ASSERT(r, stats.fOps > 0);
+
+    sk_sp<SkSurface> expected = SkSurface::MakeRasterN32Premul(128, 128),
+                     actual   = SkSurface::MakeRasterN32Premul(128, 128);
+    draw(expected->getCanvas());
+    SkRecordDraw(record, actual->getCanvas(), nullptr, nullptr, 0, nullptr, nullptr);
+
+    SkPixmap a, b;
+    REPORTER_ASSERT(r, expected->peekPixels(&a) && actual->peekPixels(&b));
+    for (int y = 0; y < 128; y++) {
+        REPORTER_ASSERT(r, 0 == memcmp(a.addr32(0, y), b.addr32(0, y), 128 * sizeof(uint32_t)));
+    }
+}
+
+// An image's src can hang off its edge; only the dst mapped from pixels inside the image is drawn.
+DEF_TEST(RecordOpts_NoopOccludedDrawsImageSrcOverhang, r) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::MakeN32(32, 32, kOpaque_SkAlphaType));
+    bm.eraseColor(SK_ColorGREEN);
+    sk_sp<SkImage> image = bm.asImage();
+
+    auto draw = [&](SkCanvas* canvas) {
+        SkPaint red;
+        red.setColor(SK_ColorRED);
+        canvas->drawRect(SkRect::MakeXYWH(10, 10, 40, 40), red);   // Under the image's pixels.
+        canvas->drawRect(SkRect::MakeXYWH(80, 10, 40, 40), red);   // Under the overhang.
+        // The right half of src is outside the image, so only the left half of dst is painted.
+        canvas->drawImageRect(image, SkRect::MakeWH(64, 32), SkRect::MakeWH(128, 64),
+                              SkSamplingOptions(), nullptr, SkCanvas::kStrict_SrcRectConstraint);
+    };
+
+    SkRecord record;
+    SkRecorder recorder(&record, 128, 128);
+    draw(&recorder);
+
+    SkRecordNoopOccludedDraws(&record);
+    assert_type<SkRecords::NoOp>(r, record, 0);
+    assert_type<SkRecords::DrawRect>(r, record, 1);
+    assert_type<SkRecords::DrawImageRect>(r, record, 2);
+
+    sk_sp<SkSurface> expected = SkSurface::MakeRasterN32Premul(128, 128),
+                     actual   = SkSurface::MakeRasterN32Premul(128, 128);
+    draw(expected->getCanvas());
+    SkRecordDraw(record, actual->getCanvas(), nullptr, nullptr, 0, nullptr, nullptr);
+
+    SkPixmap a, b;
+    REPORTER_ASSERT(r, expected->peekPixels(&a) && actual->peekPixels(&b));
+    REPORTER_ASSERT(r, SK_ColorRED == b.getColor(100, 30));
+    for (int y = 0; y < 128; y++) {
+        REPORTER_ASSERT(r, 0 == memcmp(a.addr32(0, y), b.addr32(0, y), 128 * sizeof(uint32_t)));
+    }
+}
+
+// SkRecordOptimize() must not change what a record draws however it's played back. Culling
+// occluded draws would here: scaled down or rotated, the green rect's antialiased edges let the
+// red circles beneath show through.
+DEF_TEST(RecordOpts_OptimizeRenderTransformed, r) {
+    auto draw = [](SkCanvas* canvas) {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(SK_ColorRED);
+        for (int i = 0; i < 8; i++) {
+            canvas->drawCircle(20.5f + 11 * i, 20.5f + 11 * i, 9.5f, paint);
+        }
+        paint.setColor(SK_ColorGREEN);
+        canvas->drawRect(SkRect::MakeLTRB(9.25f, 9.25f, 118.75f, 118.75f), paint);
+    };
+
+    SkRecord record;
+    SkRecorder recorder(&record, 128, 128);
+    draw(&recorder);
+    SkRecordOptimize(&record);
+    REPORTER_ASSERT(r, 0 == count_instances_of_type<SkRecords::NoOp>(record));
+
+    SkMatrix rotate;
+    rotate.setRotate(30, 64, 64);
+    for (const SkMatrix& matrix : {SkMatrix::Scale(0.25f, 0.25f), rotate}) {
+        sk_sp<SkSurface> expected = SkSurface::MakeRasterN32Premul(128, 128),
+                         actual   = SkSurface::MakeRasterN32Premul(128, 128);
+        expected->getCanvas()->concat(matrix);
+        actual->getCanvas()->concat(matrix);
+        draw(expected->getCanvas());
+        SkRecordDraw(record, actual->getCanvas(), nullptr, nullptr, 0, nullptr, nullptr);
+
+        SkPixmap a, b;
+        REPORTER_ASSERT(r, expected->peekPixels(&a) && actual->peekPixels(&b));
+        for (int y = 0; y < 128; y++) {
+            REPORTER_ASSERT(r,
+                            0 == memcmp(a.addr32(0, y), b.addr32(0, y), 128 * sizeof(uint32_t)));
+        }
+    }
+}
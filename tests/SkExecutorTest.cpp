@@ -0,0 +1,296 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkExecutor.h"
+#include "include/private/SkMutex.h"
+#include "src/core/SkRecordReplay.h"
+#include "src/core/SkTaskGroup.h"
+
+#include "tests/Test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static std::vector<std::unique_ptr<SkExecutor>> make_pools(int threads) {
+    std::vector<std::unique_ptr<SkExecutor>> pools;
+    pools.push_back(SkExecutor::MakeFIFOThreadPool(threads));
+    pools.push_back(SkExecutor::MakeLIFOThreadPool(threads));
+    pools.push_back(SkExecutor::MakeWorkStealingPool(threads));
+    pools.push_back(SkExecutor::MakeDeterministicPool(threads));
+    return pools;
+}
+
+DEF_TEST(SkExecutor_BatchRunsEachIndexOnce, r) {
+    for (auto& pool : make_pools(4)) {
+        for (int N : {0, 1, 7, 64, 1000, 12345}) {
+            std::vector<std::atomic<int>> calls(N);
+            SkTaskGroup tg(*pool);
+            tg.batch(N, [&](int i) { calls[i].fetch_add(1, std::memory_order_relaxed); });
+            tg.wait();
+            for (int i = 0; i < N; i++) {
+                REPORTER_ASSERT(r, calls[i].load() == 1, "N=%d i=%d", N, i);
+            }
+        }
+    }
+}
+
+DEF_TEST(SkExecutor_NestedTaskGroups, r) {
+    // Nested waits must make progress by borrowing, even with fewer threads than waiters.
+    for (auto& pool : make_pools(2)) {
+        std::atomic<int> leaves{0};
+        SkTaskGroup outer(*pool);
+        outer.batch(16, [&](int) {
+            SkTaskGroup inner(*pool);
+            for (int i = 0; i < 50; i++) {
+                inner.add([&] { leaves.fetch_add(1, std::memory_order_relaxed); });
+            }
+            inner.wait();
+        });
+        outer.wait();
+        REPORTER_ASSERT(r, leaves.load() == 16 * 50);
+    }
+}
+
+DEF_TEST(SkExecutor_WorkStealingSpawnFromTasks, r) {
+    // Work added from pool threads lands on their own deques and must be stolen by the others.
+    auto pool = SkExecutor::MakeWorkStealingPool(4);
+    SkTaskGroup tg(*pool);
+    std::atomic<int> count{0};
+    std::function<void(int)> spawn = [&](int depth) {
+        count.fetch_add(1, std::memory_order_relaxed);
+        if (depth > 0) {
+            for (int i = 0; i < 4; i++) {
+                tg.add([&spawn, depth] { spawn(depth - 1); });
+            }
+        }
+    };
+    tg.add([&] { spawn(6); });
+    tg.wait();
+    REPORTER_ASSERT(r, count.load() == 1 + 4 + 16 + 64 + 256 + 1024 + 4096);
+}
+
+DEF_TEST(SkExecutor_WorkStealingDrainsOnDestruction, r) {
+    // Destroying the pool must run everything already queued, and anything that work adds.
+    std::atomic<int> count{0};
+    {
+        auto pool = SkExecutor::MakeWorkStealingPool(4);
+        SkExecutor* executor = pool.get();
+        for (int i = 0; i < 100; i++) {
+            pool->add([&count, executor] {
+                count.fetch_add(1, std::memory_order_relaxed);
+                for (int j = 0; j < 10; j++) {
+                    executor->add([&count] { count.fetch_add(1, std::memory_order_relaxed); });
+                }
+            });
+        }
+    }
+    REPORTER_ASSERT(r, count.load() == 100 * 11);
+}
+
+namespace {
+// Stands in for a record/replay runtime, through the hooks SkMutex and SkRecordReplayAssertValues
+// use to reach the real one.  Recording logs which thread took each ordered lock, in order;
+// replaying makes threads take each lock in the order the recording logged.  Each thread's binary
+// assertions are kept in the order it made them, which is what has to match between the runs.
+class StubRecordReplayRuntime {
+public:
+    explicit StubRecordReplayRuntime(const StubRecordReplayRuntime* recording = nullptr)
+            : fRecording(recording) {}
+
+    // Ordered locks are told apart by who takes them, so each thread that takes one is named.
+    static thread_local int tlsThread;
+
+    void install() {
+        gRuntime = this;
+        SkRecordReplaySetOrderedLocksForTesting(CreateOrderedLock, OrderedLock, OrderedUnlock);
+        SkRecordReplaySetAssertsForTesting(AssertFormatted, AssertBytes);
+    }
+
+    static void Uninstall() {
+        SkRecordReplaySetAssertsForTesting(nullptr, nullptr);
+        SkRecordReplaySetOrderedLocksForTesting(nullptr, nullptr, nullptr);
+        gRuntime = nullptr;
+    }
+
+    // Which threads took each ordered lock, in the order they took it.
+    std::vector<std::vector<int>> lockOrders() const {
+        std::lock_guard<std::mutex> lock(fMutex);
+        std::vector<std::vector<int>> orders;
+        for (const auto& ordered : fLocks) {
+            orders.push_back(ordered->fOrder);
+        }
+        return orders;
+    }
+
+    // Each thread's assertions; which thread is which doesn't matter, only that the same set of
+    // per-thread histories comes out of both runs.
+    std::vector<std::vector<uint64_t>> histories() const {
+        std::lock_guard<std::mutex> lock(fMutex);
+        std::vector<std::vector<uint64_t>> histories;
+        for (const auto& [thread, words] : fAsserts) {
+            histories.push_back(words);
+        }
+        std::sort(histories.begin(), histories.end());
+        return histories;
+    }
+
+private:
+    struct Lock {
+        std::mutex              fMutex;
+        std::condition_variable fReleased;
+        bool                    fHeld = false;
+        std::vector<int>        fOrder;
+    };
+
+    static int CreateOrderedLock(const char*) {
+        std::lock_guard<std::mutex> lock(gRuntime->fMutex);
+        gRuntime->fLocks.push_back(std::make_unique<Lock>());
+        return (int)gRuntime->fLocks.size();
+    }
+
+    static void OrderedLock(int id) {
+        Lock* ordered = gRuntime->lockWithId(id);
+        const std::vector<int>* recorded = nullptr;
+        if (gRuntime->fRecording) {
+            recorded = &gRuntime->fRecording->lockWithId(id)->fOrder;
+        }
+        std::unique_lock<std::mutex> lock(ordered->fMutex);
+        ordered->fReleased.wait(lock, [&] {
+            size_t next = ordered->fOrder.size();
+            return !ordered->fHeld &&
+                   (!recorded || next >= recorded->size() || (*recorded)[next] == tlsThread);
+        });
+        ordered->fHeld = true;
+        ordered->fOrder.push_back(tlsThread);
+    }
+
+    static void OrderedUnlock(int id) {
+        Lock* ordered = gRuntime->lockWithId(id);
+        {
+            std::lock_guard<std::mutex> lock(ordered->fMutex);
+            ordered->fHeld = false;
+        }
+        ordered->fReleased.notify_all();
+    }
+
+    static void AssertFormatted(const char* format, va_list args) {
+        char text[256];
+        vsnprintf(text, sizeof(text), format, args);
+        AssertBytes("", text, strlen(text));
+    }
+
+    static void AssertBytes(const char*, const void* data, size_t size) {
+        std::lock_guard<std::mutex> lock(gRuntime->fMutex);
+        auto& words = gRuntime->fAsserts[std::this_thread::get_id()];
+        size_t used = words.size();
+        words.resize(used + (size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+        memcpy(words.data() + used, data, size);
+    }
+
+    Lock* lockWithId(int id) const {
+        std::lock_guard<std::mutex> lock(fMutex);
+        return fLocks[id - 1].get();
+    }
+
+    static StubRecordReplayRuntime* gRuntime;
+
+    const StubRecordReplayRuntime*                   fRecording;
+    mutable std::mutex                               fMutex;
+    std::vector<std::unique_ptr<Lock>>               fLocks;
+    std::map<std::thread::id, std::vector<uint64_t>> fAsserts;
+};
+
+StubRecordReplayRuntime* StubRecordReplayRuntime::gRuntime  = nullptr;
+thread_local int         StubRecordReplayRuntime::tlsThread = -1;
+}  // namespace
+
+static void run_replay_workload(StubRecordReplayRuntime* runtime, int seed) {
+    // Make each run's timing different, to shake out anything that depends on it.
+    auto jitter = [seed](int i) {
+        std::this_thread::sleep_for(std::chrono::microseconds((seed * 7919 + i * 104729) % 97));
+    };
+    auto event = [](int id) {
+        SkRecordReplayAssertValues(SK_RECORD_REPLAY_SITE("SkExecutorTest::event"), id);
+    };
+
+    runtime->install();
+    {
+        auto pool = SkExecutor::MakeDeterministicPool(4);
+        SkExecutor* executor = pool.get();
+
+        // A second thread outside the pool races this one to add work.  Which thread's work
+        // lands on which pool thread is only the same in both runs if replay makes them take the
+        // pool's ordered lock in the order they took it while recording.
+        std::thread racer([=] {
+            StubRecordReplayRuntime::tlsThread = 1;
+            SkTaskGroup tg(*executor);
+            for (int k = 0; k < 200; k++) {
+                jitter(k + 1);
+                tg.add([=] {
+                    jitter(k);
+                    event(200000 + k);
+                });
+            }
+            tg.wait();
+        });
+
+        StubRecordReplayRuntime::tlsThread = 0;
+        event(-1);
+        SkTaskGroup tg(*pool);
+        for (int i = 0; i < 32; i++) {
+            jitter(2 * i);
+            tg.add([=] {
+                jitter(i);
+                event(1000 * i);
+                if (i % 4 == 0) {
+                    SkTaskGroup inner(*executor);
+                    for (int j = 1; j <= 4; j++) {
+                        inner.add([=] {
+                            jitter(i + j);
+                            event(1000 * i + j);
+                        });
+                    }
+                    inner.wait();
+                    event(1000 * i + 999);
+                }
+            });
+        }
+        tg.batch(500, [=](int k) {
+            jitter(k);
+            event(100000 + k);
+        });
+        tg.wait();
+        racer.join();
+        event(-2);
+    }
+    // The pool's threads and the racer flushed their assertions as they exited, and this
+    // thread's are flushed on the way out.
+    StubRecordReplayRuntime::Uninstall();
+}
+
+DEF_SERIAL_TEST(SkExecutor_DeterministicPoolReplays, r) {
+    // Record, then replay: each ordered lock must be taken in the same order, and each thread
+    // must make the same assertions in the same order.
+    StubRecordReplayRuntime recording;
+    run_replay_workload(&recording, 1);
+    StubRecordReplayRuntime replaying(&recording);
+    run_replay_workload(&replaying, 2);
+
+    auto lockOrders = recording.lockOrders();
+    REPORTER_ASSERT(r, lockOrders.size() == 1);  // SkDeterministicPool.fAddLock
+    REPORTER_ASSERT(r, lockOrders == replaying.lockOrders());
+    REPORTER_ASSERT(r, recording.histories() == replaying.histories());
+}
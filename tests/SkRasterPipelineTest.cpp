@@ -5,12 +5,20 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkMatrix.h"
 #include "include/private/SkHalf.h"
 #include "include/private/SkTo.h"
+#include "include/utils/SkRandom.h"
+#include "modules/skcms/skcms.h"
+#include "src/core/SkCpu.h"
+#include "src/core/SkOpts.h"
 #include "src/core/SkRasterPipeline.h"
 #include "src/gpu/Swizzle.h"
 #include "tests/Test.h"
 
+#include <functional>
+#include <vector>
+
 DEF_TEST(SkRasterPipeline, r) {
     // Build and run a simple pipeline to exercise SkRasterPipeline,
     // drawing 50% transparent blue over opaque red in half-floats.
@@ -674,3 +682,197 @@ DEF_TEST(SkRasterPipeline_stack_rewind, r) {
         stack.validate(r);
     }
 }
+
+#if defined(SK_CPU_X86) && !defined(SK_ENABLE_OPTIMIZE_SIZE) && \
+    SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_SKX
+namespace SkOpts {
+    // Defined in src/opts/SkOpts_{hsw,skx}.cpp.
+    void Init_hsw();
+    void Init_skx();
+}  // namespace SkOpts
+
+// The SKX stages run twice as many pixels at a time as the HSW ones, and are meant to draw exactly
+// the same.  This runs a spread of lowp and highp pipelines through both and compares the results.
+// It swaps out the process-wide stage tables, so it must run serially.
+DEF_SERIAL_TEST(SkRasterPipeline_SKXMatchesHSW, r) {
+    if (!SkCpu::Supports(SkCpu::SKX)) {
+        INFOF(r, "SkRasterPipeline_SKXMatchesHSW: this CPU can't run the SKX stages, skipping.\n");
+        return;
+    }
+
+    // Several of the widest stride and then a tail on each row.
+    static constexpr int kW = 3 * SkRasterPipeline_kMaxStride + 7,
+                         kH = 5,
+                         kMaxBytesPerPixel = 16;
+
+    // Random premultiplied 8888 source and destination pixels, converted to each color type below.
+    SkRandom rand;
+    uint32_t src8888[kW * kH], dst8888[kW * kH];
+    for (uint32_t* px : {src8888, dst8888}) {
+        for (int i = 0; i < kW * kH; i++) {
+            uint32_t a = rand.nextULessThan(256);
+            px[i] = a << 24 | rand.nextULessThan(a + 1) << 16 |
+                              rand.nextULessThan(a + 1) <<  8 |
+                              rand.nextULessThan(a + 1);
+        }
+    }
+
+    const SkColorType colorTypes[] = {
+        kAlpha_8_SkColorType,       kA16_unorm_SkColorType,   kA16_float_SkColorType,
+        kRGB_565_SkColorType,       kARGB_4444_SkColorType,   kGray_8_SkColorType,
+        kR8G8_unorm_SkColorType,    kR16G16_unorm_SkColorType, kR16G16_float_SkColorType,
+        kRGBA_8888_SkColorType,     kBGRA_8888_SkColorType,   kSRGBA_8888_SkColorType,
+        kRGBA_1010102_SkColorType,  kR16G16B16A16_unorm_SkColorType,
+        kRGBA_F16_SkColorType,      kRGBA_F32_SkColorType,
+    };
+    struct Converted {
+        SkColorType          ct;
+        std::vector<uint8_t> src, dst;
+    };
+    std::vector<Converted> converted;
+    for (SkColorType ct : colorTypes) {
+        Converted c{ct, std::vector<uint8_t>(kW * kH * kMaxBytesPerPixel),
+                        std::vector<uint8_t>(kW * kH * kMaxBytesPerPixel)};
+        for (auto [from, to] : {std::make_pair(src8888, &c.src), std::make_pair(dst8888, &c.dst)}) {
+            SkRasterPipeline_MemoryCtx in  = {from, kW},
+                                       out = {to->data(), kW};
+            SkRasterPipeline_<256> p;
+            p.append_load (kRGBA_8888_SkColorType, &in);
+            p.append_store(ct, &out);
+            p.run(0,0, kW,kH);
+        }
+        converted.push_back(std::move(c));
+    }
+
+    SkRasterPipeline_GatherCtx gather = {src8888, kW, (float)kW, (float)kH, {}};
+    SkRasterPipeline_TileCtx repeatX = {(float)kW, 1.0f / kW},
+                             repeatY = {(float)kH, 1.0f / kH};
+    SkRasterPipeline_EvenlySpaced2StopGradientCtx twoStop = {{ 0.9f, -0.5f,  0.3f,  0.7f},
+                                                             { 0.1f,  0.8f,  0.2f,  0.3f},
+                                                             false};
+    float fs[4][4], bs[4][4],
+          ts[4] = {0, 0.25f, 0.5f, 0.75f};
+    for (int c = 0; c < 4; c++)
+    for (int i = 0; i < 4; i++) {
+        fs[c][i] = rand.nextRangeF(-1, 1);
+        bs[c][i] = rand.nextRangeF( 0, 1);
+    }
+    SkRasterPipeline_GradientCtx fourStop = {4, {fs[0], fs[1], fs[2], fs[3]},
+                                                {bs[0], bs[1], bs[2], bs[3]}, ts, false};
+    const float ditherRate = 1 / 63.0f;
+
+    SkMatrix rotate = SkMatrix::RotateDeg(17, {kW/2.0f, kH/2.0f});
+    rotate.preScale(0.77f, 1.3f);
+
+    // Each builder appends a pipeline that writes its result to out.
+    using Builder = std::function<void(SkRasterPipeline*, SkArenaAlloc*,
+                                       const SkRasterPipeline_MemoryCtx* out)>;
+    std::vector<std::pair<SkString, Builder>> pipelines;
+    for (const Converted& c : converted) {
+        // Loads and stores in every format, lowp when the format allows it.
+        pipelines.push_back({SkStringPrintf("srcover ct %d", c.ct),
+                             [&c](SkRasterPipeline* p, SkArenaAlloc* alloc,
+                                  const SkRasterPipeline_MemoryCtx* out) {
+            auto src = alloc->make<SkRasterPipeline_MemoryCtx>(
+                                   SkRasterPipeline_MemoryCtx{(void*)c.src.data(), kW}),
+                 dst = alloc->make<SkRasterPipeline_MemoryCtx>(
+                                   SkRasterPipeline_MemoryCtx{(void*)c.dst.data(), kW});
+            p->append_load    (c.ct, src);
+            p->append_load_dst(c.ct, dst);
+            p->append(SkRasterPipeline::srcover);
+            p->append_store(c.ct, out);
+        }});
+    }
+    for (SkRasterPipeline::StockStage mode : {SkRasterPipeline::multiply,
+                                              SkRasterPipeline::overlay,
+                                              SkRasterPipeline::softlight,
+                                              SkRasterPipeline::colorburn,
+                                              SkRasterPipeline::hue}) {
+        pipelines.push_back({SkStringPrintf("blend mode stage %d", mode),
+                             [&, mode](SkRasterPipeline* p, SkArenaAlloc* alloc,
+                                       const SkRasterPipeline_MemoryCtx* out) {
+            auto src = alloc->make<SkRasterPipeline_MemoryCtx>(
+                                   SkRasterPipeline_MemoryCtx{src8888, kW}),
+                 dst = alloc->make<SkRasterPipeline_MemoryCtx>(
+                                   SkRasterPipeline_MemoryCtx{dst8888, kW});
+            p->append_load    (kRGBA_8888_SkColorType, src);
+            p->append_load_dst(kRGBA_8888_SkColorType, dst);
+            p->append(mode);
+            p->append_store(kRGBA_8888_SkColorType, out);
+        }});
+    }
+    pipelines.push_back({SkString("unpremul, transfer function, dither"),
+                         [&](SkRasterPipeline* p, SkArenaAlloc* alloc,
+                             const SkRasterPipeline_MemoryCtx* out) {
+        auto src = alloc->make<SkRasterPipeline_MemoryCtx>(
+                               SkRasterPipeline_MemoryCtx{src8888, kW});
+        p->append_load(kRGBA_8888_SkColorType, src);
+        p->append(SkRasterPipeline::unpremul);
+        p->append_transfer_function(*skcms_sRGB_Inverse_TransferFunction());
+        p->append(SkRasterPipeline::premul);
+        p->append(SkRasterPipeline::dither, &ditherRate);
+        p->append_store(kRGB_565_SkColorType, out);
+    }});
+    pipelines.push_back({SkString("2 stop gradient"),
+                         [&](SkRasterPipeline* p, SkArenaAlloc* alloc,
+                             const SkRasterPipeline_MemoryCtx* out) {
+        p->append(SkRasterPipeline::seed_shader);
+        p->append_matrix(alloc, SkMatrix::Scale(1.0f / kW, 0.1f));
+        p->append(SkRasterPipeline::evenly_spaced_2_stop_gradient, &twoStop);
+        p->append(SkRasterPipeline::clamp_01);
+        p->append_store(kRGBA_8888_SkColorType, out);
+    }});
+    pipelines.push_back({SkString("4 stop radial gradient"),
+                         [&](SkRasterPipeline* p, SkArenaAlloc* alloc,
+                             const SkRasterPipeline_MemoryCtx* out) {
+        p->append(SkRasterPipeline::seed_shader);
+        p->append_matrix(alloc, SkMatrix::Translate(-kW/2.0f, -kH/2.0f).postScale(0.05f, 0.3f));
+        p->append(SkRasterPipeline::xy_to_radius);
+        p->append(SkRasterPipeline::mirror_x_1);
+        p->append(SkRasterPipeline::gradient, &fourStop);
+        p->append_store(kRGBA_F16_SkColorType, out);
+    }});
+    pipelines.push_back({SkString("repeating nearest image"),
+                         [&](SkRasterPipeline* p, SkArenaAlloc* alloc,
+                             const SkRasterPipeline_MemoryCtx* out) {
+        p->append(SkRasterPipeline::seed_shader);
+        p->append_matrix(alloc, rotate);
+        p->append(SkRasterPipeline::repeat_x, &repeatX);
+        p->append(SkRasterPipeline::repeat_y, &repeatY);
+        p->append(SkRasterPipeline::gather_8888, &gather);
+        p->append_store(kRGBA_8888_SkColorType, out);
+    }});
+    pipelines.push_back({SkString("clamped bilerp image"),
+                         [&](SkRasterPipeline* p, SkArenaAlloc* alloc,
+                             const SkRasterPipeline_MemoryCtx* out) {
+        p->append(SkRasterPipeline::seed_shader);
+        p->append_matrix(alloc, rotate);
+        p->append(SkRasterPipeline::bilerp_clamp_8888, &gather);
+        p->append_store(kRGBA_F32_SkColorType, out);
+    }});
+
+    auto run_all = [&] {
+        std::vector<std::vector<uint8_t>> results;
+        for (const auto& [name, build] : pipelines) {
+            std::vector<uint8_t> result(kW * kH * kMaxBytesPerPixel, 0);
+            SkRasterPipeline_MemoryCtx out = {result.data(), kW};
+            SkSTArenaAlloc<1024> alloc;
+            SkRasterPipeline p(&alloc);
+            build(&p, &alloc, &out);
+            p.run(0,0, kW,kH);
+            results.push_back(std::move(result));
+        }
+        return results;
+    };
+
+    // SkOpts::Init() has installed the SKX stages.  Swap in the HSW ones and back again.
+    const std::vector<std::vector<uint8_t>> skx = run_all();
+    SkOpts::Init_hsw();
+    const std::vector<std::vector<uint8_t>> hsw = run_all();
+    SkOpts::Init_skx();
+
+    for (size_t i = 0; i < pipelines.size(); i++) {
+        REPORTER_ASSERT(r, skx[i] == hsw[i], "%s", pipelines[i].first.c_str());
+    }
+}
+#endif
@@ -290,3 +290,54 @@ DEF_TEST(ResourceCache_purge, reporter) {
         }
     }
 }
+
+/*
+ *  The global cache is sharded by key. Check that a sharedID purge reaches every shard, and that
+ *  an entry larger than one shard's share of the budget is still kept. Other tests purge the
+ *  global cache and change its limit, so this one runs on its own.
+ */
+DEF_SERIAL_TEST(ResourceCache_globalShards, reporter) {
+    static constexpr int kSharedID = 0x5ca1ab1e;
+    static constexpr int kCount = 64;
+
+    auto found = [](const TestKey& key) {
+        return SkResourceCache::Find(key, [](const SkResourceCache::Rec&, void*) { return true; },
+                                     nullptr);
+    };
+
+    int flags = 0;
+    for (int i = 0; i < kCount; ++i) {
+        auto rec = std::make_unique<TestRec>(kSharedID, i, &flags);
+        rec->fCanBePurged = true;
+        SkResourceCache::Add(rec.release());
+    }
+    int hits = 0;
+    for (int i = 0; i < kCount; ++i) {
+        hits += found(TestKey(kSharedID, i));
+    }
+    REPORTER_ASSERT(reporter, hits == kCount);
+
+    SkResourceCache::PostPurgeSharedID(kSharedID);
+    SkResourceCache::CheckMessages();
+    for (int i = 0; i < kCount; ++i) {
+        REPORTER_ASSERT(reporter, !found(TestKey(kSharedID, i)));
+    }
+
+    // Setting the budget returns the previous one, whatever backs the cache.
+    const size_t limit = SkResourceCache::GetTotalByteLimit();
+    REPORTER_ASSERT(reporter, SkResourceCache::SetTotalByteLimit(limit + 1) == limit);
+    REPORTER_ASSERT(reporter, SkResourceCache::SetTotalByteLimit(limit) == limit + 1);
+
+    if (SkResourceCache::GetDiscardableFactory()) {
+        return;
+    }
+    struct BigRec : TestRec {
+        BigRec(int* flags) : TestRec(kSharedID, -1, flags) { fCanBePurged = true; }
+        size_t bytesUsed() const override { return fBytes; }
+        size_t fBytes = SkResourceCache::GetTotalByteLimit() / 4;
+    };
+    SkResourceCache::Add(new BigRec(&flags));
+    REPORTER_ASSERT(reporter, found(TestKey(kSharedID, -1)));
+    SkResourceCache::PostPurgeSharedID(kSharedID);
+    SkResourceCache::CheckMessages();
+}
@@ -82,3 +82,71 @@ DEF_TEST(SkScalerCacheMultiThread, Reporter) {
         SkTaskGroup(*executor).batch(kThreadCount, perThread);
     }
 }
+
+// Once a glyph's image is prepared, prepareForDrawingMasksCPU reads it without taking the lock.
+// Threads drawing warm and cold glyphs of the same strike must all see the same result as a
+// single thread would.
+DEF_TEST(SkScalerCacheMultiThreadMasksCPU, reporter) {
+    sk_sp<SkTypeface> typeface =
+            ToolUtils::create_portable_typeface("serif", SkFontStyle::Italic());
+    static constexpr int kThreadCount = 4;
+
+    SkFont font;
+    font.setEdging(SkFont::Edging::kAntiAlias);
+    font.setSubpixel(true);
+    font.setTypeface(typeface);
+
+    SkGlyphID glyphs['z'];
+    SkPoint pos['z'];
+    for (int c = ' '; c < 'z'; c++) {
+        glyphs[c] = font.unicharToGlyph(c);
+        pos[c] = {30.0f * c + 30, 30.0f};
+    }
+    constexpr size_t glyphCount = 'z' - ' ';
+    auto data = SkMakeZip(glyphs, pos).subspan(SkTo<int>(' '), glyphCount);
+
+    SkPaint defaultPaint;
+    SkStrikeSpec strikeSpec = SkStrikeSpec::MakeMask(
+            font, defaultPaint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I());
+
+    auto draw = [&](SkScalerCache* scalerCache, int threadIndex) {
+        auto local = data.subspan(threadIndex * 2, data.size() - kThreadCount * 2);
+        SkDrawableGlyphBuffer accepted;
+        SkSourceGlyphBuffer rejected;
+        accepted.ensureSize(glyphCount);
+        rejected.setSource(local);
+        accepted.startDevicePositioning(
+                rejected.source(), SkMatrix::I(), scalerCache->roundingSpec());
+        scalerCache->prepareForDrawingMasksCPU(&accepted);
+
+        std::vector<SkPackedGlyphID> result;
+        for (auto [variant, _] : accepted.accepted()) {
+            result.push_back(variant.glyph()->getPackedID());
+        }
+        accepted.reset();
+        return result;
+    };
+
+    std::vector<SkPackedGlyphID> expected[kThreadCount];
+    {
+        SkScalerCache scalerCache{strikeSpec.createScalerContext()};
+        for (int threadIndex = 0; threadIndex < kThreadCount; threadIndex++) {
+            expected[threadIndex] = draw(&scalerCache, threadIndex);
+        }
+    }
+
+    auto executor = SkExecutor::MakeFIFOThreadPool(kThreadCount);
+    for (int tries = 0; tries < 20; tries++) {
+        SkScalerCache scalerCache{strikeSpec.createScalerContext()};
+        std::atomic<int> mismatches{0};
+        SkTaskGroup(*executor).batch(kThreadCount, [&](int threadIndex) {
+            for (int i = 0; i < 50; i++) {
+                if (draw(&scalerCache, threadIndex) != expected[threadIndex]) {
+                    mismatches++;
+                }
+            }
+        });
+        REPORTER_ASSERT(reporter, mismatches == 0);
+    }
+}
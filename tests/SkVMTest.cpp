@@ -5,12 +5,20 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkColorPriv.h"
+#include "include/core/SkData.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkStream.h"
+#include "include/effects/SkGradientShader.h"
 #include "include/private/SkColorData.h"
+#include "include/private/SkTHash.h"
+#include "src/core/SkArenaAlloc.h"
 #include "src/core/SkCpu.h"
 #include "src/core/SkMSAN.h"
+#include "src/core/SkMatrixProvider.h"
 #include "src/core/SkVM.h"
+#include "src/core/SkVMBlitter.h"
 #include "src/sksl/SkSLCompiler.h"
 #include "src/sksl/SkSLUtil.h"
 #include "src/sksl/codegen/SkSLVMCodeGenerator.h"
@@ -2885,3 +2893,92 @@ DEF_TEST(SkVM_Visualizer, r) {
                        "<tr class='source'><td class='mask'>&#8617;v9</td>"
                        "<td colspan=2>int main(int x, int y)</td></tr>"));
 }
+
+// Serial, since this installs a process-wide persistent cache that lives on our stack.
+DEF_SERIAL_TEST(SkVMBlitter_ProgramCache, r) {
+    // load() and store() reach back into the program cache, which would deadlock if they were
+    // called while it's locked.
+    struct MemoryPersistentCache final : public SkGraphics::VMProgramPersistentCache {
+        sk_sp<SkData> load(const SkData& key) override {
+            SkGraphics::GetVMProgramCacheTotalByteLimit();
+            sk_sp<SkData>* data = fEntries.find(SkString((const char*)key.data(), key.size()));
+            return data ? *data : nullptr;
+        }
+        void store(const SkData& key, const SkData& data) override {
+            SkGraphics::GetVMProgramCacheTotalByteLimit();
+            fEntries.set(SkString((const char*)key.data(), key.size()),
+                         SkData::MakeWithCopy(data.data(), data.size()));
+        }
+        SkTHashMap<SkString, sk_sp<SkData>> fEntries;
+    } persistent;
+
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::Make(19, 5, kRGBA_F16_SkColorType, kPremul_SkAlphaType));
+    auto draw = [&] {
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        const SkPoint pts[] = {{0, 0}, {19, 5}};
+        const SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+        SkPaint paint;
+        paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2, SkTileMode::kClamp));
+
+        SkArenaAlloc alloc{0};
+        SkMatrixProvider matrices{SkMatrix::I()};
+        SkBlitter* blitter = SkVMBlitter::Make(bm.pixmap(), paint, matrices, &alloc, nullptr);
+        REPORTER_ASSERT(r, blitter);
+        for (int y = 0; blitter && y < bm.height(); y++) {
+            blitter->blitH(0, y, bm.width());
+        }
+    };
+    auto same_pixels = [](const SkBitmap& a, const SkBitmap& b) {
+        return 0 == memcmp(a.getPixels(), b.getPixels(), a.computeByteSize());
+    };
+
+    SkGraphics::SetVMProgramPersistentCache(&persistent);
+    SkVMBlitter::PurgeProgramCache();
+
+    SkGraphics::VMProgramCacheStats before = SkGraphics::GetVMProgramCacheStats();
+    draw();
+    SkGraphics::VMProgramCacheStats built = SkGraphics::GetVMProgramCacheStats();
+    REPORTER_ASSERT(r, built.misses > before.misses);
+    REPORTER_ASSERT(r, persistent.fEntries.count() > 0);
+    SkBitmap expected;
+    expected.allocPixels(bm.info());
+    memcpy(expected.getPixels(), bm.getPixels(), bm.computeByteSize());
+
+    draw();
+    SkGraphics::VMProgramCacheStats hit = SkGraphics::GetVMProgramCacheStats();
+    REPORTER_ASSERT(r, hit.hits > built.hits);
+    REPORTER_ASSERT(r, same_pixels(bm, expected));
+
+    // With the in-memory cache empty, the program comes back from the persistent cache.
+    SkVMBlitter::PurgeProgramCache();
+    draw();
+    SkGraphics::VMProgramCacheStats loaded = SkGraphics::GetVMProgramCacheStats();
+    REPORTER_ASSERT(r, loaded.persistentHits > hit.persistentHits);
+    REPORTER_ASSERT(r, same_pixels(bm, expected));
+
+    // Truncated data is rejected, and the program is simply rebuilt.
+    persistent.fEntries.foreach([](const SkString&, sk_sp<SkData>* data) {
+        *data = SkData::MakeWithCopy((*data)->data(), (*data)->size() / 2);
+    });
+    SkVMBlitter::PurgeProgramCache();
+    draw();
+    REPORTER_ASSERT(r, same_pixels(bm, expected));
+
+    SkGraphics::SetVMProgramPersistentCache(nullptr);
+
+    // Programs are evicted to stay under the byte limit, so with a limit of 0 nothing is kept.
+    REPORTER_ASSERT(r, SkGraphics::GetVMProgramCacheTotalBytesUsed() > 0);
+    size_t limit = SkGraphics::SetVMProgramCacheTotalByteLimit(0);
+    REPORTER_ASSERT(r, SkGraphics::GetVMProgramCacheTotalByteLimit() == 0);
+    REPORTER_ASSERT(r, SkGraphics::GetVMProgramCacheTotalBytesUsed() == 0);
+    draw();
+    REPORTER_ASSERT(r, SkGraphics::GetVMProgramCacheTotalBytesUsed() == 0);
+    REPORTER_ASSERT(r, same_pixels(bm, expected));
+
+    SkGraphics::SetVMProgramCacheTotalByteLimit(limit);
+    REPORTER_ASSERT(r, SkGraphics::GetVMProgramCacheTotalByteLimit() == limit);
+    draw();
+    REPORTER_ASSERT(r, SkGraphics::GetVMProgramCacheTotalBytesUsed() > 0);
+    REPORTER_ASSERT(r, SkGraphics::GetVMProgramCacheTotalBytesUsed() <= limit);
+}
@@ -8,14 +8,17 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkOverdrawCanvas.h"
 #include "include/core/SkPath.h"
+#include "include/core/SkPictureRecorder.h"
 #include "include/core/SkRRect.h"
 #include "include/core/SkRegion.h"
 #include "include/core/SkSurface.h"
 #include "include/effects/SkColorMatrix.h"
 #include "include/gpu/GrBackendSurface.h"
 #include "include/gpu/GrDirectContext.h"
+#include "include/utils/SkRandom.h"
 #include "src/core/SkAutoPixmapStorage.h"
 #include "src/core/SkCanvasPriv.h"
 #include "src/core/SkDevice.h"
@@ -1207,6 +1210,101 @@ DEF_TEST(Surface_null, r) {
     REPORTER_ASSERT(r, surf->makeImageSnapshot() == nullptr);
 }
 
+static void draw_tiled_surface_content(SkCanvas* canvas, int frame) {
+    SkRandom rand(frame);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+
+    // Odd frames draw into an unbounded layer, which all the tiles share.
+    SkAutoCanvasRestore restore(canvas, /*doSave=*/false);
+    if (frame % 2) {
+        canvas->saveLayerAlpha(nullptr, 0xC0);
+    }
+    for (int i = 0; i < 200; i++) {
+        paint.setColor(rand.nextU() | 0x80000000);
+        SkRect r = SkRect::MakeXYWH(rand.nextRangeF(-50, 600), rand.nextRangeF(-50, 600),
+                                    rand.nextRangeF(1, 150), rand.nextRangeF(1, 150));
+        switch (i % 6) {
+            case 0: canvas->drawRect(r, paint); break;
+            case 1: canvas->drawOval(r, paint); break;
+            case 2: canvas->drawRRect(SkRRect::MakeRectXY(r, 7, 7), paint); break;
+            case 3: {
+                canvas->save();
+                canvas->rotate(rand.nextRangeF(0, 90), r.centerX(), r.centerY());
+                canvas->clipRect(r.makeOutset(5, 5), true);
+                canvas->saveLayerAlpha(nullptr, 0x80);
+                canvas->drawPath(SkPath::Circle(r.centerX(), r.centerY(), r.width()), paint);
+                canvas->restore();
+                canvas->restore();
+            } break;
+            case 4: {
+                // Antialiased hairlines blit pixel pairs that can straddle tile edges.
+                SkPaint hairline(paint);
+                hairline.setStyle(SkPaint::kStroke_Style);
+                canvas->drawLine(r.left(), r.top(), r.right(), r.bottom(), hairline);
+            } break;
+            case 5: {
+                // Layers made while drawing a picture are shared too.
+                SkPictureRecorder recorder;
+                SkCanvas* picture = recorder.beginRecording(r.makeOutset(10, 10));
+                picture->saveLayerAlpha(nullptr, 0x80);
+                picture->drawOval(r, paint);
+                picture->restore();
+                picture->saveLayer(nullptr, nullptr);
+                picture->drawRRect(SkRRect::MakeRectXY(r, 7, 7), paint);
+                picture->restore();
+                canvas->drawPicture(recorder.finishRecordingAsPicture());
+            } break;
+        }
+    }
+}
+
+DEF_TEST(SurfaceRasterTiled_MatchesRaster, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(700, 650);
+
+    auto serial = SkSurface::MakeRaster(info);
+    auto tiled  = SkSurface::MakeRasterTiled(info, executor.get());
+    REPORTER_ASSERT(r, tiled);
+    REPORTER_ASSERT(r, tiled->imageInfo() == info);
+
+    for (int frame = 0; frame < 3; frame++) {
+        for (SkSurface* surface : {serial.get(), tiled.get()}) {
+            draw_tiled_surface_content(surface->getCanvas(), frame);
+        }
+        // Snapshots must match, and must not see draws recorded after them.
+        sk_sp<SkImage> expected = serial->makeImageSnapshot(),
+                       actual   = tiled->makeImageSnapshot();
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected.get(), actual.get()));
+
+        // Leave a matrix and an open layer pending across the snapshot.
+        for (SkSurface* surface : {serial.get(), tiled.get()}) {
+            surface->getCanvas()->translate(3, 5);
+            surface->getCanvas()->saveLayerAlpha(nullptr, 0x40);
+            surface->getCanvas()->drawColor(SK_ColorBLUE);
+        }
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected.get(), actual.get()));
+
+        SkBitmap expectedBM, actualBM;
+        expectedBM.allocPixels(info);
+        actualBM.allocPixels(info);
+        REPORTER_ASSERT(r, serial->readPixels(expectedBM, 0, 0));
+        REPORTER_ASSERT(r, tiled->readPixels(actualBM, 0, 0));
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(expectedBM, actualBM));
+
+        for (SkSurface* surface : {serial.get(), tiled.get()}) {
+            surface->getCanvas()->restore();
+        }
+    }
+
+    SkBitmap expectedBM, actualBM;
+    expectedBM.allocPixels(info);
+    actualBM.allocPixels(info);
+    REPORTER_ASSERT(r, serial->readPixels(expectedBM, 0, 0));
+    REPORTER_ASSERT(r, tiled->readPixels(actualBM, 0, 0));
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(expectedBM, actualBM));
+}
+
 // assert: if a given imageinfo is valid for a surface, then it must be valid for an image
 //         (so the snapshot can succeed)
 DEF_TEST(surface_image_unity, reporter) {
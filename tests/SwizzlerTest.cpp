@@ -5,12 +5,17 @@
  * found in the LICENSE file.
  */
 
+#include "include/codec/SkCodec.h"
 #include "include/core/SkSwizzle.h"
+#include "include/private/SkEncodedInfo.h"
 #include "include/private/SkImageInfoPriv.h"
 #include "src/codec/SkSwizzler.h"
 #include "src/core/SkOpts.h"
 #include "tests/Test.h"
 
+#include <algorithm>
+#include <cstring>
+
 static void check_fill(skiatest::Reporter* r,
                        const SkImageInfo& imageInfo,
                        uint32_t startRow,
@@ -152,3 +157,54 @@ DEF_TEST(PublicSwizzleOpts, r) {
     SkSwapRB(&dst, &src, 1);
     REPORTER_ASSERT(r, dst == 0xFA04B0CE);
 }
+
+// swizzleRange() over consecutive chunks must write the same pixels as swizzle().
+DEF_TEST(SwizzlerRange, r) {
+    constexpr int kWidth = 50;
+    uint8_t src[kWidth * 3];
+    for (size_t i = 0; i < sizeof(src); i++) {
+        src[i] = (uint8_t)(i * 37 + 11);
+    }
+
+    const struct {
+        SkEncodedInfo::Color color;
+        int                  bitsPerComponent;
+        SkColorType          dstColorType;
+    } kFormats[] = {
+        { SkEncodedInfo::kRGB_Color,  8, kRGBA_8888_SkColorType },
+        { SkEncodedInfo::kRGB_Color,  8, kBGRA_8888_SkColorType },
+        { SkEncodedInfo::kGray_Color, 8, kGray_8_SkColorType    },
+        { SkEncodedInfo::kGray_Color, 1, kGray_8_SkColorType    },  // Offsets are in bits.
+    };
+    const SkIRect subset = SkIRect::MakeXYWH(5, 0, 40, 1);
+    for (const auto& format : kFormats) {
+        auto encodedInfo = SkEncodedInfo::Make(kWidth, 1, format.color,
+                                               SkEncodedInfo::kOpaque_Alpha,
+                                               format.bitsPerComponent);
+        for (bool useSubset : { false, true }) {
+            for (int sampleX : { 1, 3 }) {
+                SkCodec::Options options;
+                options.fSubset = useSubset ? &subset : nullptr;
+                const SkImageInfo dstInfo = SkImageInfo::Make(useSubset ? subset.width() : kWidth,
+                                                              1, format.dstColorType,
+                                                              kOpaque_SkAlphaType);
+                auto swizzler = SkSwizzler::Make(encodedInfo, nullptr, dstInfo, options);
+                REPORTER_ASSERT(r, swizzler);
+                if (!swizzler) {
+                    continue;
+                }
+                swizzler->setSampleX(sampleX);
+
+                const int width = swizzler->swizzleWidth();
+                const size_t bpp = dstInfo.bytesPerPixel();
+                uint8_t expected[kWidth * 4] = {},
+                        actual[kWidth * 4] = {};
+                swizzler->swizzle(expected, src);
+                for (int x = 0; x < width; x += 7) {
+                    swizzler->swizzleRange(actual + x * bpp, src, x, std::min(7, width - x));
+                }
+                REPORTER_ASSERT(r, 0 == memcmp(expected, actual, width * bpp));
+            }
+        }
+    }
+}
@@ -93,6 +93,14 @@ struct Test {
                     proc, nullptr, nullptr, nullptr);
     }
 
+    // Like MakeCPU(), but the test runner won't run it concurrently with anything else, for tests
+    // that change process-wide state.
+    static Test MakeSerialCPU(const char* name, CPUTestProc proc) {
+        Test test = MakeCPU(name, proc);
+        test.fSerial = true;
+        return test;
+    }
+
     static Test MakeGanesh(const char* name, CtsEnforcement ctsEnforcement,
                            GaneshTestProc proc, ContextOptionsProc optionsProc = nullptr) {
         return Test(name, TestType::kGanesh, ctsEnforcement,
@@ -112,6 +120,7 @@ struct Test {
     GaneshTestProc fGaneshProc = nullptr;
     GraphiteTestProc fGraphiteProc = nullptr;
     ContextOptionsProc fContextOptionsProc = nullptr;
+    bool fSerial = false;
 
     void modifyGrContextOptions(GrContextOptions* options) {
         if (fContextOptionsProc) {
@@ -263,6 +272,14 @@ using skiatest::Test;
 
 #define DEF_TEST_DISABLED(name, reporter) DEF_CONDITIONAL_TEST(name, reporter, false)
 
+// For CPU tests that change process-wide state, like global caches or which SkOpts are in use.
+// DM runs these one at a time, after all its other work has finished.
+#define DEF_SERIAL_TEST(name, reporter)                                                \
+    static void test_##name(skiatest::Reporter*);                                      \
+    skiatest::TestRegistry name##TestRegistry(Test::MakeSerialCPU(#name,               \
+                                                                  test_##name));       \
+    void test_##name(skiatest::Reporter* reporter)
+
 #ifdef SK_BUILD_FOR_UNIX
     #define UNIX_ONLY_TEST DEF_TEST
 #else
@@ -2703,8 +2703,7 @@ void Viewer::drawImGui() {
             }
 
             if (ImGui::CollapsingHeader("SkVM")) {
-                auto* cache = SkVMBlitter::TryAcquireProgramCache();
-                SkASSERT(cache);
+                auto* cache = SkVMBlitter::AcquireProgramCache();
 
                 if (ImGui::Button("Clear")) {
                     cache->reset();
@@ -2713,10 +2712,11 @@ void Viewer::drawImGui() {
 
                 // First, go through the cache and restore the original program if we were hovering
                 if (!fHoveredProgram.empty()) {
-                    auto restoreHoveredProgram = [this](const SkVMBlitter::Key* key,
-                                                        skvm::Program* program) {
+                    auto restoreHoveredProgram = [this](
+                            const SkVMBlitter::Key* key,
+                            sk_sp<SkVMBlitter::SharedProgram>* shared) {
                         if (*key == fHoveredKey) {
-                            *program = std::move(fHoveredProgram);
+                            (*shared)->program = std::move(fHoveredProgram);
                             fHoveredProgram = {};
                         }
                     };
@@ -2725,7 +2725,9 @@ void Viewer::drawImGui() {
 
                 // Now iterate again, and dump any expanded program. If any program is hovered,
                 // patch it, and remember the original (so it can be restored next frame).
-                auto showVMEntry = [this](const SkVMBlitter::Key* key, skvm::Program* program) {
+                auto showVMEntry = [this](const SkVMBlitter::Key* key,
+                                          sk_sp<SkVMBlitter::SharedProgram>* shared) {
+                    skvm::Program* program = &(*shared)->program;
                     SkString keyString = SkVMBlitter::DebugName(*key);
                     bool inTreeNode = ImGui::TreeNode(keyString.c_str());
                     bool hovered = ImGui::IsItemHovered();